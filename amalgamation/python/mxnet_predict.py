@@ -29,7 +29,7 @@ import ctypes
 import logging
 import numpy as np
 
-__all__ = ["Predictor", "load_ndarray_file"]
+__all__ = ["Predictor", "create_predictors", "Batcher", "load_ndarray_file"]
 
 if sys.version_info[0] == 3:
     py_str = lambda x: x.decode('utf-8')
@@ -94,6 +94,8 @@ mx_float = ctypes.c_float
 mx_float_p = ctypes.POINTER(mx_float)
 PredictorHandle = ctypes.c_void_p
 NDListHandle = ctypes.c_void_p
+PredBatcherHandle = ctypes.c_void_p
+PredRequestHandle = ctypes.c_void_p
 
 devstr2type = {'cpu': 1, 'gpu': 2, 'cpu_pinned': 3}
 
@@ -144,6 +146,13 @@ class Predictor(object):
             ctypes.byref(handle)))
         self.handle = handle
 
+    @classmethod
+    def _from_handle(cls, handle):
+        """Create a predictor from an existing predictor handle."""
+        predictor = cls.__new__(cls)
+        predictor.handle = handle
+        return predictor
+
     def __del__(self):
         _check_call(_LIB.MXPredFree(self.handle))
 
@@ -231,6 +240,226 @@ class Predictor(object):
         return data
 
 
+def create_predictors(symbol_file, param_raw_bytes, input_shapes,
+                      num_instances, dev_type="cpu", dev_id=0):
+    """Create several static-shape predictors sharing one copy of parameters.
+
+    Each predictor owns its activation memory only, so different predictors
+    can run in different threads. Reshaping such a predictor caches the bound
+    shapes, switching back to a previously used shape does not rebind.
+
+    Parameters
+    ----------
+    symbol_file : str
+        The JSON string of the symbol.
+
+    param_raw_bytes : str, bytes
+        The raw parameter bytes.
+
+    input_shapes : dict of str to tuple
+        The shape of input data
+
+    num_instances : int
+        The number of predictors to create.
+
+    dev_type : str, optional
+        The device type of the predictors.
+
+    dev_id : int, optional
+        The device id of the predictors.
+
+    Returns
+    -------
+    out : list of Predictor
+        The created predictors.
+    """
+    dev_type = devstr2type[dev_type]
+    indptr = [0]
+    sdata = []
+    keys = []
+    for k, v  in input_shapes.items():
+        if not isinstance(v, tuple):
+            raise ValueError("Expect input_shapes to be dict str->tuple")
+        keys.append(c_str(k))
+        sdata.extend(v)
+        indptr.append(len(sdata))
+    handles = (PredictorHandle * num_instances)()
+    param_raw_bytes = bytearray(param_raw_bytes)
+    ptr = (ctypes.c_char * len(param_raw_bytes)).from_buffer(param_raw_bytes)
+    _check_call(_LIB.MXPredCreateMultiInstance(
+        c_str(symbol_file),
+        ptr, len(param_raw_bytes),
+        ctypes.c_int(dev_type), ctypes.c_int(dev_id),
+        mx_uint(len(indptr) - 1),
+        c_array(ctypes.c_char_p, keys),
+        c_array(mx_uint, indptr),
+        c_array(mx_uint, sdata),
+        mx_uint(num_instances),
+        handles))
+    return [Predictor._from_handle(PredictorHandle(h)) for h in handles]
+
+
+class BatchRequest(object):
+    """A single-sample request submitted to a Batcher."""
+    def __init__(self, handle):
+        self.handle = handle
+
+    def __del__(self):
+        _check_call(_LIB.MXPredRequestFree(self.handle))
+
+    def wait(self):
+        """Block until the outputs of the request are ready."""
+        _check_call(_LIB.MXPredRequestWait(self.handle))
+
+    def get_output(self, index):
+        """Get the index-th output, the first dimension of which is 1.
+
+        Parameters
+        ----------
+        index : int
+            The index of output.
+
+        Returns
+        -------
+        out : numpy array.
+            The output array.
+        """
+        pdata = ctypes.POINTER(mx_uint)()
+        ndim = mx_uint()
+        _check_call(_LIB.MXPredRequestGetOutputShape(
+            self.handle, mx_uint(index),
+            ctypes.byref(pdata),
+            ctypes.byref(ndim)))
+        shape = tuple(pdata[:ndim.value])
+        data = np.empty(shape, dtype=np.float32)
+        _check_call(_LIB.MXPredRequestGetOutput(
+            self.handle, mx_uint(index),
+            data.ctypes.data_as(mx_float_p),
+            mx_uint(data.size)))
+        return data
+
+
+class Batcher(object):
+    """A predictor which coalesces single-sample requests into batches.
+
+    Requests can be submitted from multiple threads.
+
+    Parameters
+    ----------
+    symbol_file : str
+        The JSON string of the symbol.
+
+    param_raw_bytes : str, bytes
+        The raw parameter bytes.
+
+    sample_shapes : dict of str to tuple
+        The shape of a single sample of input data, without the batch dimension.
+
+    max_batch_size : int
+        The maximum number of requests in a batch.
+
+    max_wait_us : int, optional
+        The maximum time in microseconds to wait for a batch to fill up.
+
+    num_workers : int, optional
+        The number of worker threads running batches.
+
+    dev_type : str, optional
+        The device type of the predictor.
+
+    dev_id : int, optional
+        The device id of the predictor.
+    """
+    def __init__(self, symbol_file, param_raw_bytes, sample_shapes,
+                 max_batch_size, max_wait_us=1000, num_workers=1,
+                 dev_type="cpu", dev_id=0):
+        dev_type = devstr2type[dev_type]
+        indptr = [0]
+        sdata = []
+        keys = []
+        self.input_keys = []
+        for k, v in sample_shapes.items():
+            if not isinstance(v, tuple):
+                raise ValueError("Expect sample_shapes to be dict str->tuple")
+            keys.append(c_str(k))
+            self.input_keys.append(k)
+            sdata.extend(v)
+            indptr.append(len(sdata))
+        handle = PredBatcherHandle()
+        param_raw_bytes = bytearray(param_raw_bytes)
+        ptr = (ctypes.c_char * len(param_raw_bytes)).from_buffer(param_raw_bytes)
+        _check_call(_LIB.MXPredBatcherCreate(
+            c_str(symbol_file),
+            ptr, len(param_raw_bytes),
+            ctypes.c_int(dev_type), ctypes.c_int(dev_id),
+            mx_uint(len(indptr) - 1),
+            c_array(ctypes.c_char_p, keys),
+            c_array(mx_uint, indptr),
+            c_array(mx_uint, sdata),
+            mx_uint(max_batch_size),
+            mx_uint(max_wait_us),
+            mx_uint(num_workers),
+            ctypes.byref(handle)))
+        self.handle = handle
+
+    def __del__(self):
+        _check_call(_LIB.MXPredBatcherFree(self.handle))
+
+    def submit(self, **kwargs):
+        """Submit a single-sample request.
+
+        Parameters
+        ----------
+        **kwargs
+            Keyword arguments of input variable name to data of a single sample.
+
+        Returns
+        -------
+        out : BatchRequest
+            The submitted request.
+        """
+        data = []
+        for k in self.input_keys:
+            v = kwargs[k]
+            if not isinstance(v, np.ndarray):
+                raise ValueError("Expect numpy ndarray as input")
+            data.append(np.ascontiguousarray(v, dtype=np.float32))
+        ptrs = c_array(mx_float_p, [v.ctypes.data_as(mx_float_p) for v in data])
+        handle = PredRequestHandle()
+        _check_call(_LIB.MXPredBatcherSubmit(self.handle, ptrs, ctypes.byref(handle)))
+        return BatchRequest(handle)
+
+    def batch_size_histogram(self):
+        """Get the number of batches run for each batch size.
+
+        Returns
+        -------
+        out : list of int
+            The i-th element is the number of batches of size i + 1.
+        """
+        num_bins = mx_uint()
+        counts = ctypes.POINTER(mx_uint)()
+        _check_call(_LIB.MXPredBatcherGetBatchSizeHistogram(
+            self.handle, ctypes.byref(num_bins), ctypes.byref(counts)))
+        return list(counts[:num_bins.value])
+
+    def latency_histogram(self):
+        """Get the histogram of request latencies.
+
+        Returns
+        -------
+        out : list of (int, int)
+            The upper bound in microseconds and the number of requests of each bin.
+        """
+        num_bins = mx_uint()
+        bounds = ctypes.POINTER(mx_uint)()
+        counts = ctypes.POINTER(mx_uint)()
+        _check_call(_LIB.MXPredBatcherGetLatencyHistogram(
+            self.handle, ctypes.byref(num_bins),
+            ctypes.byref(bounds), ctypes.byref(counts)))
+        return list(zip(bounds[:num_bins.value], counts[:num_bins.value]))
+
+
 def load_ndarray_file(nd_bytes):
     """Load ndarray file and return as list of numpy array.
 
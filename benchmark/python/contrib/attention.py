@@ -0,0 +1,82 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+# Benchmark the fused multihead attention operators on CPU against the unfused
+# graph, which materializes the attention weights:
+#   interleaved_matmul_*_qk -> softmax -> interleaved_matmul_*_valatt
+
+from __future__ import print_function
+from six.moves import range
+
+import argparse
+from itertools import product
+from time import time
+
+import mxnet as mx
+
+
+_parser = argparse.ArgumentParser(description='Benchmark the fused multihead attention on CPU.')
+_parser.add_argument('--heads', type=int, default=8)
+_parser.add_argument('--head_dim', type=int, default=64)
+_parser.add_argument('--warmup_rounds', type=int, default=5)
+_parser.add_argument('--test_rounds', type=int, default=20)
+args = _parser.parse_args()
+
+
+def _unfused_selfatt(qkv, heads):
+    att = mx.nd.contrib.interleaved_matmul_selfatt_qk(qkv, heads=heads)
+    att = mx.nd.softmax(att, axis=-1)
+    return mx.nd.contrib.interleaved_matmul_selfatt_valatt(qkv, att, heads=heads)
+
+
+def _fused_selfatt(qkv, heads):
+    return mx.nd.contrib.interleaved_selfatt(qkv, heads=heads)
+
+
+def _time(f, qkv, heads, backward):
+    qkv.attach_grad()
+
+    def run():
+        if backward:
+            with mx.autograd.record():
+                out = f(qkv, heads)
+            out.backward()
+            qkv.grad.wait_to_read()
+        else:
+            f(qkv, heads).wait_to_read()
+    for _ in range(args.warmup_rounds):
+        run()
+    start = time()
+    for _ in range(args.test_rounds):
+        run()
+    return (time() - start) / args.test_rounds * 1000
+
+
+def main():
+    ctx = mx.cpu()
+    embed = args.heads * args.head_dim
+    print('seq_length batch pass    unfused (ms)  fused (ms)')
+    for length, batch, backward in product([128, 512, 1024], [1, 16], [False, True]):
+        qkv = mx.nd.random.normal(shape=(length, batch, 3 * embed), ctx=ctx)
+        unfused = _time(_unfused_selfatt, qkv, args.heads, backward)
+        fused = _time(_fused_selfatt, qkv, args.heads, backward)
+        print('%10d %5d %-8s %12.3f %11.3f' % (length, batch, 'backward' if backward else 'forward',
+                                               unfused, fused))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,109 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+# Benchmark the CPU detection post-processing operators with the box counts of
+# SSD (8732 anchors at 300x300) and Faster-RCNN (RPN over a 38x50 feature map,
+# 300 to 1000 ROIs per image classified over 80 classes):
+#   box_nms, MultiBoxDetection, Proposal and MultiProposal
+
+from __future__ import print_function
+from six.moves import range
+
+import argparse
+from time import time
+
+import mxnet as mx
+
+
+_parser = argparse.ArgumentParser(description='Benchmark CPU detection post-processing.')
+_parser.add_argument('--batch_sizes', type=int, nargs='+', default=[1, 8])
+_parser.add_argument('--warmup_rounds', type=int, default=3)
+_parser.add_argument('--test_rounds', type=int, default=10)
+args = _parser.parse_args()
+
+
+def _time(f):
+    for _ in range(args.warmup_rounds):
+        f().wait_to_read()
+    start = time()
+    for _ in range(args.test_rounds):
+        f().wait_to_read()
+    return (time() - start) / args.test_rounds * 1000
+
+
+def _random_boxes(batch, num_box, num_classes, ctx):
+    xy = mx.nd.random.uniform(0, 1, shape=(batch, num_box, 2), ctx=ctx)
+    wh = mx.nd.random.uniform(0.02, 0.3, shape=(batch, num_box, 2), ctx=ctx)
+    cls_id = mx.nd.random.randint(0, num_classes, shape=(batch, num_box, 1), ctx=ctx)
+    score = mx.nd.random.uniform(shape=(batch, num_box, 1), ctx=ctx)
+    return mx.nd.concat(cls_id.astype('float32'), score, xy, xy + wh, dim=-1)
+
+
+def bench_box_nms(batch, ctx):
+    cases = [('ssd', 8732, 20, 400), ('ssd', 8732, 80, 400), ('faster-rcnn', 300 * 80, 80, -1),
+             ('faster-rcnn', 1000 * 80, 80, -1)]
+    for name, num_box, num_classes, topk in cases:
+        data = _random_boxes(batch, num_box, num_classes, ctx)
+        for force in [False, True]:
+            ms = _time(lambda: mx.nd.contrib.box_nms(data, overlap_thresh=0.45, valid_thresh=0.01,
+                                                     topk=topk, id_index=0, force_suppress=force))
+            print('box_nms            %-12s batch %2d boxes %6d classes %2d force %-5s %9.3f ms'
+                  % (name, batch, num_box, num_classes, force, ms))
+
+
+def bench_multibox_detection(batch, ctx):
+    num_anchors = 8732
+    for num_classes in [21, 81]:
+        cls_prob = mx.nd.softmax(mx.nd.random.normal(shape=(batch, num_classes, num_anchors),
+                                                     ctx=ctx), axis=1)
+        loc_pred = mx.nd.random.normal(0, 0.1, shape=(batch, num_anchors * 4), ctx=ctx)
+        anchors = _random_boxes(1, num_anchors, 1, ctx)[:, :, 2:]
+        ms = _time(lambda: mx.nd.contrib.MultiBoxDetection(cls_prob, loc_pred, anchors,
+                                                           threshold=0.01, nms_threshold=0.45,
+                                                           nms_topk=400))
+        print('MultiBoxDetection  %-12s batch %2d boxes %6d classes %2d %21.3f ms'
+              % ('ssd', batch, num_anchors, num_classes, ms))
+
+
+def bench_proposal(batch, ctx):
+    height, width, num_anchors = 38, 50, 9
+    cls_prob = mx.nd.random.uniform(shape=(batch, 2 * num_anchors, height, width), ctx=ctx)
+    bbox_pred = mx.nd.random.normal(0, 0.1, shape=(batch, 4 * num_anchors, height, width),
+                                    ctx=ctx)
+    im_info = mx.nd.array([[height * 16, width * 16, 1]] * batch, ctx=ctx)
+    for pre_nms, post_nms in [(6000, 300), (12000, 2000)]:
+        kwargs = dict(rpn_pre_nms_top_n=pre_nms, rpn_post_nms_top_n=post_nms, threshold=0.7,
+                      feature_stride=16, scales=(8, 16, 32), ratios=(0.5, 1, 2))
+        if batch == 1:
+            ms = _time(lambda: mx.nd.contrib.Proposal(cls_prob, bbox_pred, im_info, **kwargs))
+            print('Proposal           %-12s batch %2d boxes %6d pre_nms %5d %17.3f ms'
+                  % ('faster-rcnn', batch, height * width * num_anchors, pre_nms, ms))
+        ms = _time(lambda: mx.nd.contrib.MultiProposal(cls_prob, bbox_pred, im_info, **kwargs))
+        print('MultiProposal      %-12s batch %2d boxes %6d pre_nms %5d %17.3f ms'
+              % ('faster-rcnn', batch, height * width * num_anchors, pre_nms, ms))
+
+
+def main():
+    ctx = mx.cpu()
+    for batch in args.batch_sizes:
+        bench_box_nms(batch, ctx)
+        bench_multibox_detection(batch, ctx)
+        bench_proposal(batch, ctx)
+
+
+if __name__ == '__main__':
+    main()
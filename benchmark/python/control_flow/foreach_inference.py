@@ -0,0 +1,89 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+# Benchmark the per-step overhead of foreach in inference, with the loop body
+# pushed to the engine in every step (MXNET_FOREACH_FUSE_INFERENCE=0) and with
+# all the steps running in a single engine operation (the default).
+
+from __future__ import print_function
+from six.moves import range
+
+import argparse
+import os
+from itertools import product
+from time import time
+
+import mxnet as mx
+import numpy as np
+
+
+_parser = argparse.ArgumentParser(description='Benchmark the per-step overhead of foreach in inference.')
+_parser.add_argument('--warmup_rounds', type=int, default=20)
+_parser.add_argument('--test_rounds', type=int, default=100)
+args = _parser.parse_args()
+
+
+def _rnn(hidden_dim):
+    def _step(data, states):
+        h = mx.sym.FullyConnected(data, num_hidden=hidden_dim, name='i2h') + \
+            mx.sym.FullyConnected(states[0], num_hidden=hidden_dim, name='h2h')
+        h = mx.sym.tanh(h)
+        return h, [h]
+    out, _ = mx.sym.contrib.foreach(_step, mx.sym.var('data'), [mx.sym.var('h')])
+    return out
+
+
+def run_benchmark(ctx, seq_len, batch_size, hidden_dim, fuse):
+    os.environ["MXNET_FOREACH_FUSE_INFERENCE"] = "1" if fuse else "0"
+    sym = _rnn(hidden_dim)
+    exe = sym.simple_bind(ctx=ctx, grad_req='null',
+                          data=(seq_len, batch_size, hidden_dim), h=(batch_size, hidden_dim))
+    for arr in exe.arg_arrays:
+        arr[:] = np.random.normal(size=arr.shape)
+    times = []
+    for _ in range(args.warmup_rounds + args.test_rounds):
+        tick = time()
+        exe.forward(is_train=False)
+        mx.nd.waitall()
+        tock = time()
+        times.append((tock - tick) * 1000.0)
+    del os.environ["MXNET_FOREACH_FUSE_INFERENCE"]
+    return np.mean(times[args.warmup_rounds:])
+
+
+def main():
+    ctx = mx.cpu(0)
+    seq_lens = [25, 100]
+    batch_sizes = [1, 32]
+    hidden_dims = [16, 512]
+    print("--------------------------------------")
+    print("Benchmarking foreach inference")
+    for batch_size, hidden_dim in product(batch_sizes, hidden_dims):
+        print("--------------------------------------")
+        print("ctx: %s  batch size: %d  dim: %d" % (str(ctx), batch_size, hidden_dim))
+        for fuse in [False, True]:
+            t = [run_benchmark(ctx, seq_len, batch_size, hidden_dim, fuse) for seq_len in seq_lens]
+            # The per-step time is the slope over the sequence lengths, which
+            # excludes the fixed cost of a forward.
+            per_step = (t[-1] - t[0]) / (seq_lens[-1] - seq_lens[0])
+            print("fused = %r: %s, per step = %.4f ms" % (
+                fuse, ", ".join("length %d = %.3f ms" % (l, x) for l, x in zip(seq_lens, t)),
+                per_step))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,83 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+# Benchmark the CPU preprocessing of a batch of HWC uint8 images into normalized
+# CHW float tensors: image.to_tensor_normalize against to_tensor followed by
+# normalize on each image, without and with resizing and center cropping.
+
+from __future__ import print_function
+from six.moves import range
+
+import argparse
+from time import time
+
+import mxnet as mx
+
+
+_parser = argparse.ArgumentParser(description='Benchmark CPU image to tensor preprocessing.')
+_parser.add_argument('--batch_sizes', type=int, nargs='+', default=[1, 8, 32])
+_parser.add_argument('--warmup_rounds', type=int, default=3)
+_parser.add_argument('--test_rounds', type=int, default=10)
+args = _parser.parse_args()
+
+MEAN = (0.485, 0.456, 0.406)
+STD = (0.229, 0.224, 0.225)
+
+
+def _time(f):
+    for _ in range(args.warmup_rounds):
+        f()
+    mx.nd.waitall()
+    start = time()
+    for _ in range(args.test_rounds):
+        f()
+    mx.nd.waitall()
+    return (time() - start) / args.test_rounds * 1000
+
+
+def _separate(images, size=None, crop=None):
+    out = []
+    for img in images:
+        if size is not None:
+            img = mx.image.imresize(img, *size)
+        if crop is not None:
+            img = mx.image.fixed_crop(img, *crop)
+        out.append(mx.nd.image.normalize(mx.nd.image.to_tensor(img), mean=MEAN, std=STD))
+    return out
+
+
+def main():
+    for batch in args.batch_sizes:
+        for height, width in [(224, 224), (480, 640)]:
+            data = mx.nd.random.uniform(0, 255, shape=(batch, height, width, 3)).astype('uint8')
+            images = [data[i] for i in range(batch)]
+            sep = _time(lambda: _separate(images))
+            fused = _time(lambda: mx.nd.image.to_tensor_normalize(data, mean=MEAN, std=STD))
+            print('to_tensor+normalize            batch %2d %4dx%-4d separate %8.3f ms '
+                  'fused %8.3f ms' % (batch, width, height, sep, fused))
+            # resize the short side to 256 and crop 224x224 at the center
+            size = (256 * width // height, 256) if width > height else (256, 256 * height // width)
+            crop = ((size[0] - 224) // 2, (size[1] - 224) // 2, 224, 224)
+            sep = _time(lambda: _separate(images, size, crop))
+            fused = _time(lambda: mx.nd.image.to_tensor_normalize(data, mean=MEAN, std=STD,
+                                                                  size=size, crop=crop))
+            print('resize+crop+to_tensor+normalize batch %2d %4dx%-4d separate %8.3f ms '
+                  'fused %8.3f ms' % (batch, width, height, sep, fused))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,82 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+# Benchmark the overhead of dispatching an imperative operator, with the
+# inferred attributes of the calls cached (the default) and not cached
+# (MXNET_IMPERATIVE_DISPATCH_CACHE_SIZE=0). The operators run on tiny arrays,
+# so that the time is dominated by the dispatch.
+
+from __future__ import print_function
+from six.moves import range
+
+import argparse
+import os
+import subprocess
+import sys
+from time import time
+
+import mxnet as mx
+
+
+_parser = argparse.ArgumentParser(description='Benchmark the dispatch overhead of imperative operators.')
+_parser.add_argument('--num_calls', type=int, default=100000)
+_parser.add_argument('--run', action='store_true', help='run the benchmark in this process.')
+args = _parser.parse_args()
+
+
+def _ops():
+    a = mx.nd.ones((2, 2))
+    b = mx.nd.ones((2, 2))
+    w = mx.nd.ones((2, 2))
+    return [
+        ("elemwise_add", lambda: mx.nd.elemwise_add(a, b)),
+        ("broadcast_mul", lambda: mx.nd.broadcast_mul(a, b)),
+        ("relu", lambda: mx.nd.relu(a)),
+        ("sum(axis=1)", lambda: mx.nd.sum(a, axis=1)),
+        ("FullyConnected", lambda: mx.nd.FullyConnected(a, w, num_hidden=2, no_bias=True)),
+    ]
+
+
+def run():
+    for name, fn in _ops():
+        for _ in range(100):
+            fn()
+        mx.nd.waitall()
+        tick = time()
+        for _ in range(args.num_calls):
+            fn()
+        mx.nd.waitall()
+        tock = time()
+        print("%-16s %.2f us per call" % (name, (tock - tick) * 1e6 / args.num_calls))
+
+
+def main():
+    for cache_size in ["0", "4096"]:
+        env = dict(os.environ)
+        env["MXNET_IMPERATIVE_DISPATCH_CACHE_SIZE"] = cache_size
+        print("--------------------------------------")
+        print("MXNET_IMPERATIVE_DISPATCH_CACHE_SIZE = %s" % cache_size)
+        sys.stdout.flush()
+        subprocess.check_call([sys.executable, __file__, "--run",
+                               "--num_calls", str(args.num_calls)], env=env)
+
+
+if __name__ == "__main__":
+    if args.run:
+        run()
+    else:
+        main()
@@ -0,0 +1,84 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+# Benchmark the fused RNN operator in lstm or gru mode on CPU across sequence
+# lengths and batch sizes, for inference and training (forward + backward).
+#
+# The recurrent steps use MKL for their per thread GEMMs in MKL builds, and a plain
+# loop with any other BLAS. Compare both on the same machine, e.g. with an OpenBLAS
+# build (USE_BLAS=openblas), whose own threads are not used by the recurrent steps:
+#   OMP_NUM_THREADS=16 python fused_lstm.py --seq_lengths 64 --batch_sizes 1 64
+#   OMP_NUM_THREADS=16 python fused_lstm.py --mode gru --seq_lengths 64 --batch_sizes 1 64
+
+from __future__ import print_function
+from six.moves import range
+
+import argparse
+from itertools import product
+from time import time
+
+import mxnet as mx
+
+
+_parser = argparse.ArgumentParser(description='Benchmark the fused LSTM or GRU on CPU.')
+_parser.add_argument('--mode', choices=['lstm', 'gru'], default='lstm')
+_parser.add_argument('--input_size', type=int, default=512)
+_parser.add_argument('--hidden_size', type=int, default=512)
+_parser.add_argument('--num_layers', type=int, default=1)
+_parser.add_argument('--bidirectional', action='store_true')
+_parser.add_argument('--seq_lengths', type=int, nargs='+', default=[16, 64, 256])
+_parser.add_argument('--batch_sizes', type=int, nargs='+', default=[1, 16, 64])
+_parser.add_argument('--warmup_rounds', type=int, default=3)
+_parser.add_argument('--test_rounds', type=int, default=10)
+args = _parser.parse_args()
+
+
+def _time(layer, x, backward):
+    x.attach_grad()
+
+    def run():
+        if backward:
+            with mx.autograd.record():
+                out = layer(x)
+            out.backward()
+            x.grad.wait_to_read()
+        else:
+            layer(x).wait_to_read()
+    for _ in range(args.warmup_rounds):
+        run()
+    start = time()
+    for _ in range(args.test_rounds):
+        run()
+    return (time() - start) / args.test_rounds * 1000
+
+
+def main():
+    ctx = mx.cpu()
+    rnn = mx.gluon.rnn.LSTM if args.mode == 'lstm' else mx.gluon.rnn.GRU
+    layer = rnn(args.hidden_size, num_layers=args.num_layers,
+                bidirectional=args.bidirectional, input_size=args.input_size)
+    layer.initialize(ctx=ctx)
+    print('seq_length batch pass      time (ms)  steps/s')
+    for length, batch, backward in product(args.seq_lengths, args.batch_sizes, [False, True]):
+        x = mx.nd.random.uniform(shape=(length, batch, args.input_size), ctx=ctx)
+        ms = _time(layer, x, backward)
+        print('%10d %5d %-8s %11.3f %8.0f' % (length, batch, 'backward' if backward else 'forward',
+                                              ms, length * 1000 / ms))
+
+
+if __name__ == '__main__':
+    main()
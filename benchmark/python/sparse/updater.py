@@ -17,17 +17,32 @@
 
 import time
 import mxnet as mx
-from mxnet.ndarray.sparse import adam_update
+from mxnet.ndarray import sparse
 import numpy as np
 import argparse
 
 mx.random.seed(0)
 np.random.seed(0)
 
-parser = argparse.ArgumentParser(description='Benchmark adam updater')
+# update op, number of states, arguments
+updaters = {
+    'adam': (sparse.adam_update, 2,
+             {'lr': 1, 'wd': 0, 'beta1': 0.9, 'beta2': 0.99, 'rescale_grad': 0.5, 'epsilon': 1e-8}),
+    'rmsprop': (sparse.rmsprop_update, 1, {'lr': 1e-3, 'wd': 0, 'rescale_grad': 0.5}),
+    'rmspropalex': (sparse.rmspropalex_update, 3, {'lr': 1e-3, 'wd': 0, 'rescale_grad': 0.5}),
+    'ftml': (sparse.ftml_update, 3, {'lr': 1e-3, 't': 1, 'wd': 0, 'rescale_grad': 0.5}),
+    'signum': (sparse.signum_update, 1, {'lr': 1e-3, 'momentum': 0.9, 'wd': 0}),
+    'signsgd': (sparse.signsgd_update, 0, {'lr': 1e-3, 'wd': 0}),
+    'nag': (sparse.nag_mom_update, 1, {'lr': 1e-3, 'momentum': 0.9, 'wd': 0}),
+}
+
+parser = argparse.ArgumentParser(description='Benchmark sparse updaters')
+parser.add_argument('--optimizer', type=str, default='adam', choices=sorted(updaters.keys()),
+                    help='the update op to benchmark')
 parser.add_argument('--dim-in', type=int, default=240000, help='weight.shape[0]')
 parser.add_argument('--dim-out', type=int, default=512, help='weight.shape[1]')
-parser.add_argument('--nnr', type=int, default=5000, help='grad.indices.shape[0]')
+parser.add_argument('--nnr', type=int, nargs='+', default=[5000],
+                    help='grad.indices.shape[0], the cost of a lazy update is proportional to it')
 parser.add_argument('--repeat', type=int, default=1000, help='num repeat')
 parser.add_argument('--dense-grad', action='store_true',
                     help='if set to true, both gradient and weight are dense.')
@@ -39,40 +54,37 @@ parser.add_argument('--cpu', action='store_true')
 args = parser.parse_args()
 dim_in = args.dim_in
 dim_out = args.dim_out
-nnr = args.nnr
 ctx = mx.cpu() if args.cpu else mx.gpu()
+update, num_states, kwargs = updaters[args.optimizer]
 
 ones = mx.nd.ones((dim_in, dim_out), ctx=ctx)
 
-if not args.dense_grad:
-    weight = ones.tostype('row_sparse')
-    indices = np.arange(dim_in)
-    np.random.shuffle(indices)
-    indices = np.unique(indices[:nnr])
-    indices = mx.nd.array(indices, ctx=ctx)
-    grad = mx.nd.sparse.retain(weight, indices)
-else:
-    weight = ones.copy()
-    grad = ones.copy()
-
-if args.dense_state:
-    mean = ones.copy()
-else:
-    mean = ones.tostype('row_sparse')
+for nnr in args.nnr:
+    if not args.dense_grad:
+        weight = ones.tostype('row_sparse')
+        indices = np.arange(dim_in)
+        np.random.shuffle(indices)
+        indices = np.unique(indices[:nnr])
+        indices = mx.nd.array(indices, ctx=ctx)
+        grad = mx.nd.sparse.retain(weight, indices)
+    else:
+        weight = ones.copy()
+        grad = ones.copy()
 
-var = mean.copy()
+    if args.dense_state:
+        states = [ones.copy() for _ in range(num_states)]
+    else:
+        states = [ones.tostype('row_sparse') for _ in range(num_states)]
 
-# warmup 
-for i in range(10):
-    adam_update(weight, grad, mean, var, out=weight, lr=1, wd=0, beta1=0.9,
-                beta2=0.99, rescale_grad=0.5, epsilon=1e-8)
-weight.wait_to_read()
+    # warmup
+    for i in range(10):
+        update(weight, grad, *states, out=weight, **kwargs)
+    weight.wait_to_read()
 
-# measure speed
-a = time.time()
-for i in range(args.repeat):
-    adam_update(weight, grad, mean, var, out=weight, lr=1, wd=0, beta1=0.9,
-                beta2=0.99, rescale_grad=0.5, epsilon=1e-8)
-weight.wait_to_read()
-b = time.time()
-print(b - a)
+    # measure speed
+    a = time.time()
+    for i in range(args.repeat):
+        update(weight, grad, *states, out=weight, **kwargs)
+    weight.wait_to_read()
+    b = time.time()
+    print('%s nnr=%d: %.3f ms per update' % (args.optimizer, nnr, (b - a) * 1000 / args.repeat))
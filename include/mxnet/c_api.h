@@ -93,6 +93,8 @@ typedef void *CudaModuleHandle;
 typedef void *CudaKernelHandle;
 /*! \brief handle to a Profile object (domain, duration, counter, etc.) */
 typedef void *ProfileHandle;
+/*! \brief handle to a calibration collector */
+typedef void *CalibCollectorHandle;
 
 typedef void (*ExecutorMonitorCallback)(const char*,
                                         NDArrayHandle,
@@ -949,6 +951,15 @@ MXNET_DLL int MXImperativeInvokeEx(AtomicSymbolCreator creator,
                                    const char **param_keys,
                                    const char **param_vals,
                                    const int **out_stypes);
+/*!
+ * \brief set whether to defer imperative operators invoked on this thread
+ *  into a pending graph that runs at the next synchronization point.
+ *  Turning it off runs the pending operators.
+ * \param is_lazy 1 when deferring, 0 when running operators immediately.
+ * \param prev returns the previous status before this set.
+ * \return 0 when success, -1 when failure happens
+ */
+MXNET_DLL int MXImperativeSetIsLazy(int is_lazy, int* prev);
 /*!
  * \brief set whether to record operator for autograd
  * \param is_recording 1 when recording, 0 when not recording.
@@ -1535,6 +1546,63 @@ MXNET_DLL int MXSetCalibTableToQuantizedSymbol(SymbolHandle qsym_handle,
                                                const float* high_quantiles,
                                                SymbolHandle* ret_sym_handle);
 
+/*!
+ * \brief Create a collector of layer output statistics for calibration
+ * \param calib_mode "naive" to take the min and max values of the outputs as thresholds,
+ *        "entropy" to take the thresholds minimizing the KL divergence of the quantized outputs
+ * \param num_bins number of bins of the histograms in entropy mode, must be odd
+ * \param num_quantized_bins number of quantized bins in entropy mode, must be odd
+ * \param num_layers number of layer outputs to collect, 0 to collect all of them
+ * \param layer_names names of the layer outputs to collect
+ * \param out the created collector
+ */
+MXNET_DLL int MXCalibCollectorCreate(const char *calib_mode,
+                                     const mx_uint num_bins,
+                                     const mx_uint num_quantized_bins,
+                                     const mx_uint num_layers,
+                                     const char **layer_names,
+                                     CalibCollectorHandle *out);
+
+/*!
+ * \brief Install the collector as the monitor callback of an executor, so that
+ *        the outputs of every forward pass are collected without leaving the backend
+ * \param handle the collector
+ * \param exec_handle the executor
+ */
+MXNET_DLL int MXCalibCollectorSetMonitorCallback(CalibCollectorHandle handle,
+                                                 ExecutorHandle exec_handle);
+
+/*!
+ * \brief Collect a layer output
+ * \param handle the collector
+ * \param name name of the layer output
+ * \param arr the output
+ */
+MXNET_DLL int MXCalibCollectorCollect(CalibCollectorHandle handle,
+                                      const char *name,
+                                      NDArrayHandle arr);
+
+/*!
+ * \brief Compute the calibration table from the statistics collected so far
+ * \param handle the collector
+ * \param num_layers number of layer outputs in the calibration table
+ * \param layer_names names of the layer outputs
+ * \param low_quantiles low thresholds of the layer outputs
+ * \param high_quantiles high thresholds of the layer outputs
+ */
+MXNET_DLL int MXCalibCollectorGetCalibTable(CalibCollectorHandle handle,
+                                            mx_uint *num_layers,
+                                            const char ***layer_names,
+                                            const float **low_quantiles,
+                                            const float **high_quantiles);
+
+/*!
+ * \brief Free the collector. Executors it is installed on keep it alive until
+ *        their monitor callback is replaced.
+ * \param handle the collector
+ */
+MXNET_DLL int MXCalibCollectorFree(CalibCollectorHandle handle);
+
 MXNET_DLL int MXPartitionGraph(SymbolHandle sym_handle,
                                const mx_uint num_ops,
                                const char** op_names,
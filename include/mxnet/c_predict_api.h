@@ -49,6 +49,10 @@ typedef float mx_float;
 typedef void *PredictorHandle;
 /*! \brief handle to NDArray list */
 typedef void *NDListHandle;
+/*! \brief handle to a dynamic batching predictor */
+typedef void *PredBatcherHandle;
+/*! \brief handle to a request submitted to a batcher */
+typedef void *PredRequestHandle;
 
 /*!
  * \brief Get the last error happeneed.
@@ -119,6 +123,42 @@ MXNET_DLL int MXPredCreatePartialOut(const char* symbol_json_str,
                                      mx_uint num_output_nodes,
                                      const char** output_keys,
                                      PredictorHandle* out);
+
+/*!
+ * \brief create several static-shape predictors which share one copy of parameters.
+ *  Each predictor runs the graph with a statically planned CachedOp and only owns
+ *  its activation memory, so different predictors can be used from different threads.
+ *  Calling MXPredReshape on such a predictor binds the new input shapes once. Once a
+ *  reshaped predictor is freed, its binding is cached, so that switching back to a
+ *  previously used shape does not rebind.
+ * \param symbol_json_str The JSON string of the symbol.
+ * \param param_bytes The in-memory raw bytes of parameter ndarray file.
+ * \param param_size The size of parameter ndarray file.
+ * \param dev_type The device type, 1: cpu, 2:gpu
+ * \param dev_id The device id of the predictor.
+ * \param num_input_nodes Number of input nodes to the net,
+ *    For feedforward net, this is 1.
+ * \param input_keys The name of input argument.
+ *    For feedforward net, this is {"data"}
+ * \param input_shape_indptr Index pointer of shapes of each input node.
+ *    The length of this array = num_input_nodes + 1.
+ *    For feedforward net that takes 4 dimensional input, this is {0, 4}.
+ * \param input_shape_data A flatted data of shapes of each input node.
+ *    For feedforward net that takes 4 dimensional input, this is the shape data.
+ * \param num_instances Number of predictors to create.
+ * \param out User allocated array of num_instances predictor handles.
+ * \return 0 when success, -1 when failure.
+ */
+MXNET_DLL int MXPredCreateMultiInstance(const char* symbol_json_str,
+                                        const void* param_bytes,
+                                        int param_size,
+                                        int dev_type, int dev_id,
+                                        mx_uint num_input_nodes,
+                                        const char** input_keys,
+                                        const mx_uint* input_shape_indptr,
+                                        const mx_uint* input_shape_data,
+                                        mx_uint num_instances,
+                                        PredictorHandle* out);
 /*!
  * \brief Change the input shape of an existing predictor.
  * \param num_input_nodes Number of input nodes to the net,
@@ -207,6 +247,124 @@ MXNET_DLL int MXPredGetOutput(PredictorHandle handle,
  * \return 0 when success, -1 when failure.
  */
 MXNET_DLL int MXPredFree(PredictorHandle handle);
+/*!
+ * \brief create a dynamic batching predictor.
+ *  Single-sample requests submitted to the batcher are coalesced into batches of
+ *  at most max_batch_size requests, waiting at most max_wait_us after the oldest request
+ *  arrives. Each batch runs on one of num_workers static-shape predictors which share
+ *  parameters and are pre-bound to the batch sizes they can run, so no rebinding happens
+ *  while serving. Every output of the network must have the batch size as first dimension.
+ * \param symbol_json_str The JSON string of the symbol.
+ * \param param_bytes The in-memory raw bytes of parameter ndarray file.
+ * \param param_size The size of parameter ndarray file.
+ * \param dev_type The device type, 1: cpu, 2:gpu
+ * \param dev_id The device id of the predictor.
+ * \param num_input_nodes Number of input nodes to the net,
+ *    For feedforward net, this is 1.
+ * \param input_keys The name of input argument.
+ *    For feedforward net, this is {"data"}
+ * \param input_shape_indptr Index pointer of shapes of each input node.
+ *    The length of this array = num_input_nodes + 1.
+ * \param input_shape_data A flatted data of the shapes of a single sample of each input
+ *    node, without the batch dimension. For images, this is {channel, height, width}.
+ * \param max_batch_size The maximum number of requests in a batch.
+ * \param max_wait_us The maximum time in microseconds to wait for a batch to fill up.
+ * \param num_workers The number of worker threads running batches.
+ * \param out The created batcher handle.
+ * \return 0 when success, -1 when failure.
+ */
+MXNET_DLL int MXPredBatcherCreate(const char* symbol_json_str,
+                                  const void* param_bytes,
+                                  int param_size,
+                                  int dev_type, int dev_id,
+                                  mx_uint num_input_nodes,
+                                  const char** input_keys,
+                                  const mx_uint* input_shape_indptr,
+                                  const mx_uint* input_shape_data,
+                                  mx_uint max_batch_size,
+                                  mx_uint max_wait_us,
+                                  mx_uint num_workers,
+                                  PredBatcherHandle* out);
+/*!
+ * \brief Submit a single-sample request to a batcher. This function is thread-safe.
+ * \param handle The batcher handle.
+ * \param input_data The data of each input node, ordered as input_keys in
+ *    MXPredBatcherCreate, each with the size of a single sample.
+ * \param out The request handle, which must be freed by MXPredRequestFree.
+ * \return 0 when success, -1 when failure.
+ */
+MXNET_DLL int MXPredBatcherSubmit(PredBatcherHandle handle,
+                                  const mx_float** input_data,
+                                  PredRequestHandle* out);
+/*!
+ * \brief Get the histogram of the sizes of the batches run by a batcher.
+ *  The returned counts is only valid before next call to this function.
+ * \param handle The batcher handle.
+ * \param num_bins Used to hold the number of bins, which is max_batch_size.
+ * \param counts Used to hold the number of batches of size i + 1 in the i-th bin.
+ * \return 0 when success, -1 when failure.
+ */
+MXNET_DLL int MXPredBatcherGetBatchSizeHistogram(PredBatcherHandle handle,
+                                                 mx_uint* num_bins,
+                                                 const mx_uint** counts);
+/*!
+ * \brief Get the histogram of request latencies, from submission to completion.
+ *  The returned counts is only valid before next call to this function.
+ * \param handle The batcher handle.
+ * \param num_bins Used to hold the number of bins.
+ * \param upper_bounds_us Used to hold the upper bound of each bin in microseconds.
+ *    The last bin also holds the requests beyond its upper bound.
+ * \param counts Used to hold the number of requests in each bin.
+ * \return 0 when success, -1 when failure.
+ */
+MXNET_DLL int MXPredBatcherGetLatencyHistogram(PredBatcherHandle handle,
+                                               mx_uint* num_bins,
+                                               const mx_uint** upper_bounds_us,
+                                               const mx_uint** counts);
+/*!
+ * \brief Free a batcher handle. Requests which are already submitted are completed first.
+ * \param handle The batcher handle.
+ * \return 0 when success, -1 when failure.
+ */
+MXNET_DLL int MXPredBatcherFree(PredBatcherHandle handle);
+/*!
+ * \brief Block until the outputs of a request are ready.
+ * \param handle The request handle.
+ * \return 0 when success, -1 when the batch of the request failed.
+ */
+MXNET_DLL int MXPredRequestWait(PredRequestHandle handle);
+/*!
+ * \brief Get the shape of an output of a request, the first dimension is 1.
+ *  Blocks until the outputs of the request are ready.
+ *  The returned shape_data and shape_ndim is only valid before next call to this function.
+ * \param handle The request handle.
+ * \param index The index of output node, set to 0 if there is only one output.
+ * \param shape_data Used to hold pointer to the shape data
+ * \param shape_ndim Used to hold shape dimension.
+ * \return 0 when success, -1 when failure.
+ */
+MXNET_DLL int MXPredRequestGetOutputShape(PredRequestHandle handle,
+                                          mx_uint index,
+                                          mx_uint** shape_data,
+                                          mx_uint* shape_ndim);
+/*!
+ * \brief Get an output of a request. Blocks until the outputs of the request are ready.
+ * \param handle The request handle.
+ * \param index The index of output node, set to 0 if there is only one output.
+ * \param data User allocated data to hold the output.
+ * \param size The size of data array, used for safe checking.
+ * \return 0 when success, -1 when failure.
+ */
+MXNET_DLL int MXPredRequestGetOutput(PredRequestHandle handle,
+                                     mx_uint index,
+                                     mx_float* data,
+                                     mx_uint size);
+/*!
+ * \brief Free a request handle.
+ * \param handle The request handle.
+ * \return 0 when success, -1 when failure.
+ */
+MXNET_DLL int MXPredRequestFree(PredRequestHandle handle);
 /*!
  * \brief Create a NDArray List by loading from ndarray file.
  *     This can be used to load mean image file.
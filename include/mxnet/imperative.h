@@ -97,6 +97,27 @@ class Imperative {
       is_recording_ = is_recording;
       return old;
   }
+  /*! \brief whether operators invoked on this thread are deferred into a pending graph. */
+  bool is_lazy() const {
+    return is_lazy_;
+  }
+  /*!
+   * \brief turn on or turn off lazy execution on this thread.
+   *  Turning it off runs the operators that are still pending.
+   */
+  bool set_is_lazy(bool is_lazy) {
+    bool old = is_lazy_;
+    if (old && !is_lazy) FlushLazy();
+    is_lazy_ = is_lazy;
+    return old;
+  }
+  /*!
+   * \brief run the operators deferred by lazy execution on this thread.
+   *  Must be called before NDArrays are accessed other than through Invoke.
+   */
+  void FlushLazy() {
+    if (is_lazy_) RunLazy();
+  }
   /*! \brief to record operator, return corresponding node. */
   void RecordOp(nnvm::NodeAttrs&& attrs,
                 const std::vector<NDArray*>& inputs,
@@ -109,14 +130,19 @@ class Imperative {
                     const nnvm::NodeAttrs& attrs,
                     const std::vector<NDArray*>& inputs,
                     const std::vector<NDArray*>& outputs);
-  /*! \brief */
+  /*!
+   * \brief invoke an operator whose attributes are inferred.
+   *  The resources requested by the operator are queried from the operator
+   *  when resource_reqs is nullptr.
+   */
   OpStatePtr InvokeOp(const Context& ctx,
                       const nnvm::NodeAttrs& attrs,
                       const std::vector<NDArray*>& inputs,
                       const std::vector<NDArray*>& outputs,
                       const std::vector<OpReqType>& req,
                       const DispatchMode dispatch_mode,
-                      OpStatePtr state = OpStatePtr());
+                      OpStatePtr state = OpStatePtr(),
+                      const std::vector<ResourceRequest>* resource_reqs = nullptr);
   /*! \brief mark variables for computing gradients. */
   void MarkVariables(const std::vector<NDArray*>& variables,
                      const std::vector<mx_uint>& grad_reqs,
@@ -144,13 +170,26 @@ class Imperative {
       uint32_t num_inputs, uint32_t num_outputs,
       std::vector<bool> *p_save_inputs,
       std::vector<bool> *p_save_outputs);
+  /*!
+   * \brief defer an operator whose attributes are inferred into the pending graph.
+   *  Returns false, after running the pending graph, if the operator can not be deferred.
+   */
+  bool RecordLazy(const Context& ctx,
+                  const nnvm::NodeAttrs& attrs,
+                  const std::vector<NDArray*>& inputs,
+                  const std::vector<NDArray*>& outputs,
+                  const DispatchMode dispatch_mode);
+  /*! \brief run the pending graph of this thread as a single CachedOp. */
+  void RunLazy();
   /*! \brief indicate whether is training. */
 #if DMLC_CXX11_THREAD_LOCAL
   static thread_local bool is_train_;
   static thread_local bool is_recording_;
+  static thread_local bool is_lazy_;
 #else
   static MX_THREAD_LOCAL bool is_train_;
   static MX_THREAD_LOCAL bool is_recording_;
+  static MX_THREAD_LOCAL bool is_lazy_;
 #endif
   /*! \brief node count used for naming */
   std::atomic<uint64_t> node_count_{0};
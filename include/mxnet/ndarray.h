@@ -36,6 +36,7 @@
 #include <string>
 #include <algorithm>
 #include <memory>
+#include <mutex>
 #include <algorithm>
 #if MXNET_USE_MKLDNN == 1
 #include <mkldnn.hpp>
@@ -667,6 +668,15 @@ class NDArray {
    */
   const mkldnn::memory *GetMKLDNNDataReorder(
       const mkldnn::memory::primitive_desc &desc) const;
+  /*
+   * This function returns an immutable copy of the data with the given
+   * primitive_desc. The copy is made by the first call and is kept with the
+   * array until the array is written, so the layout of the array itself
+   * doesn't change. default_desc describes the array in a default format.
+   */
+  const mkldnn::memory *GetMKLDNNDataCopy(
+      const mkldnn::memory::primitive_desc &default_desc,
+      const mkldnn::memory::primitive_desc &desc) const;
 
   /*
    * This function copies data from mkldnn memory.
@@ -754,6 +764,12 @@ class NDArray {
     /*! This is created when data is stored in MKLDNN format.
      */
     std::shared_ptr<MKLDNNMemory> mkl_mem_;
+    /*! Copies of the data made by GetMKLDNNDataCopy, with the version of
+     *  the data they were made from.
+     */
+    std::vector<std::pair<size_t, std::shared_ptr<mkldnn::memory>>> mkl_copies_;
+    /*! Guards mkl_copies_, which are shared by the readers of the array in all threads */
+    std::mutex mkl_copies_mutex_;
 #endif
 #if MXNET_USE_NGRAPH == 1
     /*! this is set if ngraph tensorview is associated with this ndarray
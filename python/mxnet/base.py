@@ -232,6 +232,7 @@ RtcHandle = ctypes.c_void_p
 CudaModuleHandle = ctypes.c_void_p
 CudaKernelHandle = ctypes.c_void_p
 ProfileHandle = ctypes.c_void_p
+CalibCollectorHandle = ctypes.c_void_p
 
 
 #----------------------------
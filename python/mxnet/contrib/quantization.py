@@ -29,7 +29,7 @@ import os
 import numpy as np
 from ..base import _LIB, check_call, py_str
 from ..base import c_array, c_str, mx_uint, c_str_array
-from ..base import NDArrayHandle, SymbolHandle
+from ..base import NDArrayHandle, SymbolHandle, CalibCollectorHandle
 from ..symbol import Symbol
 from ..symbol import load as sym_load
 from .. import ndarray
@@ -170,6 +170,59 @@ class _LayerOutputMinMaxCollector(object):
                              % (name, min_range, max_range))
 
 
+class _LayerOutputNativeCollector(object):
+    """Collects the statistics of layer outputs in the backend. Installed on an executor,
+    it receives the outputs without going through Python and updates the statistics of
+    each layer asynchronously, in parallel with the forward passes. With calib_mode='naive'
+    the thresholds are the min and max values of the outputs. With calib_mode='entropy'
+    the outputs are accumulated in histograms and the thresholds are the ones minimizing
+    the KL divergence, as computed by `_get_optimal_threshold`.
+    """
+    def __init__(self, calib_mode, layer_names=None, num_bins=8001, num_quantized_bins=255,
+                 logger=None):
+        layer_names = [] if layer_names is None else list(layer_names)
+        self.logger = logger
+        self.handle = CalibCollectorHandle()
+        check_call(_LIB.MXCalibCollectorCreate(c_str(calib_mode),
+                                               mx_uint(num_bins),
+                                               mx_uint(num_quantized_bins),
+                                               mx_uint(len(layer_names)),
+                                               c_str_array(layer_names),
+                                               ctypes.byref(self.handle)))
+
+    def __del__(self):
+        check_call(_LIB.MXCalibCollectorFree(self.handle))
+
+    def set_monitor(self, executor):
+        """Collects all the outputs of the executor's forward passes from now on."""
+        check_call(_LIB.MXCalibCollectorSetMonitorCallback(self.handle, executor.handle))
+
+    def collect(self, name, arr):
+        """Collects one layer output NDArray."""
+        check_call(_LIB.MXCalibCollectorCollect(self.handle, c_str(name), arr.handle))
+
+    def get_calib_table(self):
+        """Waits for the pending updates and returns a dict mapping the names of the
+        collected layer outputs to their (min, max) thresholds."""
+        num_layers = mx_uint()
+        names = ctypes.POINTER(ctypes.c_char_p)()
+        low = ctypes.POINTER(ctypes.c_float)()
+        high = ctypes.POINTER(ctypes.c_float)()
+        check_call(_LIB.MXCalibCollectorGetCalibTable(self.handle,
+                                                      ctypes.byref(num_layers),
+                                                      ctypes.byref(names),
+                                                      ctypes.byref(low),
+                                                      ctypes.byref(high)))
+        th_dict = {}
+        for i in range(num_layers.value):
+            name = py_str(names[i])
+            th_dict[name] = (low[i], high[i])
+            if self.logger is not None:
+                self.logger.info('layer=%s, min_threshold=%f, max_threshold=%f'
+                                 % (name, low[i], high[i]))
+        return th_dict
+
+
 def _calibrate_quantized_sym(qsym, th_dict):
     """Given a dictionary containing the thresholds for quantizing the layers,
     set the thresholds into the quantized symbol as the params of requantize operators.
@@ -199,7 +252,10 @@ def _collect_layer_statistics(mod, data, collector, max_num_examples=None, logge
     if not isinstance(data, DataIter):
         raise ValueError('Only supports data as a type of DataIter, while received type %s'
                          % str(type(data)))
-    mod._exec_group.execs[0].set_monitor_callback(collector.collect)
+    if isinstance(collector, _LayerOutputNativeCollector):
+        collector.set_monitor(mod._exec_group.execs[0])
+    else:
+        mod._exec_group.execs[0].set_monitor_callback(collector.collect)
     num_batches = 0
     num_examples = 0
     for batch in data:
@@ -231,6 +287,21 @@ def _collect_layer_outputs(mod, data, include_layer=None, max_num_examples=None,
     return collector.nd_dict, num_examples
 
 
+def _collect_calib_table(mod, data, calib_mode, include_layer=None,
+                         max_num_examples=None, logger=None):
+    """Collect the statistics of the layer outputs in the backend and compute the
+    thresholds for quantizing them, saved in a dictionary mapped by layer names.
+    """
+    layer_names = mod.symbol.get_internals().list_outputs()
+    if include_layer is not None:
+        layer_names = [name for name in layer_names if include_layer(name)]
+    if len(layer_names) == 0:
+        return {}, 0
+    collector = _LayerOutputNativeCollector(calib_mode, layer_names=layer_names, logger=logger)
+    num_examples = _collect_layer_statistics(mod, data, collector, max_num_examples, logger)
+    return collector.get_calib_table(), num_examples
+
+
 def _smooth_distribution(p, eps=0.0001):
     """Given a discrete distribution (may have not been normalized to 1),
     smooth it by replacing zeros with eps multiplied by a scaling factor and taking the
@@ -517,20 +588,13 @@ def quantize_model(sym, arg_params, aux_params,
         else:
             mod.bind(for_training=False, data_shapes=calib_data.provide_data)
         mod.set_params(arg_params, aux_params)
-        if calib_mode == 'entropy':
-            nd_dict, num_examples = _collect_layer_outputs(mod, calib_data,
-                                                           include_layer=calib_layer,
-                                                           max_num_examples=num_calib_examples,
-                                                           logger=logger)
-            logger.info('Collected layer outputs from FP32 model using %d examples' % num_examples)
-            logger.info('Calculating optimal thresholds for quantization')
-            th_dict = _get_optimal_thresholds(nd_dict, logger=logger)
-        elif calib_mode == 'naive':
-            th_dict, num_examples = _collect_layer_output_min_max(
-                mod, calib_data, include_layer=calib_layer, max_num_examples=num_calib_examples,
-                logger=logger)
-            logger.info('Collected layer output min/max values from FP32 model using %d examples'
-                        % num_examples)
+        if calib_mode in ('naive', 'entropy'):
+            th_dict, num_examples = _collect_calib_table(mod, calib_data, calib_mode,
+                                                         include_layer=calib_layer,
+                                                         max_num_examples=num_calib_examples,
+                                                         logger=logger)
+            logger.info('Calculated %s thresholds from FP32 model using %d examples'
+                        % (calib_mode, num_examples))
         else:
             raise ValueError('unknown calibration mode %s received,'
                              ' expected `none`, `naive`, or `entropy`' % calib_mode)
@@ -73,3 +73,55 @@ def bulk(size):
                 x += 1
     """
     return _BulkScope(size)
+
+
+def set_lazy(is_lazy):
+    """Set whether imperative operators on the calling thread run lazily.
+
+    In lazy mode operators are recorded into a pending graph instead of
+    being executed one by one. The pending graph is optimized and executed
+    as a whole when a result is needed, e.g. by `asnumpy`, `wait_to_read`,
+    or when the graph grows beyond `MXNET_IMPERATIVE_LAZY_MAX_NODES`.
+    Intermediate results that are no longer referenced are never computed.
+
+    Parameters
+    ----------
+    is_lazy : bool
+        Whether to defer operators. Turning it off runs pending operators.
+
+    Returns
+    -------
+    bool
+        Previous state.
+    """
+    prev = ctypes.c_int()
+    check_call(_LIB.MXImperativeSetIsLazy(
+        ctypes.c_int(is_lazy), ctypes.byref(prev)))
+    return bool(prev.value)
+
+
+class _LazyScope(object):
+    """Scope object for lazy execution."""
+    def __init__(self, is_lazy):
+        self._is_lazy = is_lazy
+        self._prev_is_lazy = None
+
+    def __enter__(self):
+        self._prev_is_lazy = set_lazy(self._is_lazy)
+        return self
+
+    def __exit__(self, ptype, value, trace):
+        set_lazy(self._prev_is_lazy)
+
+
+def lazy(is_lazy=True):
+    """Returns a scope in which imperative operators run lazily.
+    Chains of small operators are then executed as one graph::
+
+        with mx.engine.lazy():
+            y = x
+            for i in range(100):
+                y = y * 2 + 1
+        print(y.asnumpy())
+    """
+    return _LazyScope(is_lazy)
@@ -243,6 +243,9 @@ class Dropout(HybridBlock):
         Fraction of the input units to drop. Must be a number between 0 and 1.
     axes : tuple of int, default ()
         The axes on which dropout mask is shared. If empty, regular dropout is applied.
+    packed_mask : bool, default False
+        Whether to keep the mask for backward as one bit per element, which saves memory
+        during training. Cannot be used together with `axes`.
 
 
     Inputs:
@@ -256,12 +259,15 @@ class Dropout(HybridBlock):
         `Dropout: A Simple Way to Prevent Neural Networks from Overfitting
         <http://www.cs.toronto.edu/~rsalakhu/papers/srivastava14a.pdf>`_
     """
-    def __init__(self, rate, axes=(), **kwargs):
+    def __init__(self, rate, axes=(), packed_mask=False, **kwargs):
         super(Dropout, self).__init__(**kwargs)
         self._rate = rate
         self._axes = axes
+        self._packed_mask = packed_mask
 
     def hybrid_forward(self, F, x):
+        if self._packed_mask:
+            return F.Dropout(x, p=self._rate, axes=self._axes, packed_mask=True, name='fwd')
         return F.Dropout(x, p=self._rate, axes=self._axes, name='fwd')
 
     def __repr__(self):
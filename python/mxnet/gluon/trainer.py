@@ -345,6 +345,9 @@ class Trainer(object):
         self._update(ignore_stale_grad)
 
     def _update(self, ignore_stale_grad=False):
+        # the parameters of each device are passed to its updater all at once, so
+        # that the optimizer can update several of them in a single operator
+        updates = [[] for _ in self._updaters]
         for i, param in enumerate(self._params):
             if param.grad_req == 'null':
                 continue
@@ -368,11 +371,16 @@ class Trainer(object):
                     self._kvstore.pull(i, param.list_data(), priority=-i)
                 continue
 
-            for upd, arr, grad in zip(self._updaters, param.list_data(), param.list_grad()):
+            for upd, arr, grad in zip(updates, param.list_data(), param.list_grad()):
                 if not ignore_stale_grad or arr._fresh_grad:
-                    upd(i, grad, arr)
+                    upd.append((i, grad, arr))
                     arr._fresh_grad = False
 
+        for updater, upd in zip(self._updaters, updates):
+            if upd:
+                indices, grads, arrs = zip(*upd)
+                updater(list(indices), list(grads), list(arrs))
+
     def save_states(self, fname):
         """Saves trainer states (e.g. optimizer, momentum) to a file.
 
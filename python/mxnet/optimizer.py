@@ -20,6 +20,7 @@
 """Weight updating functions."""
 import logging
 import math
+import os
 import pickle
 import warnings
 import numpy
@@ -27,7 +28,8 @@ from .base import py_str
 from .ndarray import (NDArray, zeros, clip, sqrt, cast, maximum, abs as NDabs, array, multiply)
 from .ndarray import (sgd_update, sgd_mom_update, adam_update, rmsprop_update, rmspropalex_update,
                       mp_sgd_update, mp_sgd_mom_update, square, ftrl_update, ftml_update,
-                      signsgd_update, signum_update)
+                      signsgd_update, signum_update, nag_mom_update, multi_sgd_update,
+                      multi_sgd_mom_update, multi_adam_update)
 from .ndarray import sparse
 from .random import normal
 
@@ -75,6 +77,11 @@ class Optimizer(object):
     learning_rate : float
         The current learning rate of the optimizer. Given an Optimizer object
         optimizer, its learning rate can be accessed as optimizer.learning_rate.
+
+    aggregate_num : int
+        The maximum number of parameters that the updater passes to a single
+        update when the optimizer can update several parameters at once. 0 means
+        that the parameters are always updated one at a time.
     """
     def __init__(self, rescale_grad=1., param_idx2name=None, wd=0.,
                  clip_gradient=None, learning_rate=0.01,
@@ -94,6 +101,7 @@ class Optimizer(object):
         self._index_update_count = {}
         self.clip_gradient = clip_gradient
         self.multi_precision = multi_precision
+        self.aggregate_num = 0
 
         if param_idx2name is None:
             param_idx2name = {}
@@ -273,6 +281,23 @@ class Optimizer(object):
         else:
             self.update(index, weight, grad, state)
 
+    def _update_aggregated(self, indices, weights, grads, states):
+        """Updates several parameters, with the same dtype, at once.
+
+        Optimizers with an operator updating several parameters in a single call
+        override it; by default the parameters are updated one after the other.
+        """
+        for index, weight, grad, state in zip(indices, weights, grads, states):
+            self.update_multi_precision(index, weight, grad, state)
+
+    @staticmethod
+    def _can_aggregate(weights, grads):
+        """Whether the multi-tensor update operators, which are only implemented
+        for dense arrays on CPU, can update these parameters."""
+        return all(w.stype == 'default' and g.stype == 'default' and
+                   w.context.device_type == 'cpu' and g.context.device_type == 'cpu'
+                   for w, g in zip(weights, grads))
+
     def set_learning_rate(self, lr):
         """Sets a new learning rate of the optimizer.
 
@@ -490,6 +515,7 @@ class SGD(Optimizer):
         super(SGD, self).__init__(**kwargs)
         self.momentum = momentum
         self.lazy_update = lazy_update
+        self.aggregate_num = int(os.getenv('MXNET_OPTIMIZER_AGGREGATION_SIZE', "4"))
 
     def create_state_multi_precision(self, index, weight):
         weight_master_copy = None
@@ -546,6 +572,26 @@ class SGD(Optimizer):
         self._update_impl(index, weight, grad, state,
                           multi_precision=use_multi_precision)
 
+    def _update_aggregated(self, indices, weights, grads, states):
+        if (self.multi_precision and weights[0].dtype == numpy.float16) or \
+                not self._can_aggregate(weights, grads):
+            super(SGD, self)._update_aggregated(indices, weights, grads, states)
+            return
+        for index in indices:
+            self._update_count(index)
+        kwargs = {'rescale_grad': self.rescale_grad,
+                  'lrs': [self._get_lr(index) for index in indices],
+                  'wds': [self._get_wd(index) for index in indices],
+                  'num_weights': len(weights)}
+        if self.clip_gradient:
+            kwargs['clip_gradient'] = self.clip_gradient
+        if self.momentum > 0:
+            data = [x for w, g, s in zip(weights, grads, states) for x in (w, g, s)]
+            multi_sgd_mom_update(*data, out=list(weights), momentum=self.momentum, **kwargs)
+        else:
+            data = [x for w, g in zip(weights, grads) for x in (w, g)]
+            multi_sgd_update(*data, out=list(weights), **kwargs)
+
 @register
 class Signum(Optimizer):
     r"""The Signum optimizer that takes the sign of gradient or momentum.
@@ -565,6 +611,9 @@ class Signum(Optimizer):
     For details of the update algorithm see
     :class:`~mxnet.ndarray.signsgd_update` and :class:`~mxnet.ndarray.signum_update`.
 
+    If the storage type of grad is ``row_sparse`` and ``lazy_update`` is True, \
+    only the rows of weight and state whose indices appear in grad.indices are updated.
+
     This optimizer accepts the following parameters in addition to those accepted
     by :class:`.Optimizer`.
 
@@ -575,16 +624,21 @@ class Signum(Optimizer):
     wd_lh : float, optional
        The amount of decoupled weight decay regularization, see details in the original paper at:\
        https://arxiv.org/abs/1711.05101
+    lazy_update : bool, optional
+       Default is True. If True, lazy updates are applied \
+       if the storage types of weight and grad are both ``row_sparse``.
     """
-    def __init__(self, learning_rate=0.01, momentum=0.9, wd_lh=0.0, **kwargs):
+    def __init__(self, learning_rate=0.01, momentum=0.9, wd_lh=0.0, lazy_update=True, **kwargs):
         super(Signum, self).__init__(learning_rate=learning_rate, **kwargs)
         self.momentum = momentum
         self.wd_lh = wd_lh
+        self.lazy_update = lazy_update
 
     def create_state(self, index, weight):
         momentum = None
         if self.momentum != 0.0:
-            momentum = zeros(weight.shape, weight.context, dtype=weight.dtype, stype=weight.stype)
+            stype = weight.stype if self.lazy_update else 'default'
+            momentum = zeros(weight.shape, weight.context, dtype=weight.dtype, stype=stype)
         return momentum
 
     def _update_impl(self, index, weight, grad, state):
@@ -594,7 +648,7 @@ class Signum(Optimizer):
         lr = self._get_lr(index)
         wd = self._get_wd(index)
 
-        kwargs = {'rescale_grad': self.rescale_grad}
+        kwargs = {'rescale_grad': self.rescale_grad, 'lazy_update': self.lazy_update}
         if self.momentum > 0:
             kwargs['momentum'] = self.momentum
         if self.clip_gradient:
@@ -628,6 +682,9 @@ class FTML(Optimizer):
         z = beta1 * z + (1 - beta1) * rescaled_grad - (d_t - beta1 * d_(t-1)) * weight
         weight = - z / d_t
 
+    If the storage type of grad is ``row_sparse`` and ``lazy_update`` is True, \
+    only the rows of weight, d, v and z whose indices appear in grad.indices are updated.
+
     This optimizer accepts the following parameters in addition to those accepted
     by :class:`.Optimizer`.
 
@@ -639,17 +696,22 @@ class FTML(Optimizer):
         0 < beta2 < 1. Generally close to 1.
     epsilon : float, optional
         Small value to avoid division by 0.
+    lazy_update : bool, optional
+       Default is True. If True, lazy updates are applied \
+       if the storage types of weight and grad are both ``row_sparse``.
     """
-    def __init__(self, beta1=0.6, beta2=0.999, epsilon=1e-8, **kwargs):
+    def __init__(self, beta1=0.6, beta2=0.999, epsilon=1e-8, lazy_update=True, **kwargs):
         super(FTML, self).__init__(**kwargs)
         self.beta1 = beta1
         self.beta2 = beta2
         self.epsilon = epsilon
+        self.lazy_update = lazy_update
 
     def create_state(self, index, weight):
-        return (zeros(weight.shape, weight.context, dtype=weight.dtype), # d_0
-                zeros(weight.shape, weight.context, dtype=weight.dtype), # v_0
-                zeros(weight.shape, weight.context, dtype=weight.dtype)) # z_0
+        stype = weight.stype if self.lazy_update else 'default'
+        return (zeros(weight.shape, weight.context, dtype=weight.dtype, stype=stype), # d_0
+                zeros(weight.shape, weight.context, dtype=weight.dtype, stype=stype), # v_0
+                zeros(weight.shape, weight.context, dtype=weight.dtype, stype=stype)) # z_0
 
     def update(self, index, weight, grad, state):
         assert(isinstance(weight, NDArray))
@@ -660,7 +722,7 @@ class FTML(Optimizer):
         t = self._index_update_count[index]
 
         kwargs = {'beta1': self.beta1, 'beta2': self.beta2, 'epsilon': self.epsilon,
-                  'rescale_grad': self.rescale_grad, 't': t}
+                  'rescale_grad': self.rescale_grad, 't': t, 'lazy_update': self.lazy_update}
         if self.clip_gradient:
             kwargs['clip_grad'] = self.clip_gradient
 
@@ -923,10 +985,18 @@ class NAG(Optimizer):
         state = momentum * state + grad + wd * weight
         weight = weight - (lr * (grad + momentum * state))
 
+    If the storage type of grad is ``row_sparse`` and ``lazy_update`` is True, \
+    only the rows of weight and state whose indices appear in grad.indices are updated.
+
+    For details of the update algorithm see :class:`~mxnet.ndarray.nag_mom_update`.
+
     Parameters
     ----------
     momentum : float, optional
        The momentum value.
+    lazy_update : bool, optional
+       Default is True. If True, lazy updates are applied \
+       if the storage types of weight and grad are both ``row_sparse``.
     multi_precision: bool, optional
        Flag to control the internal precision of the optimizer.
        ``False`` results in using the same precision as the weights (default),
@@ -934,14 +1004,16 @@ class NAG(Optimizer):
                 in 32-bit precision even if actual weights used in the model have lower precision.\
                 Turning this on can improve convergence and accuracy when training with float16.
     """
-    def __init__(self, momentum=0.0, **kwargs):
+    def __init__(self, momentum=0.0, lazy_update=True, **kwargs):
         super(NAG, self).__init__(**kwargs)
         self.momentum = momentum
+        self.lazy_update = lazy_update
 
     def create_state(self, index, weight):
         momentum = None
         if self.momentum != 0.0:
-            momentum = zeros(weight.shape, weight.context, dtype=weight.dtype)
+            stype = weight.stype if self.lazy_update else 'default'
+            momentum = zeros(weight.shape, weight.context, dtype=weight.dtype, stype=stype)
         return momentum
 
     def update(self, index, weight, grad, state):
@@ -951,20 +1023,16 @@ class NAG(Optimizer):
         lr = self._get_lr(index)
         wd = self._get_wd(index)
 
-        grad = grad * self.rescale_grad
+        kwargs = {'rescale_grad': self.rescale_grad, 'lazy_update': self.lazy_update}
         if self.clip_gradient is not None:
-            grad = clip(grad, -self.clip_gradient, self.clip_gradient)
+            kwargs['clip_gradient'] = self.clip_gradient
 
         if state is not None:
-            mom = state
-            mom[:] *= self.momentum
-            grad += wd * weight
-            mom[:] += grad
-            grad[:] += self.momentum * mom
-            weight[:] += -lr * grad
+            nag_mom_update(weight, grad, state, out=weight, momentum=self.momentum,
+                           lr=lr, wd=wd, **kwargs)
         else:
             assert self.momentum == 0.0
-            weight[:] += -lr * (grad + wd * weight)
+            sgd_update(weight, grad, out=weight, lr=lr, wd=wd, **kwargs)
 
 @register
 class SGLD(Optimizer):
@@ -1055,6 +1123,7 @@ class Adam(Optimizer):
         self.beta2 = beta2
         self.epsilon = epsilon
         self.lazy_update = lazy_update
+        self.aggregate_num = int(os.getenv('MXNET_OPTIMIZER_AGGREGATION_SIZE', "4"))
 
     def create_state(self, index, weight):
         stype = weight.stype if self.lazy_update else 'default'
@@ -1084,6 +1153,30 @@ class Adam(Optimizer):
         adam_update(weight, grad, mean, var, out=weight,
                     lazy_update=self.lazy_update, lr=lr, wd=wd, **kwargs)
 
+    def _update_aggregated(self, indices, weights, grads, states):
+        if (self.multi_precision and weights[0].dtype == numpy.float16) or \
+                not self._can_aggregate(weights, grads):
+            super(Adam, self)._update_aggregated(indices, weights, grads, states)
+            return
+        lrs = []
+        for index in indices:
+            self._update_count(index)
+            t = self._index_update_count[index]
+            coef1 = 1. - self.beta1**t
+            coef2 = 1. - self.beta2**t
+            lrs.append(self._get_lr(index) * math.sqrt(coef2) / coef1)
+
+        kwargs = {'beta1': self.beta1, 'beta2': self.beta2, 'epsilon': self.epsilon,
+                  'rescale_grad': self.rescale_grad, 'lrs': lrs,
+                  'wds': [self._get_wd(index) for index in indices],
+                  'num_weights': len(weights)}
+        if self.clip_gradient:
+            kwargs['clip_gradient'] = self.clip_gradient
+
+        data = [x for w, g, (mean, var) in zip(weights, grads, states)
+                for x in (w, g, mean, var)]
+        multi_adam_update(*data, out=list(weights), **kwargs)
+
 @register
 class AdaGrad(Optimizer):
     """AdaGrad optimizer.
@@ -1158,6 +1251,9 @@ class RMSProp(Optimizer):
     by Alex Graves, 2013.
     For details of the update algorithm see :class:`~mxnet.ndarray.rmspropalex_update`.
 
+    If the storage type of grad is ``row_sparse`` and ``lazy_update`` is True, \
+    only the rows of weight and states whose indices appear in grad.indices are updated.
+
     This optimizer accepts the following parameters in addition to those accepted
     by :class:`.Optimizer`.
 
@@ -1175,24 +1271,29 @@ class RMSProp(Optimizer):
         ``False`` will use Tieleman & Hinton's version of `RMSProp`.
     clip_weights : float, optional
         Clips weights into range ``[-clip_weights, clip_weights]``.
+    lazy_update : bool, optional
+       Default is True. If True, lazy updates are applied \
+       if the storage types of weight and grad are both ``row_sparse``.
     """
     def __init__(self, learning_rate=0.001, gamma1=0.9, gamma2=0.9,
-                 epsilon=1e-8, centered=False, clip_weights=None, **kwargs):
+                 epsilon=1e-8, centered=False, clip_weights=None, lazy_update=True, **kwargs):
         super(RMSProp, self).__init__(learning_rate=learning_rate, **kwargs)
         self.gamma1 = gamma1
         self.gamma2 = gamma2
         self.centered = centered
         self.epsilon = epsilon
         self.clip_weights = clip_weights
+        self.lazy_update = lazy_update
 
     def create_state(self, index, weight):
+        stype = weight.stype if self.lazy_update else 'default'
         if self.centered:
             return (
-                zeros(weight.shape, weight.context, stype=weight.stype),  # n
-                zeros(weight.shape, weight.context, stype=weight.stype),  # g
-                zeros(weight.shape, weight.context, stype=weight.stype))  # delta
+                zeros(weight.shape, weight.context, stype=stype),  # n
+                zeros(weight.shape, weight.context, stype=stype),  # g
+                zeros(weight.shape, weight.context, stype=stype))  # delta
         else:
-            return (zeros(weight.shape, weight.context, stype=weight.stype),)  # n
+            return (zeros(weight.shape, weight.context, stype=stype),)  # n
 
     def update(self, index, weight, grad, state):
         assert(isinstance(weight, NDArray))
@@ -1202,7 +1303,7 @@ class RMSProp(Optimizer):
         wd = self._get_wd(index)
 
         kwargs = {'gamma1': self.gamma1, 'epsilon': self.epsilon,
-                  'rescale_grad': self.rescale_grad}
+                  'rescale_grad': self.rescale_grad, 'lazy_update': self.lazy_update}
         if self.centered:
             kwargs['gamma2'] = self.gamma2
         if self.clip_gradient:
@@ -1503,18 +1604,42 @@ class Updater(object):
         self.states_synced = {}
 
     def __call__(self, index, grad, weight):
-        """Updates weight given gradient and index."""
-        # convert ctypes.char_p.value back to python str if needed
-        if isinstance(index, bytes):
-            index = py_str(index)
-        if index not in self.states:
-            self.states[index] = self.optimizer.create_state_multi_precision(index, weight)
-            self.states_synced[index] = True
-        elif not self.states_synced[index]:
-            self.states[index] = \
-                self.sync_state_context(self.states[index], weight.context)
-            self.states_synced[index] = True
-        self.optimizer.update_multi_precision(index, weight, grad, self.states[index])
+        """Updates weight given gradient and index.
+
+        index, grad and weight can also be lists, to update several weights. The
+        weights of the same dtype are then updated by groups of up to
+        ``optimizer.aggregate_num`` weights at once if the optimizer supports it.
+        """
+        if not isinstance(index, (list, tuple)):
+            indices, grads, weights = [index], [grad], [weight]
+        else:
+            indices, grads, weights = list(index), list(grad), list(weight)
+        for i, idx in enumerate(indices):
+            # convert ctypes.char_p.value back to python str if needed
+            if isinstance(idx, bytes):
+                indices[i] = idx = py_str(idx)
+            if idx not in self.states:
+                self.states[idx] = self.optimizer.create_state_multi_precision(idx, weights[i])
+                self.states_synced[idx] = True
+            elif not self.states_synced[idx]:
+                self.states[idx] = \
+                    self.sync_state_context(self.states[idx], weights[i].context)
+                self.states_synced[idx] = True
+        aggregate_num = self.optimizer.aggregate_num
+        if aggregate_num <= 1 or len(indices) == 1:
+            for idx, g, w in zip(indices, grads, weights):
+                self.optimizer.update_multi_precision(idx, w, g, self.states[idx])
+            return
+        groups = {}
+        for idx, g, w in zip(indices, grads, weights):
+            groups.setdefault(w.dtype, []).append((idx, g, w))
+        for group in groups.values():
+            for begin in range(0, len(group), aggregate_num):
+                group_indices, group_grads, group_weights = \
+                    zip(*group[begin:begin + aggregate_num])
+                self.optimizer._update_aggregated(  # pylint: disable=protected-access
+                    list(group_indices), list(group_weights), list(group_grads),
+                    [self.states[idx] for idx in group_indices])
 
     def sync_state_context(self, state, context):
         """sync state context."""
@@ -32,6 +32,7 @@
 #include <mxnet/ndarray.h>
 #include <mxnet/operator.h>
 #include <mxnet/io.h>
+#include <mxnet/imperative.h>
 #include <mxnet/c_api.h>
 #include <mxnet/kvstore.h>
 #include <mxnet/rtc.h>
@@ -222,6 +223,7 @@ int MXNDArraySaveRawBytes(NDArrayHandle handle,
                           const char **out_buf) {
   MXAPIThreadLocalEntry *ret = MXAPIThreadLocalStore::Get();
   API_BEGIN();
+  Imperative::Get()->FlushLazy();
   ret->ret_str.resize(0);
   dmlc::MemoryStringStream strm(&ret->ret_str);
   static_cast<NDArray*>(handle)->Save(&strm);
@@ -234,6 +236,7 @@ int MXNDArraySyncCopyFromCPU(NDArrayHandle handle,
                              const void *data,
                              size_t size) {
   API_BEGIN();
+  Imperative::Get()->FlushLazy();
   static_cast<NDArray*>(handle)->SyncCopyFromCPU(data, size);
   API_END();
 }
@@ -242,6 +245,7 @@ int MXNDArraySyncCopyToCPU(NDArrayHandle handle,
                            void *data,
                            size_t size) {
   API_BEGIN();
+  Imperative::Get()->FlushLazy();
   static_cast<NDArray*>(handle)->SyncCopyToCPU(data, size);
   API_END();
 }
@@ -257,6 +261,7 @@ int MXNDArraySyncCopyFromNDArray(NDArrayHandle handle_dst,
                                  const NDArrayHandle handle_src,
                                  const int i) {
   API_BEGIN();
+  Imperative::Get()->FlushLazy();
   NDArray* dst = static_cast<NDArray*>(handle_dst);
   NDArray* src = static_cast<NDArray*>(handle_src);
   dst->SyncCopyFromNDArray(*src, -1, i);
@@ -272,18 +277,21 @@ int MXNDArraySyncCheckFormat(NDArrayHandle handle, const bool full_check) {
 
 int MXNDArrayWaitToRead(NDArrayHandle handle) {
   API_BEGIN();
+  Imperative::Get()->FlushLazy();
   static_cast<NDArray*>(handle)->WaitToRead();
   API_END();
 }
 
 int MXNDArrayWaitToWrite(NDArrayHandle handle) {
   API_BEGIN();
+  Imperative::Get()->FlushLazy();
   static_cast<NDArray*>(handle)->WaitToWrite();
   API_END();
 }
 
 int MXNDArrayWaitAll() {
   API_BEGIN();
+  Imperative::Get()->FlushLazy();
   Engine::Get()->WaitForAll();
   API_END();
 }
@@ -293,6 +301,7 @@ int MXNDArraySave(const char* fname,
                   NDArrayHandle* args,
                   const char** keys) {
   API_BEGIN();
+  Imperative::Get()->FlushLazy();
   std::vector<NDArray> data(num_args);
   std::vector<std::string> names;
   for (mx_uint i = 0; i < num_args; ++i) {
@@ -491,6 +500,7 @@ int MXNDArrayGetShape(NDArrayHandle handle,
 int MXNDArrayGetData(NDArrayHandle handle,
                      void **out_pdata) {
   API_BEGIN();
+  Imperative::Get()->FlushLazy();
   NDArray *arr = static_cast<NDArray*>(handle);
   if (!arr->is_none()) {
     *out_pdata = arr->data().dptr_;
@@ -543,6 +553,7 @@ int MXNDArrayGetAuxNDArray(NDArrayHandle handle,
 int MXNDArrayGetDataNDArray(NDArrayHandle handle,
                             NDArrayHandle *out) {
   API_BEGIN();
+  Imperative::Get()->FlushLazy();
   NDArray *arr = static_cast<NDArray*>(handle);
   *out = new NDArray(arr->data_ndarray());
   API_END();
@@ -808,6 +819,7 @@ int MXKVStoreInit(KVStoreHandle handle,
                   const int* keys,
                   NDArrayHandle* vals) {
   API_BEGIN();
+  Imperative::Get()->FlushLazy();
   std::vector<int> v_keys(num);
   std::vector<NDArray> v_vals(num);
   for (mx_uint i = 0; i < num; ++i) {
@@ -823,6 +835,7 @@ int MXKVStoreInitEx(KVStoreHandle handle,
                   const char** keys,
                   NDArrayHandle* vals) {
   API_BEGIN();
+  Imperative::Get()->FlushLazy();
   std::vector<std::string> v_keys(num);
   std::vector<NDArray> v_vals(num);
   for (mx_uint i = 0; i < num; ++i) {
@@ -839,6 +852,7 @@ int MXKVStorePush(KVStoreHandle handle,
                   NDArrayHandle* vals,
                   int priority) {
   API_BEGIN();
+  Imperative::Get()->FlushLazy();
   std::vector<int> v_keys(num);
   std::vector<NDArray> v_vals(num);
   for (mx_uint i = 0; i < num; ++i) {
@@ -855,6 +869,7 @@ int MXKVStorePushEx(KVStoreHandle handle,
                   NDArrayHandle* vals,
                   int priority) {
   API_BEGIN();
+  Imperative::Get()->FlushLazy();
   std::vector<std::string> v_keys(num);
   std::vector<NDArray> v_vals(num);
   for (mx_uint i = 0; i < num; ++i) {
@@ -871,6 +886,7 @@ int MXKVStorePull(KVStoreHandle handle,
                   NDArrayHandle* vals,
                   int priority) {
   API_BEGIN();
+  Imperative::Get()->FlushLazy();
   std::vector<int> v_keys(num);
   std::vector<NDArray*> v_vals(num);
   for (mx_uint i = 0; i < num; ++i) {
@@ -887,6 +903,7 @@ int MXKVStorePullEx(KVStoreHandle handle,
                     NDArrayHandle* vals,
                     int priority) {
   API_BEGIN();
+  Imperative::Get()->FlushLazy();
   std::vector<std::string> v_keys(num);
   std::vector<NDArray*> v_vals(num);
   for (mx_uint i = 0; i < num; ++i) {
@@ -904,6 +921,7 @@ int MXKVStorePullWithSparse(KVStoreHandle handle,
                             int priority,
                             bool ignore_sparse) {
   API_BEGIN();
+  Imperative::Get()->FlushLazy();
   std::vector<int> v_keys(num);
   std::vector<NDArray*> v_vals(num);
   for (mx_uint i = 0; i < num; ++i) {
@@ -921,6 +939,7 @@ int MXKVStorePullWithSparseEx(KVStoreHandle handle,
                               int priority,
                               bool ignore_sparse) {
   API_BEGIN();
+  Imperative::Get()->FlushLazy();
   std::vector<std::string> v_keys(num);
   std::vector<NDArray*> v_vals(num);
   for (mx_uint i = 0; i < num; ++i) {
@@ -938,6 +957,7 @@ int MXKVStorePullRowSparse(KVStoreHandle handle,
                            const NDArrayHandle* row_ids,
                            int priority) {
   API_BEGIN();
+  Imperative::Get()->FlushLazy();
   std::vector<int> v_keys(num);
   std::vector<std::pair<NDArray*, NDArray>> v_val_rowids(num);
   for (mx_uint i = 0; i < num; ++i) {
@@ -956,6 +976,7 @@ int MXKVStorePullRowSparseEx(KVStoreHandle handle,
                              const NDArrayHandle* row_ids,
                              int priority) {
   API_BEGIN();
+  Imperative::Get()->FlushLazy();
   std::vector<std::string> v_keys(num);
   std::vector<std::pair<NDArray*, NDArray>> v_val_rowids(num);
   for (mx_uint i = 0; i < num; ++i) {
@@ -25,6 +25,7 @@
 #include <mxnet/base.h>
 #include <mxnet/c_api.h>
 #include <mxnet/executor.h>
+#include <mxnet/imperative.h>
 #include "./c_api_common.h"
 #include "../executor/graph_executor.h"
 #if MXNET_USE_TENSORRT
@@ -50,6 +51,7 @@ int MXExecutorFree(ExecutorHandle handle) {
 
 int MXExecutorForward(ExecutorHandle handle, int is_train) {
   API_BEGIN();
+  Imperative::Get()->FlushLazy();
   Executor *exec = static_cast<Executor*>(handle);
   exec->Forward(is_train != 0);
   API_END();
@@ -66,6 +68,7 @@ int MXExecutorBackwardEx(ExecutorHandle handle,
                          NDArrayHandle *head_grads,
                          int is_train) {
   API_BEGIN();
+  Imperative::Get()->FlushLazy();
   Executor *exec = static_cast<Executor*>(handle);
   std::vector<NDArray> ndarrays;
   NDArray **args_ptr = reinterpret_cast<NDArray**>(head_grads);
@@ -197,6 +197,7 @@ int MXInvokeCachedOp(CachedOpHandle handle,
   MXAPIThreadLocalEntry *ret = MXAPIThreadLocalStore::Get();
 
   API_BEGIN();
+  Imperative::Get()->FlushLazy();
   CachedOpPtr op = *static_cast<CachedOpPtr*>(handle);
   std::vector<NDArray*> ndinputs;
   ndinputs.reserve(num_inputs);
@@ -270,6 +271,12 @@ int MXAutogradIsRecording(bool* curr) {
   API_END();
 }
 
+int MXImperativeSetIsLazy(int is_lazy, int* prev) {
+  API_BEGIN();
+  *prev = Imperative::Get()->set_is_lazy(static_cast<bool>(is_lazy));
+  API_END();
+}
+
 int MXAutogradSetIsRecording(int is_recording, int* prev) {
   API_BEGIN();
   *prev = Imperative::Get()->set_is_recording(static_cast<bool>(is_recording));
@@ -321,6 +328,7 @@ int MXAutogradBackwardEx(mx_uint num_output,
                          int **grad_stypes) {
   MXAPIThreadLocalEntry *ret = MXAPIThreadLocalStore::Get();
   API_BEGIN();
+  Imperative::Get()->FlushLazy();
 
   std::vector<NDArray*> outputs, ograds, variables;
   outputs.reserve(num_output);
@@ -24,6 +24,7 @@
  */
 #include <mxnet/base.h>
 #include <mxnet/c_api.h>
+#include <mxnet/executor.h>
 #include <nnvm/c_api.h>
 #include <nnvm/pass.h>
 #include <nnvm/pass_functions.h>
@@ -34,6 +35,7 @@
 #include "./c_api_common.h"
 #include "../operator/operator_common.h"
 #include "../executor/exec_pass.h"
+#include "../operator/quantization/calibrate.h"
 
 namespace mxnet {
 namespace op {
@@ -703,3 +705,85 @@ int MXSetCalibTableToQuantizedSymbol(SymbolHandle qsym_handle,
   *ret_qsym_handle = s;
   API_END_HANDLE_ERROR(delete s);
 }
+
+/*! \brief a calibration collector and the holders of its calibration table */
+struct MXCalibCollectorEntry {
+  std::shared_ptr<mxnet::op::CalibCollector> collector;
+  std::vector<std::string> names;
+  std::vector<const char*> names_charp;
+  std::vector<float> low_quantiles, high_quantiles;
+};
+
+int MXCalibCollectorCreate(const char *calib_mode,
+                           const mx_uint num_bins,
+                           const mx_uint num_quantized_bins,
+                           const mx_uint num_layers,
+                           const char **layer_names,
+                           CalibCollectorHandle *out) {
+  using mxnet::op::CalibCollector;
+  MXCalibCollectorEntry *entry = new MXCalibCollectorEntry();
+  API_BEGIN();
+  const std::string mode(calib_mode);
+  CHECK(mode == "naive" || mode == "entropy")
+      << "unknown calibration mode " << mode << ", expected naive or entropy";
+  std::vector<std::string> names(layer_names, layer_names + num_layers);
+  entry->collector = std::make_shared<CalibCollector>(
+      mode == "naive" ? CalibCollector::kNaive : CalibCollector::kEntropy,
+      num_bins, num_quantized_bins, names);
+  *out = entry;
+  API_END_HANDLE_ERROR(delete entry);
+}
+
+int MXCalibCollectorSetMonitorCallback(CalibCollectorHandle handle,
+                                       ExecutorHandle exec_handle) {
+  API_BEGIN();
+  std::shared_ptr<mxnet::op::CalibCollector> collector =
+      static_cast<MXCalibCollectorEntry*>(handle)->collector;
+  Executor *exec = static_cast<Executor*>(exec_handle);
+  exec->SetMonitorCallback([collector](const char *name, void *arr) {
+    NDArray *nd = static_cast<NDArray*>(arr);
+    collector->Collect(name, *nd);
+    delete nd;
+  });
+  API_END();
+}
+
+int MXCalibCollectorCollect(CalibCollectorHandle handle,
+                            const char *name,
+                            NDArrayHandle arr) {
+  API_BEGIN();
+  static_cast<MXCalibCollectorEntry*>(handle)->collector->Collect(
+      name, *static_cast<NDArray*>(arr));
+  API_END();
+}
+
+int MXCalibCollectorGetCalibTable(CalibCollectorHandle handle,
+                                  mx_uint *num_layers,
+                                  const char ***layer_names,
+                                  const float **low_quantiles,
+                                  const float **high_quantiles) {
+  API_BEGIN();
+  MXCalibCollectorEntry *entry = static_cast<MXCalibCollectorEntry*>(handle);
+  const auto table = entry->collector->GetCalibTable();
+  entry->names.clear();
+  entry->names_charp.clear();
+  entry->low_quantiles.clear();
+  entry->high_quantiles.clear();
+  for (const auto& kv : table) {
+    entry->names.push_back(kv.first);
+    entry->low_quantiles.push_back(kv.second.first);
+    entry->high_quantiles.push_back(kv.second.second);
+  }
+  for (const auto& name : entry->names) entry->names_charp.push_back(name.c_str());
+  *num_layers = static_cast<mx_uint>(table.size());
+  *layer_names = dmlc::BeginPtr(entry->names_charp);
+  *low_quantiles = dmlc::BeginPtr(entry->low_quantiles);
+  *high_quantiles = dmlc::BeginPtr(entry->high_quantiles);
+  API_END();
+}
+
+int MXCalibCollectorFree(CalibCollectorHandle handle) {
+  API_BEGIN();
+  delete static_cast<MXCalibCollectorEntry*>(handle);
+  API_END();
+}
@@ -28,15 +28,67 @@
 #include <mxnet/executor.h>
 #include <mxnet/ndarray.h>
 #include <nnvm/pass_functions.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
 #include <unordered_set>
 #include <unordered_map>
 #include "./c_api_common.h"
 #include "../operator/operator_common.h"
 #include "../executor/exec_pass.h"
+#include "../imperative/cached_op.h"
 
 using namespace mxnet;
 
+// read-only parameters shared by static-shape predictors
+struct MXAPIPredParams {
+  // symbol
+  nnvm::Symbol sym;
+  // names of all the inputs of the symbol
+  std::vector<std::string> input_names;
+  // parameter arrays, indexed by input position, none for data inputs
+  std::vector<NDArray> param_arrays;
+  // position of data inputs
+  std::vector<uint32_t> data_indices;
+  // position of parameter inputs
+  std::vector<uint32_t> param_indices;
+  // Context
+  Context ctx;
+};
+
+// executor state of a static-shape predictor for one set of input shapes
+struct MXAPIPredStaticEntry {
+  // key of the input shapes in the shape cache
+  std::string key;
+  // cached op planned for the input shapes
+  CachedOpPtr op;
+  // data arrays, ordered as MXAPIPredParams::data_indices
+  std::vector<NDArray> data_arrays;
+  // output arrays
+  std::vector<NDArray> out_arrays;
+  // output shapes
+  std::vector<TShape> out_shapes;
+  // inputs passed to the cached op
+  std::vector<NDArray*> op_inputs;
+  // outputs passed to the cached op
+  std::vector<NDArray*> op_outputs;
+};
+
+// cache of the static entries of a predictor and of the predictors reshaped from it.
+// An entry is taken out of the cache while a predictor is bound to it, so that
+// predictors used on different threads never share arrays or cached ops.
+struct MXAPIPredShapeCache {
+  std::mutex mutex;
+  // unbound entries, keyed by the requested input shapes
+  std::unordered_multimap<std::string, std::shared_ptr<MXAPIPredStaticEntry> > entries;
+};
+
 // predictor interface
 struct MXAPIPredictor {
   // output arrays
@@ -57,6 +109,12 @@ struct MXAPIPredictor {
   nnvm::Symbol sym;
   // Context
   Context ctx;
+  // shared parameters, only set for static-shape predictors
+  std::shared_ptr<MXAPIPredParams> params;
+  // pre-bound input shapes of a static-shape predictor
+  std::shared_ptr<MXAPIPredShapeCache> shape_cache;
+  // entry of the current input shapes of a static-shape predictor
+  std::shared_ptr<MXAPIPredStaticEntry> entry;
 };
 
 struct MXAPINDList {
@@ -92,6 +150,439 @@ int MXPredCreate(const char* symbol_json_str,
 }
 namespace mxnet {
 
+// load the parameters used by sym from the raw bytes of a parameter file
+void LoadPredParams(const nnvm::Symbol& sym,
+                    const void* param_bytes,
+                    int param_size,
+                    std::unordered_map<std::string, NDArray>* arg_params,
+                    std::unordered_map<std::string, NDArray>* aux_params) {
+  using nnvm::Symbol;
+  std::unordered_set<std::string> arg_names, aux_names;
+  std::vector<std::string> arg_names_vec = sym.ListInputNames(Symbol::kReadOnlyArgs);
+  std::vector<std::string> aux_names_vec = sym.ListInputNames(Symbol::kAuxiliaryStates);
+  for (size_t i = 0; i < arg_names_vec.size(); ++i) {
+    arg_names.insert(arg_names_vec[i]);
+  }
+  for (size_t i = 0; i < aux_names_vec.size(); ++i) {
+    aux_names.insert(aux_names_vec[i]);
+  }
+  std::vector<NDArray> data;
+  std::vector<std::string> names;
+  dmlc::MemoryFixedSizeStream fi((void*)param_bytes, param_size);  // NOLINT(*)
+  NDArray::Load(&fi, &data, &names);
+  CHECK_EQ(names.size(), data.size())
+      << "Invalid param file format";
+  for (size_t i = 0; i < names.size(); ++i) {
+    if (!strncmp(names[i].c_str(), "aux:", 4)) {
+      std::string name(names[i].c_str() + 4);
+      if (aux_names.count(name) != 0) {
+        (*aux_params)[name] = data[i];
+      }
+    }
+    if (!strncmp(names[i].c_str(), "arg:", 4)) {
+      std::string name(names[i].c_str() + 4);
+      if (arg_names.count(name) != 0) {
+        (*arg_params)[name] = data[i];
+      }
+    }
+  }
+}
+
+// load the symbol and copy its parameters to the device, so that they can be
+// shared by static-shape predictors.
+std::shared_ptr<MXAPIPredParams> CreatePredParams(const char* symbol_json_str,
+                                                  const void* param_bytes,
+                                                  int param_size,
+                                                  int dev_type, int dev_id) {
+  using nnvm::Symbol;
+  // make sure symbols are registered
+  {
+  mx_uint outSize;
+  const char **outArray;
+  MXListAllOpNames(&outSize, &outArray);
+  }
+  std::shared_ptr<MXAPIPredParams> params = std::make_shared<MXAPIPredParams>();
+  {
+    nnvm::Graph g;
+    g.attrs["json"] = std::make_shared<nnvm::any>(std::string(symbol_json_str));
+    params->sym.outputs = nnvm::ApplyPass(g, "LoadLegacyJSON").outputs;
+  }
+  params->ctx = Context::Create(static_cast<Context::DeviceType>(dev_type), dev_id);
+
+  std::unordered_map<std::string, NDArray> arg_params, aux_params;
+  LoadPredParams(params->sym, param_bytes, param_size, &arg_params, &aux_params);
+  params->input_names = params->sym.ListInputNames(Symbol::kAll);
+  params->param_arrays.resize(params->input_names.size());
+  for (size_t i = 0; i < params->input_names.size(); ++i) {
+    const std::string& name = params->input_names[i];
+    const NDArray* src = nullptr;
+    if (arg_params.count(name) != 0) {
+      src = &arg_params[name];
+    } else if (aux_params.count(name) != 0) {
+      src = &aux_params[name];
+    }
+    if (src == nullptr) {
+      params->data_indices.push_back(i);
+      continue;
+    }
+    NDArray nd = NDArray(src->shape(), params->ctx, false, src->dtype());
+    CopyFromTo(*src, &nd);
+    params->param_arrays[i] = nd;
+    params->param_indices.push_back(i);
+  }
+  CHECK_GT(params->data_indices.size(), 0U)
+      << "Static-shape predictor requires at least one data input";
+  return params;
+}
+
+// create an unbound static-shape predictor with an empty shape cache
+std::unique_ptr<MXAPIPredictor> CreateStaticPredictor(
+    const std::shared_ptr<MXAPIPredParams>& params) {
+  std::unique_ptr<MXAPIPredictor> ret(new MXAPIPredictor());
+  ret->sym = params->sym;
+  ret->ctx = params->ctx;
+  for (size_t i = 0; i < params->data_indices.size(); ++i) {
+    ret->key2arg[params->input_names[params->data_indices[i]]] = i;
+  }
+  ret->params = params;
+  ret->shape_cache = std::make_shared<MXAPIPredShapeCache>();
+  return ret;
+}
+
+// put the entry a static-shape predictor is bound to back into its shape cache
+void ReleaseStaticEntry(MXAPIPredictor* p) {
+  if (p->entry == nullptr) return;
+  std::lock_guard<std::mutex> lock(p->shape_cache->mutex);
+  const std::string key = p->entry->key;
+  p->shape_cache->entries.emplace(key, std::move(p->entry));
+}
+
+// bind a static-shape predictor to the given input shapes,
+// reusing a cached entry if these shapes have been bound before.
+void BindStaticPredictor(MXAPIPredictor* p,
+                         const std::unordered_map<std::string, TShape>& known_shape) {
+  const MXAPIPredParams& params = *p->params;
+  std::ostringstream os;
+  for (const auto i : params.data_indices) {
+    auto it = known_shape.find(params.input_names[i]);
+    if (it != known_shape.end()) os << it->first << ':' << it->second << ';';
+  }
+  const std::string key = os.str();
+  if (p->entry != nullptr && p->entry->key == key) return;
+
+  std::shared_ptr<MXAPIPredStaticEntry> entry;
+  {
+    std::lock_guard<std::mutex> lock(p->shape_cache->mutex);
+    auto it = p->shape_cache->entries.find(key);
+    if (it != p->shape_cache->entries.end()) {
+      entry = std::move(it->second);
+      p->shape_cache->entries.erase(it);
+    }
+  }
+  if (entry == nullptr) {
+    const size_t num_inputs = params.input_names.size();
+    nnvm::ShapeVector in_shapes(num_inputs);
+    nnvm::DTypeVector in_dtypes(num_inputs, mshadow::kFloat32);
+    for (const auto i : params.param_indices) {
+      in_shapes[i] = params.param_arrays[i].shape();
+      in_dtypes[i] = params.param_arrays[i].dtype();
+    }
+    for (const auto i : params.data_indices) {
+      auto it = known_shape.find(params.input_names[i]);
+      if (it != known_shape.end()) in_shapes[i] = it->second;
+    }
+    nnvm::Graph g; g.outputs = params.sym.outputs;
+    try {
+      g = mxnet::exec::InferShape(std::move(g), std::move(in_shapes), "__shape__");
+    } catch (const mxnet::op::InferShapeError &err) {
+      throw dmlc::Error(err.msg);
+    }
+    CHECK_EQ(g.GetAttr<size_t>("shape_num_unknown_nodes"), 0U)
+      << "The shape information of is not enough to get the shapes";
+    g = mxnet::exec::InferType(std::move(g), std::move(in_dtypes), "__dtype__");
+    const auto& idx = g.indexed_graph();
+    const auto& shapes = g.GetAttr<nnvm::ShapeVector>("shape");
+    const auto& dtypes = g.GetAttr<nnvm::DTypeVector>("dtype");
+
+    std::shared_ptr<MXAPIPredStaticEntry> ret = std::make_shared<MXAPIPredStaticEntry>();
+    ret->key = key;
+    ret->data_arrays.reserve(params.data_indices.size());
+    for (const auto i : params.data_indices) {
+      const uint32_t eid = idx.entry_id(idx.input_nodes()[i], 0);
+      ret->data_arrays.emplace_back(shapes[eid], params.ctx, false, dtypes[eid]);
+    }
+    for (const auto& e : idx.outputs()) {
+      const uint32_t eid = idx.entry_id(e);
+      ret->out_shapes.push_back(shapes[eid]);
+      ret->out_arrays.emplace_back(shapes[eid], params.ctx, false, dtypes[eid]);
+    }
+
+    std::ostringstream data_indices, param_indices;
+    data_indices << nnvm::Tuple<uint32_t>(params.data_indices.begin(),
+                                          params.data_indices.end());
+    param_indices << nnvm::Tuple<uint32_t>(params.param_indices.begin(),
+                                           params.param_indices.end());
+    std::vector<std::pair<std::string, std::string> > flags = {
+      {"static_alloc", "true"},
+      {"static_shape", "true"},
+      {"data_indices", data_indices.str()},
+      {"param_indices", param_indices.str()}};
+    ret->op = std::make_shared<CachedOp>(params.sym, flags);
+
+    ret->op_inputs.resize(num_inputs);
+    for (size_t i = 0; i < params.data_indices.size(); ++i) {
+      ret->op_inputs[params.data_indices[i]] = &ret->data_arrays[i];
+    }
+    for (const auto i : params.param_indices) {
+      // parameters are never written by an inference forward pass.
+      ret->op_inputs[i] = const_cast<NDArray*>(&params.param_arrays[i]);
+    }
+    for (auto& nd : ret->out_arrays) ret->op_outputs.push_back(&nd);
+    entry = ret;
+  }
+  ReleaseStaticEntry(p);
+  p->entry = entry;
+  p->arg_arrays = entry->data_arrays;
+  p->out_arrays = entry->out_arrays;
+  p->out_shapes = entry->out_shapes;
+}
+
+// run forward of a static-shape predictor with its current input shapes
+inline void StaticPredForward(MXAPIPredictor* p) {
+  MXAPIPredStaticEntry* e = p->entry.get();
+  e->op->Forward(e->op, e->op_inputs, e->op_outputs);
+}
+
+// a single-sample request submitted to a batcher
+struct MXAPIPredRequest {
+  // input data, ordered as the input keys of the batcher
+  std::vector<std::vector<mx_float> > inputs;
+  // output data
+  std::vector<std::vector<mx_float> > outputs;
+  // output shapes, with batch size 1
+  std::vector<TShape> out_shapes;
+  // uint32_t buffer for output shapes
+  std::vector<uint32_t> out_shapes_buffer;
+  // error message if the batch of this request failed
+  std::string error;
+  // time when the request is submitted
+  std::chrono::steady_clock::time_point submit_time;
+  // set when the outputs are ready
+  std::promise<void> done;
+  std::shared_future<void> future;
+};
+
+/*!
+ * \brief Dynamic batching front end of the predict API.
+ *  Single-sample requests are pushed to a queue. Each worker thread owns a static-shape
+ *  predictor which is pre-bound to all the batch sizes it can run, takes up to
+ *  max_batch_size requests from the queue (waiting at most max_wait_us after the oldest
+ *  request arrives), runs them as one batch and scatters the outputs back to the requests.
+ */
+class MXAPIPredBatcher {
+ public:
+  // upper bound of the i-th latency bin is 2^i microseconds
+  static const size_t kNumLatencyBins = 32;
+
+  MXAPIPredBatcher(const std::shared_ptr<MXAPIPredParams>& params,
+                   const std::vector<std::string>& input_keys,
+                   const std::vector<TShape>& sample_shapes,
+                   mx_uint max_batch_size,
+                   mx_uint max_wait_us,
+                   mx_uint num_workers)
+      : input_keys_(input_keys), max_batch_size_(max_batch_size),
+        max_wait_(max_wait_us), batch_hist_(max_batch_size, 0),
+        latency_hist_(kNumLatencyBins, 0) {
+    CHECK_GT(max_batch_size, 0U) << "max_batch_size must be positive";
+    CHECK_GT(num_workers, 0U) << "num_workers must be positive";
+    for (const auto& s : sample_shapes) sample_sizes_.push_back(s.Size());
+    for (size_t i = 0; i < kNumLatencyBins; ++i) {
+      latency_bounds_.push_back(static_cast<mx_uint>(1U << i));
+    }
+    // batches are padded to the next power of two, or max_batch_size
+    for (mx_uint b = 1; b < max_batch_size; b *= 2) buckets_.push_back(b);
+    buckets_.push_back(max_batch_size);
+    for (const auto b : buckets_) {
+      std::unordered_map<std::string, TShape> shapes;
+      for (size_t i = 0; i < input_keys.size(); ++i) {
+        TShape shape(sample_shapes[i].ndim() + 1);
+        shape[0] = b;
+        for (size_t j = 0; j < sample_shapes[i].ndim(); ++j) {
+          shape[j + 1] = sample_shapes[i][j];
+        }
+        shapes[input_keys[i]] = shape;
+      }
+      bucket_shapes_.push_back(shapes);
+    }
+    for (mx_uint i = 0; i < num_workers; ++i) {
+      std::unique_ptr<MXAPIPredictor> pred = CreateStaticPredictor(params);
+      for (const auto& shapes : bucket_shapes_) BindStaticPredictor(pred.get(), shapes);
+      for (const auto& key : input_keys) {
+        CHECK(pred->key2arg.count(key))
+            << "cannot find input key " << key;
+      }
+      preds_.push_back(std::move(pred));
+    }
+    for (mx_uint i = 0; i < num_workers; ++i) {
+      workers_.emplace_back([this, i]() { this->WorkerLoop(i); });
+    }
+  }
+
+  ~MXAPIPredBatcher() {
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex_);
+      stop_ = true;
+    }
+    queue_cond_.notify_all();
+    for (auto& t : workers_) t.join();
+  }
+
+  std::shared_ptr<MXAPIPredRequest> Submit(const mx_float** input_data) {
+    std::shared_ptr<MXAPIPredRequest> req = std::make_shared<MXAPIPredRequest>();
+    req->inputs.resize(input_keys_.size());
+    for (size_t i = 0; i < input_keys_.size(); ++i) {
+      req->inputs[i].assign(input_data[i], input_data[i] + sample_sizes_[i]);
+    }
+    req->future = req->done.get_future().share();
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex_);
+      CHECK(!stop_) << "cannot submit to a stopped batcher";
+      req->submit_time = std::chrono::steady_clock::now();
+      queue_.push_back(req);
+    }
+    queue_cond_.notify_one();
+    return req;
+  }
+
+  // copy of the number of batches of each size, the i-th entry counts size i + 1.
+  const std::vector<mx_uint>& BatchSizeHistogram() {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    batch_hist_buffer_ = batch_hist_;
+    return batch_hist_buffer_;
+  }
+
+  // copy of the number of requests whose latency falls into each latency bin.
+  const std::vector<mx_uint>& LatencyHistogram() {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    latency_hist_buffer_ = latency_hist_;
+    return latency_hist_buffer_;
+  }
+
+  const std::vector<mx_uint>& LatencyUpperBounds() const {
+    return latency_bounds_;
+  }
+
+ private:
+  // pop at most max_batch_size requests, return false when stopped and drained.
+  bool PopBatch(std::vector<std::shared_ptr<MXAPIPredRequest> >* batch) {
+    batch->clear();
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    queue_cond_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+    if (queue_.empty()) return false;
+    auto deadline = queue_.front()->submit_time + max_wait_;
+    while (!stop_ && queue_.size() < max_batch_size_) {
+      if (queue_cond_.wait_until(lock, deadline) == std::cv_status::timeout) break;
+    }
+    const size_t n = std::min<size_t>(queue_.size(), max_batch_size_);
+    batch->assign(queue_.begin(), queue_.begin() + n);
+    queue_.erase(queue_.begin(), queue_.begin() + n);
+    // let other workers pick up the rest of the queue
+    if (!queue_.empty()) queue_cond_.notify_one();
+    return true;
+  }
+
+  void RunBatch(MXAPIPredictor* pred,
+                const std::vector<std::shared_ptr<MXAPIPredRequest> >& batch,
+                std::vector<std::vector<mx_float> >* buffers) {
+    const size_t bucket_id =
+        std::lower_bound(buckets_.begin(), buckets_.end(), batch.size()) - buckets_.begin();
+    const size_t batch_size = buckets_[bucket_id];
+    // shapes have been bound at construction, so this is a cache lookup.
+    BindStaticPredictor(pred, bucket_shapes_[bucket_id]);
+    buffers->resize(std::max(input_keys_.size(), pred->out_arrays.size()));
+    for (size_t i = 0; i < input_keys_.size(); ++i) {
+      std::vector<mx_float>& buf = (*buffers)[i];
+      const size_t size = sample_sizes_[i];
+      buf.assign(batch_size * size, 0.0f);
+      for (size_t j = 0; j < batch.size(); ++j) {
+        std::copy(batch[j]->inputs[i].begin(), batch[j]->inputs[i].end(),
+                  buf.begin() + j * size);
+      }
+      pred->arg_arrays[pred->key2arg[input_keys_[i]]].SyncCopyFromCPU(buf.data(), buf.size());
+    }
+    StaticPredForward(pred);
+    for (size_t i = 0; i < pred->out_arrays.size(); ++i) {
+      const TShape& shape = pred->out_shapes[i];
+      CHECK(shape.ndim() > 0 && shape[0] == batch_size)
+          << "The first dimension of output " << i << " must be the batch size";
+      std::vector<mx_float>& buf = (*buffers)[i];
+      buf.resize(shape.Size());
+      pred->out_arrays[i].SyncCopyToCPU(buf.data(), buf.size());
+      TShape sample_shape = shape;
+      sample_shape[0] = 1;
+      const size_t size = sample_shape.Size();
+      for (size_t j = 0; j < batch.size(); ++j) {
+        batch[j]->outputs.resize(pred->out_arrays.size());
+        batch[j]->out_shapes.resize(pred->out_arrays.size());
+        batch[j]->outputs[i].assign(buf.begin() + j * size, buf.begin() + (j + 1) * size);
+        batch[j]->out_shapes[i] = sample_shape;
+      }
+    }
+  }
+
+  void WorkerLoop(size_t worker_id) {
+    MXAPIPredictor* pred = preds_[worker_id].get();
+    std::vector<std::shared_ptr<MXAPIPredRequest> > batch;
+    std::vector<std::vector<mx_float> > buffers;
+    while (PopBatch(&batch)) {
+      std::string error;
+      try {
+        RunBatch(pred, batch, &buffers);
+      } catch (const std::exception& e) {
+        error = e.what();
+      } catch (...) {
+        error = "unknown error while running the batch";
+      }
+      auto now = std::chrono::steady_clock::now();
+      {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        ++batch_hist_[batch.size() - 1];
+        for (const auto& req : batch) {
+          const int64_t us = std::chrono::duration_cast<std::chrono::microseconds>(
+              now - req->submit_time).count();
+          size_t bin = 0;
+          while (bin + 1 < kNumLatencyBins && (int64_t{1} << bin) < us) ++bin;
+          ++latency_hist_[bin];
+        }
+      }
+      for (const auto& req : batch) {
+        req->error = error;
+        req->done.set_value();
+      }
+    }
+  }
+
+  std::vector<std::string> input_keys_;
+  std::vector<size_t> sample_sizes_;
+  size_t max_batch_size_;
+  std::chrono::microseconds max_wait_;
+  // batch sizes the predictors are bound to, in increasing order
+  std::vector<size_t> buckets_;
+  std::vector<std::unordered_map<std::string, TShape> > bucket_shapes_;
+  std::vector<std::unique_ptr<MXAPIPredictor> > preds_;
+  std::vector<std::thread> workers_;
+
+  std::mutex queue_mutex_;
+  std::condition_variable queue_cond_;
+  std::deque<std::shared_ptr<MXAPIPredRequest> > queue_;
+  bool stop_ = false;
+
+  std::mutex stats_mutex_;
+  std::vector<mx_uint> batch_hist_, batch_hist_buffer_;
+  std::vector<mx_uint> latency_hist_, latency_hist_buffer_;
+  std::vector<mx_uint> latency_bounds_;
+};
+
 }  // namespace mxnet
 
 int MXPredCreatePartialOut(const char* symbol_json_str,
@@ -144,37 +635,7 @@ int MXPredCreatePartialOut(const char* symbol_json_str,
 
   // load the parameters
   std::unordered_map<std::string, NDArray> arg_params, aux_params;
-  {
-    std::unordered_set<std::string> arg_names, aux_names;
-    std::vector<std::string> arg_names_vec = sym.ListInputNames(Symbol::kReadOnlyArgs);
-    std::vector<std::string> aux_names_vec = sym.ListInputNames(Symbol::kAuxiliaryStates);
-    for (size_t i = 0; i < arg_names_vec.size(); ++i) {
-      arg_names.insert(arg_names_vec[i]);
-    }
-    for (size_t i = 0; i < aux_names_vec.size(); ++i) {
-      aux_names.insert(aux_names_vec[i]);
-    }
-    std::vector<NDArray> data;
-    std::vector<std::string> names;
-    dmlc::MemoryFixedSizeStream fi((void*)param_bytes, param_size);  // NOLINT(*)
-    NDArray::Load(&fi, &data, &names);
-    CHECK_EQ(names.size(), data.size())
-        << "Invalid param file format";
-    for (size_t i = 0; i < names.size(); ++i) {
-      if (!strncmp(names[i].c_str(), "aux:", 4)) {
-        std::string name(names[i].c_str() + 4);
-        if (aux_names.count(name) != 0) {
-          aux_params[name] = data[i];
-        }
-      }
-      if (!strncmp(names[i].c_str(), "arg:", 4)) {
-        std::string name(names[i].c_str() + 4);
-        if (arg_names.count(name) != 0) {
-          arg_params[name] = data[i];
-        }
-      }
-    }
-  }
+  LoadPredParams(sym, param_bytes, param_size, &arg_params, &aux_params);
 
   // shape inference and bind
   std::unordered_map<std::string, TShape> known_shape;
@@ -252,6 +713,65 @@ int MXPredCreatePartialOut(const char* symbol_json_str,
   API_END_HANDLE_ERROR(delete ret);
 }
 
+int MXPredCreateMultiInstance(const char* symbol_json_str,
+                              const void* param_bytes,
+                              int param_size,
+                              int dev_type, int dev_id,
+                              mx_uint num_input_nodes,
+                              const char** input_keys,
+                              const mx_uint* input_shape_indptr,
+                              const mx_uint* input_shape_data,
+                              mx_uint num_instances,
+                              PredictorHandle* out) {
+  std::vector<std::unique_ptr<MXAPIPredictor> > preds(num_instances);
+  API_BEGIN();
+  CHECK_GT(num_instances, 0U) << "num_instances must be positive";
+  std::shared_ptr<MXAPIPredParams> params = CreatePredParams(
+      symbol_json_str, param_bytes, param_size, dev_type, dev_id);
+  std::unordered_map<std::string, TShape> known_shape;
+  for (mx_uint i = 0; i < num_input_nodes; ++i) {
+    known_shape[std::string(input_keys[i])] =
+        TShape(input_shape_data + input_shape_indptr[i],
+               input_shape_data + input_shape_indptr[i + 1]);
+  }
+  for (mx_uint n = 0; n < num_instances; ++n) {
+    preds[n] = CreateStaticPredictor(params);
+    BindStaticPredictor(preds[n].get(), known_shape);
+  }
+  for (mx_uint n = 0; n < num_instances; ++n) {
+    out[n] = preds[n].release();
+  }
+  API_END();
+}
+
+// reshape a static-shape predictor. The shape cache is shared with the original
+// predictor, so switching back to a previously used shape once the predictor bound
+// to it has been freed does not need to rebind.
+static int MXPredReshapeStatic(mx_uint num_input_nodes,
+                               const char** input_keys,
+                               const mx_uint* input_shape_indptr,
+                               const mx_uint* input_shape_data,
+                               MXAPIPredictor* p,
+                               PredictorHandle* out) {
+  std::unique_ptr<MXAPIPredictor> ret(new MXAPIPredictor());
+
+  API_BEGIN();
+  std::unordered_map<std::string, TShape> new_shape;
+  for (mx_uint i = 0; i < num_input_nodes; ++i) {
+    new_shape[std::string(input_keys[i])] =
+        TShape(input_shape_data + input_shape_indptr[i],
+            input_shape_data + input_shape_indptr[i + 1]);
+  }
+  ret->sym = p->sym;
+  ret->ctx = p->ctx;
+  ret->key2arg = p->key2arg;
+  ret->params = p->params;
+  ret->shape_cache = p->shape_cache;
+  BindStaticPredictor(ret.get(), new_shape);
+  *out = ret.release();
+  API_END();
+}
+
 int MXPredReshape(mx_uint num_input_nodes,
                   const char** input_keys,
                   const mx_uint* input_shape_indptr,
@@ -259,6 +779,10 @@ int MXPredReshape(mx_uint num_input_nodes,
                   PredictorHandle handle,
                   PredictorHandle* out) {
   MXAPIPredictor* p = static_cast<MXAPIPredictor*>(handle);
+  if (p->params != nullptr) {
+    return MXPredReshapeStatic(num_input_nodes, input_keys, input_shape_indptr,
+                               input_shape_data, p, out);
+  }
   std::unique_ptr<MXAPIPredictor> ret(new MXAPIPredictor());
 
   API_BEGIN();
@@ -376,13 +900,19 @@ int MXPredSetInput(PredictorHandle handle,
 int MXPredForward(PredictorHandle handle) {
   MXAPIPredictor* p = static_cast<MXAPIPredictor*>(handle);
   API_BEGIN();
-  p->exec->Forward(false);
+  if (p->entry != nullptr) {
+    StaticPredForward(p);
+  } else {
+    p->exec->Forward(false);
+  }
   API_END();
 }
 
 int MXPredPartialForward(PredictorHandle handle, int step, int* step_left) {
   MXAPIPredictor* p = static_cast<MXAPIPredictor*>(handle);
   API_BEGIN();
+  CHECK(p->exec != nullptr)
+      << "PartialForward is not supported by static-shape predictors";
   p->exec->PartialForward(false, step, step_left);
   API_END();
 }
@@ -402,7 +932,126 @@ int MXPredGetOutput(PredictorHandle handle,
 
 int MXPredFree(PredictorHandle handle) {
   API_BEGIN();
-  delete static_cast<MXAPIPredictor*>(handle);
+  MXAPIPredictor* p = static_cast<MXAPIPredictor*>(handle);
+  ReleaseStaticEntry(p);
+  delete p;
+  API_END();
+}
+
+int MXPredBatcherCreate(const char* symbol_json_str,
+                        const void* param_bytes,
+                        int param_size,
+                        int dev_type, int dev_id,
+                        mx_uint num_input_nodes,
+                        const char** input_keys,
+                        const mx_uint* input_shape_indptr,
+                        const mx_uint* input_shape_data,
+                        mx_uint max_batch_size,
+                        mx_uint max_wait_us,
+                        mx_uint num_workers,
+                        PredBatcherHandle* out) {
+  API_BEGIN();
+  std::shared_ptr<MXAPIPredParams> params = CreatePredParams(
+      symbol_json_str, param_bytes, param_size, dev_type, dev_id);
+  std::vector<std::string> keys;
+  std::vector<TShape> sample_shapes;
+  for (mx_uint i = 0; i < num_input_nodes; ++i) {
+    keys.emplace_back(input_keys[i]);
+    sample_shapes.emplace_back(input_shape_data + input_shape_indptr[i],
+                               input_shape_data + input_shape_indptr[i + 1]);
+  }
+  *out = new MXAPIPredBatcher(params, keys, sample_shapes,
+                              max_batch_size, max_wait_us, num_workers);
+  API_END();
+}
+
+int MXPredBatcherSubmit(PredBatcherHandle handle,
+                        const mx_float** input_data,
+                        PredRequestHandle* out) {
+  MXAPIPredBatcher* b = static_cast<MXAPIPredBatcher*>(handle);
+  API_BEGIN();
+  *out = new std::shared_ptr<MXAPIPredRequest>(b->Submit(input_data));
+  API_END();
+}
+
+int MXPredBatcherGetBatchSizeHistogram(PredBatcherHandle handle,
+                                       mx_uint* num_bins,
+                                       const mx_uint** counts) {
+  MXAPIPredBatcher* b = static_cast<MXAPIPredBatcher*>(handle);
+  API_BEGIN();
+  const std::vector<mx_uint>& hist = b->BatchSizeHistogram();
+  *num_bins = static_cast<mx_uint>(hist.size());
+  *counts = hist.data();
+  API_END();
+}
+
+int MXPredBatcherGetLatencyHistogram(PredBatcherHandle handle,
+                                     mx_uint* num_bins,
+                                     const mx_uint** upper_bounds_us,
+                                     const mx_uint** counts) {
+  MXAPIPredBatcher* b = static_cast<MXAPIPredBatcher*>(handle);
+  API_BEGIN();
+  const std::vector<mx_uint>& hist = b->LatencyHistogram();
+  *num_bins = static_cast<mx_uint>(hist.size());
+  *upper_bounds_us = b->LatencyUpperBounds().data();
+  *counts = hist.data();
+  API_END();
+}
+
+int MXPredBatcherFree(PredBatcherHandle handle) {
+  API_BEGIN();
+  delete static_cast<MXAPIPredBatcher*>(handle);
+  API_END();
+}
+
+int MXPredRequestWait(PredRequestHandle handle) {
+  MXAPIPredRequest* r = static_cast<std::shared_ptr<MXAPIPredRequest>*>(handle)->get();
+  API_BEGIN();
+  r->future.wait();
+  if (!r->error.empty()) {
+    LOG(FATAL) << r->error;
+  }
+  API_END();
+}
+
+int MXPredRequestGetOutputShape(PredRequestHandle handle,
+                                mx_uint index,
+                                mx_uint** shape_data,
+                                mx_uint* shape_ndim) {
+  MXAPIPredRequest* r = static_cast<std::shared_ptr<MXAPIPredRequest>*>(handle)->get();
+  API_BEGIN();
+  r->future.wait();
+  CHECK(r->error.empty()) << r->error;
+  CHECK_LT(index, r->out_shapes.size())
+      << "Index exceed number of outputs";
+  const TShape& s = r->out_shapes[index];
+  r->out_shapes_buffer.resize(s.ndim());
+  nnvm::ShapeTypeCast(s.begin(), s.end(), r->out_shapes_buffer.data());
+  *shape_data = r->out_shapes_buffer.data();
+  *shape_ndim = s.ndim();
+  API_END();
+}
+
+int MXPredRequestGetOutput(PredRequestHandle handle,
+                           mx_uint index,
+                           mx_float* data,
+                           mx_uint size) {
+  MXAPIPredRequest* r = static_cast<std::shared_ptr<MXAPIPredRequest>*>(handle)->get();
+  API_BEGIN();
+  r->future.wait();
+  CHECK(r->error.empty()) << r->error;
+  CHECK_LT(index, r->outputs.size())
+      << "Output index out of range";
+  const std::vector<mx_float>& out = r->outputs[index];
+  CHECK_EQ(static_cast<size_t>(size), out.size())
+      << "Memory size do not match";
+  std::copy(out.begin(), out.end(), data);
+  API_END();
+}
+
+int MXPredRequestFree(PredRequestHandle handle) {
+  API_BEGIN();
+  delete static_cast<std::shared_ptr<MXAPIPredRequest>*>(handle);
   API_END();
 }
 
@@ -26,6 +26,7 @@
 #define MXNET_COMMON_RANDOM_GENERATOR_H_
 
 #include <mxnet/base.h>
+#include <cstdint>
 #include <random>
 #include <new>
 
@@ -38,6 +39,126 @@ namespace mxnet {
 namespace common {
 namespace random {
 
+/*!
+ * \brief Philox4x32-10 counter-based random bit generator, see Salmon et al.,
+ *  "Parallel Random Numbers: As Easy as 1, 2, 3", SC'11.
+ *  Block n of a stream is a pure function of the key (seed, stream) and of n, so a stream
+ *  only keeps its key, a counter and a small buffer, and any number of streams can be
+ *  generated independently. Blocks are generated kLanes at a time, in a form the compiler
+ *  vectorizes. Meets the UniformRandomBitGenerator requirements of the std distributions.
+ */
+class Philox4x32 {
+ public:
+  typedef uint32_t result_type;
+  // number of blocks of 4 values generated together
+  static const int kLanes = 8;
+
+  Philox4x32() { seed(0); }
+
+  explicit Philox4x32(uint32_t seed_value, uint32_t stream = 0) { seed(seed_value, stream); }
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return 0xFFFFFFFFU; }
+
+  void seed(uint32_t seed_value, uint32_t stream = 0) {
+    key_[0] = seed_value;
+    key_[1] = stream;
+    counter_ = 0;
+    pos_ = kBufferSize;
+  }
+
+  result_type operator()() {
+    if (pos_ == kBufferSize) {
+      Generate(key_, counter_, kLanes, buffer_);
+      counter_ += kLanes;
+      pos_ = 0;
+    }
+    return buffer_[pos_++];
+  }
+
+  /*!
+   * \brief Computes the blocks first, ..., first + num_blocks - 1 of a stream into
+   *  out[0, 4 * num_blocks). The counter of block n is (n & 0xFFFFFFFF, n >> 32, 0, 0).
+   */
+  static void Generate(const uint32_t key[2], uint64_t first, int num_blocks, uint32_t *out) {
+    for (int b = 0; b < num_blocks; b += kLanes) {
+      uint32_t c0[kLanes], c1[kLanes], c2[kLanes], c3[kLanes];
+      for (int l = 0; l < kLanes; ++l) {
+        const uint64_t n = first + b + l;
+        c0[l] = static_cast<uint32_t>(n);
+        c1[l] = static_cast<uint32_t>(n >> 32);
+        c2[l] = 0;
+        c3[l] = 0;
+      }
+      uint32_t k0 = key[0], k1 = key[1];
+      for (int r = 0; r < kRounds; ++r) {
+        for (int l = 0; l < kLanes; ++l) {
+          Round(k0, k1, &c0[l], &c1[l], &c2[l], &c3[l]);
+        }
+        k0 += kW0;
+        k1 += kW1;
+      }
+      const int n = num_blocks - b < kLanes ? num_blocks - b : kLanes;
+      for (int l = 0; l < n; ++l) {
+        out[4 * (b + l)] = c0[l];
+        out[4 * (b + l) + 1] = c1[l];
+        out[4 * (b + l) + 2] = c2[l];
+        out[4 * (b + l) + 3] = c3[l];
+      }
+    }
+  }
+
+  /*! \brief Computes the block of an arbitrary 128-bit counter. */
+  static void Block(const uint32_t key[2], const uint32_t counter[4], uint32_t out[4]) {
+    uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+    uint32_t k0 = key[0], k1 = key[1];
+    for (int r = 0; r < kRounds; ++r) {
+      Round(k0, k1, &c0, &c1, &c2, &c3);
+      k0 += kW0;
+      k1 += kW1;
+    }
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+  }
+
+ private:
+  static const int kRounds = 10;
+  static const int kBufferSize = 4 * kLanes;
+  static const uint32_t kM0 = 0xD2511F53U;
+  static const uint32_t kM1 = 0xCD9E8D57U;
+  static const uint32_t kW0 = 0x9E3779B9U;
+  static const uint32_t kW1 = 0xBB67AE85U;
+
+  static inline void Round(uint32_t k0, uint32_t k1,
+                           uint32_t *c0, uint32_t *c1, uint32_t *c2, uint32_t *c3) {
+    const uint64_t p0 = static_cast<uint64_t>(kM0) * *c0;
+    const uint64_t p1 = static_cast<uint64_t>(kM1) * *c2;
+    *c0 = static_cast<uint32_t>(p1 >> 32) ^ *c1 ^ k0;
+    *c1 = static_cast<uint32_t>(p1);
+    *c2 = static_cast<uint32_t>(p0 >> 32) ^ *c3 ^ k1;
+    *c3 = static_cast<uint32_t>(p0);
+  }
+
+  uint32_t key_[2];
+  uint64_t counter_;
+  uint32_t buffer_[kBufferSize];
+  int pos_;
+};
+
+/*! \brief uniform number in [0, 1) from the top 24 bits of a random value */
+inline float UniformFromBits(Philox4x32 *engine, float) {
+  return ((*engine)() >> 8) * (1.0f / 16777216.0f);
+}
+
+/*! \brief uniform number in [0, 1) from 53 bits of two random values */
+inline double UniformFromBits(Philox4x32 *engine, double) {
+  const uint64_t hi = (*engine)() >> 5;
+  const uint64_t lo = (*engine)() >> 6;
+  return ((hi << 26) + lo) * (1.0 / 9007199254740992.0);
+}
+
 template<typename Device, typename DType MSHADOW_DEFAULT_DTYPE>
 class RandGenerator;
 
@@ -64,11 +185,7 @@ class RandGenerator<cpu, DType> {
     MSHADOW_XINLINE int rand() { return engine_->operator()(); }
 
     MSHADOW_XINLINE FType uniform() {
-      typedef typename std::conditional<std::is_integral<DType>::value,
-      std::uniform_int_distribution<DType>,
-      std::uniform_real_distribution<FType>>::type GType;
-      GType dist_uniform;
-      return dist_uniform(*engine_);
+      return uniform(std::is_integral<DType>());
     }
 
     MSHADOW_XINLINE FType normal() {
@@ -77,11 +194,20 @@ class RandGenerator<cpu, DType> {
     }
 
    private:
-    std::mt19937 *engine_;
+    MSHADOW_XINLINE FType uniform(std::true_type) {
+      std::uniform_int_distribution<DType> dist_uniform;
+      return dist_uniform(*engine_);
+    }
+
+    MSHADOW_XINLINE FType uniform(std::false_type) {
+      return UniformFromBits(engine_, FType());
+    }
+
+    Philox4x32 *engine_;
   };
 
   static void AllocState(RandGenerator<cpu, DType> *inst) {
-    inst->states_ = new std::mt19937[kNumRandomStates];
+    inst->states_ = new Philox4x32[kNumRandomStates];
   }
 
   static void FreeState(RandGenerator<cpu, DType> *inst) {
@@ -89,11 +215,12 @@ class RandGenerator<cpu, DType> {
   }
 
   MSHADOW_XINLINE void Seed(mshadow::Stream<cpu> *, uint32_t seed) {
-    for (int i = 0; i < kNumRandomStates; ++i) (states_ + i)->seed(seed + i);
+    // one stream per state, whatever the number of threads that draw from them
+    for (int i = 0; i < kNumRandomStates; ++i) (states_ + i)->seed(seed, i);
   }
 
  private:
-  std::mt19937 *states_;
+  Philox4x32 *states_;
 };  // class RandGenerator<cpu, DType>
 
 template<typename DType>
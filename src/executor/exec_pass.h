@@ -163,6 +163,23 @@ void AttachOpResources(const Graph& g,
  */
 Graph DetectInplaceAddTo(Graph g);
 
+/*!
+ * \brief Select the forward nodes whose outputs are dropped after forward and
+ *  recomputed in backward, so that the predicted peak memory of training fits
+ *  in the budget. It recomputes as little as possible.
+ *
+ * \param g forward graph with "shape" and "dtype" attributes.
+ * \param budget_bytes the memory budget of training the graph.
+ * \param fixed_bytes the memory held during the whole training step,
+ *  i.e. the inputs, the gradients and the head gradients.
+ *
+ * \return graph with two new attributes.
+ *  - "mirror", std::vector<int> size=g.num_nodes()
+ *    - mirror[nid] == 1, the node is recomputed in backward.
+ *  - "mirror_predicted_peak_bytes", size_t, the predicted peak memory.
+ */
+Graph PlanMirrorWithBudget(Graph g, size_t budget_bytes, size_t fixed_bytes);
+
 /*!
  * \brief Infer shapes in the graph given the information.
  * \param graph The input graph.
@@ -102,6 +102,11 @@ void GraphExecutor::Print(std::ostream &os) const {  // NOLINT(*)
   size_t total_bytes = graph_.GetAttr<size_t>("storage_allocated_bytes");
   os << "Total " << (total_bytes >> 20UL) <<" MB allocated\n";
   os << "Total " << 11 << " TempSpace resource requested\n";
+  if (mirror_budget_bytes_ > 0) {
+    os << "Memory budget " << (mirror_budget_bytes_ >> 20) << " MB\n";
+    os << "Predicted peak " << (mirror_predicted_peak_bytes_ >> 20) << " MB\n";
+    os << "Actual peak " << (mirror_actual_peak_bytes_ >> 20) << " MB\n";
+  }
 }
 
 void GraphExecutor::SetMonitorCallback(const MonitorCallback& callback) {
@@ -261,11 +266,12 @@ nnvm::Graph GraphExecutor::InitFullGraph(nnvm::Symbol symbol,
   }
 
   int do_mirror = dmlc::GetEnv("MXNET_BACKWARD_DO_MIRROR", 0);
-  auto need_mirror = [do_mirror](const nnvm::Node& node) -> int {
+  auto need_mirror = [do_mirror, this](const nnvm::Node& node) -> int {
     if (node.is_variable()) return 0;
     const std::string& type = node.attrs.op->name;
     if (type == "Dropout") return false;
     if (get_node_attr(node, "__force_mirroring__", false)) return true;
+    if (mirror_nodes_.count(&node)) return true;
     if (do_mirror == 0) return false;
     if (type == "Convolution") return false;
     if (type == "FullyConnected") return false;
@@ -293,6 +299,74 @@ nnvm::Graph GraphExecutor::InitFullGraph(nnvm::Symbol symbol,
   return g;
 }
 
+/*!
+ * \brief Select the forward nodes to recompute in backward, so that the
+ * predicted peak memory of training fits in MXNET_BACKWARD_MEMORY_BUDGET_MB.
+ * The shapes and types of the forward graph are inferred from the arguments.
+ */
+void GraphExecutor::InitMirrorWithBudget(
+    const nnvm::Symbol& symbol,
+    const std::unordered_map<std::string, TShape>& arg_shape_map,
+    const std::unordered_map<std::string, int>& arg_dtype_map,
+    const std::vector<OpReqType>& grad_req_types) {
+  mirror_nodes_.clear();
+  mirror_budget_bytes_ = dmlc::GetEnv("MXNET_BACKWARD_MEMORY_BUDGET_MB", size_t(0)) << 20;
+  if (mirror_budget_bytes_ == 0) return;
+  if (std::all_of(grad_req_types.begin(), grad_req_types.end(),
+                  [](OpReqType req) { return req == kNullOp; })) return;
+
+  nnvm::Graph g;
+  g.outputs = symbol.outputs;
+  {
+    const auto& idx = g.indexed_graph();
+    nnvm::ShapeVector arg_shapes(idx.input_nodes().size(), TShape());
+    nnvm::DTypeVector arg_dtypes(idx.input_nodes().size(), -1);
+    for (size_t i = 0; i < idx.input_nodes().size(); ++i) {
+      const std::string& name = idx[idx.input_nodes()[i]].source->attrs.name;
+      auto it_shape = arg_shape_map.find(name);
+      if (it_shape != arg_shape_map.end()) arg_shapes[i] = it_shape->second;
+      auto it_dtype = arg_dtype_map.find(name);
+      if (it_dtype != arg_dtype_map.end()) arg_dtypes[i] = it_dtype->second;
+    }
+    g = InferShape(std::move(g), std::move(arg_shapes), "__shape__");
+    g = InferType(std::move(g), std::move(arg_dtypes), "__dtype__");
+  }
+  if (g.GetAttr<size_t>("shape_num_unknown_nodes") != 0U ||
+      g.GetAttr<size_t>("dtype_num_unknown_nodes") != 0U) {
+    LOG(WARNING) << "MXNET_BACKWARD_MEMORY_BUDGET_MB is ignored because the shapes "
+                 << "or types of the forward graph can't be inferred";
+    return;
+  }
+
+  const auto& idx = g.indexed_graph();
+  const auto& vshape = g.GetAttr<nnvm::ShapeVector>("shape");
+  const auto& vdtype = g.GetAttr<nnvm::DTypeVector>("dtype");
+  auto entry_bytes = [&](uint32_t eid) {
+    return vshape[eid].Size() * mshadow::mshadow_sizeof(vdtype[eid]);
+  };
+  // The inputs, the gradients of the arguments and the head gradients are
+  // held during the whole training step.
+  size_t fixed_bytes = 0;
+  for (const uint32_t nid : idx.input_nodes()) fixed_bytes += entry_bytes(idx.entry_id(nid, 0));
+  const std::vector<nnvm::NodePtr> args = symbol.ListInputs(nnvm::Symbol::kReadOnlyArgs);
+  for (size_t i = 0; i < grad_req_types.size(); ++i) {
+    if (grad_req_types[i] != kNullOp) {
+      fixed_bytes += entry_bytes(idx.entry_id(idx.node_id(args[i].get()), 0));
+    }
+  }
+  for (const auto& e : idx.outputs()) fixed_bytes += entry_bytes(idx.entry_id(e));
+
+  g = PlanMirrorWithBudget(std::move(g), mirror_budget_bytes_, fixed_bytes);
+  const auto& mirror = g.GetAttr<std::vector<int> >("mirror");
+  for (uint32_t nid = 0; nid < idx.num_nodes(); ++nid) {
+    if (mirror[nid]) mirror_nodes_.insert(idx[nid].source);
+  }
+  mirror_predicted_peak_bytes_ = g.GetAttr<size_t>("mirror_predicted_peak_bytes");
+  LOG(INFO) << "Memory budget " << (mirror_budget_bytes_ >> 20) << " MB: recompute "
+            << mirror_nodes_.size() << " nodes in backward, predicted peak memory "
+            << (mirror_predicted_peak_bytes_ >> 20) << " MB";
+}
+
 #if MXNET_USE_NGRAPH == 1
 bool multi_context_check(const Context& default_ctx,
                          const std::vector<Context>& in_arg_ctxes,
@@ -336,6 +410,21 @@ void GraphExecutor::Init(nnvm::Symbol symbol,
                          Executor* shared_exec,
                          const nnvm::NodeEntryMap<NDArray>& feed_dict) {
   symbol_ = symbol;
+  {
+    std::unordered_map<std::string, TShape> arg_shape_map;
+    std::unordered_map<std::string, int> arg_dtype_map;
+    const auto arg_names = symbol.ListInputNames(nnvm::Symbol::kReadOnlyArgs);
+    const auto aux_names = symbol.ListInputNames(nnvm::Symbol::kAuxiliaryStates);
+    for (size_t i = 0; i < arg_names.size() && i < in_args.size(); ++i) {
+      arg_shape_map[arg_names[i]] = in_args[i].shape();
+      arg_dtype_map[arg_names[i]] = in_args[i].dtype();
+    }
+    for (size_t i = 0; i < aux_names.size() && i < aux_states.size(); ++i) {
+      arg_shape_map[aux_names[i]] = aux_states[i].shape();
+      arg_dtype_map[aux_names[i]] = aux_states[i].dtype();
+    }
+    InitMirrorWithBudget(symbol, arg_shape_map, arg_dtype_map, grad_req_types);
+  }
   // create in_arg_ctxes, arg_grad_ctxes, aux_state_ctxes
   auto get_ctx1 = [](const NDArray& nd) { return nd.ctx(); };
   auto get_ctx2 = [default_ctx](const NDArray& nd) -> Context {
@@ -714,6 +803,27 @@ void GraphExecutor::FinishInitGraph(nnvm::Symbol symbol,
   }
   g = DetectInplaceAddTo(g);
 
+  if (mirror_budget_bytes_ > 0) {
+    // The memory planned for the internal entries and the external arrays.
+    const auto& vshape = g.GetAttr<nnvm::ShapeVector>("shape");
+    const auto& vdtype = g.GetAttr<nnvm::DTypeVector>("dtype");
+    const auto& vstorage = g.GetAttr<nnvm::StorageVector>("storage_id");
+    const auto& planned_idx = g.indexed_graph();
+    mirror_actual_peak_bytes_ = g.GetAttr<size_t>("storage_allocated_bytes");
+    std::vector<bool> external(planned_idx.num_node_entries(), false);
+    for (const uint32_t nid : planned_idx.input_nodes()) {
+      external[planned_idx.entry_id(nid, 0)] = true;
+    }
+    for (size_t i = 0; i < vstorage.size(); ++i) {
+      if (vstorage[i] == kExternalStorageID || external[i]) {
+        mirror_actual_peak_bytes_ += vshape[i].Size() * mshadow::mshadow_sizeof(vdtype[i]);
+      }
+    }
+    LOG(INFO) << "Memory budget " << (mirror_budget_bytes_ >> 20) << " MB: predicted peak memory "
+              << (mirror_predicted_peak_bytes_ >> 20) << " MB, actual peak memory "
+              << (mirror_actual_peak_bytes_ >> 20) << " MB";
+  }
+
   // log the static memory plan of the graph
   static bool mem_log_verbose = dmlc::GetEnv("MXNET_MEM_PLAN_VERBOSE_LOGGING", false);
   if (mem_log_verbose) {
@@ -781,6 +891,7 @@ void GraphExecutor::Init(nnvm::Symbol symbol,
                          Executor* shared_exec,
                          const nnvm::NodeEntryMap<NDArray>& feed_dict) {
   symbol_ = symbol;
+  InitMirrorWithBudget(symbol, arg_shape_mapRef, arg_dtype_mapRef, grad_req_types);
   nnvm::Graph g = InitGraph(symbol, default_ctx, ctx_map, in_arg_ctxes, arg_grad_ctxes,
                             aux_state_ctxes, grad_req_types);
   // make copies so that ngraph compilation can modify shape / dtype
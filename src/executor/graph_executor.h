@@ -190,6 +190,11 @@ class GraphExecutor : public Executor {
                   const std::vector<OpReqType>& grad_req_types);
   // intialize the full graph for simple bind, including gradient
   Graph InitFullGraph(nnvm::Symbol symbol, const std::vector<OpReqType>& grad_req_types);
+  // select the nodes to recompute in backward with MXNET_BACKWARD_MEMORY_BUDGET_MB
+  void InitMirrorWithBudget(const nnvm::Symbol& symbol,
+                            const std::unordered_map<std::string, TShape>& arg_shape_map,
+                            const std::unordered_map<std::string, int>& arg_dtype_map,
+                            const std::vector<OpReqType>& grad_req_types);
   // initialize the cached operator
   void InitCachedOps();
   // initialize the opr segments for bulk exec
@@ -257,6 +262,13 @@ class GraphExecutor : public Executor {
   std::vector<CachedSegOpr> cached_seg_opr_;
   // cached segment operator name (needs a longer lifecycle than cached_seg_opr_)
   std::unordered_set<std::string> cached_seg_opr_names_;
+  // the memory budget of training, 0 if there is no budget
+  size_t mirror_budget_bytes_{0};
+  // the forward nodes recomputed in backward to fit in the budget
+  std::unordered_set<const nnvm::Node*> mirror_nodes_;
+  // the predicted and the actual peak memory with the recomputation
+  size_t mirror_predicted_peak_bytes_{0};
+  size_t mirror_actual_peak_bytes_{0};
   // verbose logging
   bool log_verbose_ = false;
   // subgraph property name
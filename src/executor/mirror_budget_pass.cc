@@ -0,0 +1,156 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * Copyright (c) 2018 by Contributors
+ * \file mirror_budget_pass.cc
+ * \brief Select the nodes to recompute in backward, so that training fits in a memory budget.
+ */
+#include <mxnet/base.h>
+#include <mxnet/operator.h>
+#include <mxnet/op_attr_types.h>
+#include <nnvm/graph_attr_types.h>
+#include <algorithm>
+
+#include "./exec_pass.h"
+
+namespace mxnet {
+namespace exec {
+
+namespace {
+
+// The nodes to recompute in backward and the cost of doing so.
+struct MirrorPlan {
+  std::vector<int> mirror;
+  size_t peak_bytes{0};
+  size_t recompute_bytes{0};
+};
+
+// Whether the outputs of a node can be dropped after forward and recomputed in backward.
+bool CanMirror(const nnvm::Node& node) {
+  static auto& fmutate = nnvm::Op::GetAttr<nnvm::FMutateInputs>("FMutateInputs");
+  static auto& fstate = nnvm::Op::GetAttr<FCreateOpState>("FCreateOpState");
+  static auto& fresource = nnvm::Op::GetAttr<FResourceRequest>("FResourceRequest");
+  if (node.is_variable()) return false;
+  const nnvm::Op* op = node.op();
+  if (op->name == "Dropout" || op->name.substr(0, 6) == "ngraph") return false;
+  // Recomputing these would update their inputs or states a second time.
+  if (fmutate.count(op) || fstate.count(op)) return false;
+  // Recomputing these would give different results.
+  if (fresource.count(op)) {
+    for (const auto& req : fresource[op](node.attrs)) {
+      if (req.type == ResourceRequest::kRandom ||
+          req.type == ResourceRequest::kParallelRandom) return false;
+    }
+  }
+  return true;
+}
+
+/*
+ * Walk the nodes in topological order and recompute the mirrorable nodes until
+ * the outputs recomputed since the last kept node exceed the threshold. The kept
+ * nodes split the graph into segments, and a segment is recomputed at once in
+ * backward.
+ */
+MirrorPlan PlanWithThreshold(const nnvm::IndexedGraph& idx,
+                             const std::vector<size_t>& node_bytes,
+                             const std::vector<bool>& can_mirror,
+                             size_t fixed_bytes,
+                             size_t threshold) {
+  MirrorPlan plan;
+  plan.mirror.resize(idx.num_nodes(), 0);
+  size_t kept_bytes = 0, segment_bytes = 0, max_segment_bytes = 0;
+  for (uint32_t nid = 0; nid < idx.num_nodes(); ++nid) {
+    if (idx[nid].source->is_variable()) continue;
+    if (threshold > 0 && can_mirror[nid] && segment_bytes + node_bytes[nid] <= threshold) {
+      plan.mirror[nid] = 1;
+      segment_bytes += node_bytes[nid];
+      max_segment_bytes = std::max(max_segment_bytes, segment_bytes);
+      plan.recompute_bytes += node_bytes[nid];
+    } else {
+      kept_bytes += node_bytes[nid];
+      segment_bytes = 0;
+    }
+  }
+  plan.peak_bytes = fixed_bytes + kept_bytes + max_segment_bytes;
+  return plan;
+}
+
+}  // namespace
+
+Graph PlanMirrorWithBudget(Graph g, size_t budget_bytes, size_t fixed_bytes) {
+  const auto& idx = g.indexed_graph();
+  const auto& shapes = g.GetAttr<nnvm::ShapeVector>("shape");
+  const auto& dtypes = g.GetAttr<nnvm::DTypeVector>("dtype");
+
+  std::vector<size_t> node_bytes(idx.num_nodes(), 0);
+  std::vector<bool> can_mirror(idx.num_nodes(), false);
+  size_t total_bytes = 0, min_bytes = 0, max_entry_bytes = 0;
+  for (uint32_t nid = 0; nid < idx.num_nodes(); ++nid) {
+    const auto& inode = idx[nid];
+    if (inode.source->is_variable()) continue;
+    for (uint32_t i = 0; i < inode.source->num_outputs(); ++i) {
+      const uint32_t eid = idx.entry_id(nid, i);
+      const size_t bytes = shapes[eid].Size() * mshadow::mshadow_sizeof(dtypes[eid]);
+      node_bytes[nid] += bytes;
+      max_entry_bytes = std::max(max_entry_bytes, bytes);
+    }
+    can_mirror[nid] = CanMirror(*inode.source);
+    total_bytes += node_bytes[nid];
+    if (node_bytes[nid] > 0 && (min_bytes == 0 || node_bytes[nid] < min_bytes)) {
+      min_bytes = node_bytes[nid];
+    }
+  }
+  // The outputs of the graph are kept anyway.
+  for (const auto& e : idx.outputs()) can_mirror[e.node_id] = false;
+  // The backward of a node holds the gradients of its outputs and inputs
+  // besides the kept outputs.
+  fixed_bytes += 2 * max_entry_bytes;
+
+  MirrorPlan best = PlanWithThreshold(idx, node_bytes, can_mirror, fixed_bytes, 0);
+  if (best.peak_bytes > budget_bytes && min_bytes > 0) {
+    // Try segments of geometrically growing sizes. Among the plans that fit in
+    // the budget, pick the one that recomputes the least.
+    MirrorPlan lowest = best;
+    bool found = false;
+    for (double threshold = min_bytes; ; threshold *= 1.2) {
+      const size_t t = std::min(static_cast<size_t>(threshold), total_bytes);
+      MirrorPlan plan = PlanWithThreshold(idx, node_bytes, can_mirror, fixed_bytes, t);
+      if (plan.peak_bytes < lowest.peak_bytes) lowest = plan;
+      if (plan.peak_bytes <= budget_bytes &&
+          (!found || plan.recompute_bytes < best.recompute_bytes)) {
+        best = plan;
+        found = true;
+      }
+      if (t >= total_bytes) break;
+    }
+    if (!found) {
+      LOG(WARNING) << "The predicted peak memory " << (lowest.peak_bytes >> 20)
+                   << " MB exceeds the memory budget " << (budget_bytes >> 20)
+                   << " MB even if the outputs of all possible nodes are recomputed";
+      best = lowest;
+    }
+  }
+  g.attrs["mirror"] = std::make_shared<dmlc::any>(std::move(best.mirror));
+  g.attrs["mirror_predicted_peak_bytes"] = std::make_shared<dmlc::any>(best.peak_bytes);
+  return g;
+}
+
+}  // namespace exec
+}  // namespace mxnet
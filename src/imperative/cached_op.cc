@@ -681,15 +681,61 @@ void CachedOp::StaticRunOps(
   }
 }
 
+OpStatePtr CachedOp::CreateStaticState(
+    const Context& ctx,
+    const OpStatePtr& like,
+    std::multimap<size_t, NDArray>&& pool) {
+  CHECK(config_.static_alloc)
+      << "Only CachedOp with static_alloc can create static states";
+  auto state_ptr = OpStatePtr::Create<CachedOpState>(ctx, fwd_graph_, full_graph_);
+  auto& state = state_ptr.get_state<CachedOpState>();
+  if (like) {
+    // Shapes and the memory plans only depend on the inputs, which are the
+    // same for the states of a loop body, so we skip re-planning.
+    auto& like_state = like.get_state<CachedOpState>();
+    std::lock_guard<std::mutex> lock(like_state.mutex);
+    CHECK_EQ(like_state.context, ctx);
+    state.info = like_state.info;
+  }
+  state.fwd_reuse_pool = std::move(pool);
+  return state_ptr;
+}
+
+std::vector<size_t> CachedOp::StaticForwardBufferSizes(const OpStatePtr& state_ptr) const {
+  auto& state = state_ptr.get_state<CachedOpState>();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  std::vector<size_t> sizes;
+  sizes.reserve(state.fwd_reuse_pool.size());
+  for (const auto& kv : state.fwd_reuse_pool) sizes.push_back(kv.first);
+  return sizes;
+}
+
+void CachedOp::TransferStaticBackward(const OpStatePtr& from, const OpStatePtr& to) {
+  auto& from_state = from.get_state<CachedOpState>();
+  auto& to_state = to.get_state<CachedOpState>();
+  if (&from_state == &to_state) return;
+  std::lock(from_state.mutex, to_state.mutex);
+  std::lock_guard<std::mutex> from_lock(from_state.mutex, std::adopt_lock);
+  std::lock_guard<std::mutex> to_lock(to_state.mutex, std::adopt_lock);
+  if (!to_state.bwd_alloc && from_state.bwd_alloc) {
+    to_state.info.full_graph = from_state.info.full_graph;
+    to_state.info.bwd_output_reqs = from_state.info.bwd_output_reqs;
+    to_state.info.bwd_input_eid = from_state.info.bwd_input_eid;
+  }
+  for (auto& kv : from_state.bwd_reuse_pool) to_state.bwd_reuse_pool.insert(kv);
+  from_state.bwd_reuse_pool.clear();
+}
+
 OpStatePtr CachedOp::StaticForward(
     const Context& default_ctx,
     const std::vector<NDArray*>& inputs,
-    const std::vector<NDArray*>& outputs) {
+    const std::vector<NDArray*>& outputs,
+    const OpStatePtr& given_state) {
   using namespace nnvm;
   using namespace imperative;
 
   bool recording = Imperative::Get()->is_recording();
-  auto state_ptr = GetCachedOpState(default_ctx);
+  auto state_ptr = given_state ? given_state : GetCachedOpState(default_ctx);
   auto& state = state_ptr.get_state<CachedOpState>();
   std::lock_guard<std::mutex> lock(state.mutex);
 
@@ -834,7 +880,8 @@ OpStatePtr CachedOp::DynamicForward(
 OpStatePtr CachedOp::Forward(
     const std::shared_ptr<CachedOp>& op_ptr,
     const std::vector<NDArray*>& inputs,
-    const std::vector<NDArray*>& outputs) {
+    const std::vector<NDArray*>& outputs,
+    const OpStatePtr& state) {
   static const auto cached_op = nnvm::Op::Get("_CachedOp");
 
   CHECK_EQ(inputs.size(), num_inputs());
@@ -855,8 +902,9 @@ OpStatePtr CachedOp::Forward(
 
   OpStatePtr op_state;
   if (config_.static_alloc) {
-    op_state = StaticForward(default_ctx, inputs, outputs);
+    op_state = StaticForward(default_ctx, inputs, outputs, state);
   } else {
+    CHECK(!state) << "Only CachedOp with static_alloc can run with a given state";
     op_state = DynamicForward(default_ctx, inputs, outputs);
   }
 
@@ -23,6 +23,7 @@
 #include <mxnet/imperative.h>
 #include <vector>
 #include <atomic>
+#include <map>
 #include <utility>
 #include <string>
 #include <unordered_map>
@@ -95,13 +96,31 @@ class CachedOp {
   OpStatePtr Forward(
       const std::shared_ptr<CachedOp>& op_ptr,
       const std::vector<NDArray*>& inputs,
-      const std::vector<NDArray*>& outputs);
+      const std::vector<NDArray*>& outputs,
+      const OpStatePtr& state = OpStatePtr());
   void Backward(
       const bool retain_graph,
       const OpStatePtr& state,
       const std::vector<NDArray*>& inputs,
       const std::vector<OpReqType>& reqs,
       const std::vector<NDArray*>& outputs);
+  /*!
+   * \brief Create a static_alloc state owned by the caller rather than the
+   *  per-context state list. The state reuses the graph plans of like if given,
+   *  and takes its forward buffers from pool before allocating new memory.
+   *  It is passed to Forward explicitly.
+   */
+  OpStatePtr CreateStaticState(
+      const Context& ctx,
+      const OpStatePtr& like,
+      std::multimap<size_t, NDArray>&& pool);
+  /*! \brief Byte sizes of the forward buffers held by a static_alloc state. */
+  std::vector<size_t> StaticForwardBufferSizes(const OpStatePtr& state) const;
+  /*!
+   * \brief Hand the backward buffers and the backward plan of a state whose
+   *  backward has finished to the state that runs backward next.
+   */
+  void TransferStaticBackward(const OpStatePtr& from, const OpStatePtr& to);
   // forward storage type inference
   bool ForwardStorageType(
       const nnvm::NodeAttrs& attrs,
@@ -160,7 +179,8 @@ class CachedOp {
   OpStatePtr StaticForward(
       const Context& default_ctx,
       const std::vector<NDArray*>& inputs,
-      const std::vector<NDArray*>& outputs);
+      const std::vector<NDArray*>& outputs,
+      const OpStatePtr& given_state);
   void StaticBackward(
       const bool retain_graph,
       const OpStatePtr& state_ptr,
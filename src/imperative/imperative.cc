@@ -42,7 +42,8 @@ OpStatePtr Imperative::InvokeOp(
     const std::vector<NDArray*>& outputs,
     const std::vector<OpReqType>& req,
     const DispatchMode dispatch_mode,
-    OpStatePtr state) {
+    OpStatePtr state,
+    const std::vector<ResourceRequest>* resource_reqs) {
   using namespace imperative;
   static auto& createop = nnvm::Op::GetAttr<FCreateOpState>("FCreateOpState");
   static auto& is_layer_backward = Op::GetAttr<bool>("TIsLayerOpBackward");
@@ -54,7 +55,7 @@ OpStatePtr Imperative::InvokeOp(
   std::vector<Resource> requested;
   std::vector<uint32_t> mutate_idx;
   SetDependency(attrs, ctx, inputs, outputs,
-      &read_vars, &write_vars, &requested, &mutate_idx, dispatch_mode);
+      &read_vars, &write_vars, &requested, &mutate_idx, dispatch_mode, resource_reqs);
 
   FCompute fn = common::GetFCompute<FCompute>(op, "FCompute", ctx);
   FComputeEx fn_ex = common::GetFCompute<FComputeEx>(op, "FComputeEx", ctx);
@@ -92,6 +93,12 @@ OpStatePtr Imperative::Invoke(
   using namespace imperative;
   static auto& ndfunc = nnvm::Op::GetAttr<FNDArrayFunction>("FNDArrayFunction");
 
+  // Only operators that write fresh arrays are deferred, so a pending graph
+  // never overwrites an array that is visible to the caller.
+  bool lazy = is_lazy_ && !is_recording_ && !ndfunc.count(attrs.op);
+  for (const auto* arr : outputs) lazy = lazy && arr->is_none();
+  if (is_lazy_ && !lazy) FlushLazy();
+
   if (ndfunc.count(attrs.op)) {
     std::vector<NDArray> p_inputs, p_outputs;
     DerefInputOutput(inputs, outputs, &p_inputs, &p_outputs);
@@ -103,11 +110,16 @@ OpStatePtr Imperative::Invoke(
   // TODO(piiswrong): infer ctx
   DispatchMode dispatch_mode = DispatchMode::kUndefined;
   Context ctx = GetContext(attrs, inputs, outputs, default_ctx);
-  SetShapeType(ctx, attrs, inputs, outputs, &dispatch_mode);
+  const DispatchCacheEntry* cached =
+      SetShapeTypeCached(ctx, attrs, inputs, outputs, &dispatch_mode);
+  if (lazy && RecordLazy(ctx, attrs, inputs, outputs, dispatch_mode)) {
+    return OpStatePtr();
+  }
   std::vector<OpReqType> req;
   SetWriteInplaceReq(inputs, outputs, &req);
 
-  return InvokeOp(ctx, attrs, inputs, outputs, req, dispatch_mode);
+  return InvokeOp(ctx, attrs, inputs, outputs, req, dispatch_mode, OpStatePtr(),
+                  cached ? &cached->resource_reqs : nullptr);
 }
 
 void Imperative::MarkVariables(
@@ -20,11 +20,13 @@
 #include <mxnet/executor.h>
 #include <mxnet/imperative.h>
 #include <nnvm/pass_functions.h>
+#include <dmlc/common.h>
 #include <utility>
 #include <algorithm>
 #include <vector>
 #include <map>
 #include <string>
+#include <unordered_map>
 #include "../executor/graph_executor.h"
 #include "../executor/exec_pass.h"
 #include "../c_api/c_api_common.h"
@@ -196,45 +198,27 @@ inline void SetShapeType(const Context& ctx,
   }
 }
 
-inline void SetDependency(const nnvm::NodeAttrs& attrs,
-                   const Context& ctx,
-                   const std::vector<NDArray*>& inputs,
-                   const std::vector<NDArray*>& outputs,
-                   std::vector<engine::VarHandle> *p_read_vars,
-                   std::vector<engine::VarHandle> *p_write_vars,
-                   std::vector<Resource> *p_requested,
-                   std::vector<uint32_t> *p_mutate_idx,
-                   const DispatchMode dispatch_mode) {
-  static auto& fmutate = nnvm::Op::GetAttr<nnvm::FMutateInputs>("FMutateInputs");
+// Get the resources requested by an operator, including the ones for storage fallback
+inline std::vector<ResourceRequest> GetResourceRequests(const nnvm::NodeAttrs& attrs,
+                                                        const Context& ctx,
+                                                        const DispatchMode dispatch_mode) {
   static auto& ftmp_resource = nnvm::Op::GetAttr<FResourceRequest>("FResourceRequest");
   static auto& ftmp_resource_ex = nnvm::Op::GetAttr<FResourceRequestEx>("FResourceRequestEx");
 
-  std::vector<engine::VarHandle>& read_vars  = *p_read_vars;
-  std::vector<engine::VarHandle>& write_vars = *p_write_vars;
-  std::vector<Resource>& requested = *p_requested;
-  std::vector<uint32_t>& mutate_idx = *p_mutate_idx;
-
-  if (fmutate.count(attrs.op)) {
-    mutate_idx = fmutate[attrs.op](attrs);
-  }
+  std::vector<ResourceRequest> resource_reqs;
   const bool rsc_req = (ftmp_resource.count(attrs.op) != 0);
   const bool rsc_ex_req = (ftmp_resource_ex.count(attrs.op) != 0);
   if (rsc_req || rsc_ex_req) {
     int ntmp = 0;
-    auto resource_reqs = rsc_ex_req ? ftmp_resource_ex[attrs.op](attrs,
-                                          static_cast<int>(ctx.dev_mask()), dispatch_mode)
-                                    : ftmp_resource[attrs.op](attrs);
+    resource_reqs = rsc_ex_req ? ftmp_resource_ex[attrs.op](attrs,
+                                     static_cast<int>(ctx.dev_mask()), dispatch_mode)
+                               : ftmp_resource[attrs.op](attrs);
     for (const auto& req : resource_reqs) {
       switch (req.type) {
        case ResourceRequest::kTempSpace:
         ++ntmp;
        case ResourceRequest::kRandom:
-        requested.push_back(ResourceManager::Get()->Request(ctx, req));
-        write_vars.push_back(requested.back().var);
-        break;
        case ResourceRequest::kParallelRandom:
-        requested.push_back(ResourceManager::Get()->Request(ctx, req));
-        write_vars.push_back(requested.back().var);
         break;
        default:
         LOG(FATAL) << "resource type not yet supported";
@@ -245,8 +229,164 @@ inline void SetDependency(const nnvm::NodeAttrs& attrs,
 
   // append extra resource requests for storage fallback
   if (dispatch_mode == DispatchMode::kFComputeFallback) {
-    requested.push_back(ResourceManager::Get()->Request(ctx, ResourceRequest::kTempSpace));
-    write_vars.push_back(requested.back().var);
+    resource_reqs.push_back(ResourceRequest::kTempSpace);
+  }
+  return resource_reqs;
+}
+
+/*!
+ * \brief The attributes inferred for an imperative operator call, which are
+ *  reused by the following calls with the same operator, attributes, context
+ *  and signatures of the inputs and outputs.
+ */
+struct DispatchCacheEntry {
+  const nnvm::Op* op;
+  std::unordered_map<std::string, std::string> dict;
+  std::vector<int64_t> signature;
+  std::vector<TShape> in_shapes;
+  std::vector<int> in_types;
+  std::vector<TShape> out_shapes;
+  std::vector<int> out_types;
+  std::vector<int> out_storage_types;
+  DispatchMode dispatch_mode;
+  std::vector<ResourceRequest> resource_reqs;
+};
+
+/*! \brief Per-thread cache of the attributes inferred for imperative operator calls. */
+struct DispatchCache {
+  std::unordered_multimap<size_t, DispatchCacheEntry> entries;
+  // The signature of the current call, kept to avoid allocations.
+  std::vector<int64_t> signature;
+};
+typedef dmlc::ThreadLocalStore<DispatchCache> DispatchCacheStore;
+
+// Encode the context and the shapes, types and storage types of the arrays of a call.
+inline void GetDispatchSignature(const Context& ctx,
+                                 const std::vector<NDArray*>& inputs,
+                                 const std::vector<NDArray*>& outputs,
+                                 std::vector<int64_t>* signature) {
+  signature->clear();
+  signature->push_back(ctx.dev_type);
+  signature->push_back(ctx.dev_id);
+  for (const auto* arrays : {&inputs, &outputs}) {
+    signature->push_back(arrays->size());
+    for (const NDArray* arr : *arrays) {
+      if (arr->is_none()) {
+        signature->push_back(-1);
+        continue;
+      }
+      const TShape& shape = arr->shape();
+      signature->push_back(shape.ndim());
+      signature->insert(signature->end(), shape.begin(), shape.end());
+      signature->push_back(arr->dtype());
+      signature->push_back(arr->storage_type());
+    }
+  }
+}
+
+inline size_t HashDispatchKey(const nnvm::NodeAttrs& attrs,
+                              const std::vector<int64_t>& signature) {
+  std::hash<std::string> hash_str;
+  size_t ret = std::hash<const nnvm::Op*>()(attrs.op);
+  // The order of the attributes in the dict doesn't matter.
+  size_t dict_hash = 0;
+  for (const auto& kv : attrs.dict) {
+    dict_hash += hash_str(kv.first) * 31 + hash_str(kv.second);
+  }
+  ret = dmlc::HashCombine(ret, dict_hash);
+  for (const int64_t v : signature) ret = dmlc::HashCombine(ret, v);
+  return ret;
+}
+
+/*!
+ * \brief Set the shape, dtype, storage type and dispatch mode like SetShapeType.
+ *  The inferred attributes are cached, so that the following calls with the same
+ *  operator, attributes, context and signatures skip the inference.
+ * \return the cache entry of the call, or nullptr if the cache is disabled.
+ */
+inline const DispatchCacheEntry* SetShapeTypeCached(const Context& ctx,
+                                                    const nnvm::NodeAttrs& attrs,
+                                                    const std::vector<NDArray*>& inputs,
+                                                    const std::vector<NDArray*>& outputs,
+                                                    DispatchMode* dispatch_mode) {
+  static const size_t cache_size = dmlc::GetEnv("MXNET_IMPERATIVE_DISPATCH_CACHE_SIZE", 4096);
+  if (cache_size == 0) {
+    SetShapeType(ctx, attrs, inputs, outputs, dispatch_mode);
+    return nullptr;
+  }
+  DispatchCache* cache = DispatchCacheStore::Get();
+  GetDispatchSignature(ctx, inputs, outputs, &cache->signature);
+  const size_t key = HashDispatchKey(attrs, cache->signature);
+  MXAPIThreadLocalEntry *ret = MXAPIThreadLocalStore::Get();
+
+  auto range = cache->entries.equal_range(key);
+  for (auto it = range.first; it != range.second; ++it) {
+    const DispatchCacheEntry& entry = it->second;
+    if (entry.op != attrs.op || entry.signature != cache->signature ||
+        entry.dict != attrs.dict) continue;
+    // The input attributes are used to create the operator state.
+    ret->arg_shapes = entry.in_shapes;
+    ret->arg_types = entry.in_types;
+    *dispatch_mode = entry.dispatch_mode;
+    for (size_t i = 0; i < outputs.size(); ++i) {
+      if (!outputs[i]->is_none()) continue;
+      NDArrayStorageType storage_type =
+          static_cast<NDArrayStorageType>(entry.out_storage_types[i]);
+      if (storage_type == kDefaultStorage) {
+        *outputs[i] = NDArray(entry.out_shapes[i], ctx, true, entry.out_types[i]);
+      } else {
+        *outputs[i] = NDArray(storage_type, entry.out_shapes[i], ctx, true, entry.out_types[i]);
+      }
+    }
+    return &entry;
+  }
+
+  SetShapeType(ctx, attrs, inputs, outputs, dispatch_mode);
+  if (cache->entries.size() >= cache_size) cache->entries.clear();
+  DispatchCacheEntry entry;
+  entry.op = attrs.op;
+  entry.dict = attrs.dict;
+  entry.signature = cache->signature;
+  entry.in_shapes = ret->arg_shapes;
+  entry.in_types = ret->arg_types;
+  entry.out_shapes = ret->out_shapes;
+  entry.out_types = ret->out_types;
+  entry.out_storage_types = ret->out_storage_types;
+  entry.dispatch_mode = *dispatch_mode;
+  entry.resource_reqs = GetResourceRequests(attrs, ctx, *dispatch_mode);
+  return &cache->entries.emplace(key, std::move(entry))->second;
+}
+
+inline void SetDependency(const nnvm::NodeAttrs& attrs,
+                   const Context& ctx,
+                   const std::vector<NDArray*>& inputs,
+                   const std::vector<NDArray*>& outputs,
+                   std::vector<engine::VarHandle> *p_read_vars,
+                   std::vector<engine::VarHandle> *p_write_vars,
+                   std::vector<Resource> *p_requested,
+                   std::vector<uint32_t> *p_mutate_idx,
+                   const DispatchMode dispatch_mode,
+                   const std::vector<ResourceRequest>* resource_reqs = nullptr) {
+  static auto& fmutate = nnvm::Op::GetAttr<nnvm::FMutateInputs>("FMutateInputs");
+
+  std::vector<engine::VarHandle>& read_vars  = *p_read_vars;
+  std::vector<engine::VarHandle>& write_vars = *p_write_vars;
+  std::vector<Resource>& requested = *p_requested;
+  std::vector<uint32_t>& mutate_idx = *p_mutate_idx;
+
+  if (fmutate.count(attrs.op)) {
+    mutate_idx = fmutate[attrs.op](attrs);
+  }
+  if (resource_reqs != nullptr) {
+    for (const auto& req : *resource_reqs) {
+      requested.push_back(ResourceManager::Get()->Request(ctx, req));
+      write_vars.push_back(requested.back().var);
+    }
+  } else {
+    for (const auto& req : GetResourceRequests(attrs, ctx, dispatch_mode)) {
+      requested.push_back(ResourceManager::Get()->Request(ctx, req));
+      write_vars.push_back(requested.back().var);
+    }
   }
 
   read_vars.reserve(inputs.size());
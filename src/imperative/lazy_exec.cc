@@ -0,0 +1,347 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file lazy_exec.cc
+ * \brief Lazy imperative execution. Operators invoked while lazy execution is
+ *  on are recorded into a per-thread pending graph instead of being pushed to
+ *  the engine. The pending graph is run as a single static_alloc CachedOp when
+ *  one of its outputs is needed outside of Invoke.
+ */
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+#include "./imperative_utils.h"
+#include "./cached_op.h"
+#include "../operator/subgraph/subgraph_property.h"
+
+namespace mxnet {
+#if DMLC_CXX11_THREAD_LOCAL
+thread_local bool Imperative::is_lazy_ = false;
+#else
+MX_THREAD_LOCAL bool Imperative::is_lazy_ = false;
+#endif
+
+namespace {
+
+/*! \brief an operator deferred by lazy execution. */
+struct LazyOp {
+  nnvm::NodeAttrs attrs;
+  DispatchMode dispatch_mode;
+  std::vector<NDArray> inputs;
+  std::vector<NDArray> outputs;
+};
+
+/*! \brief a CachedOp built from a pending graph. */
+struct LazyCachedOp {
+  std::shared_ptr<CachedOp> op;
+  /*! \brief index of the external input bound to each input of op */
+  std::vector<size_t> input_order;
+};
+
+/*! \brief the pending graph of a thread. */
+struct LazyGraph {
+  Context ctx;
+  bool is_train = false;
+  std::vector<LazyOp> ops;
+  /*! \brief (op index, output index) of the pending outputs of each engine variable */
+  std::unordered_map<Engine::VarHandle,
+                     std::vector<std::pair<uint32_t, uint32_t> > > produced;
+  /*! \brief CachedOps of previously seen pending graphs */
+  std::unordered_map<std::string, LazyCachedOp> cache;
+};
+
+typedef dmlc::ThreadLocalStore<LazyGraph> LazyGraphStore;
+
+// Find the pending output that arr refers to. Returns false when arr is not
+// written by a pending op. Sets *overlap when arr shares memory with a pending
+// output without being the same array, e.g. a slice of it.
+bool FindProducer(const LazyGraph& lg, const NDArray& arr,
+                  std::pair<uint32_t, uint32_t>* producer, bool* overlap) {
+  auto it = lg.produced.find(arr.var());
+  if (it == lg.produced.end()) return false;
+  for (const auto& p : it->second) {
+    if (lg.ops[p.first].outputs[p.second].IsSame(arr)) {
+      *producer = p;
+      return true;
+    }
+  }
+  *overlap = true;
+  return false;
+}
+
+// The index of the external input bound to each input variable of sym,
+// in the order in which a CachedOp created from sym takes its inputs.
+std::vector<size_t> LazyInputOrder(const nnvm::Symbol& sym) {
+  nnvm::Graph g;
+  g.outputs = sym.outputs;
+  const auto& idx = g.indexed_graph();
+  std::vector<size_t> order;
+  for (auto nid : idx.input_nodes()) {
+    order.push_back(std::stoul(idx[nid].source->attrs.name.substr(7)));
+  }
+  return order;
+}
+
+// Partition the pending graph with the subgraph backend named by
+// MXNET_SUBGRAPH_BACKEND so that fusing backends apply to lazy graphs as well.
+nnvm::Symbol PartitionLazyGraph(const nnvm::Symbol& sym,
+                                const std::string& backend,
+                                const Context& ctx,
+                                const std::vector<NDArray>& ext_inputs) {
+  using namespace imperative;
+  nnvm::Graph g;
+  g.outputs = sym.outputs;
+  const auto& idx = g.indexed_graph();
+  nnvm::ShapeVector shapes;
+  nnvm::DTypeVector dtypes;
+  StorageTypeVector stypes;
+  for (size_t k : LazyInputOrder(sym)) {
+    shapes.push_back(ext_inputs[k].shape());
+    dtypes.push_back(ext_inputs[k].dtype());
+    stypes.push_back(ext_inputs[k].storage_type());
+  }
+  CheckAndInferShape(&g, std::move(shapes), true);
+  CheckAndInferType(&g, std::move(dtypes), true);
+  exec::DevMaskVector dev_mask(idx.num_nodes(), ctx.dev_mask());
+  CheckAndInferStorageType(&g, std::move(dev_mask), std::move(stypes), true);
+
+  auto prop = op::SubgraphPropertyRegistry::Get()->CreateSubgraphProperty(backend);
+  prop->SetAttr("graph", g);
+  g.attrs["subgraph_property"] = std::make_shared<nnvm::any>(std::move(prop));
+  g = nnvm::ApplyPass(std::move(g), "PartitionGraph");
+  nnvm::Symbol ret;
+  ret.outputs = g.outputs;
+  return ret;
+}
+
+}  // namespace
+
+bool Imperative::RecordLazy(const Context& ctx,
+                            const nnvm::NodeAttrs& attrs,
+                            const std::vector<NDArray*>& inputs,
+                            const std::vector<NDArray*>& outputs,
+                            const DispatchMode dispatch_mode) {
+  static auto& createop = nnvm::Op::GetAttr<FCreateOpState>("FCreateOpState");
+  static auto& mutate = nnvm::Op::GetAttr<nnvm::FMutateInputs>("FMutateInputs");
+  static auto& exec_type = nnvm::Op::GetAttr<FExecType>("FExecType");
+  static const size_t max_nodes =
+      dmlc::GetEnv("MXNET_IMPERATIVE_LAZY_MAX_NODES", static_cast<size_t>(256));
+  const nnvm::Op* op = attrs.op;
+  LazyGraph* lg = LazyGraphStore::Get();
+
+  bool eligible = (dispatch_mode == DispatchMode::kFCompute ||
+                   dispatch_mode == DispatchMode::kFComputeEx) &&
+                  !createop.count(op) && !mutate.count(op) &&
+                  (!exec_type.count(op) || exec_type[op](attrs) == ExecType::kSync);
+  for (const auto* arr : inputs) {
+    eligible = eligible && arr->storage_type() == kDefaultStorage;
+  }
+  for (const auto* arr : outputs) {
+    eligible = eligible && arr->storage_type() == kDefaultStorage;
+  }
+  if (!eligible) {
+    FlushLazy();
+    return false;
+  }
+
+  if (lg->ops.size() && (lg->ctx != ctx || lg->is_train != is_train_)) FlushLazy();
+  // Reading memory that a pending op writes only partially through another
+  // array can not be expressed as a graph edge; run the pending ops first.
+  for (const auto* arr : inputs) {
+    std::pair<uint32_t, uint32_t> producer;
+    bool overlap = false;
+    if (!FindProducer(*lg, *arr, &producer, &overlap) && overlap) {
+      FlushLazy();
+      break;
+    }
+  }
+
+  if (lg->ops.empty()) {
+    lg->ctx = ctx;
+    lg->is_train = is_train_;
+  }
+  uint32_t op_idx = lg->ops.size();
+  lg->ops.emplace_back();
+  LazyOp& rec = lg->ops.back();
+  rec.attrs = attrs;
+  rec.dispatch_mode = dispatch_mode;
+  for (const auto* arr : inputs) rec.inputs.push_back(*arr);
+  for (uint32_t i = 0; i < outputs.size(); ++i) {
+    rec.outputs.push_back(*outputs[i]);
+    lg->produced[outputs[i]->var()].emplace_back(op_idx, i);
+  }
+
+  if (lg->ops.size() >= max_nodes) FlushLazy();
+  return true;
+}
+
+void Imperative::RunLazy() {
+  using namespace nnvm;
+  using namespace imperative;
+  static const size_t max_cached = dmlc::GetEnv("MXNET_IMPERATIVE_LAZY_CACHE_SIZE",
+                                                static_cast<size_t>(64));
+  static const std::string backend = dmlc::GetEnv("MXNET_SUBGRAPH_BACKEND", std::string());
+  LazyGraph* lg = LazyGraphStore::Get();
+  if (lg->ops.empty()) return;
+
+  std::vector<LazyOp> ops;
+  ops.swap(lg->ops);
+  lg->produced.clear();
+  const Context ctx = lg->ctx;
+  bool prev_lazy = is_lazy_;
+  bool prev_train = is_train_;
+  is_lazy_ = false;
+  is_train_ = lg->is_train;
+
+  // An output is live when an array outside of the pending graph refers to it.
+  std::unordered_map<const NDArray::Chunk*, size_t> pending_refs;
+  for (const auto& rec : ops) {
+    for (const auto& arr : rec.inputs) ++pending_refs[arr.ptr_.get()];
+    for (const auto& arr : rec.outputs) ++pending_refs[arr.ptr_.get()];
+  }
+  std::vector<std::vector<bool> > live(ops.size());
+  for (size_t i = 0; i < ops.size(); ++i) {
+    for (const auto& arr : ops[i].outputs) {
+      live[i].push_back(static_cast<size_t>(arr.ptr_.use_count()) >
+                        pending_refs[arr.ptr_.get()]);
+    }
+  }
+
+  // Link inputs to the pending outputs that produce them.
+  std::unordered_map<Engine::VarHandle, std::vector<std::pair<uint32_t, uint32_t> > > produced;
+  std::vector<std::vector<std::pair<int, uint32_t> > > links(ops.size());
+  for (uint32_t i = 0; i < ops.size(); ++i) {
+    for (const auto& arr : ops[i].inputs) {
+      std::pair<int, uint32_t> link(-1, 0);
+      auto it = produced.find(arr.var());
+      if (it != produced.end()) {
+        for (const auto& p : it->second) {
+          if (ops[p.first].outputs[p.second].IsSame(arr)) link = p;
+        }
+      }
+      links[i].push_back(link);
+    }
+    for (uint32_t j = 0; j < ops[i].outputs.size(); ++j) {
+      produced[ops[i].outputs[j].var()].emplace_back(i, j);
+    }
+  }
+
+  // Dead code elimination.
+  std::vector<bool> needed(ops.size(), false);
+  for (size_t i = ops.size(); i-- > 0;) {
+    needed[i] = needed[i] ||
+        std::find(live[i].begin(), live[i].end(), true) != live[i].end();
+    if (!needed[i]) continue;
+    for (const auto& l : links[i]) {
+      if (l.first >= 0) needed[l.first] = true;
+    }
+  }
+
+  size_t num_needed = std::count(needed.begin(), needed.end(), true);
+  std::vector<NDArray> ext_inputs;
+  std::vector<NodePtr> nodes(ops.size());
+  std::vector<NodePtr> ext_vars;
+  Symbol sym;
+  std::vector<NDArray*> outputs;
+  std::ostringstream key;
+  key << ctx.dev_type << ':' << ctx.dev_id << ':' << is_train_ << ';';
+  for (size_t i = 0; i < ops.size(); ++i) {
+    if (!needed[i]) continue;
+    LazyOp& rec = ops[i];
+    nodes[i] = Node::Create();
+    nodes[i]->attrs = rec.attrs;
+    if (nodes[i]->attrs.name.empty()) {
+      nodes[i]->attrs.name = rec.attrs.op->name + std::to_string(i);
+    }
+    key << rec.attrs.op->name << '(';
+    std::map<std::string, std::string> dict(rec.attrs.dict.begin(), rec.attrs.dict.end());
+    for (const auto& kv : dict) key << kv.first << '=' << kv.second << ',';
+    key << ')';
+    for (size_t j = 0; j < rec.inputs.size(); ++j) {
+      const auto& l = links[i][j];
+      if (l.first >= 0) {
+        nodes[i]->inputs.emplace_back(NodeEntry{nodes[l.first], l.second, 0});
+        key << 'n' << l.first << ':' << l.second << ',';
+        continue;
+      }
+      size_t k = 0;
+      while (k < ext_inputs.size() && !ext_inputs[k].IsSame(rec.inputs[j])) ++k;
+      if (k == ext_inputs.size()) {
+        ext_inputs.push_back(rec.inputs[j]);
+        ext_vars.push_back(
+            Symbol::CreateVariable("lazy_in" + std::to_string(k)).outputs[0].node);
+      }
+      nodes[i]->inputs.emplace_back(NodeEntry{ext_vars[k], 0, 0});
+      key << 'e' << k << ',';
+    }
+    for (size_t j = 0; j < rec.outputs.size(); ++j) {
+      if (!live[i][j]) continue;
+      sym.outputs.emplace_back(NodeEntry{nodes[i], static_cast<uint32_t>(j), 0});
+      outputs.push_back(&rec.outputs[j]);
+      key << 'o' << j;
+    }
+    key << ';';
+  }
+
+  try {
+    if (outputs.empty()) {
+      // Every pending result was dropped.
+    } else if (ext_inputs.empty() || num_needed == 1) {
+      // CachedOp needs an input, and a single op gains nothing from a graph.
+      for (size_t i = 0; i < ops.size(); ++i) {
+        if (!needed[i]) continue;
+        std::vector<NDArray*> in_ptrs, out_ptrs;
+        for (auto& arr : ops[i].inputs) in_ptrs.push_back(&arr);
+        for (auto& arr : ops[i].outputs) out_ptrs.push_back(&arr);
+        std::vector<OpReqType> req(out_ptrs.size(), kWriteTo);
+        InvokeOp(ctx, ops[i].attrs, in_ptrs, out_ptrs, req, ops[i].dispatch_mode);
+      }
+    } else {
+      for (const auto& arr : ext_inputs) key << 'i' << arr.shape() << arr.dtype();
+      auto it = lg->cache.find(key.str());
+      if (it == lg->cache.end()) {
+        // Subgraph backends may fold operators in ways that are only valid
+        // for inference, e.g. batch norm with its moving statistics.
+        if (backend.size() && !lg->is_train) {
+          sym = PartitionLazyGraph(sym, backend, ctx, ext_inputs);
+        }
+        if (lg->cache.size() >= max_cached) lg->cache.clear();
+        LazyCachedOp entry;
+        entry.op = std::make_shared<CachedOp>(
+            sym, std::vector<std::pair<std::string, std::string> >{{"static_alloc", "true"}});
+        entry.input_order = LazyInputOrder(sym);
+        it = lg->cache.emplace(key.str(), std::move(entry)).first;
+      }
+      std::vector<NDArray*> inputs;
+      for (size_t k : it->second.input_order) inputs.push_back(&ext_inputs[k]);
+      it->second.op->Forward(it->second.op, inputs, outputs);
+    }
+  } catch (...) {
+    is_train_ = prev_train;
+    is_lazy_ = prev_lazy;
+    throw;
+  }
+
+  is_train_ = prev_train;
+  is_lazy_ = prev_lazy;
+}
+
+}  // namespace mxnet
@@ -582,6 +582,43 @@ void NDArray::Reorder2DefaultAsync() {
     FnProperty::kNormal, 0, "Reorder2Default");
 }
 
+const mkldnn::memory *NDArray::GetMKLDNNDataCopy(
+    const mkldnn::memory::primitive_desc &default_desc,
+    const mkldnn::memory::primitive_desc &desc) const {
+  CHECK(!IsView()) << "Cannot copy a view of an array to a MKLDNN format";
+  // The version of the data can't change while an operator reads it, so a
+  // copy returned here stays valid until the operator is done.
+  const size_t ver = version();
+  auto &copies = ptr_->mkl_copies_;
+  const mkldnn::memory *mem = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(ptr_->mkl_copies_mutex_);
+    for (const auto &copy : copies) {
+      if (copy.first == ver && copy.second->get_primitive_desc() == desc)
+        return copy.second.get();
+    }
+    mem = GetMKLDNNData(default_desc);
+    if (mem == nullptr) mem = GetMKLDNNData();
+  }
+  // The reorder runs without the lock, so that the other readers of the array
+  // still find the copies that are already made.
+  auto copy = std::make_shared<mkldnn::memory>(desc);
+  std::vector<mkldnn::primitive> net(1, mkldnn::reorder(*mem, *copy));
+  mkldnn::stream(mkldnn::stream::kind::eager).submit(net).wait();
+  std::lock_guard<std::mutex> lock(ptr_->mkl_copies_mutex_);
+  // The copies of older versions of the data are not read anymore.
+  copies.erase(std::remove_if(copies.begin(), copies.end(),
+      [ver](const std::pair<size_t, std::shared_ptr<mkldnn::memory>> &copy) {
+        return copy.first != ver;
+      }), copies.end());
+  // Another reader may have made the same copy meanwhile.
+  for (const auto &c : copies) {
+    if (c.second->get_primitive_desc() == desc) return c.second.get();
+  }
+  copies.emplace_back(ver, copy);
+  return copy.get();
+}
+
 void NDArray::MKLDNNDataReorderAsync(const mkldnn::memory::primitive_desc &desc) {
   std::vector<Engine::VarHandle> const_vars;
   std::vector<Engine::VarHandle> mutable_vars(1, this->var());
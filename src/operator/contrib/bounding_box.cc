@@ -33,6 +33,214 @@ DMLC_REGISTER_PARAMETER(BoxNMSParam);
 DMLC_REGISTER_PARAMETER(BoxOverlapParam);
 DMLC_REGISTER_PARAMETER(BipartiteMatchingParam);
 
+/*!
+ * \brief Greedy suppression of the candidates [begin, end), sorted by descending score.
+ *  Corner coordinates and areas are stored as separate arrays so that the overlaps of a
+ *  reference box with all the following ones are computed in one vectorizable loop.
+ *  keep[j] is cleared for every suppressed candidate.
+ */
+template<typename DType>
+static void SuppressSortedBoxes(const DType *x1, const DType *y1,
+                                const DType *x2, const DType *y2, const DType *area,
+                                int32_t *keep, int begin, int end, float thresh) {
+  for (int i = begin; i < end; ++i) {
+    if (!keep[i]) continue;
+    const DType ix1 = x1[i], iy1 = y1[i], ix2 = x2[i], iy2 = y2[i], iarea = area[i];
+    for (int j = i + 1; j < end; ++j) {
+      DType w = (ix2 < x2[j] ? ix2 : x2[j]) - (ix1 > x1[j] ? ix1 : x1[j]);
+      DType h = (iy2 < y2[j] ? iy2 : y2[j]) - (iy1 > y1[j] ? iy1 : y1[j]);
+      w = w > DType(0) ? w : DType(0);
+      h = h > DType(0) ? h : DType(0);
+      const DType intersect = w * h;
+      keep[j] &= !(intersect / (iarea + area[j] - intersect) > thresh);
+    }
+  }
+}
+
+/*!
+ * \brief cpu box nms. Every batch is filtered and only its topk best candidates are
+ *  sorted, instead of sorting all the boxes of all batches together. The suppression then
+ *  runs in parallel over batches and, unless force_suppress is set, over the classes of
+ *  each batch, since boxes of different classes never suppress each other.
+ */
+template<typename DType>
+static void BoxNMSForwardCPUImpl(const BoxNMSParam& param,
+                                 const OpContext& ctx,
+                                 const OpReqType req,
+                                 const int num_batch,
+                                 const int num_elem,
+                                 const int width_elem,
+                                 mshadow::Tensor<cpu, 1, DType> data,
+                                 mshadow::Tensor<cpu, 1, DType> out,
+                                 mshadow::Tensor<cpu, 1, DType> record) {
+  using namespace mshadow;
+  using namespace mshadow::expr;
+  Stream<cpu> *s = ctx.get_stream<cpu>();
+  const int coord_start = param.coord_start;
+  const int score_index = param.score_index;
+  const int id_index = param.id_index;
+  const bool per_class = !param.force_suppress && id_index >= 0;
+  const int topk = param.topk < 0? num_elem : std::min(num_elem, param.topk);
+  const int total = num_batch * num_elem;
+  const int omp_threads = engine::OpenMP::Get()->GetRecommendedOMPThreadCount();
+  if (topk < 1) {
+    if (out.dptr_ != data.dptr_) Copy(out, data, s);
+    record = range<DType>(0, total);
+    return;
+  }
+
+  // int32 candidate index, class order, keep flag and class segment end per box,
+  // followed by the coordinates and areas of the candidates and a copy of the input
+  // when running in place
+  const index_t int32_offset = (total * 4 * sizeof(int32_t) - 1) / sizeof(DType) + 1;
+  index_t workspace_size = int32_offset + total * 5;
+  if (req == kWriteInplace) workspace_size += total * width_elem;
+  Tensor<cpu, 1, DType> workspace = ctx.requested[box_nms_enum::kTempSpace]
+    .get_space_typed<cpu, 1, DType>(Shape1(workspace_size), s);
+  int32_t *cand_all = reinterpret_cast<int32_t*>(workspace.dptr_);
+  int32_t *order_all = cand_all + total;
+  int32_t *keep = order_all + total;
+  int32_t *seg_end = keep + total;
+  DType *x1 = workspace.dptr_ + int32_offset;
+  DType *y1 = x1 + total;
+  DType *x2 = y1 + total;
+  DType *y2 = x2 + total;
+  DType *area = y2 + total;
+  const DType *buffer = data.dptr_;
+  if (req == kWriteInplace) {
+    DType *copy = area + total;
+    std::copy(data.dptr_, data.dptr_ + total * width_elem, copy);
+    buffer = copy;
+  }
+  std::vector<int> num_cand(num_batch), num_seg(num_batch);
+
+  // filter, select the topk candidates of each batch and split them by class
+  #pragma omp parallel for num_threads(omp_threads)
+  for (int b = 0; b < num_batch; ++b) {
+    const DType *in = buffer + b * num_elem * width_elem;
+    const int base = b * num_elem;
+    int32_t *cand = cand_all + base;
+    int32_t *order = order_all + base;
+    int n = 0;
+    for (int i = 0; i < num_elem; ++i) {
+      if (in[i * width_elem + score_index] > param.valid_thresh) cand[n++] = i;
+    }
+    // descending score, ties kept in input order
+    auto by_score = [in, width_elem, score_index](int32_t l, int32_t r) {
+      const DType sl = in[l * width_elem + score_index];
+      const DType sr = in[r * width_elem + score_index];
+      return sl > sr || (sl == sr && l < r);
+    };
+    const int k = std::min(n, topk);
+    if (k < n) std::nth_element(cand, cand + k, cand + n, by_score);
+    std::sort(cand, cand + k, by_score);
+    for (int g = 0; g < k; ++g) order[g] = g;
+    auto class_of = [in, width_elem, id_index](int32_t i) {
+      return static_cast<int>(in[i * width_elem + id_index]);
+    };
+    if (per_class) {
+      std::stable_sort(order, order + k, [cand, &class_of](int32_t l, int32_t r) {
+        return class_of(cand[l]) < class_of(cand[r]);
+      });
+    }
+    int segs = 0;
+    for (int g = 0; g < k; ++g) {
+      const DType *box = in + cand[order[g]] * width_elem + coord_start;
+      if (box_common_enum::kCorner == param.in_format) {
+        x1[base + g] = box[0];
+        y1[base + g] = box[1];
+        x2[base + g] = box[2];
+        y2[base + g] = box[3];
+      } else {
+        x1[base + g] = box[0] - box[2] / 2;
+        y1[base + g] = box[1] - box[3] / 2;
+        x2[base + g] = box[0] + box[2] / 2;
+        y2[base + g] = box[1] + box[3] / 2;
+      }
+      area[base + g] = BoxArea(box, param.in_format);
+      keep[base + g] = 1;
+      if (g + 1 == k ||
+          (per_class && class_of(cand[order[g]]) != class_of(cand[order[g + 1]]))) {
+        seg_end[base + segs++] = g + 1;
+      }
+    }
+    num_cand[b] = k;
+    num_seg[b] = segs;
+  }
+
+  // suppress within every (batch, class) segment
+  std::vector<std::pair<int, int> > segments;
+  for (int b = 0; b < num_batch; ++b) {
+    int begin = b * num_elem;
+    for (int i = 0; i < num_seg[b]; ++i) {
+      const int end = b * num_elem + seg_end[b * num_elem + i];
+      segments.emplace_back(begin, end);
+      begin = end;
+    }
+  }
+  const int num_segments = static_cast<int>(segments.size());
+  #pragma omp parallel for schedule(dynamic) num_threads(omp_threads)
+  for (int i = 0; i < num_segments; ++i) {
+    SuppressSortedBoxes(x1, y1, x2, y2, area, keep, segments[i].first, segments[i].second,
+                        param.overlap_thresh);
+  }
+
+  // gather the kept boxes in descending score order, keep a record for backward
+  #pragma omp parallel for num_threads(omp_threads)
+  for (int b = 0; b < num_batch; ++b) {
+    const int base = b * num_elem;
+    const DType *in = buffer + base * width_elem;
+    DType *out_b = out.dptr_ + base * width_elem;
+    DType *record_b = record.dptr_ + base;
+    int32_t *cand = cand_all + base;
+    const int32_t *order = order_all + base;
+    for (int g = 0; g < num_cand[b]; ++g) {
+      if (!keep[base + g]) cand[order[g]] = -1;
+    }
+    int count = 0;
+    for (int r = 0; r < num_cand[b]; ++r) {
+      if (cand[r] < 0) continue;
+      std::copy(in + cand[r] * width_elem, in + (cand[r] + 1) * width_elem,
+                out_b + count * width_elem);
+      record_b[count++] = base + cand[r];
+    }
+    std::fill(out_b + count * width_elem, out_b + num_elem * width_elem, DType(-1));
+    std::fill(record_b + count, record_b + num_elem, DType(-1));
+    if (param.in_format != param.out_format) {
+      for (int i = 0; i < count; ++i) {
+        if (box_common_enum::kCenter == param.out_format) {
+          corner_to_center::Map(i, out_b + coord_start, width_elem);
+        } else {
+          center_to_corner::Map(i, out_b + coord_start, width_elem);
+        }
+      }
+    }
+  }
+}
+
+static void BoxNMSForwardCPU(const nnvm::NodeAttrs& attrs,
+                             const OpContext& ctx,
+                             const std::vector<TBlob>& inputs,
+                             const std::vector<OpReqType>& req,
+                             const std::vector<TBlob>& outputs) {
+  using namespace mshadow;
+  CHECK_EQ(inputs.size(), 1U);
+  CHECK_EQ(outputs.size(), 2U) << "BoxNMS output: [output, temp]";
+  const BoxNMSParam& param = nnvm::get<BoxNMSParam>(attrs.parsed);
+  Stream<cpu> *s = ctx.get_stream<cpu>();
+  const TShape& in_shape = inputs[box_nms_enum::kData].shape_;
+  const int indim = in_shape.ndim();
+  const int num_batch = indim <= 2? 1 : in_shape.ProdShape(0, indim - 2);
+  const int num_elem = in_shape[indim - 2];
+  const int width_elem = in_shape[indim - 1];
+  MSHADOW_REAL_TYPE_SWITCH(outputs[0].type_flag_, DType, {
+    BoxNMSForwardCPUImpl<DType>(param, ctx, req[0], num_batch, num_elem, width_elem,
+                                inputs[box_nms_enum::kData].FlatTo1D<cpu, DType>(s),
+                                outputs[box_nms_enum::kOut].FlatTo1D<cpu, DType>(s),
+                                outputs[box_nms_enum::kTemp].FlatTo1D<cpu, DType>(s));
+  });
+}
+
 NNVM_REGISTER_OP(_contrib_box_nms)
 .add_alias("_contrib_box_non_maximum_suppression")
 .describe(R"code(Apply non-maximum suppression to input.
@@ -90,7 +298,7 @@ Examples::
   [](const NodeAttrs& attrs) {
     return std::vector<ResourceRequest>{ResourceRequest::kTempSpace};
   })
-.set_attr<FCompute>("FCompute<cpu>", BoxNMSForward<cpu>)
+.set_attr<FCompute>("FCompute<cpu>", BoxNMSForwardCPU)
 .set_attr<nnvm::FGradient>("FGradient", ElemwiseGradUseOut{"_backward_contrib_box_nms"})
 .add_argument("data", "NDArray-or-Symbol", "The input")
 .add_arguments(BoxNMSParam::__FIELDS__());
@@ -25,23 +25,10 @@
 */
 #include "./multibox_detection-inl.h"
 #include <algorithm>
+#include <utility>
+#include <vector>
 
 namespace mshadow {
-template<typename DType>
-struct SortElemDescend {
-  DType value;
-  int index;
-
-  SortElemDescend(DType v, int i) {
-    value = v;
-    index = i;
-  }
-
-  bool operator<(const SortElemDescend &other) const {
-    return value > other.value;
-  }
-};
-
 template<typename DType>
 inline void TransformLocations(DType *out, const DType *anchors,
                                const DType *loc_pred, const bool clip,
@@ -98,88 +85,107 @@ inline void MultiBoxDetectionForward(const Tensor<cpu, 3, DType> &out,
   const DType *p_anchor = anchors.dptr_;
 
   const int omp_threads = mxnet::engine::OpenMP::Get()->GetRecommendedOMPThreadCount();
-  std::vector<DType> outputs;
-  outputs.reserve(num_anchors * 6);
-  for (int nbatch = 0; nbatch < num_batches; ++nbatch) {
+  // decode the anchors of all batches to [id, prob, xmin, ymin, xmax, ymax] in temp_space
+#pragma omp parallel for num_threads(omp_threads)
+  for (int k = 0; k < num_batches * num_anchors; ++k) {
+    const int nbatch = k / num_anchors;
+    const int i = k % num_anchors;
     const DType *p_cls_prob = cls_prob.dptr_ + nbatch * num_classes * num_anchors;
     const DType *p_loc_pred = loc_pred.dptr_ + nbatch * num_anchors * 4;
-    DType *p_out = out.dptr_ + nbatch * num_anchors * 6;
-
-#pragma omp parallel for num_threads(omp_threads)
-    for (int i = 0; i < num_anchors; ++i) {
-      // find the predicted class id and probability
-      DType score = -1;
-      int id = 0;
-      for (int j = 1; j < num_classes; ++j) {
-        DType temp = p_cls_prob[j * num_anchors + i];
-        if (temp > score) {
-          score = temp;
-          id = j;
-        }
-      }
-
-      if (id > 0 && score < threshold) {
-        id = 0;
+    DType *p_temp = temp_space.dptr_ + k * 6;
+    // find the predicted class id and probability
+    DType score = -1;
+    int id = 0;
+    for (int j = 1; j < num_classes; ++j) {
+      DType temp = p_cls_prob[j * num_anchors + i];
+      if (temp > score) {
+        score = temp;
+        id = j;
       }
+    }
 
-      // [id, prob, xmin, ymin, xmax, ymax]
-      outputs[i * 6] = id - 1;
-      outputs[i * 6 + 1] = score;
-      int offset = i * 4;
-      TransformLocations(outputs.data() + i * 6 + 2, p_anchor + offset, p_loc_pred + offset, clip,
-                         variances[0], variances[1], variances[2], variances[3]);
+    if (id > 0 && score < threshold) {
+      id = 0;
     }
 
+    p_temp[0] = id - 1;
+    p_temp[1] = score;
+    int offset = i * 4;
+    TransformLocations(p_temp + 2, p_anchor + offset, p_loc_pred + offset, clip,
+                       variances[0], variances[1], variances[2], variances[3]);
+  }
+
+  // compact the valid detections of every batch, sort the nms_topk best ones by
+  // descending confidence and group their positions by class in rows
+  const bool apply_nms = nms_threshold > 0 && nms_threshold <= 1;
+  std::vector<int> rows(num_batches * num_anchors);
+  std::vector<std::vector<int> > groups(num_batches);
+#pragma omp parallel for num_threads(omp_threads)
+  for (int nbatch = 0; nbatch < num_batches; ++nbatch) {
+    const DType *ptemp = temp_space.dptr_ + nbatch * num_anchors * 6;
+    DType *p_out = out.dptr_ + nbatch * num_anchors * 6;
+    int *valid = rows.data() + nbatch * num_anchors;
     int valid_count = 0;
     for (int i = 0; i < num_anchors; ++i) {
-      int offset1 = valid_count * 6;
-      int offset2 = i * 6;
-      if (outputs[offset2] >= 0) {
-        p_out[offset1]     = outputs[offset2];
-        p_out[offset1 + 1] = outputs[offset2 + 1];
-        p_out[offset1 + 2] = outputs[offset2 + 2];
-        p_out[offset1 + 3] = outputs[offset2 + 3];
-        p_out[offset1 + 4] = outputs[offset2 + 4];
-        p_out[offset1 + 5] = outputs[offset2 + 5];
-        ++valid_count;
+      if (ptemp[i * 6] >= 0) {
+        std::copy(ptemp + i * 6, ptemp + (i + 1) * 6, p_out + valid_count * 6);
+        valid[valid_count++] = i;
       }
     }
-
-    if (valid_count < 1 || nms_threshold <= 0 || nms_threshold > 1) continue;
-
-    // sort and apply NMS
-    Copy(temp_space[nbatch], out[nbatch], out.stream_);
-    // sort confidence in descend order
-    std::vector<SortElemDescend<DType>> sorter;
-    sorter.reserve(valid_count);
-    for (int i = 0; i < valid_count; ++i) {
-      sorter.push_back(SortElemDescend<DType>(p_out[i * 6 + 1], i));
-    }
-    std::stable_sort(sorter.begin(), sorter.end());
-
-    // re-order output
-    DType *ptemp = temp_space.dptr_ + nbatch * num_anchors * 6;
-    int nkeep = static_cast<int>(sorter.size());
+    if (valid_count < 1 || !apply_nms) continue;
+
+    // descending confidence, ties kept in anchor order
+    auto by_score = [ptemp](int l, int r) {
+      return ptemp[l * 6 + 1] > ptemp[r * 6 + 1] ||
+             (ptemp[l * 6 + 1] == ptemp[r * 6 + 1] && l < r);
+    };
+    int nkeep = valid_count;
     if (nms_topk > 0 && nms_topk < nkeep) {
       // keep topk detections
       nkeep = nms_topk;
       for (int i = nkeep; i < valid_count; ++i) {
         p_out[i * 6] = -1;
       }
+      std::nth_element(valid, valid + nkeep, valid + valid_count, by_score);
+    }
+    std::sort(valid, valid + nkeep, by_score);
+    for (int i = 0; i < nkeep; ++i) {
+      std::copy(ptemp + valid[i] * 6, ptemp + (valid[i] + 1) * 6, p_out + i * 6);
+      valid[i] = i;
     }
+    if (!force_suppress) {
+      std::stable_sort(valid, valid + nkeep, [p_out](int l, int r) {
+        return p_out[l * 6] < p_out[r * 6];
+      });
+    }
+    std::vector<int> &ends = groups[nbatch];
     for (int i = 0; i < nkeep; ++i) {
-      for (int j = 0; j < 6; ++j) {
-        p_out[i * 6 + j] = ptemp[sorter[i].index * 6 + j];
+      if (i + 1 == nkeep || (!force_suppress && p_out[valid[i] * 6] != p_out[valid[i + 1] * 6])) {
+        ends.push_back(i + 1);
       }
     }
+  }
 
-    // apply nms
-#pragma omp parallel for num_threads(omp_threads)
-    for (int i = 0; i < nkeep; ++i) {
-      int offset_i = i * 6;
+  // apply nms greedily within every class of every batch, or every batch with
+  // force_suppress, in parallel
+  std::vector<std::pair<int, int> > tasks;
+  for (int nbatch = 0; nbatch < num_batches; ++nbatch) {
+    int begin = nbatch * num_anchors;
+    for (const int end : groups[nbatch]) {
+      tasks.emplace_back(begin, nbatch * num_anchors + end);
+      begin = nbatch * num_anchors + end;
+    }
+  }
+  const int num_tasks = static_cast<int>(tasks.size());
+#pragma omp parallel for schedule(dynamic) num_threads(omp_threads)
+  for (int t = 0; t < num_tasks; ++t) {
+    const int nbatch = tasks[t].first / num_anchors;
+    DType *p_out = out.dptr_ + nbatch * num_anchors * 6;
+    for (int i = tasks[t].first; i < tasks[t].second; ++i) {
+      int offset_i = rows[i] * 6;
       if (p_out[offset_i] < 0) continue;  // skip eliminated
-      for (int j = i + 1; j < nkeep; ++j) {
-        int offset_j = j * 6;
+      for (int j = i + 1; j < tasks[t].second; ++j) {
+        int offset_j = rows[j] * 6;
         if (p_out[offset_j] < 0) continue;  // skip eliminated
         if (force_suppress || (p_out[offset_i] == p_out[offset_j])) {
           // when foce_suppress == true or class_id equals
@@ -190,7 +196,7 @@ inline void MultiBoxDetectionForward(const Tensor<cpu, 3, DType> &out,
         }
       }
     }
-  }  // end iter batch
+  }
 }
 }  // namespace mshadow
 
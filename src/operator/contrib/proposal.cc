@@ -173,8 +173,9 @@ struct ReverseArgsortCompl {
   explicit ReverseArgsortCompl(float *val)
     : val_(val) {}
   bool operator() (float i, float j) {
-    return (val_[static_cast<index_t>(i)] >
-            val_[static_cast<index_t>(j)]);
+    const float vi = val_[static_cast<index_t>(i)];
+    const float vj = val_[static_cast<index_t>(j)];
+    return vi > vj || (vi == vj && i < j);
   }
 };
 
@@ -188,11 +189,18 @@ inline void CopyScore(const mshadow::Tensor<cpu, 2>& dets,
   }
 }
 
-// sort order array according to score
+// sort the top_n first entries of order array according to score, ties kept in index order
 inline void ReverseArgsort(const mshadow::Tensor<cpu, 1>& score,
+                           const index_t top_n,
                            mshadow::Tensor<cpu, 1> *order) {
   ReverseArgsortCompl cmpl(score.dptr_);
-  std::stable_sort(order->dptr_, order->dptr_ + score.size(0), cmpl);
+  float *first = order->dptr_;
+  float *last = order->dptr_ + score.size(0);
+  if (top_n < score.size(0)) {
+    std::nth_element(first, first + top_n, last, cmpl);
+    last = first + top_n;
+  }
+  std::sort(first, last, cmpl);
 }
 
 // reorder proposals according to order and keep the pre_nms_top_n proposals
@@ -244,21 +252,21 @@ inline void NonMaximumSuppression(const mshadow::Tensor<cpu, 2>& dets,
     }
 
     (*keep)[(*out_size)++] = i;
-    for (index_t j = i + 1; j < dets.size(0); j ++) {
-      if ((*suppressed)[j] > 0.0f) {
-        continue;
-      }
-      float xx1 = std::max(ix1, dets[j][0]);
-      float yy1 = std::max(iy1, dets[j][1]);
-      float xx2 = std::min(ix2, dets[j][2]);
-      float yy2 = std::min(iy2, dets[j][3]);
+    // suppressed boxes are compared again rather than skipped, to keep the loop branch free
+    const float *d = dets.dptr_;
+    const float *a = area->dptr_;
+    float *sup = suppressed->dptr_;
+    const int num_dets = static_cast<int>(dets.size(0));
+    for (int j = i + 1; j < num_dets; ++j) {
+      float xx1 = std::max(ix1, d[j * 5]);
+      float yy1 = std::max(iy1, d[j * 5 + 1]);
+      float xx2 = std::min(ix2, d[j * 5 + 2]);
+      float yy2 = std::min(iy2, d[j * 5 + 3]);
       float w = std::max(0.0f, xx2 - xx1 + 1.0f);
       float h = std::max(0.0f, yy2 - yy1 + 1.0f);
       float inter = w * h;
-      float ovr = inter / (iarea + (*area)[j] - inter);
-      if (ovr > thresh) {
-        (*suppressed)[j] = 1.0f;
-      }
+      float ovr = inter / (iarea + a[j] - inter);
+      sup[j] = ovr > thresh ? 1.0f : sup[j];
     }
   }
 }
@@ -380,6 +388,7 @@ class ProposalOp : public Operator{
                      &score,
                      &order);
     utils::ReverseArgsort(score,
+                          rpn_pre_nms_top_n,
                           &order);
     utils::ReorderProposals(workspace_proposals,
                             order,
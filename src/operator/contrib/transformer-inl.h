@@ -25,15 +25,160 @@
 #ifndef MXNET_OPERATOR_CONTRIB_TRANSFORMER_INL_H_
 #define MXNET_OPERATOR_CONTRIB_TRANSFORMER_INL_H_
 
+#include <dmlc/parameter.h>
 #include <mxnet/operator_util.h>
 #include <vector>
 #include "../mxnet_op.h"
 #include "../mshadow_op.h"
+#include "../operator_common.h"
 
 
 namespace mxnet {
 namespace op {
 
+namespace transformer {
+enum AttentionOutputs {kOut, kLogSumExp};
+}  // namespace transformer
+
+struct InterleavedMatMulParam : public dmlc::Parameter<InterleavedMatMulParam> {
+  int heads;
+  DMLC_DECLARE_PARAMETER(InterleavedMatMulParam) {
+    DMLC_DECLARE_FIELD(heads)
+    .describe("Set number of heads");
+  }
+};
+
+struct InterleavedAttentionParam : public dmlc::Parameter<InterleavedAttentionParam> {
+  int heads;
+  bool causal;
+  bool use_valid_length;
+  DMLC_DECLARE_PARAMETER(InterleavedAttentionParam) {
+    DMLC_DECLARE_FIELD(heads)
+    .describe("Set number of heads");
+    DMLC_DECLARE_FIELD(causal).set_default(false)
+    .describe("If set to True, the query at position i only attends to the keys at "
+              "positions up to i.");
+    DMLC_DECLARE_FIELD(use_valid_length).set_default(false)
+    .describe("If set to True, the number of keys attended to by each batch element is "
+              "given by the additional input valid_length.");
+  }
+};
+
+/*!
+ * \brief Check the shape of an array of shape (length, batch, heads * num_interleaved *
+ *  head_dim), the projections of each head being interleaved along the last axis.
+ */
+inline void CheckInterleavedShape(const TShape& shape, int heads, int num_interleaved,
+                                  const char* name) {
+  CHECK_EQ(shape.ndim(), 3U) << name << " must be of shape (length, batch, embedding)";
+  CHECK_EQ(shape[2] % (heads * num_interleaved), 0)
+    << "the last dimension of " << name << " must be a multiple of "
+    << heads * num_interleaved << ", got " << shape;
+}
+
+inline bool InterleavedMatMulSelfAttQKShape(const NodeAttrs& attrs,
+                                            std::vector<TShape>* in_shape,
+                                            std::vector<TShape>* out_shape) {
+  const auto& params = nnvm::get<InterleavedMatMulParam>(attrs.parsed);
+  CHECK_EQ(in_shape->size(), 1U);
+  const TShape& qkv_shape = in_shape->at(0);
+  if (qkv_shape.ndim() == 0) return false;
+  CheckInterleavedShape(qkv_shape, params.heads, 3, "queries_keys_values");
+  SHAPE_ASSIGN_CHECK(*out_shape, 0,
+                     mshadow::Shape3(params.heads * qkv_shape[1], qkv_shape[0], qkv_shape[0]));
+  return true;
+}
+
+inline bool InterleavedMatMulSelfAttValAttShape(const NodeAttrs& attrs,
+                                                std::vector<TShape>* in_shape,
+                                                std::vector<TShape>* out_shape) {
+  const auto& params = nnvm::get<InterleavedMatMulParam>(attrs.parsed);
+  CHECK_EQ(in_shape->size(), 2U);
+  const TShape& qkv_shape = in_shape->at(0);
+  if (qkv_shape.ndim() == 0) return false;
+  CheckInterleavedShape(qkv_shape, params.heads, 3, "queries_keys_values");
+  SHAPE_ASSIGN_CHECK(*in_shape, 1,
+                     mshadow::Shape3(params.heads * qkv_shape[1], qkv_shape[0], qkv_shape[0]));
+  SHAPE_ASSIGN_CHECK(*out_shape, 0,
+                     mshadow::Shape3(qkv_shape[0], qkv_shape[1], qkv_shape[2] / 3));
+  return true;
+}
+
+inline bool InterleavedMatMulEncDecQKShape(const NodeAttrs& attrs,
+                                           std::vector<TShape>* in_shape,
+                                           std::vector<TShape>* out_shape) {
+  const auto& params = nnvm::get<InterleavedMatMulParam>(attrs.parsed);
+  CHECK_EQ(in_shape->size(), 2U);
+  const TShape& q_shape = in_shape->at(0);
+  const TShape& kv_shape = in_shape->at(1);
+  if (q_shape.ndim() == 0 || kv_shape.ndim() == 0) return false;
+  CheckInterleavedShape(q_shape, params.heads, 1, "queries");
+  CheckInterleavedShape(kv_shape, params.heads, 2, "keys_values");
+  CHECK_EQ(q_shape[1], kv_shape[1]) << "queries and keys_values must have the same batch size";
+  CHECK_EQ(2 * q_shape[2], kv_shape[2])
+    << "keys_values must have twice the embedding size of queries";
+  SHAPE_ASSIGN_CHECK(*out_shape, 0,
+                     mshadow::Shape3(params.heads * q_shape[1], q_shape[0], kv_shape[0]));
+  return true;
+}
+
+inline bool InterleavedMatMulEncDecValAttShape(const NodeAttrs& attrs,
+                                               std::vector<TShape>* in_shape,
+                                               std::vector<TShape>* out_shape) {
+  const auto& params = nnvm::get<InterleavedMatMulParam>(attrs.parsed);
+  CHECK_EQ(in_shape->size(), 2U);
+  const TShape& kv_shape = in_shape->at(0);
+  const TShape& att_shape = in_shape->at(1);
+  if (kv_shape.ndim() == 0 || att_shape.ndim() == 0) return false;
+  CheckInterleavedShape(kv_shape, params.heads, 2, "keys_values");
+  CHECK_EQ(att_shape.ndim(), 3U) << "attention must be of shape (batch * heads, qlen, klen)";
+  CHECK_EQ(att_shape[0], params.heads * kv_shape[1]);
+  CHECK_EQ(att_shape[2], kv_shape[0]);
+  SHAPE_ASSIGN_CHECK(*out_shape, 0,
+                     mshadow::Shape3(att_shape[1], kv_shape[1], kv_shape[2] / 2));
+  return true;
+}
+
+inline bool InterleavedSelfAttShape(const NodeAttrs& attrs,
+                                    std::vector<TShape>* in_shape,
+                                    std::vector<TShape>* out_shape) {
+  const auto& params = nnvm::get<InterleavedAttentionParam>(attrs.parsed);
+  CHECK_EQ(in_shape->size(), params.use_valid_length ? 2U : 1U);
+  const TShape& qkv_shape = in_shape->at(0);
+  if (qkv_shape.ndim() == 0) return false;
+  CheckInterleavedShape(qkv_shape, params.heads, 3, "queries_keys_values");
+  if (params.use_valid_length) {
+    SHAPE_ASSIGN_CHECK(*in_shape, 1, mshadow::Shape1(qkv_shape[1]));
+  }
+  SHAPE_ASSIGN_CHECK(*out_shape, transformer::kOut,
+                     mshadow::Shape3(qkv_shape[0], qkv_shape[1], qkv_shape[2] / 3));
+  SHAPE_ASSIGN_CHECK(*out_shape, transformer::kLogSumExp,
+                     mshadow::Shape2(params.heads * qkv_shape[1], qkv_shape[0]));
+  return true;
+}
+
+inline bool InterleavedEncDecAttShape(const NodeAttrs& attrs,
+                                      std::vector<TShape>* in_shape,
+                                      std::vector<TShape>* out_shape) {
+  const auto& params = nnvm::get<InterleavedAttentionParam>(attrs.parsed);
+  CHECK_EQ(in_shape->size(), params.use_valid_length ? 3U : 2U);
+  const TShape& q_shape = in_shape->at(0);
+  const TShape& kv_shape = in_shape->at(1);
+  if (q_shape.ndim() == 0 || kv_shape.ndim() == 0) return false;
+  CheckInterleavedShape(q_shape, params.heads, 1, "queries");
+  CheckInterleavedShape(kv_shape, params.heads, 2, "keys_values");
+  CHECK_EQ(q_shape[1], kv_shape[1]) << "queries and keys_values must have the same batch size";
+  CHECK_EQ(2 * q_shape[2], kv_shape[2])
+    << "keys_values must have twice the embedding size of queries";
+  if (params.use_valid_length) {
+    SHAPE_ASSIGN_CHECK(*in_shape, 2, mshadow::Shape1(q_shape[1]));
+  }
+  SHAPE_ASSIGN_CHECK(*out_shape, transformer::kOut, q_shape);
+  SHAPE_ASSIGN_CHECK(*out_shape, transformer::kLogSumExp,
+                     mshadow::Shape2(params.heads * q_shape[1], q_shape[0]));
+  return true;
+}
+
 template<typename xpu>
 static void DivSqrtDimForward_(const nnvm::NodeAttrs& attrs,
                   const OpContext& ctx,
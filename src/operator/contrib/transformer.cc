@@ -23,12 +23,871 @@
  * \brief CPU implementation of the operators used in Transformer
  */
 #include <mxnet/base.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
 #include "./transformer-inl.h"
+#include "../linalg.h"
+#include "../../engine/openmp.h"
 #include "../tensor/elemwise_unary_op.h"
 
 namespace mxnet {
 namespace op {
 
+DMLC_REGISTER_PARAMETER(InterleavedMatMulParam);
+DMLC_REGISTER_PARAMETER(InterleavedAttentionParam);
+
+/*!
+ * \brief The matrices of all the (batch, head) pairs of an array. The matrix of
+ *  batch b and head h starts at dptr + b * batch_stride + h * head_stride and its
+ *  rows are row_stride elements apart.
+ */
+template<typename DType>
+struct HeadMatrices {
+  DType* dptr;
+  index_t batch_stride, head_stride, row_stride, rows, cols;
+
+  /*! \brief num_rows rows of the matrix of batch b and head h, from row begin */
+  Tensor<cpu, 2, DType> Get(int b, int h, index_t begin, index_t num_rows) const {
+    return Tensor<cpu, 2, DType>(dptr + b * batch_stride + h * head_stride + begin * row_stride,
+                                 Shape2(num_rows, cols), row_stride, nullptr);
+  }
+  Tensor<cpu, 2, DType> Get(int b, int h) const {
+    return Get(b, h, 0, rows);
+  }
+};
+
+/*!
+ * \brief The projections of the heads stored at the given offset of an array of
+ *  shape (length, batch, heads * num_interleaved * head_dim), e.g. the keys of
+ *  queries_keys_values are at offset 1 out of 3.
+ */
+template<typename DType>
+inline HeadMatrices<DType> InterleavedHeads(const TBlob& blob, int heads, int num_interleaved,
+                                            int offset) {
+  const index_t embed = blob.shape_[2];
+  const index_t head_dim = embed / (heads * num_interleaved);
+  HeadMatrices<DType> m;
+  m.dptr = blob.dptr<DType>() + offset * head_dim;
+  m.batch_stride = embed;
+  m.head_stride = num_interleaved * head_dim;
+  m.row_stride = blob.shape_[1] * embed;
+  m.rows = blob.shape_[0];
+  m.cols = head_dim;
+  return m;
+}
+
+/*! \brief The attention matrices of an array of shape (batch * heads, qlen, klen) */
+template<typename DType>
+inline HeadMatrices<DType> AttentionHeads(const TBlob& blob, int heads) {
+  HeadMatrices<DType> m;
+  m.dptr = blob.dptr<DType>();
+  m.rows = blob.shape_[1];
+  m.cols = blob.shape_[2];
+  m.row_stride = m.cols;
+  m.head_stride = m.rows * m.cols;
+  m.batch_stride = heads * m.head_stride;
+  return m;
+}
+
+/*!
+ * \brief Number of threads processing the (batch, head) pairs in parallel. The BLAS
+ *  calls are single threaded within a parallel region, so when there are fewer
+ *  pairs than threads the pairs are processed one after the other instead.
+ */
+inline int HeadsOMPThreads(int num_pairs) {
+  const int omp_threads = engine::OpenMP::Get()->GetRecommendedOMPThreadCount();
+  return num_pairs >= omp_threads ? omp_threads : 1;
+}
+
+/*! \brief C = alpha * op(A) op(B) + beta * C for the matrices of all (batch, head) pairs */
+template<typename DType>
+void HeadsGemm(const HeadMatrices<DType>& A, const HeadMatrices<DType>& B,
+               const HeadMatrices<DType>& C, int batch, int heads,
+               DType alpha, DType beta, bool tA, bool tB) {
+  #pragma omp parallel for num_threads(HeadsOMPThreads(batch * heads))
+  for (int bh = 0; bh < batch * heads; ++bh) {
+    const int b = bh / heads, h = bh % heads;
+    linalg_gemm(A.Get(b, h), B.Get(b, h), C.Get(b, h), alpha, beta, tA, tB);
+  }
+}
+
+/*! \brief Zero a gradient written with req, so that it can be accumulated into */
+template<typename DType>
+inline void ZeroGrad(Stream<cpu>* s, const TBlob& grad, OpReqType req) {
+  if (req == kWriteTo) {
+    mxnet_op::Kernel<mxnet_op::set_zero, cpu>::Launch(s, grad.Size(), grad.dptr<DType>());
+  }
+}
+
+template<typename DType>
+inline DType AttentionScale(const HeadMatrices<DType>& queries) {
+  return DType(1.0 / std::sqrt(static_cast<double>(queries.cols)));
+}
+
+void InterleavedMatMulSelfAttQKCPU(const nnvm::NodeAttrs& attrs,
+                                   const OpContext& ctx,
+                                   const std::vector<TBlob>& inputs,
+                                   const std::vector<OpReqType>& req,
+                                   const std::vector<TBlob>& outputs) {
+  if (req[0] == kNullOp) return;
+  const auto& params = nnvm::get<InterleavedMatMulParam>(attrs.parsed);
+  const TBlob& qkv = inputs[0];
+  const int batch = qkv.shape_[1];
+  MSHADOW_SGL_DBL_TYPE_SWITCH(qkv.type_flag_, DType, {
+    const HeadMatrices<DType> queries = InterleavedHeads<DType>(qkv, params.heads, 3, 0);
+    HeadsGemm(queries, InterleavedHeads<DType>(qkv, params.heads, 3, 1),
+              AttentionHeads<DType>(outputs[0], params.heads), batch, params.heads,
+              AttentionScale(queries), DType(req[0] == kAddTo ? 1 : 0), false, true);
+  });
+}
+
+void BackwardInterleavedMatMulSelfAttQKCPU(const nnvm::NodeAttrs& attrs,
+                                           const OpContext& ctx,
+                                           const std::vector<TBlob>& inputs,
+                                           const std::vector<OpReqType>& req,
+                                           const std::vector<TBlob>& outputs) {
+  if (req[0] == kNullOp) return;
+  const auto& params = nnvm::get<InterleavedMatMulParam>(attrs.parsed);
+  const TBlob& qkv = inputs[1];
+  const int batch = qkv.shape_[1];
+  MSHADOW_SGL_DBL_TYPE_SWITCH(qkv.type_flag_, DType, {
+    ZeroGrad<DType>(ctx.get_stream<cpu>(), outputs[0], req[0]);
+    const HeadMatrices<DType> att_grad = AttentionHeads<DType>(inputs[0], params.heads);
+    const HeadMatrices<DType> queries = InterleavedHeads<DType>(qkv, params.heads, 3, 0);
+    const HeadMatrices<DType> keys = InterleavedHeads<DType>(qkv, params.heads, 3, 1);
+    const DType scale = AttentionScale(queries);
+    HeadsGemm(att_grad, keys, InterleavedHeads<DType>(outputs[0], params.heads, 3, 0),
+              batch, params.heads, scale, DType(1), false, false);
+    HeadsGemm(att_grad, queries, InterleavedHeads<DType>(outputs[0], params.heads, 3, 1),
+              batch, params.heads, scale, DType(1), true, false);
+  });
+}
+
+void InterleavedMatMulSelfAttValAttCPU(const nnvm::NodeAttrs& attrs,
+                                       const OpContext& ctx,
+                                       const std::vector<TBlob>& inputs,
+                                       const std::vector<OpReqType>& req,
+                                       const std::vector<TBlob>& outputs) {
+  if (req[0] == kNullOp) return;
+  const auto& params = nnvm::get<InterleavedMatMulParam>(attrs.parsed);
+  const TBlob& qkv = inputs[0];
+  const int batch = qkv.shape_[1];
+  MSHADOW_SGL_DBL_TYPE_SWITCH(qkv.type_flag_, DType, {
+    HeadsGemm(AttentionHeads<DType>(inputs[1], params.heads),
+              InterleavedHeads<DType>(qkv, params.heads, 3, 2),
+              InterleavedHeads<DType>(outputs[0], params.heads, 1, 0), batch, params.heads,
+              DType(1), DType(req[0] == kAddTo ? 1 : 0), false, false);
+  });
+}
+
+void BackwardInterleavedMatMulSelfAttValAttCPU(const nnvm::NodeAttrs& attrs,
+                                               const OpContext& ctx,
+                                               const std::vector<TBlob>& inputs,
+                                               const std::vector<OpReqType>& req,
+                                               const std::vector<TBlob>& outputs) {
+  const auto& params = nnvm::get<InterleavedMatMulParam>(attrs.parsed);
+  const TBlob& qkv = inputs[1];
+  const int batch = qkv.shape_[1];
+  MSHADOW_SGL_DBL_TYPE_SWITCH(qkv.type_flag_, DType, {
+    const HeadMatrices<DType> out_grad = InterleavedHeads<DType>(inputs[0], params.heads, 1, 0);
+    if (req[0] != kNullOp) {
+      ZeroGrad<DType>(ctx.get_stream<cpu>(), outputs[0], req[0]);
+      HeadsGemm(AttentionHeads<DType>(inputs[2], params.heads), out_grad,
+                InterleavedHeads<DType>(outputs[0], params.heads, 3, 2), batch, params.heads,
+                DType(1), DType(1), true, false);
+    }
+    if (req[1] != kNullOp) {
+      HeadsGemm(out_grad, InterleavedHeads<DType>(qkv, params.heads, 3, 2),
+                AttentionHeads<DType>(outputs[1], params.heads), batch, params.heads,
+                DType(1), DType(req[1] == kAddTo ? 1 : 0), false, true);
+    }
+  });
+}
+
+void InterleavedMatMulEncDecQKCPU(const nnvm::NodeAttrs& attrs,
+                                  const OpContext& ctx,
+                                  const std::vector<TBlob>& inputs,
+                                  const std::vector<OpReqType>& req,
+                                  const std::vector<TBlob>& outputs) {
+  if (req[0] == kNullOp) return;
+  const auto& params = nnvm::get<InterleavedMatMulParam>(attrs.parsed);
+  const int batch = inputs[0].shape_[1];
+  MSHADOW_SGL_DBL_TYPE_SWITCH(inputs[0].type_flag_, DType, {
+    const HeadMatrices<DType> queries = InterleavedHeads<DType>(inputs[0], params.heads, 1, 0);
+    HeadsGemm(queries, InterleavedHeads<DType>(inputs[1], params.heads, 2, 0),
+              AttentionHeads<DType>(outputs[0], params.heads), batch, params.heads,
+              AttentionScale(queries), DType(req[0] == kAddTo ? 1 : 0), false, true);
+  });
+}
+
+void BackwardInterleavedMatMulEncDecQKCPU(const nnvm::NodeAttrs& attrs,
+                                          const OpContext& ctx,
+                                          const std::vector<TBlob>& inputs,
+                                          const std::vector<OpReqType>& req,
+                                          const std::vector<TBlob>& outputs) {
+  const auto& params = nnvm::get<InterleavedMatMulParam>(attrs.parsed);
+  const int batch = inputs[1].shape_[1];
+  MSHADOW_SGL_DBL_TYPE_SWITCH(inputs[1].type_flag_, DType, {
+    const HeadMatrices<DType> att_grad = AttentionHeads<DType>(inputs[0], params.heads);
+    const HeadMatrices<DType> queries = InterleavedHeads<DType>(inputs[1], params.heads, 1, 0);
+    const DType scale = AttentionScale(queries);
+    if (req[0] != kNullOp) {
+      HeadsGemm(att_grad, InterleavedHeads<DType>(inputs[2], params.heads, 2, 0),
+                InterleavedHeads<DType>(outputs[0], params.heads, 1, 0), batch, params.heads,
+                scale, DType(req[0] == kAddTo ? 1 : 0), false, false);
+    }
+    if (req[1] != kNullOp) {
+      ZeroGrad<DType>(ctx.get_stream<cpu>(), outputs[1], req[1]);
+      HeadsGemm(att_grad, queries, InterleavedHeads<DType>(outputs[1], params.heads, 2, 0),
+                batch, params.heads, scale, DType(1), true, false);
+    }
+  });
+}
+
+void InterleavedMatMulEncDecValAttCPU(const nnvm::NodeAttrs& attrs,
+                                      const OpContext& ctx,
+                                      const std::vector<TBlob>& inputs,
+                                      const std::vector<OpReqType>& req,
+                                      const std::vector<TBlob>& outputs) {
+  if (req[0] == kNullOp) return;
+  const auto& params = nnvm::get<InterleavedMatMulParam>(attrs.parsed);
+  const int batch = inputs[0].shape_[1];
+  MSHADOW_SGL_DBL_TYPE_SWITCH(inputs[0].type_flag_, DType, {
+    HeadsGemm(AttentionHeads<DType>(inputs[1], params.heads),
+              InterleavedHeads<DType>(inputs[0], params.heads, 2, 1),
+              InterleavedHeads<DType>(outputs[0], params.heads, 1, 0), batch, params.heads,
+              DType(1), DType(req[0] == kAddTo ? 1 : 0), false, false);
+  });
+}
+
+void BackwardInterleavedMatMulEncDecValAttCPU(const nnvm::NodeAttrs& attrs,
+                                              const OpContext& ctx,
+                                              const std::vector<TBlob>& inputs,
+                                              const std::vector<OpReqType>& req,
+                                              const std::vector<TBlob>& outputs) {
+  const auto& params = nnvm::get<InterleavedMatMulParam>(attrs.parsed);
+  const int batch = inputs[1].shape_[1];
+  MSHADOW_SGL_DBL_TYPE_SWITCH(inputs[1].type_flag_, DType, {
+    const HeadMatrices<DType> out_grad = InterleavedHeads<DType>(inputs[0], params.heads, 1, 0);
+    if (req[0] != kNullOp) {
+      ZeroGrad<DType>(ctx.get_stream<cpu>(), outputs[0], req[0]);
+      HeadsGemm(AttentionHeads<DType>(inputs[2], params.heads), out_grad,
+                InterleavedHeads<DType>(outputs[0], params.heads, 2, 1), batch, params.heads,
+                DType(1), DType(1), true, false);
+    }
+    if (req[1] != kNullOp) {
+      HeadsGemm(out_grad, InterleavedHeads<DType>(inputs[1], params.heads, 2, 1),
+                AttentionHeads<DType>(outputs[1], params.heads), batch, params.heads,
+                DType(1), DType(req[1] == kAddTo ? 1 : 0), false, true);
+    }
+  });
+}
+
+/*!
+ * \brief Number of query rows whose scores are computed at once by the fused
+ *  attention, so that the scores of a block fit in the cache.
+ */
+inline index_t AttentionBlockRows(index_t qlen, index_t klen) {
+  const index_t kScoresBlockSize = 1 << 15;
+  return std::min(qlen, std::max<index_t>(16, kScoresBlockSize / klen));
+}
+
+/*! \brief The keys attended to by the queries of the fused attention */
+template<typename DType>
+struct AttentionMask {
+  /*! \brief number of valid keys of each batch element, null if all keys are valid */
+  const DType* valid_length;
+  bool causal;
+  index_t klen;
+
+  /*! \brief number of keys attended to by the query at position row of batch b */
+  index_t NumKeys(int b, index_t row) const {
+    index_t num_keys = klen;
+    if (valid_length != nullptr) {
+      const double length = static_cast<double>(valid_length[b]);
+      num_keys = length <= 0 ? 0 : std::min(klen, static_cast<index_t>(length));
+    }
+    if (causal) num_keys = std::min(num_keys, row + 1);
+    return num_keys;
+  }
+};
+
+/*!
+ * \brief Replace the scores of a row by their softmax over the first num_keys of
+ *  them, the other keys getting a zero probability.
+ * \return the log of the sum of the exponentials of the attended scores. It is
+ *  infinite if no key is attended to, so that the probabilities recomputed from
+ *  it are all zero.
+ */
+template<typename DType>
+inline DType MaskedSoftmaxRow(DType* row, index_t len, index_t num_keys) {
+  std::fill(row + num_keys, row + len, DType(0));
+  if (num_keys == 0) return std::numeric_limits<DType>::infinity();
+  DType max_score = row[0];
+  for (index_t j = 1; j < num_keys; ++j) max_score = std::max(max_score, row[j]);
+  DType sum = 0;
+  for (index_t j = 0; j < num_keys; ++j) {
+    row[j] = std::exp(row[j] - max_score);
+    sum += row[j];
+  }
+  for (index_t j = 0; j < num_keys; ++j) row[j] /= sum;
+  return max_score + std::log(sum);
+}
+
+/*!
+ * \brief Fused attention: out = softmax(mask(queries keys^T / sqrt(head_dim))) values.
+ *  The scores are computed for blocks of query rows at a time, so the full
+ *  (qlen, klen) score matrix of a head is never materialized. The log-sum-exp
+ *  of every row is saved for the backward pass to recompute the probabilities.
+ */
+template<typename DType>
+void AttentionForward(const HeadMatrices<DType>& queries, const HeadMatrices<DType>& keys,
+                      const HeadMatrices<DType>& values, const HeadMatrices<DType>& out,
+                      DType* logsumexp, const AttentionMask<DType>& mask, int batch, int heads,
+                      OpReqType req, const OpContext& ctx) {
+  const index_t qlen = queries.rows, klen = keys.rows;
+  const index_t block_rows = AttentionBlockRows(qlen, klen);
+  const DType scale = AttentionScale(queries);
+  const DType out_beta = req == kAddTo ? 1 : 0;
+  const int nthreads = HeadsOMPThreads(batch * heads);
+  Tensor<cpu, 1, DType> workspace = ctx.requested[0].get_space_typed<cpu, 1, DType>(
+    Shape1(nthreads * block_rows * klen), ctx.get_stream<cpu>());
+  #pragma omp parallel num_threads(nthreads)
+  {
+    DType* scores_ptr = workspace.dptr_ + omp_get_thread_num() * block_rows * klen;
+    #pragma omp for
+    for (int bh = 0; bh < batch * heads; ++bh) {
+      const int b = bh / heads, h = bh % heads;
+      for (index_t begin = 0; begin < qlen; begin += block_rows) {
+        const index_t rows = std::min(block_rows, qlen - begin);
+        Tensor<cpu, 2, DType> scores(scores_ptr, Shape2(rows, klen));
+        linalg_gemm(queries.Get(b, h, begin, rows), keys.Get(b, h), scores,
+                    scale, DType(0), false, true);
+        for (index_t i = 0; i < rows; ++i) {
+          logsumexp[bh * qlen + begin + i] =
+            MaskedSoftmaxRow(scores[i].dptr_, klen, mask.NumKeys(b, begin + i));
+        }
+        linalg_gemm(scores, values.Get(b, h), out.Get(b, h, begin, rows),
+                    DType(1), out_beta, false, false);
+      }
+    }
+  }
+}
+
+/*!
+ * \brief Backward of the fused attention. The probabilities are recomputed block
+ *  by block from the saved log-sum-exp. The gradients are accumulated into, so
+ *  they have to be zeroed beforehand unless the request is kAddTo.
+ */
+template<typename DType>
+void AttentionBackward(const HeadMatrices<DType>& queries, const HeadMatrices<DType>& keys,
+                       const HeadMatrices<DType>& values,
+                       const HeadMatrices<DType>& out_grad, const DType* logsumexp,
+                       const AttentionMask<DType>& mask,
+                       const HeadMatrices<DType>& queries_grad,
+                       const HeadMatrices<DType>& keys_grad,
+                       const HeadMatrices<DType>& values_grad,
+                       bool need_queries_grad, bool need_keys_values_grad,
+                       int batch, int heads, const OpContext& ctx) {
+  const index_t qlen = queries.rows, klen = keys.rows;
+  const index_t block_rows = AttentionBlockRows(qlen, klen);
+  const DType scale = AttentionScale(queries);
+  const int nthreads = HeadsOMPThreads(batch * heads);
+  Tensor<cpu, 1, DType> workspace = ctx.requested[0].get_space_typed<cpu, 1, DType>(
+    Shape1(nthreads * 2 * block_rows * klen), ctx.get_stream<cpu>());
+  #pragma omp parallel num_threads(nthreads)
+  {
+    DType* probs_ptr = workspace.dptr_ + omp_get_thread_num() * 2 * block_rows * klen;
+    DType* scores_grad_ptr = probs_ptr + block_rows * klen;
+    // The gradients of the keys and values of a head are accumulated over the
+    // blocks of queries, which are therefore processed by the same thread.
+    #pragma omp for
+    for (int bh = 0; bh < batch * heads; ++bh) {
+      const int b = bh / heads, h = bh % heads;
+      for (index_t begin = 0; begin < qlen; begin += block_rows) {
+        const index_t rows = std::min(block_rows, qlen - begin);
+        Tensor<cpu, 2, DType> probs(probs_ptr, Shape2(rows, klen));
+        Tensor<cpu, 2, DType> scores_grad(scores_grad_ptr, Shape2(rows, klen));
+        const Tensor<cpu, 2, DType> queries_block = queries.Get(b, h, begin, rows);
+        const Tensor<cpu, 2, DType> out_grad_block = out_grad.Get(b, h, begin, rows);
+        linalg_gemm(queries_block, keys.Get(b, h), probs, scale, DType(0), false, true);
+        for (index_t i = 0; i < rows; ++i) {
+          DType* row = probs[i].dptr_;
+          const index_t num_keys = mask.NumKeys(b, begin + i);
+          const DType lse = logsumexp[bh * qlen + begin + i];
+          for (index_t j = 0; j < num_keys; ++j) row[j] = std::exp(row[j] - lse);
+          std::fill(row + num_keys, row + klen, DType(0));
+        }
+        if (need_keys_values_grad) {
+          linalg_gemm(probs, out_grad_block, values_grad.Get(b, h), DType(1), DType(1),
+                      true, false);
+        }
+        linalg_gemm(out_grad_block, values.Get(b, h), scores_grad, DType(1), DType(0),
+                    false, true);
+        // softmax backward: dscores = probs * (dprobs - sum(probs * dprobs)), where
+        // sum(probs * dprobs) = sum(dout * out) is recomputed rather than read from
+        // the forward output, which holds more than the attention if it was kAddTo.
+        for (index_t i = 0; i < rows; ++i) {
+          const DType* prob_row = probs[i].dptr_;
+          DType* grad_row = scores_grad[i].dptr_;
+          DType dot = 0;
+          for (index_t j = 0; j < klen; ++j) dot += prob_row[j] * grad_row[j];
+          for (index_t j = 0; j < klen; ++j) grad_row[j] = prob_row[j] * (grad_row[j] - dot);
+        }
+        if (need_queries_grad) {
+          linalg_gemm(scores_grad, keys.Get(b, h), queries_grad.Get(b, h, begin, rows),
+                      scale, DType(1), false, false);
+        }
+        if (need_keys_values_grad) {
+          linalg_gemm(scores_grad, queries_block, keys_grad.Get(b, h), scale, DType(1),
+                      true, false);
+        }
+      }
+    }
+  }
+}
+
+template<typename DType>
+inline AttentionMask<DType> MakeAttentionMask(const InterleavedAttentionParam& params,
+                                              const TBlob* valid_length, index_t klen) {
+  AttentionMask<DType> mask;
+  mask.valid_length = params.use_valid_length ? valid_length->dptr<DType>() : nullptr;
+  mask.causal = params.causal;
+  mask.klen = klen;
+  return mask;
+}
+
+void InterleavedSelfAttCPU(const nnvm::NodeAttrs& attrs,
+                           const OpContext& ctx,
+                           const std::vector<TBlob>& inputs,
+                           const std::vector<OpReqType>& req,
+                           const std::vector<TBlob>& outputs) {
+  using namespace transformer;
+  if (req[kOut] == kNullOp) return;
+  const auto& params = nnvm::get<InterleavedAttentionParam>(attrs.parsed);
+  const TBlob& qkv = inputs[0];
+  const int batch = qkv.shape_[1];
+  MSHADOW_SGL_DBL_TYPE_SWITCH(qkv.type_flag_, DType, {
+    AttentionForward(InterleavedHeads<DType>(qkv, params.heads, 3, 0),
+                     InterleavedHeads<DType>(qkv, params.heads, 3, 1),
+                     InterleavedHeads<DType>(qkv, params.heads, 3, 2),
+                     InterleavedHeads<DType>(outputs[kOut], params.heads, 1, 0),
+                     outputs[kLogSumExp].dptr<DType>(),
+                     MakeAttentionMask<DType>(params, &inputs.back(), qkv.shape_[0]),
+                     batch, params.heads, req[kOut], ctx);
+  });
+}
+
+void BackwardInterleavedSelfAttCPU(const nnvm::NodeAttrs& attrs,
+                                   const OpContext& ctx,
+                                   const std::vector<TBlob>& inputs,
+                                   const std::vector<OpReqType>& req,
+                                   const std::vector<TBlob>& outputs) {
+  // inputs: out_grad, queries_keys_values, [valid_length], logsumexp
+  const auto& params = nnvm::get<InterleavedAttentionParam>(attrs.parsed);
+  const TBlob& qkv = inputs[1];
+  const TBlob& logsumexp = inputs.back();
+  const int batch = qkv.shape_[1];
+  Stream<cpu>* s = ctx.get_stream<cpu>();
+  MSHADOW_SGL_DBL_TYPE_SWITCH(qkv.type_flag_, DType, {
+    if (params.use_valid_length) ZeroGrad<DType>(s, outputs[1], req[1]);
+    if (req[0] == kNullOp) return;
+    ZeroGrad<DType>(s, outputs[0], req[0]);
+    AttentionBackward(InterleavedHeads<DType>(qkv, params.heads, 3, 0),
+                      InterleavedHeads<DType>(qkv, params.heads, 3, 1),
+                      InterleavedHeads<DType>(qkv, params.heads, 3, 2),
+                      InterleavedHeads<DType>(inputs[0], params.heads, 1, 0),
+                      logsumexp.dptr<DType>(),
+                      MakeAttentionMask<DType>(params, &inputs[2], qkv.shape_[0]),
+                      InterleavedHeads<DType>(outputs[0], params.heads, 3, 0),
+                      InterleavedHeads<DType>(outputs[0], params.heads, 3, 1),
+                      InterleavedHeads<DType>(outputs[0], params.heads, 3, 2),
+                      true, true, batch, params.heads, ctx);
+  });
+}
+
+void InterleavedEncDecAttCPU(const nnvm::NodeAttrs& attrs,
+                             const OpContext& ctx,
+                             const std::vector<TBlob>& inputs,
+                             const std::vector<OpReqType>& req,
+                             const std::vector<TBlob>& outputs) {
+  using namespace transformer;
+  if (req[kOut] == kNullOp) return;
+  const auto& params = nnvm::get<InterleavedAttentionParam>(attrs.parsed);
+  const TBlob& queries = inputs[0];
+  const TBlob& keys_values = inputs[1];
+  const int batch = queries.shape_[1];
+  MSHADOW_SGL_DBL_TYPE_SWITCH(queries.type_flag_, DType, {
+    AttentionForward(InterleavedHeads<DType>(queries, params.heads, 1, 0),
+                     InterleavedHeads<DType>(keys_values, params.heads, 2, 0),
+                     InterleavedHeads<DType>(keys_values, params.heads, 2, 1),
+                     InterleavedHeads<DType>(outputs[kOut], params.heads, 1, 0),
+                     outputs[kLogSumExp].dptr<DType>(),
+                     MakeAttentionMask<DType>(params, &inputs.back(), keys_values.shape_[0]),
+                     batch, params.heads, req[kOut], ctx);
+  });
+}
+
+void BackwardInterleavedEncDecAttCPU(const nnvm::NodeAttrs& attrs,
+                                     const OpContext& ctx,
+                                     const std::vector<TBlob>& inputs,
+                                     const std::vector<OpReqType>& req,
+                                     const std::vector<TBlob>& outputs) {
+  // inputs: out_grad, queries, keys_values, [valid_length], logsumexp
+  const auto& params = nnvm::get<InterleavedAttentionParam>(attrs.parsed);
+  const TBlob& queries = inputs[1];
+  const TBlob& keys_values = inputs[2];
+  const TBlob& logsumexp = inputs.back();
+  const int batch = queries.shape_[1];
+  Stream<cpu>* s = ctx.get_stream<cpu>();
+  MSHADOW_SGL_DBL_TYPE_SWITCH(queries.type_flag_, DType, {
+    if (params.use_valid_length) ZeroGrad<DType>(s, outputs[2], req[2]);
+    if (req[0] == kNullOp && req[1] == kNullOp) return;
+    ZeroGrad<DType>(s, outputs[0], req[0]);
+    ZeroGrad<DType>(s, outputs[1], req[1]);
+    AttentionBackward(InterleavedHeads<DType>(queries, params.heads, 1, 0),
+                      InterleavedHeads<DType>(keys_values, params.heads, 2, 0),
+                      InterleavedHeads<DType>(keys_values, params.heads, 2, 1),
+                      InterleavedHeads<DType>(inputs[0], params.heads, 1, 0),
+                      logsumexp.dptr<DType>(),
+                      MakeAttentionMask<DType>(params, &inputs[3], keys_values.shape_[0]),
+                      InterleavedHeads<DType>(outputs[0], params.heads, 1, 0),
+                      InterleavedHeads<DType>(outputs[1], params.heads, 2, 0),
+                      InterleavedHeads<DType>(outputs[1], params.heads, 2, 1),
+                      req[0] != kNullOp, req[1] != kNullOp, batch, params.heads, ctx);
+  });
+}
+
+NNVM_REGISTER_OP(_contrib_interleaved_matmul_selfatt_qk)
+.describe(R"code(Compute the matrix multiplication between the projections of
+queries and keys in multihead attention use as self attention.
+
+the input must be a single tensor of interleaved projections
+of queries, keys and values following the layout:
+(seq_length, batch_size, num_heads * head_dim * 3)
+
+the equivalent code would be:
+tmp = mx.nd.reshape(queries_keys_values, shape=(0, 0, num_heads, 3, -1))
+q_proj = mx.nd.transpose(tmp[:,:,:,0,:], axes=(1, 2, 0, 3))
+q_proj = mx.nd.reshape(q_proj, shape=(-1, 0, 0), reverse=True)
+q_proj = mx.nd.contrib.div_sqrt_dim(q_proj)
+k_proj = mx.nd.transpose(tmp[:,:,:,1,:], axes=(1, 2, 0, 3))
+k_proj = mx.nd.reshape(k_proj, shape=(-1, 0, 0), reverse=True)
+output = mx.nd.batch_dot(q_proj, k_proj, transpose_b=True)
+
+)code" ADD_FILELINE)
+.set_num_inputs(1)
+.set_num_outputs(1)
+.set_attr_parser(ParamParser<InterleavedMatMulParam>)
+.set_attr<nnvm::FListInputNames>("FListInputNames", [](const NodeAttrs& attrs) {
+  return std::vector<std::string>{"queries_keys_values"};
+})
+.set_attr<nnvm::FListOutputNames>("FListOutputNames", [](const NodeAttrs& attrs) {
+  return std::vector<std::string>{"output"};
+})
+.set_attr<nnvm::FInferShape>("FInferShape", InterleavedMatMulSelfAttQKShape)
+.set_attr<nnvm::FInferType>("FInferType", ElemwiseType<1, 1>)
+.set_attr<FCompute>("FCompute<cpu>", InterleavedMatMulSelfAttQKCPU)
+.set_attr<nnvm::FGradient>("FGradient",
+    ElemwiseGradUseIn{"_backward_interleaved_matmul_selfatt_qk"})
+.add_argument("queries_keys_values", "NDArray-or-Symbol", "Interleaved queries, keys and values")
+.add_arguments(InterleavedMatMulParam::__FIELDS__());
+
+NNVM_REGISTER_OP(_backward_interleaved_matmul_selfatt_qk)
+.set_num_inputs(2)
+.set_num_outputs(1)
+.set_attr<nnvm::TIsBackward>("TIsBackward", true)
+.set_attr_parser(ParamParser<InterleavedMatMulParam>)
+.set_attr<FCompute>("FCompute<cpu>", BackwardInterleavedMatMulSelfAttQKCPU);
+
+NNVM_REGISTER_OP(_contrib_interleaved_matmul_selfatt_valatt)
+.describe(R"code(Compute the matrix multiplication between the projections of
+values and the attention weights in multihead attention use as self attention.
+
+the inputs must be a tensor of interleaved projections
+of queries, keys and values following the layout:
+(seq_length, batch_size, num_heads * head_dim * 3)
+
+and the attention weights following the layout:
+(batch_size * num_heads, seq_length, seq_length)
+
+the equivalent code would be:
+tmp = mx.nd.reshape(queries_keys_values, shape=(0, 0, num_heads, 3, -1))
+v_proj = mx.nd.transpose(tmp[:,:,:,2,:], axes=(1, 2, 0, 3))
+v_proj = mx.nd.reshape(v_proj, shape=(-1, 0, 0), reverse=True)
+output = mx.nd.batch_dot(attention, v_proj)
+output = mx.nd.reshape(output, shape=(-1, num_heads, 0, 0), reverse=True)
+output = mx.nd.transpose(output, axes=(2, 0, 1, 3))
+output = mx.nd.reshape(output, shape=(0, 0, -1))
+
+)code" ADD_FILELINE)
+.set_num_inputs(2)
+.set_num_outputs(1)
+.set_attr_parser(ParamParser<InterleavedMatMulParam>)
+.set_attr<nnvm::FListInputNames>("FListInputNames", [](const NodeAttrs& attrs) {
+  return std::vector<std::string>{"queries_keys_values", "attention"};
+})
+.set_attr<nnvm::FListOutputNames>("FListOutputNames", [](const NodeAttrs& attrs) {
+  return std::vector<std::string>{"output"};
+})
+.set_attr<nnvm::FInferShape>("FInferShape", InterleavedMatMulSelfAttValAttShape)
+.set_attr<nnvm::FInferType>("FInferType", ElemwiseType<2, 1>)
+.set_attr<FCompute>("FCompute<cpu>", InterleavedMatMulSelfAttValAttCPU)
+.set_attr<nnvm::FGradient>("FGradient",
+    ElemwiseGradUseIn{"_backward_interleaved_matmul_selfatt_valatt"})
+.add_argument("queries_keys_values", "NDArray-or-Symbol", "Queries, keys and values interleaved")
+.add_argument("attention", "NDArray-or-Symbol", "Attention maps")
+.add_arguments(InterleavedMatMulParam::__FIELDS__());
+
+NNVM_REGISTER_OP(_backward_interleaved_matmul_selfatt_valatt)
+.set_num_inputs(3)
+.set_num_outputs(2)
+.set_attr<nnvm::TIsBackward>("TIsBackward", true)
+.set_attr_parser(ParamParser<InterleavedMatMulParam>)
+.set_attr<FCompute>("FCompute<cpu>", BackwardInterleavedMatMulSelfAttValAttCPU);
+
+NNVM_REGISTER_OP(_contrib_interleaved_matmul_encdec_qk)
+.describe(R"code(Compute the matrix multiplication between the projections of
+queries and keys in multihead attention use as encoder-decoder.
+
+the inputs must be a tensor of projections of queries following the layout:
+(seq_length, batch_size, num_heads * head_dim)
+
+and a tensor of interleaved projections of keys and values following the layout:
+(seq_length, batch_size, num_heads * head_dim * 2)
+
+the equivalent code would be:
+q_proj = mx.nd.reshape(queries, shape=(0, 0, num_heads, -1))
+q_proj = mx.nd.transpose(q_proj, axes=(1, 2, 0, 3))
+q_proj = mx.nd.reshape(q_proj, shape=(-1, 0, 0), reverse=True)
+q_proj = mx.nd.contrib.div_sqrt_dim(q_proj)
+tmp = mx.nd.reshape(keys_values, shape=(0, 0, num_heads, 2, -1))
+k_proj = mx.nd.transpose(tmp[:,:,:,0,:], axes=(1, 2, 0, 3))
+k_proj = mx.nd.reshape(k_proj, shape=(-1, 0, 0), reverse=True)
+output = mx.nd.batch_dot(q_proj, k_proj, transpose_b=True)
+
+)code" ADD_FILELINE)
+.set_num_inputs(2)
+.set_num_outputs(1)
+.set_attr_parser(ParamParser<InterleavedMatMulParam>)
+.set_attr<nnvm::FListInputNames>("FListInputNames", [](const NodeAttrs& attrs) {
+  return std::vector<std::string>{"queries", "keys_values"};
+})
+.set_attr<nnvm::FListOutputNames>("FListOutputNames", [](const NodeAttrs& attrs) {
+  return std::vector<std::string>{"output"};
+})
+.set_attr<nnvm::FInferShape>("FInferShape", InterleavedMatMulEncDecQKShape)
+.set_attr<nnvm::FInferType>("FInferType", ElemwiseType<2, 1>)
+.set_attr<FCompute>("FCompute<cpu>", InterleavedMatMulEncDecQKCPU)
+.set_attr<nnvm::FGradient>("FGradient",
+    ElemwiseGradUseIn{"_backward_interleaved_matmul_encdec_qk"})
+.add_argument("queries", "NDArray-or-Symbol", "Queries")
+.add_argument("keys_values", "NDArray-or-Symbol", "Keys and values interleaved")
+.add_arguments(InterleavedMatMulParam::__FIELDS__());
+
+NNVM_REGISTER_OP(_backward_interleaved_matmul_encdec_qk)
+.set_num_inputs(3)
+.set_num_outputs(2)
+.set_attr<nnvm::TIsBackward>("TIsBackward", true)
+.set_attr_parser(ParamParser<InterleavedMatMulParam>)
+.set_attr<FCompute>("FCompute<cpu>", BackwardInterleavedMatMulEncDecQKCPU);
+
+NNVM_REGISTER_OP(_contrib_interleaved_matmul_encdec_valatt)
+.describe(R"code(Compute the matrix multiplication between the projections of
+values and the attention weights in multihead attention use as encoder-decoder.
+
+the inputs must be a tensor of interleaved projections of
+keys and values following the layout:
+(seq_length, batch_size, num_heads * head_dim * 2)
+
+and the attention weights following the layout:
+(batch_size * num_heads, qlen, klen)
+
+the equivalent code would be:
+tmp = mx.nd.reshape(keys_values, shape=(0, 0, num_heads, 2, -1))
+v_proj = mx.nd.transpose(tmp[:,:,:,1,:], axes=(1, 2, 0, 3))
+v_proj = mx.nd.reshape(v_proj, shape=(-1, 0, 0), reverse=True)
+output = mx.nd.batch_dot(attention, v_proj)
+output = mx.nd.reshape(output, shape=(-1, num_heads, 0, 0), reverse=True)
+output = mx.nd.transpose(output, axes=(2, 0, 1, 3))
+output = mx.nd.reshape(output, shape=(0, 0, -1))
+
+)code" ADD_FILELINE)
+.set_num_inputs(2)
+.set_num_outputs(1)
+.set_attr_parser(ParamParser<InterleavedMatMulParam>)
+.set_attr<nnvm::FListInputNames>("FListInputNames", [](const NodeAttrs& attrs) {
+  return std::vector<std::string>{"keys_values", "attention"};
+})
+.set_attr<nnvm::FListOutputNames>("FListOutputNames", [](const NodeAttrs& attrs) {
+  return std::vector<std::string>{"output"};
+})
+.set_attr<nnvm::FInferShape>("FInferShape", InterleavedMatMulEncDecValAttShape)
+.set_attr<nnvm::FInferType>("FInferType", ElemwiseType<2, 1>)
+.set_attr<FCompute>("FCompute<cpu>", InterleavedMatMulEncDecValAttCPU)
+.set_attr<nnvm::FGradient>("FGradient",
+    ElemwiseGradUseIn{"_backward_interleaved_matmul_encdec_valatt"})
+.add_argument("keys_values", "NDArray-or-Symbol", "Keys and values interleaved")
+.add_argument("attention", "NDArray-or-Symbol", "Attention maps")
+.add_arguments(InterleavedMatMulParam::__FIELDS__());
+
+NNVM_REGISTER_OP(_backward_interleaved_matmul_encdec_valatt)
+.set_num_inputs(3)
+.set_num_outputs(2)
+.set_attr<nnvm::TIsBackward>("TIsBackward", true)
+.set_attr_parser(ParamParser<InterleavedMatMulParam>)
+.set_attr<FCompute>("FCompute<cpu>", BackwardInterleavedMatMulEncDecValAttCPU);
+
+/*!
+ * \brief Gradient of a fused attention operator: the gradient of its output, its
+ *  inputs and the log-sum-exp saved by the forward pass.
+ */
+struct AttentionGrad {
+  const char *op_name;
+  std::vector<nnvm::NodeEntry> operator()(const nnvm::NodePtr& n,
+                                          const std::vector<nnvm::NodeEntry>& ograds) const {
+    std::vector<nnvm::NodeEntry> heads;
+    heads.push_back(ograds[transformer::kOut]);
+    for (const auto& e : n->inputs) heads.push_back(e);
+    heads.emplace_back(nnvm::NodeEntry{n, transformer::kLogSumExp, 0});
+    return MakeGradNode(op_name, n, heads, n->attrs.dict);
+  }
+};
+
+NNVM_REGISTER_OP(_contrib_interleaved_selfatt)
+.describe(R"code(Fused multihead self attention.
+
+The input must be a single tensor of interleaved projections of queries, keys
+and values following the layout (seq_length, batch_size, num_heads * head_dim * 3),
+as for interleaved_matmul_selfatt_qk. The output, of shape
+(seq_length, batch_size, num_heads * head_dim), is the same as::
+
+  att = mx.nd.contrib.interleaved_matmul_selfatt_qk(queries_keys_values, heads=num_heads)
+  att = mx.nd.softmax(masked(att), axis=-1)
+  output = mx.nd.contrib.interleaved_matmul_selfatt_valatt(queries_keys_values, att,
+                                                           heads=num_heads)
+
+where the scores of the keys at positions larger than or equal to valid_length are
+masked if use_valid_length is set, and those of the keys at positions larger than
+the query if causal is set. A query without any valid key gets a zero output.
+
+The scores are computed for blocks of queries at a time and the attention weights
+are never materialized: the backward pass recomputes them from the log-sum-exp of
+the scores of each query, saved as a hidden output.
+
+)code" ADD_FILELINE)
+.set_num_inputs([](const NodeAttrs& attrs) {
+  const auto& params = nnvm::get<InterleavedAttentionParam>(attrs.parsed);
+  return params.use_valid_length ? 2 : 1;
+})
+.set_num_outputs(2)
+.set_attr<nnvm::FNumVisibleOutputs>("FNumVisibleOutputs", [](const NodeAttrs& attrs) {
+  return 1;
+})
+.set_attr_parser(ParamParser<InterleavedAttentionParam>)
+.set_attr<nnvm::FListInputNames>("FListInputNames", [](const NodeAttrs& attrs) {
+  const auto& params = nnvm::get<InterleavedAttentionParam>(attrs.parsed);
+  return params.use_valid_length ?
+    std::vector<std::string>{"queries_keys_values", "valid_length"} :
+    std::vector<std::string>{"queries_keys_values"};
+})
+.set_attr<nnvm::FListOutputNames>("FListOutputNames", [](const NodeAttrs& attrs) {
+  return std::vector<std::string>{"output", "logsumexp"};
+})
+.set_attr<nnvm::FInferShape>("FInferShape", InterleavedSelfAttShape)
+.set_attr<nnvm::FInferType>("FInferType", ElemwiseType<-1, 2>)
+.set_attr<FResourceRequest>("FResourceRequest", [](const NodeAttrs& n) {
+  return std::vector<ResourceRequest>{ResourceRequest::kTempSpace};
+})
+.set_attr<FCompute>("FCompute<cpu>", InterleavedSelfAttCPU)
+.set_attr<nnvm::FGradient>("FGradient", AttentionGrad{"_backward_interleaved_selfatt"})
+.add_argument("queries_keys_values", "NDArray-or-Symbol", "Interleaved queries, keys and values")
+.add_argument("valid_length", "NDArray-or-Symbol",
+              "Number of valid keys of each batch element, used if use_valid_length is set")
+.add_arguments(InterleavedAttentionParam::__FIELDS__());
+
+NNVM_REGISTER_OP(_backward_interleaved_selfatt)
+.set_num_inputs([](const NodeAttrs& attrs) {
+  const auto& params = nnvm::get<InterleavedAttentionParam>(attrs.parsed);
+  return params.use_valid_length ? 4 : 3;
+})
+.set_num_outputs([](const NodeAttrs& attrs) {
+  const auto& params = nnvm::get<InterleavedAttentionParam>(attrs.parsed);
+  return params.use_valid_length ? 2 : 1;
+})
+.set_attr<nnvm::TIsBackward>("TIsBackward", true)
+.set_attr_parser(ParamParser<InterleavedAttentionParam>)
+.set_attr<FResourceRequest>("FResourceRequest", [](const NodeAttrs& n) {
+  return std::vector<ResourceRequest>{ResourceRequest::kTempSpace};
+})
+.set_attr<FCompute>("FCompute<cpu>", BackwardInterleavedSelfAttCPU);
+
+NNVM_REGISTER_OP(_contrib_interleaved_encdec_att)
+.describe(R"code(Fused multihead encoder-decoder attention.
+
+The inputs are the projections of the queries, of layout
+(qlen, batch_size, num_heads * head_dim), and the interleaved projections of the
+keys and values, of layout (klen, batch_size, num_heads * head_dim * 2), as for
+interleaved_matmul_encdec_qk. The output, of the shape of the queries, is the
+same as::
+
+  att = mx.nd.contrib.interleaved_matmul_encdec_qk(queries, keys_values, heads=num_heads)
+  att = mx.nd.softmax(masked(att), axis=-1)
+  output = mx.nd.contrib.interleaved_matmul_encdec_valatt(keys_values, att, heads=num_heads)
+
+with the same masking and memory use as interleaved_selfatt.
+
+)code" ADD_FILELINE)
+.set_num_inputs([](const NodeAttrs& attrs) {
+  const auto& params = nnvm::get<InterleavedAttentionParam>(attrs.parsed);
+  return params.use_valid_length ? 3 : 2;
+})
+.set_num_outputs(2)
+.set_attr<nnvm::FNumVisibleOutputs>("FNumVisibleOutputs", [](const NodeAttrs& attrs) {
+  return 1;
+})
+.set_attr_parser(ParamParser<InterleavedAttentionParam>)
+.set_attr<nnvm::FListInputNames>("FListInputNames", [](const NodeAttrs& attrs) {
+  const auto& params = nnvm::get<InterleavedAttentionParam>(attrs.parsed);
+  return params.use_valid_length ?
+    std::vector<std::string>{"queries", "keys_values", "valid_length"} :
+    std::vector<std::string>{"queries", "keys_values"};
+})
+.set_attr<nnvm::FListOutputNames>("FListOutputNames", [](const NodeAttrs& attrs) {
+  return std::vector<std::string>{"output", "logsumexp"};
+})
+.set_attr<nnvm::FInferShape>("FInferShape", InterleavedEncDecAttShape)
+.set_attr<nnvm::FInferType>("FInferType", ElemwiseType<-1, 2>)
+.set_attr<FResourceRequest>("FResourceRequest", [](const NodeAttrs& n) {
+  return std::vector<ResourceRequest>{ResourceRequest::kTempSpace};
+})
+.set_attr<FCompute>("FCompute<cpu>", InterleavedEncDecAttCPU)
+.set_attr<nnvm::FGradient>("FGradient", AttentionGrad{"_backward_interleaved_encdec_att"})
+.add_argument("queries", "NDArray-or-Symbol", "Queries")
+.add_argument("keys_values", "NDArray-or-Symbol", "Keys and values interleaved")
+.add_argument("valid_length", "NDArray-or-Symbol",
+              "Number of valid keys of each batch element, used if use_valid_length is set")
+.add_arguments(InterleavedAttentionParam::__FIELDS__());
+
+NNVM_REGISTER_OP(_backward_interleaved_encdec_att)
+.set_num_inputs([](const NodeAttrs& attrs) {
+  const auto& params = nnvm::get<InterleavedAttentionParam>(attrs.parsed);
+  return params.use_valid_length ? 5 : 4;
+})
+.set_num_outputs([](const NodeAttrs& attrs) {
+  const auto& params = nnvm::get<InterleavedAttentionParam>(attrs.parsed);
+  return params.use_valid_length ? 3 : 2;
+})
+.set_attr<nnvm::TIsBackward>("TIsBackward", true)
+.set_attr_parser(ParamParser<InterleavedAttentionParam>)
+.set_attr<FResourceRequest>("FResourceRequest", [](const NodeAttrs& n) {
+  return std::vector<ResourceRequest>{ResourceRequest::kTempSpace};
+})
+.set_attr<FCompute>("FCompute<cpu>", BackwardInterleavedEncDecAttCPU);
+
 // relu
 MXNET_OPERATOR_REGISTER_UNARY(_contrib_div_sqrt_dim)
 .describe(R"code(Rescale the input by the square root of the channel dimension.
@@ -28,6 +28,9 @@
 #include "./elemwise_op_common.h"
 #include "../imperative/imperative_utils.h"
 #include "./subgraph_op_common.h"
+#if MXNET_USE_MKLDNN == 1
+#include "./nn/mkldnn/mkldnn_base-inl.h"
+#endif
 
 namespace mxnet {
 namespace op {
@@ -64,12 +67,151 @@ class ForeachState: public LoopState {
  public:
   ForeachParam params;
   int num_iterations;
-
-  ForeachState(const Symbol &g, const ForeachParam &params) : LoopState(g) {
+  Symbol body;
+  // Whether all the iterations run in a single engine operation in inference.
+  bool fuse_body;
+  std::shared_ptr<LoopBodyExec> body_exec;
+  // The loop states alternate between these buffers and the state outputs.
+  std::vector<NDArray> state_bufs;
+
+  ForeachState(const Symbol &g, const ForeachParam &params) : LoopState(g), body(g) {
     this->params = params;
+    fuse_body = dmlc::GetEnv("MXNET_FOREACH_FUSE_INFERENCE", true);
   }
 };
 
+// Get the data of the i-th iteration from the data of the whole sequence.
+static inline TBlob IterSlice(const TBlob &blob, size_t i) {
+  TShape shape(blob.shape_.begin() + 1, blob.shape_.end());
+  char *dptr = static_cast<char *>(blob.dptr_)
+      + i * shape.Size() * mshadow::mshadow_sizeof(blob.type_flag_);
+  return TBlob(dptr, shape, blob.dev_mask(), blob.type_flag_, blob.dev_id());
+}
+
+/*
+ * In inference, run all the iterations of foreach in a single engine
+ * operation, instead of pushing the operators of the body in every iteration.
+ * It returns false if the loop can't run this way.
+ */
+static bool ForeachFusedForward(ForeachState *state,
+                                const OpContext& ctx,
+                                const std::vector<NDArray>& inputs,
+                                const std::vector<OpReqType>& req,
+                                const std::vector<NDArray>& outputs) {
+  const ForeachParam& params = state->params;
+  const size_t num_data = params.in_data_locs.ndim();
+  const size_t num_states = params.in_state_locs.ndim();
+  const size_t num_out_data = params.num_out_data;
+  const size_t len = inputs[0].shape()[0];
+  if (!state->fuse_body || ctx.need_grad || len == 0) return false;
+  for (const auto r : req) {
+    if (r != kWriteTo) return false;
+  }
+  for (const auto &arr : inputs) {
+    if (arr.storage_type() != kDefaultStorage) return false;
+  }
+
+  // The shapes and types of the inputs of the body in an iteration.
+  std::vector<TShape> shapes(inputs.size());
+  std::vector<int> dtypes(inputs.size());
+  for (size_t i = 0; i < inputs.size(); i++) {
+    size_t loc;
+    TShape shape = inputs[i].shape();
+    if (i < num_data) {
+      loc = params.in_data_locs[i];
+      shape = TShape(shape.begin() + 1, shape.end());
+    } else if (i < num_data + num_states) {
+      loc = params.in_state_locs[i - num_data];
+    } else {
+      loc = params.remain_locs[i - num_data - num_states];
+    }
+    CHECK_LT(loc, shapes.size());
+    shapes[loc] = shape;
+    dtypes[loc] = inputs[i].dtype();
+  }
+  const Context dev_ctx = inputs[0].ctx();
+  if (!state->body_exec || !state->body_exec->Match(dev_ctx, shapes, dtypes)) {
+    state->body_exec = LoopBodyExec::Create(state->body, dev_ctx, shapes, dtypes);
+    if (!state->body_exec) {
+      // The body has operators that can't run this way.
+      state->fuse_body = false;
+      return false;
+    }
+  }
+  std::shared_ptr<LoopBodyExec> body = state->body_exec;
+  CHECK_EQ(body->output_shapes().size(), outputs.size());
+  for (size_t i = 0; i < outputs.size(); i++) {
+    TShape shape = outputs[i].shape();
+    if (i < num_out_data) shape = TShape(shape.begin() + 1, shape.end());
+    if (shape != body->output_shapes()[i] || outputs[i].dtype() != body->output_dtypes()[i])
+      return false;
+  }
+
+  std::vector<NDArray> &bufs = state->state_bufs;
+  bufs.resize(outputs.size() - num_out_data);
+  for (size_t i = 0; i < bufs.size(); i++) {
+    const NDArray &out = outputs[num_out_data + i];
+    if (bufs[i].is_none() || bufs[i].shape() != out.shape() ||
+        bufs[i].dtype() != out.dtype() || bufs[i].ctx() != out.ctx())
+      bufs[i] = NDArray(out.shape(), out.ctx(), false, out.dtype());
+  }
+
+  std::vector<engine::VarHandle> const_vars, mutable_vars;
+  for (const auto &arr : inputs) const_vars.push_back(arr.var());
+  for (const auto &arr : outputs) mutable_vars.push_back(arr.var());
+  for (const auto &arr : bufs) mutable_vars.push_back(arr.var());
+  mutable_vars.insert(mutable_vars.end(), body->mutable_vars().begin(),
+                      body->mutable_vars().end());
+  Engine::Get()->DeduplicateVarHandle(&const_vars, &mutable_vars);
+
+  const bool is_train = ctx.is_train;
+  const bool is_gpu = dev_ctx.dev_mask() == gpu::kDevMask;
+  const std::vector<NDArray> state_bufs = bufs;
+  Engine::Get()->PushSync([=](RunContext rctx) {
+      std::vector<NDArray> in_arrs(inputs.size());
+      std::vector<TBlob> in_blobs(inputs.size());
+      for (size_t i = 0; i < inputs.size(); i++) {
+#if MXNET_USE_MKLDNN == 1
+        in_arrs[i] = inputs[i].Reorder2Default();
+#else
+        in_arrs[i] = inputs[i];
+#endif
+        in_blobs[i] = in_arrs[i].data();
+      }
+#if MXNET_USE_MKLDNN == 1
+      InvalidateOutputs(outputs, req);
+#endif
+      std::vector<TBlob> subg_inputs(inputs.size());
+      std::vector<TBlob> subg_outputs(outputs.size());
+      for (size_t j = 0; j < params.remain_locs.ndim(); j++)
+        subg_inputs[params.remain_locs[j]] = in_blobs[j + num_data + num_states];
+      LoopBodyExec::Workspace ws;
+      body->InitWorkspace(&ws);
+      for (size_t i = 0; i < len; i++) {
+        for (size_t j = 0; j < num_data; j++)
+          subg_inputs[params.in_data_locs[j]] = IterSlice(in_blobs[j], i);
+        // The states are the outputs of the previous iteration.
+        for (size_t j = 0; j < num_states; j++) {
+          subg_inputs[params.in_state_locs[j]] =
+              i == 0 ? in_blobs[j + num_data] : subg_outputs[j + num_out_data];
+        }
+        for (size_t j = 0; j < num_out_data; j++)
+          subg_outputs[j] = IterSlice(outputs[j].data(), i);
+        // The iterations write the states to the outputs and the buffers in
+        // turn, so that the last iteration writes to the outputs.
+        for (size_t j = num_out_data; j < outputs.size(); j++) {
+          subg_outputs[j] = (len - 1 - i) % 2 == 0 ?
+              outputs[j].data() : state_bufs[j - num_out_data].data();
+        }
+        body->Run(rctx, is_train, subg_inputs, subg_outputs, &ws);
+      }
+      if (is_gpu) {
+        rctx.get_stream<gpu>()->Wait();
+      }
+    }, dev_ctx, const_vars, mutable_vars, FnProperty::kNormal, 0, "ForeachFused");
+  return true;
+}
+
 static void ForeachComputeExCPU(const OpStatePtr& state_ptr,
                                 const OpContext& ctx,
                                 const std::vector<NDArray>& inputs,
@@ -89,6 +231,7 @@ static void ForeachComputeExCPU(const OpStatePtr& state_ptr,
   for (const auto &arr : outputs)
     CHECK_EQ(arr.storage_type(), kDefaultStorage)
         << "The for operator doesn't support the sparse format";
+  if (ForeachFusedForward(&state, ctx, inputs, req, outputs)) return;
 
   // Initialize the outputs of the subgraph is a little trickier.
   // The states from the previous iteration are used as the inputs of the next
@@ -126,6 +269,7 @@ static void ForeachComputeExCPU(const OpStatePtr& state_ptr,
         + params.in_state_locs.ndim()];
   }
 
+  if (ctx.need_grad) state.Reserve(len);
   // Here we iterate over the first dimension of the first input array.
   for (size_t i = 0; i < len; i++) {
     // Initialize outputs for the subgraph.
@@ -147,6 +147,211 @@ void Normalize(const nnvm::NodeAttrs &attrs,
   });
 }
 
+struct ToTensorNormalizeParam : public dmlc::Parameter<ToTensorNormalizeParam> {
+  nnvm::Tuple<float> mean;
+  nnvm::Tuple<float> std;
+  TShape size;
+  TShape crop;
+  DMLC_DECLARE_PARAMETER(ToTensorNormalizeParam) {
+    DMLC_DECLARE_FIELD(mean).set_default(nnvm::Tuple<float>({0.0f}))
+    .describe("Sequence of mean for each channel, of the values scaled to [0, 1].");
+    DMLC_DECLARE_FIELD(std).set_default(nnvm::Tuple<float>({1.0f}))
+    .describe("Sequence of standard deviations for each channel, of the values "
+              "scaled to [0, 1].");
+    DMLC_DECLARE_FIELD(size).set_default(TShape())
+    .describe("Size (width, height) the images are resized to with bilinear "
+              "interpolation. Empty for no resizing.");
+    DMLC_DECLARE_FIELD(crop).set_default(TShape())
+    .describe("Region (x, y, width, height) of the resized images to keep. "
+              "Empty to keep the whole images.");
+  }
+};
+
+inline bool ToTensorNormalizeShape(const nnvm::NodeAttrs& attrs,
+                                   std::vector<TShape> *in_attrs,
+                                   std::vector<TShape> *out_attrs) {
+  const ToTensorNormalizeParam &param = nnvm::get<ToTensorNormalizeParam>(attrs.parsed);
+  CHECK_EQ(in_attrs->size(), 1U);
+  CHECK_EQ(out_attrs->size(), 1U);
+  const TShape &shp = (*in_attrs)[0];
+  if (!shp.ndim()) return false;
+  CHECK(shp.ndim() == 3 || shp.ndim() == 4)
+      << "Input image must have shape (height, width, channels) or "
+      << "(batch, height, width, channels), but got " << shp;
+  const int ndim = shp.ndim();
+  const auto nchannels = shp[ndim - 1];
+  CHECK(param.mean.ndim() == 1 || param.mean.ndim() == nchannels)
+      << "Invalid mean for input with shape " << shp
+      << ". mean must have either 1 or " << nchannels
+      << " elements, but got " << param.mean;
+  CHECK(param.std.ndim() == 1 || param.std.ndim() == nchannels)
+      << "Invalid std for input with shape " << shp
+      << ". std must have either 1 or " << nchannels
+      << " elements, but got " << param.std;
+  CHECK(param.size.ndim() == 0 || param.size.ndim() == 2)
+      << "size must be (width, height), but got " << param.size;
+  CHECK(param.crop.ndim() == 0 || param.crop.ndim() == 4)
+      << "crop must be (x, y, width, height), but got " << param.crop;
+  auto width = param.size.ndim() ? param.size[0] : shp[ndim - 2];
+  auto height = param.size.ndim() ? param.size[1] : shp[ndim - 3];
+  CHECK(width > 0 && height > 0) << "Invalid size " << param.size;
+  if (param.crop.ndim()) {
+    CHECK(param.crop[2] > 0 && param.crop[3] > 0 &&
+          param.crop[0] + param.crop[2] <= width && param.crop[1] + param.crop[3] <= height)
+        << "crop " << param.crop << " is out of the resized image of size ("
+        << width << ", " << height << ")";
+    width = param.crop[2];
+    height = param.crop[3];
+  }
+  TShape oshape(ndim);
+  if (ndim == 4) oshape[0] = shp[0];
+  oshape[ndim - 3] = nchannels;
+  oshape[ndim - 2] = height;
+  oshape[ndim - 1] = width;
+  SHAPE_ASSIGN_CHECK(*out_attrs, 0, oshape);
+  return true;
+}
+
+/*!
+ * \brief Source pixels and weight of the second one for the bilinear interpolation
+ *  of pixel dst of a dimension resized from src_size to dst_size, with pixel centers
+ *  aligned and borders replicated as in OpenCV.
+ */
+inline void BilinearSource(const int dst, const int src_size, const int dst_size,
+                           int *lo, int *hi, float *weight) {
+  const float f = (dst + 0.5f) * src_size / dst_size - 0.5f;
+  int i = static_cast<int>(std::floor(f));
+  float w = f - i;
+  if (i < 0) {
+    i = 0;
+    w = 0.f;
+  }
+  if (i >= src_size - 1) {
+    i = src_size - 1;
+    w = 0.f;
+  }
+  *lo = i;
+  *hi = std::min(i + 1, src_size - 1);
+  *weight = w;
+}
+
+/*!
+ * \brief Converts a row of interleaved pixels into a row of each channel plane.
+ *  kChannels is the number of channels when known at compile time, for the loads
+ *  of each plane to have a constant stride the compiler can vectorize.
+ */
+template<typename DType, int kChannels>
+inline void ToTensorNormalizeRow(const DType *src, const int width, const int channels,
+                                 const index_t plane, const float *scale,
+                                 const float *shift, float *dst) {
+  const int nc = kChannels > 0 ? kChannels : channels;
+  for (int c = 0; c < nc; ++c) {
+    const float a = scale[c], b = shift[c];
+    const DType *s = src + c;
+    float *d = dst + c * plane;
+    for (int x = 0; x < width; ++x) {
+      d[x] = static_cast<float>(s[x * nc]) * a + b;
+    }
+  }
+}
+
+template<typename DType>
+inline void ToTensorNormalizeImpl(const ToTensorNormalizeParam &param,
+                                  const TBlob &input, const TBlob &output) {
+  const int ndim = input.ndim();
+  const int batch = ndim == 4 ? input.shape_[0] : 1;
+  const int height = input.shape_[ndim - 3];
+  const int width = input.shape_[ndim - 2];
+  const int channels = input.shape_[ndim - 1];
+  const int out_h = output.shape_[ndim - 2];
+  const int out_w = output.shape_[ndim - 1];
+  const int resized_w = param.size.ndim() ? param.size[0] : width;
+  const int resized_h = param.size.ndim() ? param.size[1] : height;
+  const int x_off = param.crop.ndim() ? param.crop[0] : 0;
+  const int y_off = param.crop.ndim() ? param.crop[1] : 0;
+  const bool resize = resized_w != width || resized_h != height;
+  const index_t plane = static_cast<index_t>(out_h) * out_w;
+  // (x / 255 - mean) / std as x * scale + shift
+  std::vector<float> scale(channels), shift(channels);
+  for (int c = 0; c < channels; ++c) {
+    const float mean = param.mean[param.mean.ndim() > 1 ? c : 0];
+    const float stdev = param.std[param.std.ndim() > 1 ? c : 0];
+    scale[c] = 1.0f / (255.0f * stdev);
+    shift[c] = -mean / stdev;
+  }
+  std::vector<int> x_lo, x_hi;
+  std::vector<float> x_weight;
+  if (resize) {
+    x_lo.resize(out_w);
+    x_hi.resize(out_w);
+    x_weight.resize(out_w);
+    for (int x = 0; x < out_w; ++x) {
+      BilinearSource(x + x_off, width, resized_w, &x_lo[x], &x_hi[x], &x_weight[x]);
+    }
+  }
+  const DType *in = input.dptr<DType>();
+  float *out = output.dptr<float>();
+  // rows of all the images are spread over the threads, so that a single
+  // large image is converted in parallel as well
+  const int rows = batch * out_h;
+  #pragma omp parallel for num_threads(engine::OpenMP::Get()->GetRecommendedOMPThreadCount())
+  for (int r = 0; r < rows; ++r) {
+    const int n = r / out_h, y = r % out_h;
+    const DType *img = in + static_cast<index_t>(n) * height * width * channels;
+    float *dst = out + n * channels * plane + static_cast<index_t>(y) * out_w;
+    if (!resize) {
+      const DType *src = img + (static_cast<index_t>(y + y_off) * width + x_off) * channels;
+      switch (channels) {
+        case 1:
+          ToTensorNormalizeRow<DType, 1>(src, out_w, 1, plane, scale.data(), shift.data(), dst);
+          break;
+        case 3:
+          ToTensorNormalizeRow<DType, 3>(src, out_w, 3, plane, scale.data(), shift.data(), dst);
+          break;
+        default:
+          ToTensorNormalizeRow<DType, 0>(src, out_w, channels, plane, scale.data(),
+                                         shift.data(), dst);
+      }
+      continue;
+    }
+    int y_lo, y_hi;
+    float wy;
+    BilinearSource(y + y_off, height, resized_h, &y_lo, &y_hi, &wy);
+    const DType *top = img + static_cast<index_t>(y_lo) * width * channels;
+    const DType *bottom = img + static_cast<index_t>(y_hi) * width * channels;
+    for (int c = 0; c < channels; ++c) {
+      const float a = scale[c], b = shift[c];
+      float *d = dst + c * plane;
+      for (int x = 0; x < out_w; ++x) {
+        const int i0 = x_lo[x] * channels + c, i1 = x_hi[x] * channels + c;
+        const float wx = x_weight[x];
+        const float t = static_cast<float>(top[i0])
+                        + (static_cast<float>(top[i1]) - static_cast<float>(top[i0])) * wx;
+        const float u = static_cast<float>(bottom[i0])
+                        + (static_cast<float>(bottom[i1]) - static_cast<float>(bottom[i0])) * wx;
+        d[x] = (t + (u - t) * wy) * a + b;
+      }
+    }
+  }
+}
+
+/*!
+ * \brief to_tensor followed by normalize, with an optional resize and crop, in a
+ *  single pass over the images instead of one pass per transform.
+ */
+inline void ToTensorNormalize(const nnvm::NodeAttrs &attrs,
+                              const OpContext &ctx,
+                              const std::vector<TBlob> &inputs,
+                              const std::vector<OpReqType> &req,
+                              const std::vector<TBlob> &outputs) {
+  CHECK_EQ(req[0], kWriteTo)
+    << "`to_tensor_normalize` does not support inplace";
+  const ToTensorNormalizeParam &param = nnvm::get<ToTensorNormalizeParam>(attrs.parsed);
+  MSHADOW_TYPE_SWITCH(inputs[0].type_flag_, DType, {
+    ToTensorNormalizeImpl<DType>(param, inputs[0], outputs[0]);
+  });
+}
+
 template<typename DType>
 inline DType saturate_cast(const float& src) {
   return static_cast<DType>(src);
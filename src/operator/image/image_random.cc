@@ -33,6 +33,7 @@ namespace op {
 namespace image {
 
 DMLC_REGISTER_PARAMETER(NormalizeParam);
+DMLC_REGISTER_PARAMETER(ToTensorNormalizeParam);
 DMLC_REGISTER_PARAMETER(RandomEnhanceParam);
 DMLC_REGISTER_PARAMETER(AdjustLightingParam);
 DMLC_REGISTER_PARAMETER(RandomLightingParam);
@@ -64,6 +65,25 @@ NNVM_REGISTER_OP(_image_normalize)
 .add_argument("data", "NDArray-or-Symbol", "The input.")
 .add_arguments(NormalizeParam::__FIELDS__());
 
+NNVM_REGISTER_OP(_image_to_tensor_normalize)
+.describe(R"code(Converts images of shape (H x W x C), or a batch of them of shape
+(N x H x W x C), in the range [0, 255] to tensors of shape (C x H x W), or
+(N x C x H x W), normalized with mean and std in the range [0, 1].
+
+The images are first resized to `size` with bilinear interpolation, then cropped
+to `crop`, if given. This is the same as `to_tensor` followed by `normalize`,
+in a single pass over the images.
+)code" ADD_FILELINE)
+.set_num_inputs(1)
+.set_num_outputs(1)
+.set_attr_parser(ParamParser<ToTensorNormalizeParam>)
+.set_attr<nnvm::FInferShape>("FInferShape", ToTensorNormalizeShape)
+.set_attr<nnvm::FInferType>("FInferType", ToTensorType)
+.set_attr<FCompute>("FCompute<cpu>", ToTensorNormalize)
+.set_attr<nnvm::FGradient>("FGradient", MakeZeroGradNodes)
+.add_argument("data", "NDArray-or-Symbol", "The input.")
+.add_arguments(ToTensorNormalizeParam::__FIELDS__());
+
 MXNET_REGISTER_IMAGE_AUG_OP(_image_flip_left_right)
 .describe(R"code()code" ADD_FILELINE)
 .set_attr<FCompute>("FCompute<cpu>", FlipLeftRight);
@@ -62,6 +62,7 @@ struct DropoutParam : public dmlc::Parameter<DropoutParam> {
   float p;
   int mode;
   TShape axes;
+  bool packed_mask;
   DMLC_DECLARE_PARAMETER(DropoutParam) {
     DMLC_DECLARE_FIELD(p).set_default(0.5)
     .set_range(0, 1)
@@ -73,6 +74,10 @@ struct DropoutParam : public dmlc::Parameter<DropoutParam> {
     .describe("Whether to only turn on dropout during training or to also turn on for inference.");
     DMLC_DECLARE_FIELD(axes).set_default(TShape())
     .describe("Axes for variational dropout kernel.");
+    DMLC_DECLARE_FIELD(packed_mask).set_default(false)
+    .describe("Whether to keep the mask for backward as one bit per element, packed in uint8, "
+              "instead of one value of the input type per element. "
+              "Not supported together with axes.");
   }
 };  // struct DropoutParam
 
@@ -211,6 +216,46 @@ class DropoutOp {
       });
     }
   };
+  /*!
+   * \brief Dropout kernel keeping a bit-packed mask: each item of the kernel computes
+   *  8 consecutive outputs and the byte of their mask
+   */
+  struct DropoutPackedKernel {
+    MSHADOW_XINLINE static void Map(int id,
+                                    RandGenerator<xpu, DType> gen,
+                                    const int N,
+                                    const int step,
+                                    DType *dropout_out,
+                                    uint8_t *mask_out,
+                                    const DType *input_data,
+                                    const index_t size,
+                                    const real_t pkeep) {
+      RNG_KERNEL_LOOP(xpu, DType, id, gen, N, step, {
+        const index_t begin = static_cast<index_t>(i) * 8;
+        const int count = size - begin < 8 ? static_cast<int>(size - begin) : 8;
+        uint8_t bits = 0;
+        for (int j = 0; j < count; ++j) {
+          const real_t rand_num = static_cast<real_t>(genImpl.uniform());
+          const real_t keep = mshadow_op::threshold_eq::Map<real_t>(rand_num, pkeep);
+          bits |= static_cast<uint8_t>(keep) << j;
+          dropout_out[begin + j] = input_data[begin + j] * DType(keep * (1.0f / pkeep));
+        }
+        mask_out[i] = bits;
+      });
+    }
+  };
+  /*! \brief Backward of dropout with a bit-packed mask */
+  struct DropoutPackedBackwardKernel {
+    MSHADOW_XINLINE static void Map(int i,
+                                    DType *in_grad,
+                                    const DType *out_grad,
+                                    const uint8_t *mask,
+                                    const real_t pkeep,
+                                    const OpReqType req) {
+      const real_t keep = (mask[i >> 3] >> (i & 7)) & 1;
+      KERNEL_ASSIGN(in_grad[i], req, out_grad[i] * DType(keep * (1.0f / pkeep)));
+    }
+  };
   struct BernoulliKernel {
     /*! \brief Bernoulli kernel for generating mask */
     MSHADOW_XINLINE static void Map(int id,
@@ -230,6 +275,7 @@ class DropoutOp {
     this->pkeep_ = 1.0f - param.p;
     this->mode_ = static_cast<dropout::DropoutOpMode>(param.mode);
     this->axes_ = param.axes;
+    this->packed_mask_ = param.packed_mask;
   }
 
   void Forward(const OpContext &ctx,
@@ -246,6 +292,16 @@ class DropoutOp {
       if (ctx.is_train || this->mode_ == dropout::kAlways) {
         RandGenerator<xpu, DType> *pgen = ctx.requested[0].get_parallel_random<xpu, DType>();
         CHECK_NOTNULL(pgen);
+        if (this->packed_mask_) {
+          CHECK(req[dropout::kOut] != kAddTo);
+          const index_t size = out.Size();
+          LaunchRNG<DropoutPackedKernel, xpu>(s, pgen, (size + 7) / 8,
+                                              out.dptr<DType>(),
+                                              out_data[dropout::kMask].dptr<uint8_t>(),
+                                              in_data[dropout::kData].dptr<DType>(),
+                                              size, this->pkeep_);
+          return;
+        }
         if (this->axes_.ndim() != 0 || !MKLForward(s, pgen, this->pkeep_, in_data, out_data)) {
           const TBlob &mask = out_data[dropout::kMask];
           CHECK(req[dropout::kOut] != kAddTo);
@@ -311,6 +367,13 @@ class DropoutOp {
     using namespace mshadow::expr;
     Stream<xpu> *s = ctx.get_stream<xpu>();
     if (ctx.is_train || mode_ == dropout::kAlways) {
+      if (this->packed_mask_) {
+        const TBlob &gdata = in_grad[dropout::kData];
+        mxnet_op::Kernel<DropoutPackedBackwardKernel, xpu>::Launch(
+          s, gdata.Size(), gdata.dptr<DType>(), out_grad[dropout::kOut].dptr<DType>(),
+          out_data[dropout::kMask].dptr<uint8_t>(), this->pkeep_, req[dropout::kData]);
+        return;
+      }
       if (this->axes_.ndim() != 0 || !MKLBackward(s, this->pkeep_, in_grad, out_data, out_grad)) {
         const TBlob &gdata = in_grad[dropout::kData];
         const TBlob &grad = out_grad[dropout::kOut];
@@ -366,6 +429,8 @@ class DropoutOp {
   /*! \brief Dropout mode */
   dropout::DropoutOpMode mode_;
   TShape axes_;
+  /*! \brief Whether the mask is kept as packed bits */
+  bool packed_mask_;
 };  // class DropoutOp
 
 template<typename xpu>
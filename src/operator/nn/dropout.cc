@@ -73,6 +73,10 @@ Example::
   executor.outputs
   [[ 3.     0.5   -0.5    2.     7.   ]
    [ 2.    -0.4    7.     3.     0.2  ]]
+
+- With ``packed_mask=True``, the mask kept for the backward pass takes one bit per element
+  instead of one element of the input type, which cuts the memory held between the forward
+  and the backward passes of float32 dropout by 32x.
 )" ADD_FILELINE)
 .set_num_inputs(1)
 .set_num_outputs(2)
@@ -98,6 +102,12 @@ Example::
   if (dshape.ndim() == 0) return false;
   out_shape->clear();
   out_shape->push_back(dshape);
+  if (param.packed_mask) {
+    CHECK_EQ(param.axes.ndim(), 0U) << "Dropout with packed_mask does not support axes";
+    // one bit per element
+    out_shape->push_back(Shape1((dshape.Size() + 7) / 8));
+    return true;
+  }
   for (index_t i = 0; i < param.axes.ndim(); ++i) {
     dshape[param.axes[i]] = 1;
   }
@@ -114,9 +124,10 @@ Example::
     return false;
   }
 
-  size_t nout = 2;
+  const DropoutParam& param = nnvm::get<DropoutParam>(attrs.parsed);
   out_type->clear();
-  for (size_t i = 0; i < nout; ++i) out_type->push_back(dtype);
+  out_type->push_back(dtype);
+  out_type->push_back(param.packed_mask ? mshadow::kUint8 : dtype);
   return true;
 })
 .set_attr<FCompute>("FCompute<cpu>", DropoutCompute<cpu>)
@@ -25,7 +25,9 @@
 
 #include "layer_norm-inl.h"
 #include <nnvm/op_attr_types.h>
+#include <cmath>
 #include "../elemwise_op_common.h"
+#include "../../engine/openmp.h"
 
 namespace mxnet {
 namespace op {
@@ -64,6 +66,221 @@ static bool LayerNormShape(const nnvm::NodeAttrs& attrs,
   return true;
 }
 
+/*!
+ * \brief Number of channels normalized together if the channel axis is the last
+ *  non-trivial axis of the data, so that the channels of a row are contiguous,
+ *  and 0 otherwise.
+ */
+static index_t LayerNormContiguousChannels(const LayerNormParam& param, const TShape& dshape) {
+  int axis = param.axis;
+  if (axis < 0) {
+    axis += static_cast<int>(dshape.ndim());
+  }
+  CHECK(axis >= 0 && axis < static_cast<int>(dshape.ndim()))
+    << "Channel axis out of range: " << param.axis;
+  for (int i = axis + 1; i < static_cast<int>(dshape.ndim()); ++i) {
+    if (dshape[i] != 1) return 0;
+  }
+  return dshape[axis];
+}
+
+/*!
+ * \brief Mean and biased variance of a row in a single pass, with Welford's
+ *  algorithm. Eight interleaved lanes are updated together so that the updates
+ *  vectorize; the lanes and the remaining elements are then merged with Chan's
+ *  formula for combining the moments of two sets.
+ */
+template<typename DType, typename AccReal>
+static void LayerNormRowMoments(const DType* x, const index_t n, AccReal* mean, AccReal* var) {
+  const int kLanes = 8;
+  AccReal lane_mean[kLanes] = {0}, lane_m2[kLanes] = {0};
+  const index_t steps = n / kLanes;
+  for (index_t k = 0; k < steps; ++k) {
+    const AccReal inv_count = AccReal(1) / static_cast<AccReal>(k + 1);
+    const DType* xk = x + k * kLanes;
+    for (int l = 0; l < kLanes; ++l) {
+      const AccReal v = static_cast<AccReal>(xk[l]);
+      const AccReal delta = v - lane_mean[l];
+      lane_mean[l] += delta * inv_count;
+      lane_m2[l] += delta * (v - lane_mean[l]);
+    }
+  }
+  AccReal m = 0, m2 = 0, count = 0;
+  auto merge = [&](const AccReal other_mean, const AccReal other_m2, const AccReal other_count) {
+    const AccReal total = count + other_count;
+    const AccReal delta = other_mean - m;
+    m += delta * other_count / total;
+    m2 += other_m2 + delta * delta * count * other_count / total;
+    count = total;
+  };
+  if (steps > 0) {
+    for (int l = 0; l < kLanes; ++l) merge(lane_mean[l], lane_m2[l], steps);
+  }
+  for (index_t j = steps * kLanes; j < n; ++j) merge(static_cast<AccReal>(x[j]), 0, 1);
+  *mean = m;
+  *var = m2 / static_cast<AccReal>(n);
+}
+
+template<typename DType, typename AccReal>
+static void LayerNormRowsCPU(const LayerNormParam& param, const index_t rows,
+                             const index_t channels, const std::vector<TBlob>& inputs,
+                             const std::vector<TBlob>& outputs) {
+  const DType* data = inputs[layernorm::kData].dptr<DType>();
+  const DType* gamma = inputs[layernorm::kGamma].dptr<DType>();
+  const DType* beta = inputs[layernorm::kBeta].dptr<DType>();
+  DType* out = outputs[layernorm::kOut].dptr<DType>();
+  DType* mean = outputs[layernorm::kMean].dptr<DType>();
+  DType* std = outputs[layernorm::kStd].dptr<DType>();
+  const AccReal eps = param.eps;
+  #pragma omp parallel for num_threads(engine::OpenMP::Get()->GetRecommendedOMPThreadCount())
+  for (index_t i = 0; i < rows; ++i) {
+    const DType* x = data + i * channels;
+    DType* y = out + i * channels;
+    AccReal row_mean, row_var;
+    LayerNormRowMoments(x, channels, &row_mean, &row_var);
+    const AccReal row_std = std::sqrt(row_var + eps);
+    const AccReal inv_std = AccReal(1) / row_std;
+    for (index_t j = 0; j < channels; ++j) {
+      y[j] = static_cast<DType>((static_cast<AccReal>(x[j]) - row_mean) * inv_std
+                                * static_cast<AccReal>(gamma[j])
+                                + static_cast<AccReal>(beta[j]));
+    }
+    mean[i] = static_cast<DType>(row_mean);
+    std[i] = static_cast<DType>(row_std);
+  }
+}
+
+/*!
+ * \brief LayerNorm over contiguous channels: one pass over each row for its mean
+ *  and variance, and a second one to normalize it and apply gamma and beta,
+ *  instead of the reductions and broadcasts over the whole tensor of the generic
+ *  implementation.
+ */
+static void LayerNormComputeCPU(const nnvm::NodeAttrs& attrs,
+                                const OpContext& ctx, const std::vector<TBlob>& inputs,
+                                const std::vector<OpReqType>& req,
+                                const std::vector<TBlob>& outputs) {
+  const LayerNormParam& param = nnvm::get<LayerNormParam>(attrs.parsed);
+  if (req[0] == kNullOp) return;
+  CHECK_NE(req[0], kAddTo);
+  CHECK_EQ(inputs.size(), 3U);
+  const index_t channels = LayerNormContiguousChannels(param, inputs[0].shape_);
+  if (channels == 0) {
+    LayerNormCompute<cpu>(attrs, ctx, inputs, req, outputs);
+    return;
+  }
+  const index_t rows = inputs[0].Size() / channels;
+  MSHADOW_REAL_TYPE_SWITCH_EX(inputs[0].type_flag_, DType, AccReal, {
+    LayerNormRowsCPU<DType, AccReal>(param, rows, channels, inputs, outputs);
+  });
+}
+
+template<typename DType, typename AccReal>
+static void LayerNormGradRowsCPU(const OpContext& ctx, const index_t rows,
+                                 const index_t channels, const std::vector<TBlob>& inputs,
+                                 const std::vector<OpReqType>& req,
+                                 const std::vector<TBlob>& outputs) {
+  using namespace mshadow;
+  const int nthreads = engine::OpenMP::Get()->GetRecommendedOMPThreadCount();
+  const bool need_params_grad = req[1] != kNullOp || req[2] != kNullOp;
+  Stream<cpu> *s = ctx.get_stream<cpu>();
+  const DType* ograd = inputs[0].dptr<DType>();
+  const DType* data = inputs[1].dptr<DType>();
+  const DType* gamma = inputs[2].dptr<DType>();
+  const DType* mean = inputs[3].dptr<DType>();
+  const DType* std = inputs[4].dptr<DType>();
+  DType* data_grad = outputs[0].dptr<DType>();
+  // per thread sums of ograd * normalized data, and of ograd
+  AccReal* params_grad = nullptr;
+  if (need_params_grad) {
+    params_grad = ctx.requested[0].get_space_typed<cpu, 1, AccReal>(
+      Shape1(nthreads * 2 * channels), s).dptr_;
+    // The team may get fewer threads than requested, the sums of the missing ones stay zero.
+    std::fill(params_grad, params_grad + nthreads * 2 * channels, AccReal(0));
+  }
+  #pragma omp parallel num_threads(nthreads)
+  {
+    AccReal* gamma_grad_sum = nullptr;
+    AccReal* beta_grad_sum = nullptr;
+    if (need_params_grad) {
+      gamma_grad_sum = params_grad + omp_get_thread_num() * 2 * channels;
+      beta_grad_sum = gamma_grad_sum + channels;
+    }
+    #pragma omp for
+    for (index_t i = 0; i < rows; ++i) {
+      const DType* og = ograd + i * channels;
+      const DType* x = data + i * channels;
+      const AccReal row_mean = static_cast<AccReal>(mean[i]);
+      const AccReal inv_std = AccReal(1) / static_cast<AccReal>(std[i]);
+      if (need_params_grad) {
+        for (index_t j = 0; j < channels; ++j) {
+          const AccReal g = static_cast<AccReal>(og[j]);
+          gamma_grad_sum[j] += g * (static_cast<AccReal>(x[j]) - row_mean) * inv_std;
+          beta_grad_sum[j] += g;
+        }
+      }
+      if (req[0] == kNullOp) continue;
+      // w = ograd * gamma / std
+      // grad_data = w - mean(w) - normalized_data * mean(w * normalized_data)
+      AccReal sum_w = 0, sum_w_xhat = 0;
+      for (index_t j = 0; j < channels; ++j) {
+        const AccReal w = static_cast<AccReal>(og[j]) * static_cast<AccReal>(gamma[j]) * inv_std;
+        sum_w += w;
+        sum_w_xhat += w * (static_cast<AccReal>(x[j]) - row_mean) * inv_std;
+      }
+      const AccReal mean_w = sum_w / channels;
+      const AccReal mean_w_xhat = sum_w_xhat / channels;
+      DType* dx = data_grad + i * channels;
+      for (index_t j = 0; j < channels; ++j) {
+        const AccReal w = static_cast<AccReal>(og[j]) * static_cast<AccReal>(gamma[j]) * inv_std;
+        const AccReal xhat = (static_cast<AccReal>(x[j]) - row_mean) * inv_std;
+        const AccReal grad = w - mean_w - xhat * mean_w_xhat;
+        if (req[0] == kAddTo) {
+          dx[j] = static_cast<DType>(static_cast<AccReal>(dx[j]) + grad);
+        } else {
+          dx[j] = static_cast<DType>(grad);
+        }
+      }
+    }
+  }
+  if (need_params_grad) {
+    DType* gamma_grad = outputs[1].dptr<DType>();
+    DType* beta_grad = outputs[2].dptr<DType>();
+    #pragma omp parallel for num_threads(nthreads)
+    for (index_t j = 0; j < channels; ++j) {
+      AccReal gamma_sum = 0, beta_sum = 0;
+      for (int t = 0; t < nthreads; ++t) {
+        gamma_sum += params_grad[t * 2 * channels + j];
+        beta_sum += params_grad[t * 2 * channels + channels + j];
+      }
+      KERNEL_ASSIGN(gamma_grad[j], req[1], static_cast<DType>(gamma_sum));
+      KERNEL_ASSIGN(beta_grad[j], req[2], static_cast<DType>(beta_sum));
+    }
+  }
+}
+
+/*!
+ * \brief Gradient of LayerNorm over contiguous channels, see LayerNormGradCompute.
+ *  grad_data is computed row by row with two passes; grad_gamma and grad_beta
+ *  are summed over the rows of each thread into its own buffer, the buffers
+ *  being added up at the end.
+ */
+static void LayerNormGradComputeCPU(const nnvm::NodeAttrs& attrs,
+                                    const OpContext& ctx, const std::vector<TBlob>& inputs,
+                                    const std::vector<OpReqType>& req,
+                                    const std::vector<TBlob>& outputs) {
+  CHECK_EQ(inputs.size(), 5U);
+  const LayerNormParam& param = nnvm::get<LayerNormParam>(attrs.parsed);
+  const index_t channels = LayerNormContiguousChannels(param, inputs[1].shape_);
+  if (channels == 0) {
+    LayerNormGradCompute<cpu>(attrs, ctx, inputs, req, outputs);
+    return;
+  }
+  const index_t rows = inputs[1].Size() / channels;
+  MSHADOW_REAL_TYPE_SWITCH_EX(inputs[0].type_flag_, DType, AccReal, {
+    LayerNormGradRowsCPU<DType, AccReal>(ctx, rows, channels, inputs, req, outputs);
+  });
+}
 
 NNVM_REGISTER_OP(LayerNorm)
 .describe(R"code(Layer normalization.
@@ -110,7 +327,7 @@ axis to be the last item in the input shape.
 })
 .set_attr<nnvm::FInferShape>("FInferShape", LayerNormShape)
 .set_attr<nnvm::FInferType>("FInferType", ElemwiseType<3, 3>)
-.set_attr<FCompute>("FCompute<cpu>", LayerNormCompute<cpu>)
+.set_attr<FCompute>("FCompute<cpu>", LayerNormComputeCPU)
 .set_attr<nnvm::FGradient>("FGradient", [](const nnvm::NodePtr& n,
                                            const std::vector<nnvm::NodeEntry>& ograds) {
   std::vector<nnvm::NodeEntry> heads;
@@ -139,7 +356,7 @@ NNVM_REGISTER_OP(_backward_LayerNorm)
 .set_num_outputs(3)
 .set_attr<nnvm::TIsBackward>("TIsBackward", true)
 .set_attr_parser(ParamParser<LayerNormParam>)
-.set_attr<FCompute>("FCompute<cpu>", LayerNormGradCompute<cpu>)
+.set_attr<FCompute>("FCompute<cpu>", LayerNormGradComputeCPU)
 .set_attr<FResourceRequest>("FResourceRequest", [](const NodeAttrs& n) {
   return std::vector<ResourceRequest>{ResourceRequest::kTempSpace};
 });
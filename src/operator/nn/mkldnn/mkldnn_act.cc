@@ -135,24 +135,20 @@ static MKLDNNActForward &GetActForward(const ActivationParam& param,
                                        const OpContext &ctx, const NDArray &in_data,
                                        const mkldnn::memory &in_mem) {
 #if DMLC_CXX11_THREAD_LOCAL
-  static thread_local std::unordered_map<MKLDNNActSignature, MKLDNNActForward, OpHash> fwds;
+  static thread_local MKLDNNPrimitiveCache<MKLDNNActSignature, MKLDNNActForward, OpHash>
+      fwds("Activation");
 #else
-  static MX_THREAD_LOCAL std::unordered_map<MKLDNNActSignature, MKLDNNActForward, OpHash> fwds;
+  static MX_THREAD_LOCAL MKLDNNPrimitiveCache<MKLDNNActSignature, MKLDNNActForward, OpHash>
+      fwds("Activation");
 #endif
   MKLDNNActSignature key(param);
   key.AddSign(ctx.is_train);
   key.AddSign(param.act_type);
   key.AddSign(in_data);
 
-  auto it = fwds.find(key);
-  if (it == fwds.end()) {
-    MKLDNNActForward fwd(param, ctx.is_train, in_data, in_mem);
-    auto ins_ret = fwds.insert(std::pair<MKLDNNActSignature, MKLDNNActForward>(
-            key, fwd));
-    CHECK(ins_ret.second);
-    it = ins_ret.first;
-  }
-  return it->second;
+  return fwds.GetOrCreate(key, [&]() {
+    return MKLDNNActForward(param, ctx.is_train, in_data, in_mem);
+  });
 }
 
 void MKLDNNActivationForward(const nnvm::NodeAttrs& attrs, const OpContext &ctx,
@@ -47,7 +47,9 @@
 #define MXNET_OPERATOR_NN_MKLDNN_MKLDNN_BASE_INL_H_
 
 #if MXNET_USE_MKLDNN == 1
+#include <chrono>
 #include <iterator>
+#include <list>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -278,6 +280,76 @@ class TmpMemMgr {
   mkldnn::memory *Alloc(const mkldnn::memory::primitive_desc &pd);
 };
 
+/*!
+ * \brief Hit, miss and eviction counts and total creation time of the
+ *  primitive caches of an operator, summed over all threads. They are
+ *  reported as counters of the "MKLDNN primitive cache" profiler domain.
+ */
+class MKLDNNCacheStats {
+ public:
+  /*! \brief the statistics of an operator, created on first use */
+  static MKLDNNCacheStats *Get(const std::string &op_name);
+  /*! \brief the number of entries of each cache, MXNET_MKLDNN_CACHE_NUM */
+  static size_t Capacity();
+
+  void AddHit();
+  void AddMiss(uint64_t create_us);
+  void AddEviction();
+  ~MKLDNNCacheStats();
+
+ private:
+  explicit MKLDNNCacheStats(const std::string &op_name);
+  struct Counters;
+  std::unique_ptr<Counters> counters_;
+};
+
+/*!
+ * \brief Per-thread cache of the forward primitives of an operator, keyed by
+ *  the signature of their inputs. The least recently used primitive is
+ *  evicted once the cache holds MXNET_MKLDNN_CACHE_NUM of them, so inputs
+ *  of varying shapes do not make it grow without bound. A reference returned
+ *  by GetOrCreate stays valid until the next primitive created in the cache.
+ */
+template<typename Key, typename Value, typename Hash>
+class MKLDNNPrimitiveCache {
+ public:
+  explicit MKLDNNPrimitiveCache(const std::string &op_name,
+                                size_t capacity = MKLDNNCacheStats::Capacity())
+    : stats_(MKLDNNCacheStats::Get(op_name)), capacity_(capacity) {}
+
+  /*! \brief find the primitive of the key, creating it with fcreate() if needed */
+  template<typename FCreate>
+  Value &GetOrCreate(const Key &key, FCreate fcreate) {
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      entries_.splice(entries_.begin(), entries_, it->second);
+      stats_->AddHit();
+      return it->second->second;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    entries_.emplace_front(key, fcreate());
+    stats_->AddMiss(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count());
+    index_.emplace(key, entries_.begin());
+    if (capacity_ > 0 && entries_.size() > capacity_) {
+      index_.erase(entries_.back().first);
+      entries_.pop_back();
+      stats_->AddEviction();
+    }
+    return entries_.front().second;
+  }
+
+  size_t size() const { return entries_.size(); }
+
+ private:
+  typedef std::list<std::pair<Key, Value>> EntryList;
+  /*! \brief entries from the most to the least recently used */
+  EntryList entries_;
+  std::unordered_map<Key, typename EntryList::iterator, Hash> index_;
+  MKLDNNCacheStats *stats_;
+  size_t capacity_;
+};
+
 class MKLDNNStream {
   std::vector<mkldnn::primitive> net;
   // Here we hold all memory related to the operators in the stream.
@@ -371,6 +443,17 @@ static inline void CreateDefaultInputs(const std::vector<NDArray> &arrs,
 const mkldnn::memory *GetWeights(const NDArray &arr,
                                  const mkldnn::memory::primitive_desc &target_pd,
                                  int num_groups);
+/*
+ * For inference, get the weights in the layout of target_pd without
+ * reordering them at every call. By default a copy of the weights is
+ * reordered once and kept with the weight array, whose layout doesn't change,
+ * so the array can be shared by executors and predictors. With
+ * MXNET_MKLDNN_CACHE_WEIGHTS=0 the weight array itself is reordered after it
+ * is used, which saves the memory of the copy.
+ */
+const mkldnn::memory *GetInferenceWeights(NDArray *arr,
+                                          const mkldnn::memory::primitive_desc &target_pd,
+                                          int num_groups);
 
 mkldnn_memory_format_t GetDefaultFormat(const mkldnn::memory::desc &desc);
 mkldnn_memory_format_t GetDefaultFormat(int num_dims);
@@ -20,9 +20,11 @@
 #if MXNET_USE_MKLDNN == 1
 
 #include <atomic>
+#include <mutex>
 #include "./mkldnn_base-inl.h"
 #include "./mkldnn_ops-inl.h"
 #include "../../../common/exec_utils.h"
+#include "../../../profiler/profiler.h"
 #include "../../operator_common.h"
 
 namespace mxnet {
@@ -36,6 +38,68 @@ MKLDNNStream *MKLDNNStream::Get() {
   return &stream;
 }
 
+struct MKLDNNCacheStats::Counters {
+  std::atomic<uint64_t> hits{0}, misses{0}, evictions{0}, create_us{0};
+  profiler::ProfileCounter hit_counter, miss_counter, eviction_counter, create_us_counter;
+  // ProfileCounter itself is not thread-safe, so the profiler updates are serialized.
+  std::mutex report_mutex;
+
+  static profiler::ProfileDomain *Domain() {
+    static profiler::ProfileDomain domain("MKLDNN primitive cache");
+    return &domain;
+  }
+
+  explicit Counters(const std::string &op_name)
+    : hit_counter((op_name + " hits").c_str(), Domain()),
+      miss_counter((op_name + " misses").c_str(), Domain()),
+      eviction_counter((op_name + " evictions").c_str(), Domain()),
+      create_us_counter((op_name + " creation us").c_str(), Domain()) {}
+
+  // The counters are only sent to the profiler while it runs.
+  void Report(profiler::ProfileCounter *counter, const std::atomic<uint64_t> &total) {
+    if (profiler::Profiler::Get()->GetState() == profiler::Profiler::kRunning) {
+      std::lock_guard<std::mutex> lock(report_mutex);
+      *counter = total.load();
+    }
+  }
+};
+
+MKLDNNCacheStats::MKLDNNCacheStats(const std::string &op_name)
+  : counters_(new Counters(op_name)) {}
+
+MKLDNNCacheStats::~MKLDNNCacheStats() {}
+
+MKLDNNCacheStats *MKLDNNCacheStats::Get(const std::string &op_name) {
+  static std::mutex mutex;
+  static std::unordered_map<std::string, std::unique_ptr<MKLDNNCacheStats>> stats;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto &ptr = stats[op_name];
+  if (!ptr) ptr.reset(new MKLDNNCacheStats(op_name));
+  return ptr.get();
+}
+
+size_t MKLDNNCacheStats::Capacity() {
+  static const int capacity = dmlc::GetEnv("MXNET_MKLDNN_CACHE_NUM", 1024);
+  return capacity > 0 ? capacity : 0;
+}
+
+void MKLDNNCacheStats::AddHit() {
+  ++counters_->hits;
+  counters_->Report(&counters_->hit_counter, counters_->hits);
+}
+
+void MKLDNNCacheStats::AddMiss(uint64_t create_us) {
+  ++counters_->misses;
+  counters_->create_us += create_us;
+  counters_->Report(&counters_->miss_counter, counters_->misses);
+  counters_->Report(&counters_->create_us_counter, counters_->create_us);
+}
+
+void MKLDNNCacheStats::AddEviction() {
+  ++counters_->evictions;
+  counters_->Report(&counters_->eviction_counter, counters_->evictions);
+}
+
 void *AlignMem(void *mem, size_t size, size_t alignment, size_t *space) {
   if (size > *space)
     return nullptr;
@@ -228,6 +292,37 @@ void CommitOutput(const NDArray &arr, const mkldnn_output_t &res) {
   }
 }
 
+/*
+ * The primitive_desc of a weight array in a default format, with the groups of
+ * a grouped convolution as the outermost dimension.
+ */
+static mkldnn::memory::primitive_desc GetWeightsDefaultPD(const NDArray &arr,
+                                                          int num_groups) {
+  const TShape &shape = arr.shape();
+  mkldnn::memory::dims tz;
+  mkldnn::memory::format format = mkldnn::memory::format::format_undef;
+  if (shape.ndim() == 2) {
+    tz = mkldnn::memory::dims{static_cast<int>(shape[0]), static_cast<int>(shape[1])};
+    format = mkldnn::memory::format::oi;
+  } else if (shape.ndim() == 4 && num_groups == 1) {
+    tz = mkldnn::memory::dims{
+      static_cast<int>(shape[0]), static_cast<int>(shape[1]),
+          static_cast<int>(shape[2]), static_cast<int>(shape[3])};
+    format = mkldnn::memory::format::oihw;
+  } else if (shape.ndim() == 4) {
+    tz = mkldnn::memory::dims{ num_groups,
+      static_cast<int>(shape[0] / num_groups),
+      static_cast<int>(shape[1]),
+      static_cast<int>(shape[2]),
+      static_cast<int>(shape[3])};
+    format = mkldnn::memory::format::goihw;
+  } else {
+    LOG(FATAL) << "The weight array has an unsupported number of dimensions";
+  }
+  mkldnn::memory::desc md{tz, get_mkldnn_type(arr.dtype()), format};
+  return mkldnn::memory::primitive_desc{md, CpuEngine::Get()->get_engine()};
+}
+
 const mkldnn::memory *GetWeights(const NDArray &arr,
                                  const mkldnn::memory::primitive_desc &target_pd,
                                  int num_groups) {
@@ -237,40 +332,7 @@ const mkldnn::memory *GetWeights(const NDArray &arr,
   if (mem)
     return mem;
 
-  mkldnn::memory::data_type type = get_mkldnn_type(arr.dtype());
-  auto engine = CpuEngine::Get()->get_engine();
-  if (arr.shape().ndim() == 2) {
-    mkldnn::memory::dims tz = mkldnn::memory::dims{
-      static_cast<int>(arr.shape()[0]), static_cast<int>(arr.shape()[1])};
-    mkldnn::memory::desc md =
-        mkldnn::memory::desc{tz, type, mkldnn::memory::format::oi};
-    mkldnn::memory::primitive_desc pd =
-        mkldnn::memory::primitive_desc{md, engine};
-    mem = arr.GetMKLDNNData(pd);
-  } else if (arr.shape().ndim() == 4 && num_groups == 1) {
-    mkldnn::memory::dims tz = mkldnn::memory::dims{
-      static_cast<int>(arr.shape()[0]), static_cast<int>(arr.shape()[1]),
-          static_cast<int>(arr.shape()[2]), static_cast<int>(arr.shape()[3])};
-    mkldnn::memory::desc md =
-        mkldnn::memory::desc{tz, type, mkldnn::memory::format::oihw};
-    mkldnn::memory::primitive_desc pd =
-        mkldnn::memory::primitive_desc{md, engine};
-    mem = arr.GetMKLDNNData(pd);
-  } else if (arr.shape().ndim() == 4) {
-    mkldnn::memory::dims tz = mkldnn::memory::dims{ num_groups,
-      static_cast<int>(arr.shape()[0] / num_groups),
-      static_cast<int>(arr.shape()[1]),
-      static_cast<int>(arr.shape()[2]),
-      static_cast<int>(arr.shape()[3])};
-    mkldnn::memory::desc md =
-        mkldnn::memory::desc{tz, type, mkldnn::memory::format::goihw};
-    mkldnn::memory::primitive_desc pd =
-        mkldnn::memory::primitive_desc{md, engine};
-    mem = arr.GetMKLDNNData(pd);
-  } else {
-    LOG(FATAL) << "The weight array has an unsupported number of dimensions";
-    return nullptr;
-  }
+  mem = arr.GetMKLDNNData(GetWeightsDefaultPD(arr, num_groups));
   if (mem == nullptr)
     mem = arr.GetMKLDNNDataReorder(target_pd);
   if (mem->get_primitive_desc() == target_pd) return mem;
@@ -280,6 +342,23 @@ const mkldnn::memory *GetWeights(const NDArray &arr,
   return ret;
 }
 
+const mkldnn::memory *GetInferenceWeights(NDArray *arr,
+                                          const mkldnn::memory::primitive_desc &target_pd,
+                                          int num_groups) {
+  static const bool cache_weights = dmlc::GetEnv("MXNET_MKLDNN_CACHE_WEIGHTS", true);
+  const mkldnn::memory *mem = arr->GetMKLDNNData(target_pd);
+  if (mem)
+    return mem;
+  if (cache_weights && !arr->IsView())
+    return arr->GetMKLDNNDataCopy(GetWeightsDefaultPD(*arr, num_groups), target_pd);
+
+  mem = GetWeights(*arr, target_pd, num_groups);
+  // The data conversion happens after the weight array is used.
+  if (arr->IsDefaultData())
+    arr->MKLDNNDataReorderAsync(target_pd);
+  return mem;
+}
+
 mkldnn_memory_format_t GetDefaultFormat(int num_dims) {
   switch (num_dims) {
     case 1: return mkldnn_x;
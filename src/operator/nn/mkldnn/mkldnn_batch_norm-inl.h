@@ -185,25 +185,21 @@ static MKLDNNBNForward &GetBNForward(const BatchNormParam& param,
                                      const OpContext &ctx, const NDArray &in_data,
                                      unsigned flags) {
 #if DMLC_CXX11_THREAD_LOCAL
-  static thread_local std::unordered_map<MKLDNNBNSignature, MKLDNNBNForward, OpHash> fwds;
+  static thread_local MKLDNNPrimitiveCache<MKLDNNBNSignature, MKLDNNBNForward, OpHash>
+      fwds("BatchNorm");
 #else
-  static MX_THREAD_LOCAL std::unordered_map<MKLDNNBNSignature, MKLDNNBNForward, OpHash> fwds;
+  static MX_THREAD_LOCAL MKLDNNPrimitiveCache<MKLDNNBNSignature, MKLDNNBNForward, OpHash>
+      fwds("BatchNorm");
 #endif
   MKLDNNBNSignature key(param);
   key.AddSign(ctx.is_train);
   key.AddSign(in_data);
 
-  auto it = fwds.find(key);
-  if (it == fwds.end()) {
+  return fwds.GetOrCreate(key, [&]() -> MKLDNNBNForward {
     auto fwd_pd = _GetFwd(*in_data.GetMKLDNNData(), ctx.is_train,
                           (DType) param.eps, flags);
-    MKLDNNBNForward fwd(fwd_pd, ctx.is_train);
-    auto ins_ret = fwds.insert(std::pair<MKLDNNBNSignature, MKLDNNBNForward>(
-            key, fwd));
-    CHECK(ins_ret.second);
-    it = ins_ret.first;
-  }
-  return it->second;
+    return MKLDNNBNForward(fwd_pd, ctx.is_train);
+  });
 }
 
 template <typename DType>
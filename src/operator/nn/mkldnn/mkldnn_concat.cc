@@ -76,23 +76,16 @@ static MKLDNNConcatFwd &GetConcatForward(
     int concat_dim, const std::vector<NDArray> &in_data,
     const std::vector<mkldnn::memory::primitive_desc> &data_md) {
 #if DMLC_CXX11_THREAD_LOCAL
-  static thread_local std::unordered_map<OpSignature, MKLDNNConcatFwd, OpHash> fwds;
+  static thread_local MKLDNNPrimitiveCache<OpSignature, MKLDNNConcatFwd, OpHash> fwds("Concat");
 #else
-  static MX_THREAD_LOCAL std::unordered_map<OpSignature, MKLDNNConcatFwd, OpHash> fwds;
+  static MX_THREAD_LOCAL MKLDNNPrimitiveCache<OpSignature, MKLDNNConcatFwd, OpHash>
+      fwds("Concat");
 #endif
   OpSignature key;
   key.AddSign(concat_dim);
   key.AddSign(in_data);
 
-  auto it = fwds.find(key);
-  if (it == fwds.end()) {
-    MKLDNNConcatFwd fwd(concat_dim, data_md);
-    auto ins_ret = fwds.insert(std::pair<OpSignature, MKLDNNConcatFwd>(
-            key, fwd));
-    CHECK(ins_ret.second);
-    it = ins_ret.first;
-  }
-  return it->second;
+  return fwds.GetOrCreate(key, [&]() { return MKLDNNConcatFwd(concat_dim, data_md); });
 }
 
 void MKLDNNConcatForward(const nnvm::NodeAttrs& attrs, const OpContext &ctx,
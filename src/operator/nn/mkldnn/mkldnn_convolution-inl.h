@@ -35,6 +35,38 @@
 namespace mxnet {
 namespace op {
 
+struct MKLDNNConvParam : public dmlc::Parameter<MKLDNNConvParam> {
+  bool with_bn;
+  bool with_relu;
+  bool with_sum;
+  bool with_postsum_relu;
+
+  DMLC_DECLARE_PARAMETER(MKLDNNConvParam) {
+    DMLC_DECLARE_FIELD(with_bn).set_default(false)
+    .describe("Add post batchnorm.");
+    DMLC_DECLARE_FIELD(with_relu).set_default(false)
+    .describe("Add post relu");
+    DMLC_DECLARE_FIELD(with_sum).set_default(false)
+    .describe("Add post sum");
+    DMLC_DECLARE_FIELD(with_postsum_relu).set_default(false)
+    .describe("Add post relu after sum");
+  }
+};
+
+/*!
+ * \brief Convolution parameters together with the operators fused after the
+ *  convolution, which are applied as MKLDNN post-ops.
+ */
+struct MKLDNNConvFullParam {
+  ConvolutionParam conv_param;
+  MKLDNNConvParam mkldnn_param;
+  float sum_scale = 1.0f;
+};
+
+mkldnn::convolution_forward::primitive_desc GetConvFwdImpl(
+    const MKLDNNConvFullParam& param, const bool is_train, const NDArray &data,
+    const NDArray &weights, const NDArray *bias, const NDArray &output);
+
 mkldnn::convolution_forward::primitive_desc GetConvFwdImpl(
     const ConvolutionParam& param, const bool is_train, const NDArray &data,
     const NDArray &weights, const NDArray *bias, const NDArray &output);
@@ -43,6 +75,12 @@ class MKLDNNConvForward {
  public:
   mkldnn::convolution_forward::primitive_desc fwd_pd;
 
+  MKLDNNConvForward(const MKLDNNConvFullParam& param, const bool is_train,
+                    const NDArray &data, const NDArray &weights,
+                    const NDArray *bias, const NDArray &output): fwd_pd(
+                        GetConvFwdImpl(param, is_train, data, weights, bias, output)) {
+  }
+
   MKLDNNConvForward(const ConvolutionParam& param, const bool is_train,
                     const NDArray &data, const NDArray &weights,
                     const NDArray *bias, const NDArray &output): fwd_pd(
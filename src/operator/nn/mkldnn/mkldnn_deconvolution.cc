@@ -211,17 +211,9 @@ void MKLDNNDeconvForward::SetDataHandle(const DeconvolutionParam& param,
       weight.Reorder2DefaultAsync();
     weight_mem = GetWeights(weight, fwd_pd.weights_primitive_desc(), param.num_group);
   } else {
-    // For inference, we want to reorder the weight array so we don't need to
-    // reorder data every time.
-    if (weight.IsDefaultData()) {
-      weight_mem = GetWeights(weight, fwd_pd.weights_primitive_desc(), param.num_group);
-      // We also need to modify the layout on the original weight array. The
-      // data conversion happens after the weight array is used.
-      weight.MKLDNNDataReorderAsync(fwd_pd.weights_primitive_desc());
-    } else {
-      weight_mem = weight.GetMKLDNNData();
-      CHECK(weight_mem->get_primitive_desc() == fwd_pd.weights_primitive_desc());
-    }
+    // For inference, we don't want to reorder the weights every time.
+    weight_mem = GetInferenceWeights(&weight, fwd_pd.weights_primitive_desc(),
+                                     param.num_group);
   }
   auto out_mem = CreateMKLDNNMem(out_data[deconv::kOut],
       fwd_pd.diff_src_primitive_desc(), req[deconv::kOut]);
@@ -262,10 +254,10 @@ static inline MKLDNNDeconvForward &GetDeconvFwd(
     const NDArray &output) {
 #if DMLC_CXX11_THREAD_LOCAL
   static thread_local
-        std::unordered_map<DeconvSignature, MKLDNNDeconvForward, OpHash> fwds;
+        MKLDNNPrimitiveCache<DeconvSignature, MKLDNNDeconvForward, OpHash> fwds("Deconvolution");
 #else
   static MX_THREAD_LOCAL
-        std::unordered_map<DeconvSignature, MKLDNNDeconvForward, OpHash> fwds;
+        MKLDNNPrimitiveCache<DeconvSignature, MKLDNNDeconvForward, OpHash> fwds("Deconvolution");
 #endif
   const DeconvolutionParam& param = nnvm::get<DeconvolutionParam>(attrs.parsed);
   DeconvSignature key(param);
@@ -278,16 +270,10 @@ static inline MKLDNNDeconvForward &GetDeconvFwd(
   if (bias)
     key.AddSign(*bias);
 
-  auto it = fwds.find(key);
-  if (it == fwds.end()) {
+  return fwds.GetOrCreate(key, [&]() -> MKLDNNDeconvForward {
     bool has_bias = (bias != nullptr);
-    MKLDNNDeconvForward fwd(param, data, weights, has_bias, output);
-    auto ins_ret = fwds.insert(
-        std::pair<DeconvSignature, MKLDNNDeconvForward>(key, fwd));
-    CHECK(ins_ret.second);
-    it = ins_ret.first;
-  }
-  return it->second;
+    return MKLDNNDeconvForward(param, data, weights, has_bias, output);
+  });
 }
 
 void MKLDNNDeconvolutionForward(const nnvm::NodeAttrs& attrs, const OpContext &ctx,
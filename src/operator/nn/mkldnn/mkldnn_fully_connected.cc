@@ -23,14 +23,13 @@
  * \author Da Zheng
 */
 
-#include "../fully_connected-inl.h"
-#include "./mkldnn_base-inl.h"
+#include "./mkldnn_fully_connected-inl.h"
 
 #if MXNET_USE_MKLDNN == 1
 namespace mxnet {
 namespace op {
 
-inline static mkldnn::inner_product_forward::primitive_desc GetIPFwd(
+mkldnn::inner_product_forward::primitive_desc GetIPFwd(
     const NDArray &data, const NDArray &weight, const NDArray *bias,
     const mkldnn::memory::desc &out_md, const bool is_train) {
   auto data_md = GetMemDesc(data);
@@ -82,78 +81,17 @@ inline static mkldnn::inner_product_backward_weights::primitive_desc GetIPBwdWei
   }
 }
 
-class MKLDNNFullyConnectForward {
-  std::shared_ptr<mkldnn::memory> data;
-  std::shared_ptr<mkldnn::memory> weight;
-  std::shared_ptr<mkldnn::memory> out;
-  std::shared_ptr<mkldnn::memory> bias;
-  std::shared_ptr<mkldnn::inner_product_forward> ipFwd;
 
- public:
-  mkldnn::inner_product_forward::primitive_desc ipFwd_pd;
-
-  MKLDNNFullyConnectForward(const FullyConnectedParam &param, bool is_train,
-                            const NDArray &data, const NDArray &weight,
-                            const NDArray *bias,
-                            const mkldnn::memory::desc &output)
-      : ipFwd_pd(GetIPFwd(data, weight, bias, output, is_train)) {}
-
-  void SetNewMem(const mkldnn::memory &data, const mkldnn::memory &weight,
-                 const mkldnn::memory *bias, const mkldnn::memory &output) {
-    if (this->data == nullptr)
-      this->data = std::shared_ptr<mkldnn::memory>(new mkldnn::memory(
-              ipFwd_pd.src_primitive_desc(), data.get_data_handle()));
-    else
-      this->data->set_data_handle(data.get_data_handle());
-
-    if (this->weight == nullptr)
-      this->weight = std::shared_ptr<mkldnn::memory>(new mkldnn::memory(
-              ipFwd_pd.weights_primitive_desc(), weight.get_data_handle()));
-    else
-      this->weight->set_data_handle(weight.get_data_handle());
-
-    if (this->out == nullptr)
-      this->out = std::shared_ptr<mkldnn::memory>(new mkldnn::memory(
-              ipFwd_pd.dst_primitive_desc(), output.get_data_handle()));
-    else
-      this->out->set_data_handle(output.get_data_handle());
-
-    if (bias != nullptr) {
-      if (this->bias == nullptr)
-        this->bias = std::shared_ptr<mkldnn::memory>(new mkldnn::memory(
-        ipFwd_pd.bias_primitive_desc(), bias->get_data_handle()));
-      else
-        this->bias->set_data_handle(bias->get_data_handle());
-      if (this->ipFwd == nullptr)
-        this->ipFwd = std::shared_ptr<mkldnn::inner_product_forward>(
-            new mkldnn::inner_product_forward(
-                ipFwd_pd, mkldnn::primitive::at(*this->data),
-                mkldnn::primitive::at(*this->weight),
-                mkldnn::primitive::at(*this->bias), *this->out));
-    } else if (this->ipFwd == nullptr) {
-      this->ipFwd = std::shared_ptr<mkldnn::inner_product_forward>(
-          new mkldnn::inner_product_forward(
-              ipFwd_pd, mkldnn::primitive::at(*this->data),
-              mkldnn::primitive::at(*this->weight), *this->out));
-    }
-  }
-  const mkldnn::inner_product_forward &GetIpFwd() const {
-    return *ipFwd;
-  }
-};
-
-typedef ParamOpSign<FullyConnectedParam> MKLDNNFullyconSignature;
-
-static inline MKLDNNFullyConnectForward &GetFCFwd(
+MKLDNNFullyConnectForward &GetFCFwd(
     const nnvm::NodeAttrs &attrs, const NDArray &data, const NDArray &weight,
     const NDArray *bias, const mkldnn::memory::desc &output,
     const bool is_train) {
 #if DMLC_CXX11_THREAD_LOCAL
-  static thread_local std::unordered_map<MKLDNNFullyconSignature,
-              MKLDNNFullyConnectForward, OpHash> fcFwds;
+  static thread_local MKLDNNPrimitiveCache<MKLDNNFullyconSignature,
+              MKLDNNFullyConnectForward, OpHash> fcFwds("FullyConnected");
 #else
-  static MX_THREAD_LOCAL std::unordered_map<MKLDNNFullyconSignature,
-              MKLDNNFullyConnectForward, OpHash> fcFwds;
+  static MX_THREAD_LOCAL MKLDNNPrimitiveCache<MKLDNNFullyconSignature,
+              MKLDNNFullyConnectForward, OpHash> fcFwds("FullyConnected");
 #endif
   const FullyConnectedParam& param = nnvm::get<FullyConnectedParam>(attrs.parsed);
   MKLDNNFullyconSignature key(param);
@@ -164,16 +102,9 @@ static inline MKLDNNFullyConnectForward &GetFCFwd(
   if (bias)
     key.AddSign(*bias);
 
-  auto it = fcFwds.find(key);
-  if (it == fcFwds.end()) {
-    MKLDNNFullyConnectForward fcFwd(param, is_train, data, weight, bias,
-                                    output);
-    auto ins_ret = fcFwds.insert(
-        std::pair<MKLDNNFullyconSignature, MKLDNNFullyConnectForward>(key, fcFwd));
-    CHECK(ins_ret.second);
-    it = ins_ret.first;
-  }
-  return it->second;
+  return fcFwds.GetOrCreate(key, [&]() {
+    return MKLDNNFullyConnectForward(param, is_train, data, weight, bias, output);
+  });
 }
 
 void MKLDNNFCForward(const nnvm::NodeAttrs& attrs, const OpContext &ctx,
@@ -210,7 +141,9 @@ void MKLDNNFCForward(const nnvm::NodeAttrs& attrs, const OpContext &ctx,
       GetFCFwd(attrs, data, weight, param.no_bias ? nullptr : &in_data[fullc::kBias],
                out_md, ctx.is_train);
   auto data_mem = data.GetMKLDNNDataReorder(FCFwd.ipFwd_pd.src_primitive_desc());
-  auto weight_mem = weight.GetMKLDNNDataReorder(FCFwd.ipFwd_pd.weights_primitive_desc());
+  auto weight_mem = ctx.is_train ?
+      weight.GetMKLDNNDataReorder(FCFwd.ipFwd_pd.weights_primitive_desc()) :
+      GetInferenceWeights(&weight, FCFwd.ipFwd_pd.weights_primitive_desc(), 1);
   auto out_mem = CreateMKLDNNMem(out_data[fullc::kOut],
       FCFwd.ipFwd_pd.dst_primitive_desc(), req[fullc::kOut], &data);
   if (!param.no_bias) {
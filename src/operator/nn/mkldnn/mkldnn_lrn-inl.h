@@ -153,13 +153,13 @@ static MKLDNNLRNFwd &GetLRNFwd(const LRNParam& param,
                                const OpContext &ctx,
                                const NDArray &in_data) {
 #if DMLC_CXX11_THREAD_LOCAL
-  static thread_local std::unordered_map<MKLDNNLRNSignature,
-                                         MKLDNNLRNFwd,
-                                         OpHash> lrn_fwds;
+  static thread_local MKLDNNPrimitiveCache<MKLDNNLRNSignature,
+                                           MKLDNNLRNFwd,
+                                           OpHash> lrn_fwds("LRN");
 #else
-  static MX_THREAD_LOCAL std::unordered_map<MKLDNNLRNSignature,
-                                            MKLDNNLRNFwd,
-                                            OpHash> lrn_fwds;
+  static MX_THREAD_LOCAL MKLDNNPrimitiveCache<MKLDNNLRNSignature,
+                                              MKLDNNLRNFwd,
+                                              OpHash> lrn_fwds("LRN");
 #endif
   auto alg_ = algorithm::lrn_across_channels;
   auto kind_ = prop_kind::forward_training;
@@ -174,15 +174,9 @@ static MKLDNNLRNFwd &GetLRNFwd(const LRNParam& param,
   key.AddSign(kind_);
   key.AddSign(in_data);
 
-  auto it = lrn_fwds.find(key);
-  if (it == lrn_fwds.end()) {
-    MKLDNNLRNFwd fwd(param, ctx.is_train, in_data);
-    auto ins_ret = lrn_fwds.insert(std::pair<MKLDNNLRNSignature, MKLDNNLRNFwd>
-                                   (key, fwd));
-    CHECK(ins_ret.second);
-    it = ins_ret.first;
-  }
-  return it->second;
+  return lrn_fwds.GetOrCreate(key, [&]() {
+    return MKLDNNLRNFwd(param, ctx.is_train, in_data);
+  });
 }
 
 void MKLDNNLRNForward(const OpContext &ctx,
@@ -192,13 +192,13 @@ MKLDNNPoolingFwd &GetPoolingFwd(const PoolingParam &param,
                                 const NDArray &data,
                                 const NDArray &output) {
 #if DMLC_CXX11_THREAD_LOCAL
-  static thread_local std::unordered_map<MKLDNNPoolingSignature,
-                                         MKLDNNPoolingFwd,
-                                         OpHash> pooling_fwds;
+  static thread_local MKLDNNPrimitiveCache<MKLDNNPoolingSignature,
+                                           MKLDNNPoolingFwd,
+                                           OpHash> pooling_fwds("Pooling");
 #else
-  static MX_THREAD_LOCAL std::unordered_map<MKLDNNPoolingSignature,
-                                            MKLDNNPoolingFwd,
-                                            OpHash> pooling_fwds;
+  static MX_THREAD_LOCAL MKLDNNPrimitiveCache<MKLDNNPoolingSignature,
+                                              MKLDNNPoolingFwd,
+                                              OpHash> pooling_fwds("Pooling");
 #endif
 
   bool with_workspace = is_train && MKLDNNRequireWorkspace(param);
@@ -208,8 +208,7 @@ MKLDNNPoolingFwd &GetPoolingFwd(const PoolingParam &param,
   key.AddSign(data);
   key.AddSign(output);
 
-  auto it = pooling_fwds.find(key);
-  if (it == pooling_fwds.end()) {
+  return pooling_fwds.GetOrCreate(key, [&]() -> MKLDNNPoolingFwd {
     CHECK_EQ(param.kernel.ndim(), 2) << "Not Implemented";
     auto data_md = data.GetMKLDNNData()->get_primitive_desc().desc();
     int kernel_h_, kernel_w_;
@@ -242,14 +241,9 @@ MKLDNNPoolingFwd &GetPoolingFwd(const PoolingParam &param,
     }
 
     const mkldnn::algorithm alg = GetMKLDNNPoolAlgo(param);
-    MKLDNNPoolingFwd fwd(data, output, kernel_h_, kernel_w_, stride_h_, stride_w_,
-                         pad_t_, pad_b_, pad_l_, pad_r_, alg, with_workspace, is_train);
-    auto ins_ret = pooling_fwds.insert(
-        std::pair<MKLDNNPoolingSignature, MKLDNNPoolingFwd>(key, fwd));
-    CHECK(ins_ret.second);
-    it = ins_ret.first;
-  }
-  return it->second;
+    return MKLDNNPoolingFwd(data, output, kernel_h_, kernel_w_, stride_h_, stride_w_,
+                            pad_t_, pad_b_, pad_l_, pad_r_, alg, with_workspace, is_train);
+  });
 }
 
 void MKLDNNPoolingCompute(const OpContext &ctx, const PoolingParam &param,
@@ -626,6 +626,49 @@ inline bool StdOptStorageType(const nnvm::NodeAttrs& attrs,
   return dispatched;
 }
 
+/*!
+ * \brief Storge type inference function for optimizers which only support lazy update
+ *        with row_sparse gradient on cpu. The weight and the states should share the
+ *        same storage type, otherwise the inputs fall back to dense storage.
+ * \param num_states The number of states that could be row_sparse or dense
+ */
+template<size_t num_states, typename ParamType>
+inline bool LazyOptStorageType(const nnvm::NodeAttrs& attrs,
+                               const int dev_mask,
+                               DispatchMode* dispatch_mode,
+                               std::vector<int>* in_attrs,
+                               std::vector<int>* out_attrs) {
+  using namespace common;
+  const ParamType& param = nnvm::get<ParamType>(attrs.parsed);
+  // weight, grad, state 0, state 1, ... -> weight
+  CHECK_EQ(in_attrs->size(), 2 + num_states);
+  CHECK_EQ(out_attrs->size(), 1U);
+  const int weight_stype = in_attrs->at(0);
+  const int grad_stype = in_attrs->at(1);
+  bool states_match = true;
+  for (size_t i = 2; i < 2 + num_states; i++) {
+    states_match = states_match && in_attrs->at(i) == weight_stype;
+  }
+  bool dispatched = false;
+  if (!dispatched && ContainsOnlyStorage(*in_attrs, kDefaultStorage)) {
+    // dns, ... -> dns
+    dispatched = storage_type_assign(out_attrs, kDefaultStorage,
+                                     dispatch_mode, DispatchMode::kFCompute);
+  }
+  if (!dispatched && dev_mask == mshadow::cpu::kDevMask && param.lazy_update &&
+      grad_stype == kRowSparseStorage && states_match &&
+      (weight_stype == kRowSparseStorage || weight_stype == kDefaultStorage)) {
+    // weight and states share stype, grad's stype = rsp -> lazy update
+    dispatched = storage_type_assign(out_attrs, static_cast<NDArrayStorageType>(weight_stype),
+                                     dispatch_mode, DispatchMode::kFComputeEx);
+    if (dispatched) LogLazyUpdate();
+  }
+  if (!dispatched) {
+    dispatched = dispatch_fallback(out_attrs, dispatch_mode);
+  }
+  return dispatched;
+}
+
 /*
  * \brief kernel for standard momentum update for dense weight, sparse grad and dense state.
  */
@@ -717,6 +760,7 @@ struct FTMLParam : public dmlc::Parameter<FTMLParam> {
   float wd;
   float rescale_grad;
   float clip_grad;
+  bool lazy_update;
   DMLC_DECLARE_PARAMETER(FTMLParam) {
     DMLC_DECLARE_FIELD(lr)
     .describe("Learning rate.");
@@ -746,6 +790,10 @@ struct FTMLParam : public dmlc::Parameter<FTMLParam> {
     .describe("Clip gradient to the range of [-clip_gradient, clip_gradient] "
               "If clip_gradient <= 0, gradient clipping is turned off. "
               "grad = max(min(grad, clip_gradient), -clip_gradient).");
+    DMLC_DECLARE_FIELD(lazy_update)
+    .set_default(true)
+    .describe("If true, lazy updates are applied if gradient's stype is row_sparse "
+              "and all of w, d, v and z have the same stype");
   }
 };
 
@@ -1099,6 +1147,148 @@ inline void AdamUpdateEx(const nnvm::NodeAttrs& attrs,
   }
 }
 
+struct MultiSGDParam : public dmlc::Parameter<MultiSGDParam> {
+  nnvm::Tuple<float> lrs;
+  nnvm::Tuple<float> wds;
+  float rescale_grad;
+  float clip_gradient;
+  int num_weights;
+  DMLC_DECLARE_PARAMETER(MultiSGDParam) {
+    DMLC_DECLARE_FIELD(lrs)
+    .describe("Learning rates of the weights.");
+    DMLC_DECLARE_FIELD(wds)
+    .describe("Weight decays of the weights.");
+    DMLC_DECLARE_FIELD(rescale_grad)
+    .set_default(1.0f)
+    .describe("Rescale gradient to grad = rescale_grad*grad.");
+    DMLC_DECLARE_FIELD(clip_gradient)
+    .set_default(-1.0f)
+    .describe("Clip gradient to the range of [-clip_gradient, clip_gradient] "
+              "If clip_gradient <= 0, gradient clipping is turned off. "
+              "grad = max(min(grad, clip_gradient), -clip_gradient).");
+    DMLC_DECLARE_FIELD(num_weights)
+    .set_default(1)
+    .describe("Number of updated weights.");
+  }
+};
+
+struct MultiSGDMomParam : public dmlc::Parameter<MultiSGDMomParam> {
+  nnvm::Tuple<float> lrs;
+  nnvm::Tuple<float> wds;
+  float momentum;
+  float rescale_grad;
+  float clip_gradient;
+  int num_weights;
+  DMLC_DECLARE_PARAMETER(MultiSGDMomParam) {
+    DMLC_DECLARE_FIELD(lrs)
+    .describe("Learning rates of the weights.");
+    DMLC_DECLARE_FIELD(wds)
+    .describe("Weight decays of the weights.");
+    DMLC_DECLARE_FIELD(momentum)
+    .set_default(0.0f)
+    .describe("The decay rate of momentum estimates at each epoch.");
+    DMLC_DECLARE_FIELD(rescale_grad)
+    .set_default(1.0f)
+    .describe("Rescale gradient to grad = rescale_grad*grad.");
+    DMLC_DECLARE_FIELD(clip_gradient)
+    .set_default(-1.0f)
+    .describe("Clip gradient to the range of [-clip_gradient, clip_gradient] "
+              "If clip_gradient <= 0, gradient clipping is turned off. "
+              "grad = max(min(grad, clip_gradient), -clip_gradient).");
+    DMLC_DECLARE_FIELD(num_weights)
+    .set_default(1)
+    .describe("Number of updated weights.");
+  }
+};
+
+struct MultiAdamParam : public dmlc::Parameter<MultiAdamParam> {
+  nnvm::Tuple<float> lrs;
+  nnvm::Tuple<float> wds;
+  float beta1;
+  float beta2;
+  float epsilon;
+  float rescale_grad;
+  float clip_gradient;
+  int num_weights;
+  DMLC_DECLARE_PARAMETER(MultiAdamParam) {
+    DMLC_DECLARE_FIELD(lrs)
+    .describe("Learning rates of the weights.");
+    DMLC_DECLARE_FIELD(wds)
+    .describe("Weight decays of the weights.");
+    DMLC_DECLARE_FIELD(beta1)
+    .set_default(0.9f)
+    .describe("The decay rate for the 1st moment estimates.");
+    DMLC_DECLARE_FIELD(beta2)
+    .set_default(0.999f)
+    .describe("The decay rate for the 2nd moment estimates.");
+    DMLC_DECLARE_FIELD(epsilon)
+    .set_default(1e-8f)
+    .describe("A small constant for numerical stability.");
+    DMLC_DECLARE_FIELD(rescale_grad)
+    .set_default(1.0f)
+    .describe("Rescale gradient to grad = rescale_grad*grad.");
+    DMLC_DECLARE_FIELD(clip_gradient)
+    .set_default(-1.0f)
+    .describe("Clip gradient to the range of [-clip_gradient, clip_gradient] "
+              "If clip_gradient <= 0, gradient clipping is turned off. "
+              "grad = max(min(grad, clip_gradient), -clip_gradient).");
+    DMLC_DECLARE_FIELD(num_weights)
+    .set_default(1)
+    .describe("Number of updated weights.");
+  }
+};
+
+/*!
+ * \brief Shape inference of a multi-tensor update, whose inputs are the weight,
+ *  the gradient and the states of every weight one after the other and whose
+ *  outputs are the updated weights.
+ */
+template<typename ParamType, int input_stride>
+inline bool MultiUpdateShape(const nnvm::NodeAttrs& attrs,
+                             std::vector<TShape> *in_attrs,
+                             std::vector<TShape> *out_attrs) {
+  const ParamType& param = nnvm::get<ParamType>(attrs.parsed);
+  CHECK_EQ(in_attrs->size(), static_cast<size_t>(input_stride * param.num_weights));
+  CHECK_EQ(out_attrs->size(), static_cast<size_t>(param.num_weights));
+  CHECK_EQ(param.lrs.ndim(), static_cast<size_t>(param.num_weights))
+    << "Expected one learning rate per weight";
+  CHECK_EQ(param.wds.ndim(), static_cast<size_t>(param.num_weights))
+    << "Expected one weight decay per weight";
+  bool all_inferred = true;
+  for (int i = 0; i < param.num_weights; ++i) {
+    std::vector<TShape> in_shapes(in_attrs->begin() + i * input_stride,
+                                  in_attrs->begin() + (i + 1) * input_stride);
+    std::vector<TShape> out_shapes(1, out_attrs->at(i));
+    all_inferred = ElemwiseShape<input_stride, 1>(attrs, &in_shapes, &out_shapes) &&
+                   all_inferred;
+    std::copy(in_shapes.begin(), in_shapes.end(), in_attrs->begin() + i * input_stride);
+    out_attrs->at(i) = out_shapes[0];
+  }
+  return all_inferred;
+}
+
+/*!
+ * \brief Dense adam update of one element, the same as AdamUpdate but without
+ *  modifying the gradient.
+ */
+struct AdamKernel {
+  template<typename DType>
+  MSHADOW_XINLINE static void Map(int i, DType* out_data, DType* mean_data, DType* var_data,
+    const DType* weight_data, const DType* grad_data, const DType clip_gradient,
+    const DType beta1, const DType beta2, const DType lr, const DType wd, const DType epsilon,
+    const DType rescale_grad, const OpReqType req) {
+    using namespace mshadow_op;
+    DType grad_rescaled = rescale_grad * grad_data[i] + wd * weight_data[i];
+    if (clip_gradient >= 0.0f) {
+      grad_rescaled = clip::Map(grad_rescaled, clip_gradient);
+    }
+    mean_data[i] = beta1 * mean_data[i] + (1.f - beta1) * grad_rescaled;
+    var_data[i] = beta2 * var_data[i] + (1.f - beta2) * square::Map(grad_rescaled);
+    KERNEL_ASSIGN(out_data[i], req, weight_data[i] - lr * mean_data[i] /
+                  (square_root::Map(var_data[i]) + epsilon));
+  }
+};
+
 // This RMSProp code follows the version in
 // http://arxiv.org/pdf/1308.0850v5.pdf Eq(38) - Eq(45)
 // by Alex Graves, 2013.
@@ -1111,6 +1301,7 @@ struct RMSPropAlexParam : public dmlc::Parameter<RMSPropAlexParam> {
   float rescale_grad;
   float clip_gradient;
   float clip_weights;
+  bool lazy_update;
   DMLC_DECLARE_PARAMETER(RMSPropAlexParam) {
     DMLC_DECLARE_FIELD(lr)
     .describe("Learning rate");
@@ -1137,6 +1328,30 @@ struct RMSPropAlexParam : public dmlc::Parameter<RMSPropAlexParam> {
     .describe("Clip weights to the range of [-clip_weights, clip_weights] "
               "If clip_weights <= 0, weight clipping is turned off. "
               "weights = max(min(weights, clip_weights), -clip_weights).");
+    DMLC_DECLARE_FIELD(lazy_update)
+    .set_default(true)
+    .describe("If true, lazy updates are applied if gradient's stype is row_sparse "
+              "and all of w, n, g and delta have the same stype");
+  }
+};
+
+struct RMSPropAlexKernel {
+  template<typename DType>
+  MSHADOW_XINLINE static void Map(int i, DType* out, const DType* weight, const DType* grad,
+    DType* state_n, DType* state_g, DType* delta, const DType lr, const DType gamma1,
+    const DType gamma2, const DType epsilon, const DType wd, const DType rescale_grad,
+    const DType clip_gradient, const DType clip_weights, const OpReqType req) {
+    using namespace mshadow_op;
+    const DType grad_rescaled = rescale_grad * grad[i] + wd * weight[i];
+    const DType grad_i = clip_gradient >= 0.0f ? clip::Map(grad_rescaled, clip_gradient)
+                                               : grad_rescaled;
+    state_n[i] = (1 - gamma1) * grad_i * grad_i + gamma1 * state_n[i];
+    state_g[i] = (1 - gamma1) * grad_i + gamma1 * state_g[i];
+    delta[i] = gamma2 * delta[i] -
+               lr * (grad_i / square_root::Map(state_n[i] - state_g[i] * state_g[i] + epsilon));
+    const DType weight_i = weight[i] + delta[i];
+    KERNEL_ASSIGN(out[i], req, clip_weights >= 0.0f ? clip::Map(weight_i, clip_weights)
+                                                    : weight_i);
   }
 };
 
@@ -1146,51 +1361,18 @@ inline void RMSPropAlexUpdate(const nnvm::NodeAttrs &attrs,
                               const std::vector<TBlob> &inputs,
                               const std::vector<OpReqType> &req,
                               const std::vector<TBlob> &outputs) {
-  using namespace mshadow;
-  using namespace mshadow::expr;
-  using namespace mshadow_op;
+  using namespace mxnet_op;
   const RMSPropAlexParam &param = nnvm::get<RMSPropAlexParam>(attrs.parsed);
   Stream<xpu> *s = ctx.get_stream<xpu>();
   MSHADOW_REAL_TYPE_SWITCH(inputs[0].type_flag_, DType, {
-    Tensor<xpu, 2, DType> weight = inputs[0].FlatTo2D<xpu, DType>(s);
-    Tensor<xpu, 2, DType> grad = inputs[1].FlatTo2D<xpu, DType>(s);
-    Tensor<xpu, 2, DType> state_n = inputs[2].FlatTo2D<xpu, DType>(s);
-    Tensor<xpu, 2, DType> state_g = inputs[3].FlatTo2D<xpu, DType>(s);
-    Tensor<xpu, 2, DType> delta = inputs[4].FlatTo2D<xpu, DType>(s);
-    Tensor<xpu, 2, DType> out = outputs[0].FlatTo2D<xpu, DType>(s);
-
-    grad = scalar<DType>(param.rescale_grad) * grad +
-           scalar<DType>(param.wd) * weight;
-
-    if (param.clip_gradient >= 0.0f) {
-      state_n = scalar<DType>(1.f - param.gamma1) *
-                    F<clip>(grad, DType(param.clip_gradient)) *
-                    F<clip>(grad, DType(param.clip_gradient)) +
-                scalar<DType>(param.gamma1) * state_n;
-      state_g = scalar<DType>(1.f - param.gamma1) *
-                    F<clip>(grad, DType(param.clip_gradient)) +
-                scalar<DType>(param.gamma1) * state_g;
-      delta = scalar<DType>(param.gamma2) * delta -
-              scalar<DType>(param.lr) *
-                  (F<clip>(grad, DType(param.clip_gradient)) /
-                   (F<square_root>(state_n - state_g * state_g +
-                                   scalar<DType>(param.epsilon))));
-    } else {
-      state_n = scalar<DType>(1.f - param.gamma1) * (grad * grad) +
-                scalar<DType>(param.gamma1) * state_n;
-      state_g = scalar<DType>(1.f - param.gamma1) * grad +
-                scalar<DType>(param.gamma1) * state_g;
-      delta = scalar<DType>(param.gamma2) * delta -
-              scalar<DType>(param.lr) *
-                  (grad / (F<square_root>(state_n - state_g * state_g +
-                                          scalar<DType>(param.epsilon))));
-    }
-
-    if (param.clip_weights >= 0.0f) {
-      Assign(out, req[0], F<clip>(weight + delta, DType(param.clip_weights)));
-    } else {
-      Assign(out, req[0], weight + delta);
-    }
+    Kernel<RMSPropAlexKernel, xpu>::Launch(s, inputs[0].shape_.Size(),
+      outputs[0].dptr<DType>(), inputs[0].dptr<DType>(), inputs[1].dptr<DType>(),
+      inputs[2].dptr<DType>(), inputs[3].dptr<DType>(), inputs[4].dptr<DType>(),
+      static_cast<DType>(param.lr), static_cast<DType>(param.gamma1),
+      static_cast<DType>(param.gamma2), static_cast<DType>(param.epsilon),
+      static_cast<DType>(param.wd), static_cast<DType>(param.rescale_grad),
+      static_cast<DType>(param.clip_gradient), static_cast<DType>(param.clip_weights),
+      req[0]);
   });
 }
 
@@ -1205,6 +1387,7 @@ struct RMSPropParam : public dmlc::Parameter<RMSPropParam> {
   float rescale_grad;
   float clip_gradient;
   float clip_weights;
+  bool lazy_update;
   DMLC_DECLARE_PARAMETER(RMSPropParam) {
     DMLC_DECLARE_FIELD(lr)
     .describe("Learning rate");
@@ -1229,6 +1412,27 @@ struct RMSPropParam : public dmlc::Parameter<RMSPropParam> {
     .describe("Clip weights to the range of [-clip_weights, clip_weights] "
               "If clip_weights <= 0, weight clipping is turned off. "
               "weights = max(min(weights, clip_weights), -clip_weights).");
+    DMLC_DECLARE_FIELD(lazy_update)
+    .set_default(true)
+    .describe("If true, lazy updates are applied if gradient's stype is row_sparse "
+              "and both weight and n have the same stype");
+  }
+};
+
+struct RMSPropKernel {
+  template<typename DType>
+  MSHADOW_XINLINE static void Map(int i, DType* out, const DType* weight, const DType* grad,
+    DType* state_n, const DType lr, const DType gamma1, const DType epsilon,
+    const DType wd, const DType rescale_grad, const DType clip_gradient,
+    const DType clip_weights, const OpReqType req) {
+    using namespace mshadow_op;
+    const DType grad_rescaled = rescale_grad * grad[i] + wd * weight[i];
+    const DType grad_i = clip_gradient >= 0.0f ? clip::Map(grad_rescaled, clip_gradient)
+                                               : grad_rescaled;
+    state_n[i] = (1 - gamma1) * grad_i * grad_i + gamma1 * state_n[i];
+    const DType weight_i = weight[i] - lr * (grad_i / square_root::Map(state_n[i] + epsilon));
+    KERNEL_ASSIGN(out[i], req, clip_weights >= 0.0f ? clip::Map(weight_i, clip_weights)
+                                                    : weight_i);
   }
 };
 
@@ -1237,59 +1441,17 @@ inline void RMSPropUpdate(const nnvm::NodeAttrs &attrs, const OpContext &ctx,
                           const std::vector<TBlob> &inputs,
                           const std::vector<OpReqType> &req,
                           const std::vector<TBlob> &outputs) {
-  using namespace mshadow;
-  using namespace mshadow::expr;
-  using namespace mshadow_op;
+  using namespace mxnet_op;
   const RMSPropParam &param = nnvm::get<RMSPropParam>(attrs.parsed);
   Stream<xpu> *s = ctx.get_stream<xpu>();
   MSHADOW_REAL_TYPE_SWITCH(inputs[0].type_flag_, DType, {
-    Tensor<xpu, 2, DType> weight = inputs[0].FlatTo2D<xpu, DType>(s);
-    Tensor<xpu, 2, DType> grad = inputs[1].FlatTo2D<xpu, DType>(s);
-    Tensor<xpu, 2, DType> state_n = inputs[2].FlatTo2D<xpu, DType>(s);
-    Tensor<xpu, 2, DType> out = outputs[0].FlatTo2D<xpu, DType>(s);
-
-    grad = scalar<DType>(param.rescale_grad) * grad +
-           scalar<DType>(param.wd) * weight;
-
-    if (param.clip_gradient >= 0.0f) {
-      state_n = scalar<DType>(1.f - param.gamma1) *
-                    F<clip>(grad, DType(param.clip_gradient)) *
-                    F<clip>(grad, DType(param.clip_gradient)) +
-                scalar<DType>(param.gamma1) * state_n;
-      if (param.clip_weights >= 0.0f) {
-        Assign(out, req[0],
-               F<clip>(weight -
-                       scalar<DType>(param.lr) *
-                           (F<clip>(grad, DType(param.clip_gradient)) /
-                            (F<square_root>(state_n +
-                                            scalar<DType>(param.epsilon)))),
-                       DType(param.clip_weights)));
-      } else {
-        Assign(out, req[0], weight -
-                            scalar<DType>(param.lr) *
-                              (F<clip>(grad, DType(param.clip_gradient)) /
-                               (F<square_root>(state_n +
-                                               scalar<DType>(param.epsilon)))));
-      }
-    } else {
-      state_n = scalar<DType>(1.f - param.gamma1) * (grad * grad) +
-                scalar<DType>(param.gamma1) * state_n;
-      if (param.clip_weights >= 0.0f) {
-        Assign(out, req[0],
-               F<clip>(weight -
-                       scalar<DType>(param.lr) *
-                           (grad /
-                            (F<square_root>(state_n +
-                                            scalar<DType>(param.epsilon)))),
-                       DType(param.clip_weights)));
-      } else {
-        Assign(out, req[0], weight -
-                            scalar<DType>(param.lr) *
-                              (grad /
-                               (F<square_root>(state_n +
-                                               scalar<DType>(param.epsilon)))));
-      }
-    }
+    Kernel<RMSPropKernel, xpu>::Launch(s, inputs[0].shape_.Size(),
+      outputs[0].dptr<DType>(), inputs[0].dptr<DType>(), inputs[1].dptr<DType>(),
+      inputs[2].dptr<DType>(), static_cast<DType>(param.lr),
+      static_cast<DType>(param.gamma1), static_cast<DType>(param.epsilon),
+      static_cast<DType>(param.wd), static_cast<DType>(param.rescale_grad),
+      static_cast<DType>(param.clip_gradient), static_cast<DType>(param.clip_weights),
+      req[0]);
   });
 }
 
@@ -1502,6 +1664,7 @@ struct SignSGDParam : public dmlc::Parameter<SignSGDParam> {
   float wd;
   float rescale_grad;
   float clip_gradient;
+  bool lazy_update;
   DMLC_DECLARE_PARAMETER(SignSGDParam) {
     DMLC_DECLARE_FIELD(lr)
     .describe("Learning rate");
@@ -1518,6 +1681,9 @@ struct SignSGDParam : public dmlc::Parameter<SignSGDParam> {
     .describe("Clip gradient to the range of [-clip_gradient, clip_gradient] "
               "If clip_gradient <= 0, gradient clipping is turned off. "
               "grad = max(min(grad, clip_gradient), -clip_gradient).");
+    DMLC_DECLARE_FIELD(lazy_update)
+    .set_default(true)
+    .describe("If true, lazy updates are applied if gradient's stype is row_sparse.");
   }
 };
 
@@ -1564,6 +1730,7 @@ struct SignumParam : public dmlc::Parameter<SignumParam> {
   float rescale_grad;
   float clip_gradient;
   float wd_lh;  // the amount of algorithmic weight decay by Loshchilov and Frank Hutter
+  bool lazy_update;
   DMLC_DECLARE_PARAMETER(SignumParam) {
     DMLC_DECLARE_FIELD(lr)
     .describe("Learning rate");
@@ -1587,6 +1754,10 @@ struct SignumParam : public dmlc::Parameter<SignumParam> {
     .set_default(0.0f)
     .describe("The amount of weight decay that does not go into gradient/momentum calculations"
               "otherwise do weight decay algorithmically only.");
+    DMLC_DECLARE_FIELD(lazy_update)
+    .set_default(true)
+    .describe("If true, lazy updates are applied if gradient's stype is row_sparse "
+              "and both weight and momentum have the same stype");
   }
 };
 
@@ -1632,6 +1803,74 @@ inline void SignumUpdate(const nnvm::NodeAttrs& attrs,
     });
 }
 
+// Nesterov accelerated gradient, as in the NAG python optimizer
+struct NAGMomParam : public dmlc::Parameter<NAGMomParam> {
+  float lr;
+  float momentum;
+  float wd;
+  float rescale_grad;
+  float clip_gradient;
+  bool lazy_update;
+  DMLC_DECLARE_PARAMETER(NAGMomParam) {
+    DMLC_DECLARE_FIELD(lr)
+    .describe("Learning rate");
+    DMLC_DECLARE_FIELD(momentum)
+    .set_default(0.0f)
+    .describe("The decay rate of momentum estimates at each epoch.");
+    DMLC_DECLARE_FIELD(wd)
+    .set_default(0.0f)
+    .describe("Weight decay augments the objective function with a "
+              "regularization term that penalizes large weights. "
+              "The penalty scales with the square of the magnitude of each weight.");
+    DMLC_DECLARE_FIELD(rescale_grad)
+    .set_default(1.0f)
+    .describe("Rescale gradient to grad = rescale_grad*grad.");
+    DMLC_DECLARE_FIELD(clip_gradient)
+    .set_default(-1.0f)
+    .describe("Clip gradient to the range of [-clip_gradient, clip_gradient] "
+              "If clip_gradient <= 0, gradient clipping is turned off. "
+              "grad = max(min(grad, clip_gradient), -clip_gradient).");
+    DMLC_DECLARE_FIELD(lazy_update)
+    .set_default(true)
+    .describe("If true, lazy updates are applied if gradient's stype is row_sparse "
+              "and both weight and momentum have the same stype");
+  }
+};
+
+struct NAGMomKernel {
+  template<typename DType>
+  MSHADOW_XINLINE static void Map(int i, DType* out_data, DType* mom_data,
+    const DType* weight_data, const DType* grad_data, const DType param_clip_gradient,
+    const DType param_momentum, const DType param_lr, const DType param_wd,
+    const DType param_rescale_grad, const OpReqType req) {
+    const DType grad_rescaled = param_rescale_grad * grad_data[i];
+    const DType grad_i = (param_clip_gradient >= 0.0f
+                          ? mshadow_op::clip::Map(grad_rescaled, param_clip_gradient)
+                          : grad_rescaled) + param_wd * weight_data[i];
+    mom_data[i] = param_momentum * mom_data[i] + grad_i;
+    KERNEL_ASSIGN(out_data[i], req, weight_data[i]
+      - param_lr * (grad_i + param_momentum * mom_data[i]));
+  }
+};
+
+template<typename xpu>
+inline void NAGMomUpdate(const nnvm::NodeAttrs& attrs,
+                         const OpContext &ctx,
+                         const std::vector<TBlob> &inputs,
+                         const std::vector<OpReqType> &req,
+                         const std::vector<TBlob> &outputs) {
+  using namespace mxnet_op;
+  const NAGMomParam& param = nnvm::get<NAGMomParam>(attrs.parsed);
+  Stream<xpu>* s = ctx.get_stream<xpu>();
+  MSHADOW_REAL_TYPE_SWITCH(inputs[0].type_flag_, DType, {
+    Kernel<NAGMomKernel, xpu>::Launch(s, inputs[0].shape_.Size(), outputs[0].dptr<DType>(),
+      inputs[2].dptr<DType>(), inputs[0].dptr<DType>(), inputs[1].dptr<DType>(),
+      static_cast<DType>(param.clip_gradient), static_cast<DType>(param.momentum),
+      static_cast<DType>(param.lr), static_cast<DType>(param.wd),
+      static_cast<DType>(param.rescale_grad), req[0]);
+  });
+}
+
 struct AdagradParam : public dmlc::Parameter<AdagradParam> {
   float lr;
   float epsilon;
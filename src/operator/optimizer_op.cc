@@ -25,6 +25,9 @@
  */
 #include "./optimizer_op-inl.h"
 #include "./elemwise_op_common.h"
+#include <algorithm>
+#include <string>
+#include "../engine/openmp.h"
 
 namespace mxnet {
 namespace op {
@@ -33,14 +36,215 @@ DMLC_REGISTER_PARAMETER(SGDParam);
 DMLC_REGISTER_PARAMETER(SGDMomParam);
 DMLC_REGISTER_PARAMETER(FTMLParam);
 DMLC_REGISTER_PARAMETER(AdamParam);
+DMLC_REGISTER_PARAMETER(MultiSGDParam);
+DMLC_REGISTER_PARAMETER(MultiSGDMomParam);
+DMLC_REGISTER_PARAMETER(MultiAdamParam);
 DMLC_REGISTER_PARAMETER(RMSPropParam);
 DMLC_REGISTER_PARAMETER(RMSPropAlexParam);
 DMLC_REGISTER_PARAMETER(FtrlParam);
 DMLC_REGISTER_PARAMETER(SignSGDParam);
 DMLC_REGISTER_PARAMETER(SignumParam);
 DMLC_REGISTER_PARAMETER(AdagradParam);
+DMLC_REGISTER_PARAMETER(NAGMomParam);
+
+/*!
+ * \brief Prepares a lazy update on cpu with row_sparse gradient: fills the row_sparse
+ *        states with zeros if they are not initialized yet.
+ * \return false if there is nothing to update
+ */
+static bool LazyUpdateInit(const char* op_name, const OpContext& ctx,
+                           const std::vector<NDArray>& inputs, const OpReqType req) {
+  CheckAllRowsPresent(inputs[0], op_name, "weights");
+  Stream<cpu>* s = ctx.get_stream<cpu>();
+  for (size_t i = 2; i < inputs.size(); ++i) {
+    if (inputs[i].storage_type() == kRowSparseStorage && !inputs[i].storage_initialized()) {
+      NDArray state_zeros = inputs[i];
+      FillDnsZerosRspImpl(s, &state_zeros);
+    }
+    CheckAllRowsPresent(inputs[i], op_name, "states");
+  }
+  if (!inputs[1].storage_initialized() || req == kNullOp) return false;
+  CHECK_EQ(req, kWriteInplace) << "kWriteInplace is expected for the lazy update of " << op_name;
+  return true;
+}
+
+/*!
+ * \brief Calls update_row(row, grad_row) in parallel for every row present in the
+ *        row_sparse gradient, with the offsets of the row in the weight (and states)
+ *        and in the gradient values. The cost is proportional to the number of rows
+ *        in the gradient, not to the size of the weight.
+ */
+template<typename IType, typename F>
+static void LazyUpdateRowsImpl(const IType* grad_idx, const nnvm::dim_t num_rows,
+                               const nnvm::dim_t row_length, const F& update_row) {
+  #pragma omp parallel for num_threads(engine::OpenMP::Get()->GetRecommendedOMPThreadCount())
+  for (nnvm::dim_t i = 0; i < num_rows; ++i) {
+    update_row(static_cast<nnvm::dim_t>(grad_idx[i]) * row_length, i * row_length);
+  }
+}
+
+template<typename F>
+static void LazyUpdateRows(const NDArray& grad, const nnvm::dim_t row_length,
+                           const F& update_row) {
+  const nnvm::dim_t num_rows = grad.aux_shape(rowsparse::kIdx)[0];
+  MSHADOW_IDX_TYPE_SWITCH(grad.aux_type(rowsparse::kIdx), IType, {
+    LazyUpdateRowsImpl(grad.aux_data(rowsparse::kIdx).dptr<IType>(), num_rows, row_length,
+                       update_row);
+  });
+}
+
+static void SignSGDLazyUpdateEx(const nnvm::NodeAttrs& attrs,
+                                const OpContext &ctx,
+                                const std::vector<NDArray> &inputs,
+                                const std::vector<OpReqType> &req,
+                                const std::vector<NDArray> &outputs) {
+  const SignSGDParam& param = nnvm::get<SignSGDParam>(attrs.parsed);
+  if (!LazyUpdateInit("SignSGDUpdate", ctx, inputs, req[0])) return;
+  const nnvm::dim_t row_length = inputs[0].shape().ProdShape(1, inputs[0].shape().ndim());
+  MSHADOW_REAL_TYPE_SWITCH(inputs[0].dtype(), DType, {
+    DType* out = outputs[0].data().dptr<DType>();
+    const DType* weight = inputs[0].data().dptr<DType>();
+    const DType* grad = inputs[1].data().dptr<DType>();
+    LazyUpdateRows(inputs[1], row_length, [&](nnvm::dim_t row, nnvm::dim_t grad_row) {
+      for (nnvm::dim_t j = 0; j < row_length; ++j) {
+        SignSGDKernel::Map(j, out + row, weight + row, grad + grad_row,
+          static_cast<DType>(param.clip_gradient), static_cast<DType>(param.lr),
+          static_cast<DType>(param.wd), static_cast<DType>(param.rescale_grad), req[0]);
+      }
+    });
+  });
+}
+
+static void SignumLazyUpdateEx(const nnvm::NodeAttrs& attrs,
+                               const OpContext &ctx,
+                               const std::vector<NDArray> &inputs,
+                               const std::vector<OpReqType> &req,
+                               const std::vector<NDArray> &outputs) {
+  const SignumParam& param = nnvm::get<SignumParam>(attrs.parsed);
+  if (!LazyUpdateInit("SignumUpdate", ctx, inputs, req[0])) return;
+  const nnvm::dim_t row_length = inputs[0].shape().ProdShape(1, inputs[0].shape().ndim());
+  MSHADOW_REAL_TYPE_SWITCH(inputs[0].dtype(), DType, {
+    DType* out = outputs[0].data().dptr<DType>();
+    const DType* weight = inputs[0].data().dptr<DType>();
+    const DType* grad = inputs[1].data().dptr<DType>();
+    DType* mom = inputs[2].data().dptr<DType>();
+    LazyUpdateRows(inputs[1], row_length, [&](nnvm::dim_t row, nnvm::dim_t grad_row) {
+      for (nnvm::dim_t j = 0; j < row_length; ++j) {
+        SignumKernel::Map(j, out + row, mom + row, weight + row, grad + grad_row,
+          static_cast<DType>(param.clip_gradient), static_cast<DType>(param.momentum),
+          static_cast<DType>(param.lr), static_cast<DType>(param.wd),
+          static_cast<DType>(param.rescale_grad), static_cast<DType>(param.wd_lh), req[0]);
+      }
+    });
+  });
+}
+
+static void NAGMomLazyUpdateEx(const nnvm::NodeAttrs& attrs,
+                               const OpContext &ctx,
+                               const std::vector<NDArray> &inputs,
+                               const std::vector<OpReqType> &req,
+                               const std::vector<NDArray> &outputs) {
+  const NAGMomParam& param = nnvm::get<NAGMomParam>(attrs.parsed);
+  if (!LazyUpdateInit("NAGMomUpdate", ctx, inputs, req[0])) return;
+  const nnvm::dim_t row_length = inputs[0].shape().ProdShape(1, inputs[0].shape().ndim());
+  MSHADOW_REAL_TYPE_SWITCH(inputs[0].dtype(), DType, {
+    DType* out = outputs[0].data().dptr<DType>();
+    const DType* weight = inputs[0].data().dptr<DType>();
+    const DType* grad = inputs[1].data().dptr<DType>();
+    DType* mom = inputs[2].data().dptr<DType>();
+    LazyUpdateRows(inputs[1], row_length, [&](nnvm::dim_t row, nnvm::dim_t grad_row) {
+      for (nnvm::dim_t j = 0; j < row_length; ++j) {
+        NAGMomKernel::Map(j, out + row, mom + row, weight + row, grad + grad_row,
+          static_cast<DType>(param.clip_gradient), static_cast<DType>(param.momentum),
+          static_cast<DType>(param.lr), static_cast<DType>(param.wd),
+          static_cast<DType>(param.rescale_grad), req[0]);
+      }
+    });
+  });
+}
+
+static void FTMLLazyUpdateEx(const nnvm::NodeAttrs& attrs,
+                             const OpContext &ctx,
+                             const std::vector<NDArray> &inputs,
+                             const std::vector<OpReqType> &req,
+                             const std::vector<NDArray> &outputs) {
+  const FTMLParam& param = nnvm::get<FTMLParam>(attrs.parsed);
+  if (!LazyUpdateInit("FTMLUpdate", ctx, inputs, req[0])) return;
+  const nnvm::dim_t row_length = inputs[0].shape().ProdShape(1, inputs[0].shape().ndim());
+  MSHADOW_REAL_TYPE_SWITCH(inputs[0].dtype(), DType, {
+    DType* out = outputs[0].data().dptr<DType>();
+    DType* weight = inputs[0].data().dptr<DType>();
+    DType* grad = inputs[1].data().dptr<DType>();
+    DType* d = inputs[2].data().dptr<DType>();
+    DType* v = inputs[3].data().dptr<DType>();
+    DType* z = inputs[4].data().dptr<DType>();
+    LazyUpdateRows(inputs[1], row_length, [&](nnvm::dim_t row, nnvm::dim_t grad_row) {
+      for (nnvm::dim_t j = 0; j < row_length; ++j) {
+        FTMLKernel::Map(j, out + row, weight + row, grad + grad_row, d + row, v + row, z + row,
+          static_cast<DType>(param.lr), static_cast<DType>(param.beta1),
+          static_cast<DType>(param.beta2), static_cast<DType>(param.epsilon),
+          static_cast<DType>(param.t), static_cast<DType>(param.wd),
+          static_cast<DType>(param.rescale_grad), static_cast<DType>(param.clip_grad), req[0]);
+      }
+    });
+  });
+}
+
+static void RMSPropLazyUpdateEx(const nnvm::NodeAttrs& attrs,
+                                const OpContext &ctx,
+                                const std::vector<NDArray> &inputs,
+                                const std::vector<OpReqType> &req,
+                                const std::vector<NDArray> &outputs) {
+  const RMSPropParam& param = nnvm::get<RMSPropParam>(attrs.parsed);
+  if (!LazyUpdateInit("RMSPropUpdate", ctx, inputs, req[0])) return;
+  const nnvm::dim_t row_length = inputs[0].shape().ProdShape(1, inputs[0].shape().ndim());
+  MSHADOW_REAL_TYPE_SWITCH(inputs[0].dtype(), DType, {
+    DType* out = outputs[0].data().dptr<DType>();
+    const DType* weight = inputs[0].data().dptr<DType>();
+    const DType* grad = inputs[1].data().dptr<DType>();
+    DType* state_n = inputs[2].data().dptr<DType>();
+    LazyUpdateRows(inputs[1], row_length, [&](nnvm::dim_t row, nnvm::dim_t grad_row) {
+      for (nnvm::dim_t j = 0; j < row_length; ++j) {
+        RMSPropKernel::Map(j, out + row, weight + row, grad + grad_row, state_n + row,
+          static_cast<DType>(param.lr), static_cast<DType>(param.gamma1),
+          static_cast<DType>(param.epsilon), static_cast<DType>(param.wd),
+          static_cast<DType>(param.rescale_grad), static_cast<DType>(param.clip_gradient),
+          static_cast<DType>(param.clip_weights), req[0]);
+      }
+    });
+  });
+}
+
+static void RMSPropAlexLazyUpdateEx(const nnvm::NodeAttrs& attrs,
+                                    const OpContext &ctx,
+                                    const std::vector<NDArray> &inputs,
+                                    const std::vector<OpReqType> &req,
+                                    const std::vector<NDArray> &outputs) {
+  const RMSPropAlexParam& param = nnvm::get<RMSPropAlexParam>(attrs.parsed);
+  if (!LazyUpdateInit("RMSPropAlexUpdate", ctx, inputs, req[0])) return;
+  const nnvm::dim_t row_length = inputs[0].shape().ProdShape(1, inputs[0].shape().ndim());
+  MSHADOW_REAL_TYPE_SWITCH(inputs[0].dtype(), DType, {
+    DType* out = outputs[0].data().dptr<DType>();
+    const DType* weight = inputs[0].data().dptr<DType>();
+    const DType* grad = inputs[1].data().dptr<DType>();
+    DType* state_n = inputs[2].data().dptr<DType>();
+    DType* state_g = inputs[3].data().dptr<DType>();
+    DType* delta = inputs[4].data().dptr<DType>();
+    LazyUpdateRows(inputs[1], row_length, [&](nnvm::dim_t row, nnvm::dim_t grad_row) {
+      for (nnvm::dim_t j = 0; j < row_length; ++j) {
+        RMSPropAlexKernel::Map(j, out + row, weight + row, grad + grad_row, state_n + row,
+          state_g + row, delta + row, static_cast<DType>(param.lr),
+          static_cast<DType>(param.gamma1), static_cast<DType>(param.gamma2),
+          static_cast<DType>(param.epsilon), static_cast<DType>(param.wd),
+          static_cast<DType>(param.rescale_grad), static_cast<DType>(param.clip_gradient),
+          static_cast<DType>(param.clip_weights), req[0]);
+      }
+    });
+  });
+}
 
 NNVM_REGISTER_OP(signsgd_update)
+MXNET_ADD_SPARSE_OP_ALIAS(signsgd_update)
 .describe(R"code(Update function for SignSGD optimizer.
 
 .. math::
@@ -52,21 +256,28 @@ It updates the weights using::
 
  weight = weight - learning_rate * sign(gradient)
 
-.. note:: 
-   - sparse ndarray not supported for this optimizer yet.
+However, if grad's storage type is ``row_sparse`` and ``lazy_update`` is True,
+only the row slices whose indices appear in grad.indices are updated::
+
+  for row in gradient.indices:
+      weight[row] = weight[row] - learning_rate * sign(gradient[row])
+
 )code" ADD_FILELINE)
 .set_num_inputs(2)
 .set_num_outputs(1)
 .set_attr_parser(ParamParser<SignSGDParam>)
 .set_attr<nnvm::FInferShape>("FInferShape", ElemwiseShape<2, 1>)
 .set_attr<nnvm::FInferType>("FInferType", ElemwiseType<2, 1>)
+.set_attr<FInferStorageType>("FInferStorageType", LazyOptStorageType<0, SignSGDParam>)
 .set_attr<FCompute>("FCompute<cpu>", SignSGDUpdate<cpu>)
+.set_attr<FComputeEx>("FComputeEx<cpu>", SignSGDLazyUpdateEx)
 .add_argument("weight", "NDArray-or-Symbol", "Weight")
 .add_argument("grad", "NDArray-or-Symbol", "Gradient")
 .add_arguments(SignSGDParam::__FIELDS__());
 
 
 NNVM_REGISTER_OP(signum_update)
+MXNET_ADD_SPARSE_OP_ALIAS(signum_update)
 .describe(R"code(SIGN momentUM (Signum) optimizer.
 
 .. math::
@@ -81,24 +292,64 @@ It updates the weights using::
 
 Where the parameter ``momentum`` is the decay rate of momentum estimates at each epoch.
 
-.. note:: 
-   - sparse ndarray not supported for this optimizer yet.
+However, if grad's storage type is ``row_sparse``, ``lazy_update`` is True and weight's storage
+type is the same as momentum's storage type,
+only the row slices whose indices appear in grad.indices are updated (for both weight and momentum)::
+
+  for row in gradient.indices:
+      state[row] = momentum * state[row] + (1-momentum) * gradient[row]
+      weight[row] = weight[row] - learning_rate * sign(state[row])
+
 )code" ADD_FILELINE)
 .set_num_inputs(3)
 .set_num_outputs(1)
 .set_attr_parser(ParamParser<SignumParam>)
 .set_attr<nnvm::FInferShape>("FInferShape", ElemwiseShape<3, 1>)
 .set_attr<nnvm::FInferType>("FInferType", ElemwiseType<3, 1>)
+.set_attr<FInferStorageType>("FInferStorageType", LazyOptStorageType<1, SignumParam>)
 .set_attr<nnvm::FMutateInputs>("FMutateInputs",
   [](const nnvm::NodeAttrs& attrs) {
     return std::vector<uint32_t>{2};
   })
 .set_attr<FCompute>("FCompute<cpu>", SignumUpdate<cpu>)
+.set_attr<FComputeEx>("FComputeEx<cpu>", SignumLazyUpdateEx)
 .add_argument("weight", "NDArray-or-Symbol", "Weight")
 .add_argument("grad", "NDArray-or-Symbol", "Gradient")
 .add_argument("mom", "NDArray-or-Symbol", "Momentum")
 .add_arguments(SignumParam::__FIELDS__());
 
+NNVM_REGISTER_OP(nag_mom_update)
+MXNET_ADD_SPARSE_OP_ALIAS(nag_mom_update)
+.describe(R"code(Update function for Nesterov Accelerated Gradient (NAG) optimizer.
+
+It updates the weights using::
+
+  grad = clip(rescale_grad * grad, clip_gradient) + wd * weight
+  mom = momentum * mom + grad
+  weight = weight - learning_rate * (grad + momentum * mom)
+
+However, if grad's storage type is ``row_sparse``, ``lazy_update`` is True and weight's storage
+type is the same as momentum's storage type,
+only the row slices whose indices appear in grad.indices are updated (for both weight and momentum).
+
+)code" ADD_FILELINE)
+.set_num_inputs(3)
+.set_num_outputs(1)
+.set_attr_parser(ParamParser<NAGMomParam>)
+.set_attr<nnvm::FInferShape>("FInferShape", ElemwiseShape<3, 1>)
+.set_attr<nnvm::FInferType>("FInferType", ElemwiseType<3, 1>)
+.set_attr<FInferStorageType>("FInferStorageType", LazyOptStorageType<1, NAGMomParam>)
+.set_attr<nnvm::FMutateInputs>("FMutateInputs",
+  [](const nnvm::NodeAttrs& attrs) {
+    return std::vector<uint32_t>{2};
+  })
+.set_attr<FCompute>("FCompute<cpu>", NAGMomUpdate<cpu>)
+.set_attr<FComputeEx>("FComputeEx<cpu>", NAGMomLazyUpdateEx)
+.add_argument("weight", "NDArray-or-Symbol", "Weight")
+.add_argument("grad", "NDArray-or-Symbol", "Gradient")
+.add_argument("mom", "NDArray-or-Symbol", "Momentum")
+.add_arguments(NAGMomParam::__FIELDS__());
+
 template<int req>
 struct SGDMomStdDnsRspDnsKernel<req, cpu> {
   template<typename DType, typename IType, typename RType>
@@ -431,6 +682,7 @@ NNVM_REGISTER_OP(mp_sgd_mom_update)
 .add_arguments(SGDMomParam::__FIELDS__());
 
 NNVM_REGISTER_OP(ftml_update)
+MXNET_ADD_SPARSE_OP_ALIAS(ftml_update)
 .describe(R"code(The FTML optimizer described in
 *FTML - Follow the Moving Leader in Deep Learning*,
 available at http://proceedings.mlr.press/v70/zheng17a/zheng17a.pdf.
@@ -444,17 +696,23 @@ available at http://proceedings.mlr.press/v70/zheng17a/zheng17a.pdf.
  z_t = \beta_1 z_{ t-1 } + (1 - \beta_1^t) g_t - \sigma_t W_{t-1}
  W_t = - \frac{ z_t }{ d_t }
 
+However, if grad's storage type is ``row_sparse``, ``lazy_update`` is True and the storage
+type of weight is the same as those of d, v and z,
+only the row slices whose indices appear in grad.indices are updated (for weight, d, v and z).
+
 )code" ADD_FILELINE)
 .set_num_inputs(5)
 .set_num_outputs(1)
 .set_attr_parser(ParamParser<FTMLParam>)
 .set_attr<nnvm::FInferShape>("FInferShape", ElemwiseShape<5, 1>)
 .set_attr<nnvm::FInferType>("FInferType", ElemwiseType<5, 1>)
+.set_attr<FInferStorageType>("FInferStorageType", LazyOptStorageType<3, FTMLParam>)
 .set_attr<nnvm::FMutateInputs>("FMutateInputs",
   [](const nnvm::NodeAttrs& attrs) {
     return std::vector<uint32_t>{2, 3, 4};
   })
 .set_attr<FCompute>("FCompute<cpu>", FTMLUpdate<cpu>)
+.set_attr<FComputeEx>("FComputeEx<cpu>", FTMLLazyUpdateEx)
 .add_argument("weight", "NDArray-or-Symbol", "Weight")
 .add_argument("grad", "NDArray-or-Symbol", "Gradient")
 .add_argument("d", "NDArray-or-Symbol", "Internal state ``d_t``")
@@ -516,7 +774,252 @@ only the row slices whose indices appear in grad.indices are updated (for w, m a
 .add_arguments(AdamParam::__FIELDS__());
 
 
+/*! \brief A contiguous range of the elements of one weight of a multi-tensor update */
+struct MultiUpdateChunk {
+  int weight;
+  index_t begin;
+  index_t end;
+};
+
+/*!
+ * \brief Split all the weights of a multi-tensor update into chunks of at most
+ *  kMultiUpdateChunkSize elements, so that a single parallel loop over the chunks
+ *  balances small and large weights between the threads.
+ */
+static std::vector<MultiUpdateChunk> MultiUpdateChunks(const std::vector<TBlob>& inputs,
+                                                       const int num_weights,
+                                                       const int input_stride) {
+  const index_t kMultiUpdateChunkSize = 1 << 14;
+  std::vector<MultiUpdateChunk> chunks;
+  for (int w = 0; w < num_weights; ++w) {
+    const index_t size = inputs[w * input_stride].Size();
+    for (index_t begin = 0; begin < size; begin += kMultiUpdateChunkSize) {
+      chunks.push_back({w, begin, std::min(size, begin + kMultiUpdateChunkSize)});
+    }
+  }
+  return chunks;
+}
+
+/*! \brief Call update(weight, begin, end) for all the chunks in parallel */
+template<typename F>
+static void MultiUpdateLaunch(const std::vector<MultiUpdateChunk>& chunks, const F& update) {
+  const int num_chunks = chunks.size();
+  if (num_chunks == 0) return;
+  const int nthreads = std::min(num_chunks,
+                                engine::OpenMP::Get()->GetRecommendedOMPThreadCount());
+  #pragma omp parallel for num_threads(nthreads)
+  for (int c = 0; c < num_chunks; ++c) {
+    update(chunks[c].weight, chunks[c].begin, chunks[c].end);
+  }
+}
+
+static void MultiSGDUpdateCPU(const nnvm::NodeAttrs& attrs,
+                              const OpContext &ctx,
+                              const std::vector<TBlob> &inputs,
+                              const std::vector<OpReqType> &req,
+                              const std::vector<TBlob> &outputs) {
+  const MultiSGDParam& param = nnvm::get<MultiSGDParam>(attrs.parsed);
+  MSHADOW_REAL_TYPE_SWITCH(inputs[0].type_flag_, DType, {
+    MultiUpdateLaunch(MultiUpdateChunks(inputs, param.num_weights, 2),
+      [&](const int w, const index_t begin, const index_t end) {
+        if (req[w] == kNullOp) return;
+        const DType* weight = inputs[w * 2].dptr<DType>();
+        const DType* grad = inputs[w * 2 + 1].dptr<DType>();
+        DType* out = outputs[w].dptr<DType>();
+        for (index_t i = begin; i < end; ++i) {
+          SGDKernel::Map(i, out, weight, grad, static_cast<DType>(param.clip_gradient),
+                         static_cast<DType>(param.lrs[w]), static_cast<DType>(param.wds[w]),
+                         static_cast<DType>(param.rescale_grad), req[w]);
+        }
+      });
+  });
+}
+
+static void MultiSGDMomUpdateCPU(const nnvm::NodeAttrs& attrs,
+                                 const OpContext &ctx,
+                                 const std::vector<TBlob> &inputs,
+                                 const std::vector<OpReqType> &req,
+                                 const std::vector<TBlob> &outputs) {
+  const MultiSGDMomParam& param = nnvm::get<MultiSGDMomParam>(attrs.parsed);
+  MSHADOW_REAL_TYPE_SWITCH(inputs[0].type_flag_, DType, {
+    MultiUpdateLaunch(MultiUpdateChunks(inputs, param.num_weights, 3),
+      [&](const int w, const index_t begin, const index_t end) {
+        if (req[w] == kNullOp) return;
+        const DType* weight = inputs[w * 3].dptr<DType>();
+        const DType* grad = inputs[w * 3 + 1].dptr<DType>();
+        DType* mom = inputs[w * 3 + 2].dptr<DType>();
+        DType* out = outputs[w].dptr<DType>();
+        for (index_t i = begin; i < end; ++i) {
+          SGDMomKernel::Map(i, out, mom, weight, grad, static_cast<DType>(param.clip_gradient),
+                            static_cast<DType>(param.momentum), static_cast<DType>(param.lrs[w]),
+                            static_cast<DType>(param.wds[w]),
+                            static_cast<DType>(param.rescale_grad), req[w]);
+        }
+      });
+  });
+}
+
+static void MultiAdamUpdateCPU(const nnvm::NodeAttrs& attrs,
+                               const OpContext &ctx,
+                               const std::vector<TBlob> &inputs,
+                               const std::vector<OpReqType> &req,
+                               const std::vector<TBlob> &outputs) {
+  const MultiAdamParam& param = nnvm::get<MultiAdamParam>(attrs.parsed);
+  MSHADOW_REAL_TYPE_SWITCH(inputs[0].type_flag_, DType, {
+    MultiUpdateLaunch(MultiUpdateChunks(inputs, param.num_weights, 4),
+      [&](const int w, const index_t begin, const index_t end) {
+        if (req[w] == kNullOp) return;
+        const DType* weight = inputs[w * 4].dptr<DType>();
+        const DType* grad = inputs[w * 4 + 1].dptr<DType>();
+        DType* mean = inputs[w * 4 + 2].dptr<DType>();
+        DType* var = inputs[w * 4 + 3].dptr<DType>();
+        DType* out = outputs[w].dptr<DType>();
+        for (index_t i = begin; i < end; ++i) {
+          AdamKernel::Map(i, out, mean, var, weight, grad,
+                          static_cast<DType>(param.clip_gradient),
+                          static_cast<DType>(param.beta1), static_cast<DType>(param.beta2),
+                          static_cast<DType>(param.lrs[w]), static_cast<DType>(param.wds[w]),
+                          static_cast<DType>(param.epsilon),
+                          static_cast<DType>(param.rescale_grad), req[w]);
+        }
+      });
+  });
+}
+
+/*! \brief Names of the inputs of a multi-tensor update, e.g. weight_0, grad_0, mom_0, ... */
+static std::vector<std::string> MultiUpdateInputNames(const int num_weights,
+                                                      const std::vector<std::string>& names) {
+  std::vector<std::string> ret;
+  for (int i = 0; i < num_weights; ++i) {
+    for (const std::string& name : names) {
+      ret.push_back(name + "_" + std::to_string(i));
+    }
+  }
+  return ret;
+}
+
+/*! \brief Indices of the states of a multi-tensor update, which it modifies */
+static std::vector<uint32_t> MultiUpdateMutateInputs(const int num_weights,
+                                                     const int input_stride) {
+  std::vector<uint32_t> ret;
+  for (int i = 0; i < num_weights; ++i) {
+    for (int j = 2; j < input_stride; ++j) {
+      ret.push_back(i * input_stride + j);
+    }
+  }
+  return ret;
+}
+
+NNVM_REGISTER_OP(multi_sgd_update)
+.describe(R"code(Update function for Stochastic Gradient Descent (SDG) optimizer applied
+to several weights at once, each with its own learning rate and weight decay.
+
+It updates every weight using::
+
+ weight = weight - learning_rate * (gradient + wd * weight)
+
+The inputs are the weights and gradients interleaved, i.e.
+weight_0, grad_0, weight_1, grad_1, ..., and the outputs are the updated weights.
+All the weights are updated by a single parallel loop, which avoids the overhead
+of one operator per weight when there are many small weights.
+
+This operator is only implemented on CPU.
+
+)code" ADD_FILELINE)
+.set_num_inputs([](const nnvm::NodeAttrs& attrs) {
+  return static_cast<uint32_t>(nnvm::get<MultiSGDParam>(attrs.parsed).num_weights * 2);
+})
+.set_num_outputs([](const nnvm::NodeAttrs& attrs) {
+  return static_cast<uint32_t>(nnvm::get<MultiSGDParam>(attrs.parsed).num_weights);
+})
+.set_attr_parser(ParamParser<MultiSGDParam>)
+.set_attr<nnvm::FListInputNames>("FListInputNames", [](const NodeAttrs& attrs) {
+  return MultiUpdateInputNames(nnvm::get<MultiSGDParam>(attrs.parsed).num_weights,
+                               {"weight", "grad"});
+})
+.set_attr<nnvm::FInferShape>("FInferShape", MultiUpdateShape<MultiSGDParam, 2>)
+.set_attr<nnvm::FInferType>("FInferType", ElemwiseType<-1, -1>)
+.set_attr<FCompute>("FCompute<cpu>", MultiSGDUpdateCPU)
+.add_argument("data", "NDArray-or-Symbol[]", "Weights and gradients")
+.add_arguments(MultiSGDParam::__FIELDS__());
+
+NNVM_REGISTER_OP(multi_sgd_mom_update)
+.describe(R"code(Momentum update function for Stochastic Gradient Descent (SGD) optimizer
+applied to several weights at once, each with its own learning rate and weight decay.
+
+It updates every weight and its momentum using::
+
+  v = momentum * v - learning_rate * (gradient + wd * weight)
+  weight += v
+
+The inputs are the weights, gradients and momentums interleaved, i.e.
+weight_0, grad_0, mom_0, weight_1, grad_1, mom_1, ..., and the outputs are the
+updated weights.
+
+This operator is only implemented on CPU.
+
+)code" ADD_FILELINE)
+.set_num_inputs([](const nnvm::NodeAttrs& attrs) {
+  return static_cast<uint32_t>(nnvm::get<MultiSGDMomParam>(attrs.parsed).num_weights * 3);
+})
+.set_num_outputs([](const nnvm::NodeAttrs& attrs) {
+  return static_cast<uint32_t>(nnvm::get<MultiSGDMomParam>(attrs.parsed).num_weights);
+})
+.set_attr_parser(ParamParser<MultiSGDMomParam>)
+.set_attr<nnvm::FListInputNames>("FListInputNames", [](const NodeAttrs& attrs) {
+  return MultiUpdateInputNames(nnvm::get<MultiSGDMomParam>(attrs.parsed).num_weights,
+                               {"weight", "grad", "mom"});
+})
+.set_attr<nnvm::FInferShape>("FInferShape", MultiUpdateShape<MultiSGDMomParam, 3>)
+.set_attr<nnvm::FInferType>("FInferType", ElemwiseType<-1, -1>)
+.set_attr<nnvm::FMutateInputs>("FMutateInputs", [](const nnvm::NodeAttrs& attrs) {
+  return MultiUpdateMutateInputs(nnvm::get<MultiSGDMomParam>(attrs.parsed).num_weights, 3);
+})
+.set_attr<FCompute>("FCompute<cpu>", MultiSGDMomUpdateCPU)
+.add_argument("data", "NDArray-or-Symbol[]", "Weights, gradients and momentums")
+.add_arguments(MultiSGDMomParam::__FIELDS__());
+
+NNVM_REGISTER_OP(multi_adam_update)
+.describe(R"code(Update function for Adam optimizer applied to several weights at once,
+each with its own learning rate and weight decay.
+
+It updates every weight and its moment estimates using::
+
+ grad = clip(rescale_grad * grad + wd * weight, clip_gradient)
+ m = beta1*m + (1-beta1)*grad
+ v = beta2*v + (1-beta2)*(grad**2)
+ w += - learning_rate * m / (sqrt(v) + epsilon)
+
+The inputs are the weights, gradients, means and variances interleaved, i.e.
+weight_0, grad_0, mean_0, var_0, weight_1, ..., and the outputs are the updated
+weights. Unlike adam_update, the gradients are left unchanged.
+
+This operator is only implemented on CPU.
+
+)code" ADD_FILELINE)
+.set_num_inputs([](const nnvm::NodeAttrs& attrs) {
+  return static_cast<uint32_t>(nnvm::get<MultiAdamParam>(attrs.parsed).num_weights * 4);
+})
+.set_num_outputs([](const nnvm::NodeAttrs& attrs) {
+  return static_cast<uint32_t>(nnvm::get<MultiAdamParam>(attrs.parsed).num_weights);
+})
+.set_attr_parser(ParamParser<MultiAdamParam>)
+.set_attr<nnvm::FListInputNames>("FListInputNames", [](const NodeAttrs& attrs) {
+  return MultiUpdateInputNames(nnvm::get<MultiAdamParam>(attrs.parsed).num_weights,
+                               {"weight", "grad", "mean", "var"});
+})
+.set_attr<nnvm::FInferShape>("FInferShape", MultiUpdateShape<MultiAdamParam, 4>)
+.set_attr<nnvm::FInferType>("FInferType", ElemwiseType<-1, -1>)
+.set_attr<nnvm::FMutateInputs>("FMutateInputs", [](const nnvm::NodeAttrs& attrs) {
+  return MultiUpdateMutateInputs(nnvm::get<MultiAdamParam>(attrs.parsed).num_weights, 4);
+})
+.set_attr<FCompute>("FCompute<cpu>", MultiAdamUpdateCPU)
+.add_argument("data", "NDArray-or-Symbol[]", "Weights, gradients, means and variances")
+.add_arguments(MultiAdamParam::__FIELDS__());
+
+
 NNVM_REGISTER_OP(rmsprop_update)
+MXNET_ADD_SPARSE_OP_ALIAS(rmsprop_update)
 .describe(R"code(Update function for `RMSProp` optimizer.
 
 `RMSprop` is a variant of stochastic gradient descent where the gradients are
@@ -550,23 +1053,30 @@ Tieleman & Hinton, 2012.
 Hinton suggests the momentum term :math:`\gamma` to be 0.9 and the learning rate
 :math:`\eta` to be 0.001.
 
+However, if grad's storage type is ``row_sparse``, ``lazy_update`` is True and weight's storage
+type is the same as n's storage type,
+only the row slices whose indices appear in grad.indices are updated (for both weight and n).
+
 )code" ADD_FILELINE)
 .set_num_inputs(3)
 .set_num_outputs(1)
 .set_attr_parser(ParamParser<RMSPropParam>)
 .set_attr<nnvm::FInferShape>("FInferShape", ElemwiseShape<3, 1>)
 .set_attr<nnvm::FInferType>("FInferType", ElemwiseType<3, 1>)
+.set_attr<FInferStorageType>("FInferStorageType", LazyOptStorageType<1, RMSPropParam>)
 .set_attr<nnvm::FMutateInputs>("FMutateInputs",
   [](const nnvm::NodeAttrs &attrs) {
     return std::vector<uint32_t>{2};
   })
 .set_attr<FCompute>("FCompute<cpu>", RMSPropUpdate<cpu>)
+.set_attr<FComputeEx>("FComputeEx<cpu>", RMSPropLazyUpdateEx)
 .add_argument("weight", "NDArray-or-Symbol", "Weight")
 .add_argument("grad", "NDArray-or-Symbol", "Gradient")
 .add_argument("n", "NDArray-or-Symbol", "n")
 .add_arguments(RMSPropParam::__FIELDS__());
 
 NNVM_REGISTER_OP(rmspropalex_update)
+MXNET_ADD_SPARSE_OP_ALIAS(rmspropalex_update)
 .describe(R"code(Update function for RMSPropAlex optimizer.
 
 `RMSPropAlex` is non-centered version of `RMSProp`.
@@ -589,17 +1099,23 @@ http://arxiv.org/pdf/1308.0850v5.pdf Eq(38) - Eq(45) by Alex Graves, 2013.
 
 Graves suggests the momentum term :math:`\gamma_1` to be 0.95, :math:`\gamma_2`
 to be 0.9 and the learning rate :math:`\eta` to be 0.0001.
+
+However, if grad's storage type is ``row_sparse``, ``lazy_update`` is True and the storage
+type of weight is the same as those of n, g and delta,
+only the row slices whose indices appear in grad.indices are updated (for weight, n, g and delta).
 )code" ADD_FILELINE)
 .set_num_inputs(5)
 .set_num_outputs(1)
 .set_attr_parser(ParamParser<RMSPropAlexParam>)
 .set_attr<nnvm::FInferShape>("FInferShape", ElemwiseShape<5, 1>)
 .set_attr<nnvm::FInferType>("FInferType", ElemwiseType<5, 1>)
+.set_attr<FInferStorageType>("FInferStorageType", LazyOptStorageType<3, RMSPropAlexParam>)
 .set_attr<nnvm::FMutateInputs>("FMutateInputs",
   [](const nnvm::NodeAttrs& attrs) {
     return std::vector<uint32_t>{2, 3, 4};
   })
 .set_attr<FCompute>("FCompute<cpu>", RMSPropAlexUpdate<cpu>)
+.set_attr<FComputeEx>("FComputeEx<cpu>", RMSPropAlexLazyUpdateEx)
 .add_argument("weight", "NDArray-or-Symbol", "Weight")
 .add_argument("grad", "NDArray-or-Symbol", "Gradient")
 .add_argument("n", "NDArray-or-Symbol", "n")
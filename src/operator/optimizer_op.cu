@@ -228,6 +228,9 @@ NNVM_REGISTER_OP(signsgd_update)
 NNVM_REGISTER_OP(signum_update)
 .set_attr<FCompute>("FCompute<gpu>", SignumUpdate<gpu>);
 
+NNVM_REGISTER_OP(nag_mom_update)
+.set_attr<FCompute>("FCompute<gpu>", NAGMomUpdate<gpu>);
+
 NNVM_REGISTER_OP(sgd_update)
 .set_attr<FCompute>("FCompute<gpu>", SGDUpdate<gpu>)
 .set_attr<FComputeEx>("FComputeEx<gpu>", SGDUpdateEx<gpu>);
@@ -0,0 +1,284 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file calibrate.cc
+ * \brief Histogram collection and KL divergence threshold search for the
+ *  entropy calibration of quantized graphs. It follows the method of
+ *  http://on-demand.gputechconf.com/gtc/2017/presentation/s7310-8-bit-inference-with-tensorrt.pdf
+ *  and gives the same thresholds as _get_optimal_threshold in
+ *  python/mxnet/contrib/quantization.py.
+ */
+#include <algorithm>
+#include <cmath>
+#include "./calibrate.h"
+#include "../../engine/openmp.h"
+
+namespace mxnet {
+namespace op {
+
+namespace calib {
+/*! \brief minimum number of elements processed by each thread */
+const int64_t kGrainSize = 1 << 14;
+/*! \brief histograms growing beyond this many times num_bins are coarsened */
+const size_t kMaxBinsFactor = 3;
+}  // namespace calib
+
+/*! \brief merge the bins three by three, keeping the middle bin centered on zero */
+inline void CoarsenHistogram(CalibHistogram* hist) {
+  std::vector<int64_t>& counts = hist->counts;
+  const size_t pad = (3 - counts.size() % 3) * 2 % 3;
+  const double step = 2.0 * hist->th / counts.size();
+  std::vector<int64_t> coarse((counts.size() + 2 * pad) / 3, 0);
+  for (size_t i = 0; i < counts.size(); ++i) coarse[(i + pad) / 3] += counts[i];
+  hist->th = static_cast<float>(hist->th + pad * step);
+  counts.swap(coarse);
+}
+
+template<typename DType>
+void CalibHistogram::Update(const DType* data, const size_t size, const int num_bins) {
+  using namespace calib;
+  if (size == 0) return;
+  const int64_t n = static_cast<int64_t>(size);
+  const int nthreads = static_cast<int>(std::max<int64_t>(1, std::min<int64_t>(
+      engine::OpenMP::Get()->GetRecommendedOMPThreadCount(), n / kGrainSize)));
+  const int64_t chunk = (n + nthreads - 1) / nthreads;
+
+  std::vector<float> lo(nthreads, std::numeric_limits<float>::infinity());
+  std::vector<float> hi(nthreads, -std::numeric_limits<float>::infinity());
+  #pragma omp parallel for num_threads(nthreads)
+  for (int t = 0; t < nthreads; ++t) {
+    const int64_t end = std::min(n, (t + 1) * chunk);
+    for (int64_t i = t * chunk; i < end; ++i) {
+      const float v = static_cast<float>(data[i]);
+      lo[t] = std::min(lo[t], v);
+      hi[t] = std::max(hi[t], v);
+    }
+  }
+  const float batch_min = *std::min_element(lo.begin(), lo.end());
+  const float batch_max = *std::max_element(hi.begin(), hi.end());
+  min_val = std::min(min_val, batch_min);
+  max_val = std::max(max_val, batch_max);
+  if (num_bins == 0) return;
+
+  const float batch_th = std::max(std::abs(batch_min), std::abs(batch_max));
+  if (counts.empty()) {
+    if (batch_th == 0.f) {
+      num_pending_zeros += n;
+      return;
+    }
+    th = batch_th;
+    counts.assign(num_bins, 0);
+    counts[num_bins / 2] += num_pending_zeros;
+    num_pending_zeros = 0;
+  } else if (batch_th > th) {
+    // Extend the range by whole bins so that the counts so far stay exact.
+    const double step = 2.0 * th / counts.size();
+    const size_t extra = static_cast<size_t>((batch_th - th) / step) + 1;
+    std::vector<int64_t> grown(counts.size() + 2 * extra, 0);
+    std::copy(counts.begin(), counts.end(), grown.begin() + extra);
+    counts.swap(grown);
+    th = static_cast<float>(th + extra * step);
+    while (counts.size() > kMaxBinsFactor * num_bins) CoarsenHistogram(this);
+  }
+
+  const int64_t nbins = counts.size();
+  const double scale = nbins / (2.0 * th);
+  std::vector<std::vector<int64_t>> local(nthreads);
+  #pragma omp parallel for num_threads(nthreads)
+  for (int t = 0; t < nthreads; ++t) {
+    std::vector<int64_t>& bins = local[t];
+    bins.assign(nbins, 0);
+    const int64_t end = std::min(n, (t + 1) * chunk);
+    for (int64_t i = t * chunk; i < end; ++i) {
+      const int64_t b = static_cast<int64_t>((static_cast<float>(data[i]) + th) * scale);
+      ++bins[std::max<int64_t>(0, std::min(b, nbins - 1))];
+    }
+  }
+  for (int t = 0; t < nthreads; ++t) {
+    for (int64_t b = 0; b < nbins; ++b) counts[b] += local[t][b];
+  }
+}
+
+/*!
+ * \brief Replace the zeros of a distribution by eps and take the same amount
+ *  off its non-zero entries. Returns false if the result is not a valid
+ *  distribution.
+ */
+inline bool SmoothDistribution(std::vector<float>* p, const float eps = 0.0001f) {
+  size_t num_zeros = 0;
+  for (float v : *p) num_zeros += (v == 0.f);
+  const size_t num_nonzeros = p->size() - num_zeros;
+  if (num_nonzeros == 0) return false;
+  const float eps1 = eps * num_zeros / num_nonzeros;
+  if (eps1 >= 1.f) return false;
+  for (float& v : *p) {
+    v = v == 0.f ? eps : v - eps1;
+    if (v <= 0.f) return false;
+  }
+  return true;
+}
+
+/*! \brief KL divergence of the histogram quantized with the threshold at bin half_width */
+inline double ThresholdDivergence(const std::vector<int64_t>& hist,
+                                  const std::vector<int64_t>& prefix_sum,
+                                  const int64_t half_width,
+                                  const int64_t num_quantized_bins) {
+  const int64_t num_bins = hist.size();
+  const int64_t start = num_bins / 2 - half_width;
+  const int64_t stop = num_bins / 2 + half_width + 1;
+  const int64_t width = stop - start;
+  // The reference distribution p puts the outliers in its edge bins.
+  std::vector<float> p(hist.begin() + start, hist.begin() + stop);
+  p[0] += prefix_sum[start];
+  p[width - 1] += prefix_sum[num_bins] - prefix_sum[stop];
+
+  // The candidate distribution q merges the bins into num_quantized_bins
+  // and spreads each of them evenly over its non-empty bins.
+  const int64_t merged = width / num_quantized_bins;
+  std::vector<float> q(width, 0.f);
+  for (int64_t j = 0; j < num_quantized_bins; ++j) {
+    const int64_t qstart = j * merged;
+    const int64_t qstop = j == num_quantized_bins - 1 ? width : qstart + merged;
+    int64_t total = 0, norm = 0;
+    for (int64_t k = qstart; k < qstop; ++k) {
+      total += hist[start + k];
+      norm += (p[k] != 0.f);
+    }
+    if (norm == 0) continue;
+    for (int64_t k = qstart; k < qstop; ++k) {
+      if (p[k] != 0.f) q[k] = static_cast<float>(total) / norm;
+    }
+  }
+  if (!SmoothDistribution(&p) || !SmoothDistribution(&q)) {
+    return std::numeric_limits<double>::infinity();
+  }
+  double p_sum = 0, q_sum = 0;
+  for (int64_t k = 0; k < width; ++k) {
+    p_sum += p[k];
+    q_sum += q[k];
+  }
+  double divergence = 0;
+  for (int64_t k = 0; k < width; ++k) {
+    const double pk = p[k] / p_sum;
+    divergence += pk * std::log(pk / (q[k] / q_sum));
+  }
+  return divergence;
+}
+
+float GetOptimalThreshold(const CalibHistogram& hist, const int num_quantized_bins,
+                          float* divergence) {
+  const std::vector<int64_t>& counts = hist.counts;
+  const int64_t num_bins = counts.size();
+  const int64_t half_quantized = num_quantized_bins / 2;
+  const int64_t num_thresholds = num_bins / 2 + 1 - half_quantized;
+  *divergence = 0.f;
+  if (num_thresholds <= 0) return hist.th;
+
+  std::vector<int64_t> prefix_sum(num_bins + 1, 0);
+  for (int64_t i = 0; i < num_bins; ++i) prefix_sum[i + 1] = prefix_sum[i] + counts[i];
+  std::vector<double> divergences(num_thresholds);
+  const int omp_threads = engine::OpenMP::Get()->GetRecommendedOMPThreadCount();
+  #pragma omp parallel for num_threads(omp_threads) schedule(dynamic, 16)
+  for (int64_t t = 0; t < num_thresholds; ++t) {
+    divergences[t] = ThresholdDivergence(counts, prefix_sum, half_quantized + t,
+                                         num_quantized_bins);
+  }
+  const int64_t best = std::min_element(divergences.begin(), divergences.end()) -
+                       divergences.begin();
+  *divergence = static_cast<float>(divergences[best]);
+  // the upper edge of the last bin kept
+  return static_cast<float>(hist.th * (2.0 * (half_quantized + best) + 1) / num_bins);
+}
+
+CalibCollector::CalibCollector(CalibMode mode, int num_bins, int num_quantized_bins,
+                               const std::vector<std::string>& layer_names)
+  : mode_(mode), num_bins_(num_bins), num_quantized_bins_(num_quantized_bins),
+    include_(layer_names.begin(), layer_names.end()) {
+  if (mode_ == kEntropy) {
+    CHECK_EQ(num_bins % 2, 1) << "num_bins must be odd, got " << num_bins;
+    CHECK_EQ(num_quantized_bins % 2, 1)
+        << "num_quantized_bins must be odd, got " << num_quantized_bins;
+    CHECK_LE(num_quantized_bins, num_bins);
+  }
+}
+
+CalibCollector::~CalibCollector() {
+  for (auto& kv : layers_) {
+    Engine::Get()->WaitForVar(kv.second->var);
+    Engine::Get()->DeleteVariable([](RunContext) {}, Context::CPU(), kv.second->var);
+  }
+}
+
+void CalibCollector::Collect(const std::string& name, const NDArray& arr) {
+  if (arr.is_none() || (!include_.empty() && !include_.count(name))) return;
+  if (arr.dtype() != mshadow::kFloat32 && arr.dtype() != mshadow::kFloat64 &&
+      arr.dtype() != mshadow::kFloat16) {
+    return;
+  }
+  Layer* layer;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& entry = layers_[name];
+    if (!entry) {
+      entry.reset(new Layer());
+      entry->var = Engine::Get()->NewVariable();
+      order_.push_back(name);
+    }
+    layer = entry.get();
+  }
+  NDArray data = arr;
+  if (arr.ctx().dev_mask() != cpu::kDevMask || arr.storage_type() != kDefaultStorage) {
+    data = NDArray(arr.shape(), Context::CPU(), false, arr.dtype());
+    CopyFromTo(arr, &data);
+  }
+  const int num_bins = mode_ == kEntropy ? num_bins_ : 0;
+  Engine::Get()->PushSync([layer, data, num_bins](RunContext rctx) {
+#if MXNET_USE_MKLDNN == 1
+      const NDArray dense = data.IsMKLDNNData() ? data.Reorder2Default() : data;
+#else
+      const NDArray& dense = data;
+#endif
+      const TBlob blob = dense.data();
+      MSHADOW_REAL_TYPE_SWITCH(blob.type_flag_, DType, {
+        layer->hist.Update(blob.dptr<DType>(), blob.Size(), num_bins);
+      });
+    }, Context::CPU(), {data.var()}, {layer->var}, FnProperty::kNormal, 0, "CalibCollect");
+}
+
+std::vector<std::pair<std::string, std::pair<float, float>>> CalibCollector::GetCalibTable() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<std::pair<std::string, std::pair<float, float>>> table;
+  for (const std::string& name : order_) {
+    Layer* layer = layers_.at(name).get();
+    Engine::Get()->WaitForVar(layer->var);
+    const CalibHistogram& hist = layer->hist;
+    if (mode_ == kNaive) {
+      table.emplace_back(name, std::make_pair(hist.min_val, hist.max_val));
+    } else {
+      float divergence;
+      const float th = GetOptimalThreshold(hist, num_quantized_bins_, &divergence);
+      table.emplace_back(name, std::make_pair(-th, th));
+    }
+  }
+  return table;
+}
+
+}  // namespace op
+}  // namespace mxnet
@@ -0,0 +1,107 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file calibrate.h
+ * \brief Collector of layer output statistics used to calibrate the
+ *  requantize operators of a quantized graph.
+ */
+#ifndef MXNET_OPERATOR_QUANTIZATION_CALIBRATE_H_
+#define MXNET_OPERATOR_QUANTIZATION_CALIBRATE_H_
+
+#include <mxnet/engine.h>
+#include <mxnet/ndarray.h>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace mxnet {
+namespace op {
+
+/*!
+ * \brief Histogram of the values of a tensor over [-th, th]. The number of
+ *  bins is odd so that the middle bin is centered on zero. When a batch
+ *  exceeds the range, bins of the same width are added on both sides.
+ */
+struct CalibHistogram {
+  std::vector<int64_t> counts;
+  float th = 0.f;
+  float min_val = std::numeric_limits<float>::infinity();
+  float max_val = -std::numeric_limits<float>::infinity();
+  /*! \brief zeros seen before the range of the histogram is known */
+  int64_t num_pending_zeros = 0;
+
+  template<typename DType>
+  void Update(const DType* data, size_t size, int num_bins);
+};
+
+/*!
+ * \brief Find the threshold minimizing the KL divergence between the
+ *  histogram and its quantization into num_quantized_bins bins.
+ * \param divergence the divergence at the returned threshold
+ */
+float GetOptimalThreshold(const CalibHistogram& hist, int num_quantized_bins,
+                          float* divergence);
+
+/*!
+ * \brief Collects the outputs of executors through their monitor callback.
+ *  The histogram of each layer is updated by an engine operator, so the
+ *  layers of a batch are processed in parallel with the forward pass.
+ */
+class CalibCollector {
+ public:
+  enum CalibMode { kNaive, kEntropy };
+
+  CalibCollector(CalibMode mode, int num_bins, int num_quantized_bins,
+                 const std::vector<std::string>& layer_names);
+  ~CalibCollector();
+  /*! \brief queue the update of the statistics of a layer output */
+  void Collect(const std::string& name, const NDArray& arr);
+  /*!
+   * \brief wait for the pending updates and compute the calibration table,
+   *  mapping the name of each collected layer output to its thresholds.
+   */
+  std::vector<std::pair<std::string, std::pair<float, float>>> GetCalibTable();
+
+ private:
+  struct Layer {
+    CalibHistogram hist;
+    Engine::VarHandle var;
+  };
+
+  CalibMode mode_;
+  int num_bins_;
+  int num_quantized_bins_;
+  /*! \brief the layers to collect, all of them if empty */
+  std::unordered_set<std::string> include_;
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::unique_ptr<Layer>> layers_;
+  /*! \brief layer names in the order they were first collected */
+  std::vector<std::string> order_;
+};
+
+}  // namespace op
+}  // namespace mxnet
+
+#endif  // MXNET_OPERATOR_QUANTIZATION_CALIBRATE_H_
@@ -87,8 +87,12 @@ void DequantizeCompute(const nnvm::NodeAttrs& attrs,
     Kernel<dequantize_zero_centered, xpu>::Launch(s, outputs[0].Size(), outputs[0].dptr<float>(),
       inputs[0].dptr<int8_t>(), inputs[1].dptr<float>(), inputs[2].dptr<float>(),
       MinAbs(MaxValue<int8_t>(), MinValue<int8_t>()));
+  } else if (inputs[0].type_flag_ == mshadow::kInt32) {
+    Kernel<dequantize_zero_centered, xpu>::Launch(s, outputs[0].Size(), outputs[0].dptr<float>(),
+      inputs[0].dptr<int32_t>(), inputs[1].dptr<float>(), inputs[2].dptr<float>(),
+      MinAbs(MaxValue<int32_t>(), MinValue<int32_t>()));
   } else {
-    LOG(FATAL) << "dequantize op only supports input type int8 or uint8";
+    LOG(FATAL) << "dequantize op only supports input type int8, uint8 or int32";
   }
 }
 
@@ -111,8 +115,9 @@ inline bool DequantizeType(const nnvm::NodeAttrs& attrs,
                            std::vector<int> *out_attrs) {
   CHECK_EQ(in_attrs->size(), 3U);
   CHECK_EQ(out_attrs->size(), 1U);
-  CHECK(in_attrs->at(0) == mshadow::kUint8 || in_attrs->at(0) == mshadow::kInt8)
-    << "the input data type of dequantize op must be provided, either uint8 or int8";
+  CHECK(in_attrs->at(0) == mshadow::kUint8 || in_attrs->at(0) == mshadow::kInt8 ||
+        in_attrs->at(0) == mshadow::kInt32)
+    << "the input data type of dequantize op must be provided, either uint8, int8 or int32";
   TYPE_ASSIGN_CHECK(*in_attrs, 1, mshadow::kFloat32);
   TYPE_ASSIGN_CHECK(*in_attrs, 2, mshadow::kFloat32);
   TYPE_ASSIGN_CHECK(*out_attrs, 0, mshadow::kFloat32);
@@ -62,6 +62,10 @@ by keep zero centered for the quantized value:
 
 `out[i] = in[i] * MaxAbs(min_range, max_range) / 127.0`,
 
+When input data type is `int32`, which is the output type of quantized operators
+such as quantized_conv, the output is calculated in the same way with 2147483647.0
+as the quantized range.
+
 .. Note::
     This operator only supports forward propogation. DO NOT use it in training.
 )code" ADD_FILELINE)
@@ -47,7 +47,7 @@ static void MKLDNNDequantizeComputeKer(const std::vector<NDArray> &inputs,
   if (inputs[0].dtype() == mshadow::kUint8) {
     quantized_range = MaxAbs(MaxValue<SrcType>(), MinValue<SrcType>());
     real_range = MaxAbs(*inputs[1].data().dptr<DstType>(), *inputs[2].data().dptr<DstType>());
-  } else if (inputs[0].dtype() == mshadow::kInt8) {
+  } else if (inputs[0].dtype() == mshadow::kInt8 || inputs[0].dtype() == mshadow::kInt32) {
     quantized_range = MinAbs(MaxValue<SrcType>(), MinValue<SrcType>());
     real_range = MaxAbs(*inputs[1].data().dptr<DstType>(), *inputs[2].data().dptr<DstType>());
   } else {
@@ -93,8 +93,10 @@ static void MKLDNNDequantizeCompute(const nnvm::NodeAttrs& attrs, const OpContex
     MKLDNNDequantizeComputeKer<uint8_t, float>(inputs, outputs, req);
   } else if (inputs[0].dtype() == mshadow::kInt8) {
     MKLDNNDequantizeComputeKer<int8_t, float>(inputs, outputs, req);
+  } else if (inputs[0].dtype() == mshadow::kInt32) {
+    MKLDNNDequantizeComputeKer<int32_t, float>(inputs, outputs, req);
   } else {
-    LOG(FATAL) << "mkldnn dequantize op only supports int8 and uint8 as input type";
+    LOG(FATAL) << "mkldnn dequantize op only supports int8, uint8 and int32 as input type";
   }
 }
 
@@ -0,0 +1,135 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file mkldnn_quantized_fully_connected.cc
+ * \brief
+ */
+
+#if MXNET_USE_MKLDNN == 1
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+#include "../../nn/mkldnn/mkldnn_fully_connected-inl.h"
+#include "../quantization_utils.h"
+
+namespace mxnet {
+namespace op {
+
+// An int8 bias rescaled to the int32 scale of the product of data and weight.
+struct MKLDNNRescaledBias {
+  std::vector<int8_t> qbias;
+  float scale;
+  NDArray bias;
+};
+
+/*
+ * Get the int8 bias rescaled to int32. The bias is only rescaled again when its
+ * values or the scale change, which doesn't happen between inference calls.
+ */
+static const NDArray &GetRescaledBias(const NDArray &qbias, const float scale) {
+#if DMLC_CXX11_THREAD_LOCAL
+  static thread_local std::unordered_map<const void *, MKLDNNRescaledBias> biases;
+#else
+  static MX_THREAD_LOCAL std::unordered_map<const void *, MKLDNNRescaledBias> biases;
+#endif
+  static const size_t max_biases = 1024;
+  const int8_t *qbias_ptr = qbias.data().dptr<int8_t>();
+  const size_t size = qbias.shape().Size();
+  auto it = biases.find(qbias_ptr);
+  if (it != biases.end() && it->second.scale == scale &&
+      it->second.qbias.size() == size &&
+      std::memcmp(it->second.qbias.data(), qbias_ptr, size) == 0) {
+    return it->second.bias;
+  }
+  if (it == biases.end() && biases.size() >= max_biases) biases.clear();
+  MKLDNNRescaledBias &entry = biases[qbias_ptr];
+  entry.qbias.assign(qbias_ptr, qbias_ptr + size);
+  entry.scale = scale;
+  entry.bias = NDArray(qbias.shape(), Context::CPU(), false, mshadow::kInt32);
+  int32_t *bias_ptr = entry.bias.data().dptr<int32_t>();
+  for (size_t i = 0; i < size; ++i) {
+    bias_ptr[i] = static_cast<int32_t>(std::round(qbias_ptr[i] * scale));
+  }
+  return entry.bias;
+}
+
+static void MKLDNNQuantizedFullyConnectedForward(const nnvm::NodeAttrs& attrs,
+                                                 const OpContext &ctx,
+                                                 const std::vector<NDArray> &in_data,
+                                                 const std::vector<OpReqType> &req,
+                                                 const std::vector<NDArray> &out_data) {
+  CHECK_EQ(in_data[fullc::kData].dtype(), mshadow::kUint8)
+    << "mkldnn_quantized_fully_connected op only supports uint8 as input type";
+  TmpMemMgr::Get()->Init(ctx.requested[fullc::kTempSpace]);
+  const FullyConnectedParam& param = nnvm::get<FullyConnectedParam>(attrs.parsed);
+  const size_t num_inputs = param.no_bias ? 2 : 3;
+  const float min_data = in_data[num_inputs].data().dptr<float>()[0];
+  const float max_data = in_data[num_inputs + 1].data().dptr<float>()[0];
+  const float min_weight = in_data[num_inputs + 2].data().dptr<float>()[0];
+  const float max_weight = in_data[num_inputs + 3].data().dptr<float>()[0];
+  QuantizationRangeForMultiplication<int8_t, int8_t, int32_t>(
+      min_data, max_data, min_weight, max_weight,
+      out_data[1].data().dptr<float>(), out_data[2].data().dptr<float>());
+
+  NDArray data = in_data[fullc::kData];
+  NDArray weight = in_data[fullc::kWeight];
+  const TShape &ishape = data.shape();
+  if (data.IsMKLDNNData() && data.IsView())
+    data = data.Reorder2Default();
+  if (ishape.ndim() != 2)
+    data = data.MKLDNNDataReshape(Shape2(ishape[0], ishape.ProdShape(1, ishape.ndim())));
+
+  // MKLDNN adds the bias in the int32 scale of the product of data and weight,
+  // while the int8 bias is quantized with its own range.
+  NDArray bias;
+  if (!param.no_bias) {
+    const NDArray &qbias = in_data[fullc::kBias];
+    const float data_level = FloatForOneQuantizedLevel<int8_t>(min_data, max_data);
+    const float weight_level = FloatForOneQuantizedLevel<int8_t>(min_weight, max_weight);
+    const float bias_level = FloatForOneQuantizedLevel<int8_t>(
+        in_data[num_inputs + 4].data().dptr<float>()[0],
+        in_data[num_inputs + 5].data().dptr<float>()[0]);
+    const float scale = bias_level / (data_level * weight_level);
+    bias = GetRescaledBias(qbias, scale);
+  }
+
+  auto out_md = GetMemDesc(out_data[fullc::kOut]);
+  MKLDNNFullyConnectForward &fwd = GetFCFwd(attrs, data, weight,
+      param.no_bias ? nullptr : &bias, out_md, ctx.is_train);
+  auto data_mem = data.GetMKLDNNDataReorder(fwd.ipFwd_pd.src_primitive_desc());
+  auto weight_mem = GetInferenceWeights(&weight, fwd.ipFwd_pd.weights_primitive_desc(), 1);
+  auto out_mem = CreateMKLDNNMem(out_data[fullc::kOut], fwd.ipFwd_pd.dst_primitive_desc(),
+                                 req[fullc::kOut]);
+  const mkldnn::memory *bias_mem = nullptr;
+  if (!param.no_bias)
+    bias_mem = bias.GetMKLDNNDataReorder(fwd.ipFwd_pd.bias_primitive_desc());
+  fwd.SetNewMem(*data_mem, *weight_mem, bias_mem, *out_mem.second);
+  MKLDNNStream::Get()->RegisterPrim(fwd.GetIpFwd());
+  CommitOutput(out_data[fullc::kOut], out_mem);
+  MKLDNNStream::Get()->Submit();
+}
+
+NNVM_REGISTER_OP(_contrib_quantized_fully_connected)
+.set_attr<FComputeEx>("FComputeEx<cpu>", MKLDNNQuantizedFullyConnectedForward);
+
+}  // namespace op
+}  // namespace mxnet
+
+#endif  // MXNET_USE_MKLDNN == 1
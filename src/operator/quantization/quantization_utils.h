@@ -28,6 +28,25 @@
 #include <algorithm>
 #include "../mxnet_op.h"
 
+#define MXNET_QUANTIZED_TYPE_SWITCH(type, DType, ...)      \
+  switch (type) {                                          \
+  case mshadow::kUint8:                                    \
+    {                                                      \
+      typedef uint8_t DType;                               \
+      {__VA_ARGS__}                                        \
+    }                                                      \
+    break;                                                 \
+  case mshadow::kInt8:                                     \
+    {                                                      \
+      typedef int8_t DType;                                \
+      {__VA_ARGS__}                                        \
+    }                                                      \
+    break;                                                 \
+  default:                                                 \
+    LOG(FATAL) << "Quantized operators only support "      \
+                  "int8 and uint8, got " << type;          \
+  }
+
 namespace mxnet {
 namespace op {
 
@@ -169,6 +188,46 @@ struct QuantizationRangeForMultiplicationStruct {
   }
 };
 
+/*!
+ * \brief Get the real value of one quantized level of type T and the real value
+ *  represented by the quantized zero. Signed types are zero-centered; uint8 is
+ *  zero-based with MKLDNN and spans [range_min, range_max] otherwise.
+ */
+template<typename T>
+MSHADOW_XINLINE void QuantizedLevelAndZero(float range_min, float range_max,
+                                           float *level, float *zero) {
+  using mshadow::red::limits::MinValue;
+  using mshadow::red::limits::MaxValue;
+  if (MinValue<T>() < 0) {
+    *level = MaxAbs(range_min, range_max) / MinAbs(MaxValue<T>(), MinValue<T>());
+    *zero = 0.0f;
+  } else {
+#if MXNET_USE_MKLDNN == 1
+    *level = MaxAbs(range_min, range_max) / MaxValue<T>();
+    *zero = 0.0f;
+#else
+    *level = (range_max - range_min) / MaxValue<T>();
+    *zero = range_min;
+#endif
+  }
+}
+
+/*!
+ * \brief Quantize a real value to type T, given the real value of one level and
+ *  of the quantized zero. Values out of the range of T are saturated.
+ */
+template<typename T>
+MSHADOW_XINLINE T QuantizeWithLevel(double input, float level, float zero) {
+  using mshadow::red::limits::MinValue;
+  using mshadow::red::limits::MaxValue;
+  // Signed types are kept symmetric, e.g. int8 saturates at -127.
+  const double highest = static_cast<double>(MaxValue<T>());
+  const double lowest = MinValue<T>() < 0 ? -highest : 0.0;
+  const double v = (input - zero) / level;
+  const double rounded = v >= 0 ? v + 0.5 : v - 0.5;
+  return static_cast<T>(Min(Max(rounded, lowest), highest));
+}
+
 }  // namespace op
 }  // namespace mxnet
 #endif  // MXNET_OPERATOR_QUANTIZATION_QUANTIZATION_UTILS_H_
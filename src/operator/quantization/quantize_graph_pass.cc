@@ -25,7 +25,9 @@
 #include <nnvm/graph.h>
 #include <nnvm/pass.h>
 #include <mxnet/op_attr_types.h>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace mxnet {
 namespace op {
@@ -89,6 +91,38 @@ std::vector<NodeEntry> OfflineParams(std::vector<NodeEntry>&& outputs,
   return outputs;
 }
 
+/*!
+ * \brief Make the dequantize nodes read the int32 output of a quantized operator
+ * directly when its requantize node has no other consumer. Dequantizing int32
+ * gives the same values without clipping them to the requantized range, and
+ * saves one pass over the data.
+ */
+void RemoveRequantizeBeforeDequantize(std::vector<NodeEntry>* outputs) {
+  std::unordered_map<Node*, size_t> num_consumers;
+  std::unordered_map<Node*, size_t> num_dequantize_consumers;
+  DFSVisit(*outputs, [&](const NodePtr& node) {
+    const bool is_dequantize = node->op() != nullptr && node->op()->name == "_contrib_dequantize";
+    for (const auto& e : node->inputs) {
+      ++num_consumers[e.node.get()];
+      if (is_dequantize) ++num_dequantize_consumers[e.node.get()];
+    }
+  });
+  for (const auto& e : *outputs) ++num_consumers[e.node.get()];
+  DFSVisit(*outputs, [&](const NodePtr& node) {
+    if (node->op() == nullptr || node->op()->name != "_contrib_dequantize") return;
+    NodePtr requantize_node = node->inputs[0].node;
+    if (requantize_node->op() == nullptr ||
+        requantize_node->op()->name != "_contrib_requantize" ||
+        num_consumers[requantize_node.get()] != num_dequantize_consumers[requantize_node.get()]) {
+      return;
+    }
+    for (auto& e : node->inputs) {
+      CHECK(e.node == requantize_node);
+      e = requantize_node->inputs[e.index];
+    }
+  });
+}
+
 inline bool NeedQuantize(NodePtr node, const std::unordered_set<NodePtr> excluded_nodes) {
   static auto& quantized_op_map = Op::GetAttr<mxnet::FQuantizedOp>("FQuantizedOp");
   return quantized_op_map.count(node->op()) && !excluded_nodes.count(node);
@@ -103,8 +137,60 @@ Graph QuantizeGraph(Graph &&src) {
 
   // mirror_map stores the mapping from the currently visited graph to the newly created quantized
   // graph. Key is the currently visited graph's node pointer, and value is a copied node of the key
-  // node. The existing key's value may be updated with the newly created quantize/dequantize op.
+  // node, or its quantized version followed by a requantize node when it needs one.
   std::unordered_map<Node*, NodePtr> mirror_map;
+  // quantize_map and dequantize_map store the conversion nodes created for an entry of the
+  // currently visited graph, so that each entry is converted once whatever its number of
+  // consumers. Keeping them out of mirror_map lets quantized consumers of a quantized entry
+  // read it directly, even if the entry also has float32 consumers.
+  nnvm::NodeEntryMap<NodePtr> quantize_map;
+  nnvm::NodeEntryMap<NodePtr> dequantize_map;
+
+  // Get the float32 version of an entry whose node is quantized.
+  auto dequantized_entry = [&](const NodeEntry& e) {
+    auto it = dequantize_map.find(e);
+    if (it == dequantize_map.end()) {
+      NodePtr mirror_node = mirror_map.at(e.node.get());
+      // here we calculate the output number (exclude min/max, in order to
+      // calculate min/max index from mirror node) based on assumption that
+      // there is only 1min and 1max output from mirror node (which is
+      // currently true)
+      size_t num_outputs = mirror_node->num_outputs() - 2;
+      uint32_t min_index = num_outputs + 2 * e.index;
+      uint32_t max_index = num_outputs + 2 * e.index + 1;
+      NodePtr dequantize_node = CreateNode("_contrib_dequantize",
+        e.node->attrs.name + "_dequantize");
+      dequantize_node->inputs.emplace_back(NodeEntry{mirror_node, e.index, e.version});
+      dequantize_node->inputs.emplace_back(NodeEntry{mirror_node, min_index, 0});
+      dequantize_node->inputs.emplace_back(NodeEntry{mirror_node, max_index, 0});
+      dequantize_node->op()->attr_parser(&(dequantize_node->attrs));
+      it = dequantize_map.emplace(e, std::move(dequantize_node)).first;
+    }
+    return NodeEntry{it->second, 0, 0};
+  };
+
+  // Get the quantize node of an entry whose node is not quantized.
+  auto quantize_node_of = [&](const NodeEntry& e) {
+    auto it = quantize_map.find(e);
+    if (it == quantize_map.end()) {
+      NodeEntry mirror_entry{mirror_map.at(e.node.get()), e.index, e.version};
+      NodePtr quantize_node = CreateNode("_contrib_quantize", e.node->attrs.name + "_quantize");
+      quantize_node->inputs.emplace_back(mirror_entry);
+      quantize_node->attrs.dict["out_type"] = quantized_dtype;
+      quantize_node->op()->attr_parser(&(quantize_node->attrs));
+
+      NodePtr min_node = InsertNode("min",
+          e.node->attrs.name + "_min", quantize_node, mirror_entry);
+      min_node->op()->attr_parser(&(min_node->attrs));
+
+      NodePtr max_node = InsertNode("max",
+          e.node->attrs.name + "_max", quantize_node, mirror_entry);
+      max_node->op()->attr_parser(&(max_node->attrs));
+      it = quantize_map.emplace(e, std::move(quantize_node)).first;
+    }
+    return it->second;
+  };
+
   DFSVisit(src.outputs, [&](const NodePtr& node) {
     NodePtr new_node = Node::Create();
     // If the currently visited node needs quantization, insert a quantize op node before the
@@ -115,64 +201,32 @@ Graph QuantizeGraph(Graph &&src) {
       // quantizated version of a that op, such as quantized_conv2d.
       new_node = fquantized_op(node->attrs);
 
-      // add data into quantized op input
+      // add data into quantized op input. Inputs from quantized nodes stay quantized, the
+      // others go through a quantize node.
       for (const auto& e : node->inputs) {
-        NodePtr mirror_node = mirror_map.at(e.node.get());
-        NodeEntry mirror_entry = NodeEntry{
-          mirror_node, e.index, e.version};
-        // If the NodeEntry e's node does not need quantization, and (the mirror_node is a variable,
-        // or the mirror_node's op is not a quantize op), create quantize op, min op, and max op
-        // taking mirror_entry as input to generate a quantized NDArray. Save the mapping between
-        // e's source node and the newly created quantize op so that the quantize op can be
-        // reused next time when the same entry is visited again.
-        if (!NeedQuantize(e.node, excluded_nodes) &&
-            (mirror_node->op() == nullptr ||
-             mirror_node->op()->name != "_contrib_quantize")) {
-          NodePtr quantize_node = InsertNode("_contrib_quantize",
-            e.node->attrs.name + "_quantize", new_node, mirror_entry);
-          quantize_node->attrs.dict["out_type"] = quantized_dtype;
-          quantize_node->op()->attr_parser(&(quantize_node->attrs));
-
-          NodePtr min_node = InsertNode("min",
-              e.node->attrs.name + "_min", quantize_node, mirror_entry);
-          min_node->op()->attr_parser(&(min_node->attrs));
-
-          NodePtr max_node = InsertNode("max",
-              e.node->attrs.name + "_max", quantize_node, mirror_entry);
-          max_node->op()->attr_parser(&(max_node->attrs));
-
-          mirror_map[e.node.get()] = std::move(quantize_node);
+        if (NeedQuantize(e.node, excluded_nodes)) {
+          new_node->inputs.emplace_back(NodeEntry{mirror_map.at(e.node.get()), e.index, e.version});
         } else {
-          // If the entry e's node needs quantization, or mirror_entry is from a quantize op,
-          // simply add mirror_entry to the input of the new_node.
-          new_node->inputs.emplace_back(mirror_entry);
+          new_node->inputs.emplace_back(NodeEntry{quantize_node_of(e), 0, 0});
         }
-        // the input should be `quantize` or quantized version op now
       }
 
       // add min and max into quantized op input assume order of quantized op inputs is:
       // data1, data2, ..., min1, max1, min2, max2, ...
       for (const auto& e : node->inputs) {
-        NodePtr mirror_node = mirror_map.at(e.node.get());
-        NodeEntry mirror_entry = NodeEntry{
-          mirror_node, e.index, e.version};
-        // for quantize node
+        NodePtr input_node;
         uint32_t min_index = 1;
         uint32_t max_index = 2;
-        if (quantized_op_map.count(e.node->op())) {
-          // here we calculate the output number (exclude min/max, in order to
-          // calculate min/max index from mirror node) based on assumption that
-          // there is only 1min and 1max output from mirror node (which is
-          // currently true)
-          size_t  num_outputs = mirror_node->num_outputs() - 2;
+        if (NeedQuantize(e.node, excluded_nodes)) {
+          input_node = mirror_map.at(e.node.get());
+          size_t num_outputs = input_node->num_outputs() - 2;
           min_index = num_outputs + 2 * e.index;
           max_index = num_outputs + 2 * e.index + 1;
         } else {
-          CHECK(mirror_node->op()->name == "_contrib_quantize")
-            << "The input is not quantize or quantized_op";
+          input_node = quantize_node_of(e);
         }
-        new_node->inputs.emplace_back(NodeEntry{mirror_node, min_index, 0});
-        new_node->inputs.emplace_back(NodeEntry{mirror_node, max_index, 0});
+        new_node->inputs.emplace_back(NodeEntry{input_node, min_index, 0});
+        new_node->inputs.emplace_back(NodeEntry{input_node, max_index, 0});
       }
 
       // If the new_node op registered attr FNeedRequantize, insert requantize node after it.
@@ -193,39 +247,15 @@ Graph QuantizeGraph(Graph &&src) {
       }
     } else {
       // If the currently visited node does not need quantization, copy the current node to become
-      // the new_node. Meanwhile, check whether any inputs of the current node need quantization
-      // (e.g., a quantized_conv2d node), and insert a dequantize op node in the new graph if there
-      // are any. Otherwise, simply add a copy of the current node's entry to the inputs of
-      // the new_node.
+      // the new_node. Inputs from quantized nodes go through a dequantize node, the others are
+      // copied as they are.
       *new_node = *node;
       new_node->inputs.clear();
       for (const auto& e : node->inputs) {
-        NodePtr mirror_node = mirror_map.at(e.node.get());
-        NodeEntry mirror_entry = NodeEntry{
-          mirror_node, e.index, e.version};
-        // if input node is quantized operator, add dequantize node
         if (NeedQuantize(e.node, excluded_nodes)) {
-          // here we calculate the output number (exclude min/max, in order to
-          // calculate min/max index from mirror node) based on assumption that
-          // there is only 1min and 1max output from mirror node (which is
-          // currently true)
-          size_t num_outputs = mirror_node->num_outputs() - 2;
-          uint32_t min_index = num_outputs + 2 * e.index;
-          uint32_t max_index = num_outputs + 2 * e.index + 1;
-          NodePtr dequantize_node = CreateNode("_contrib_dequantize",
-            e.node->attrs.name + "_dequantize");
-          dequantize_node->inputs.emplace_back(mirror_entry);
-          dequantize_node->inputs.emplace_back(NodeEntry{mirror_node, min_index, 0});
-          dequantize_node->inputs.emplace_back(NodeEntry{mirror_node, max_index, 0});
-          dequantize_node->op()->attr_parser(&(dequantize_node->attrs));
-
-          new_node->inputs.emplace_back(NodeEntry{dequantize_node, 0, 0});
-          mirror_map[e.node.get()] = std::move(dequantize_node);
-        } else if (mirror_node->op() != nullptr
-                   && mirror_node->op()->name == "_contrib_quantize") {
-          new_node->inputs.emplace_back(NodeEntry{mirror_node->inputs[0].node, e.index, e.version});
+          new_node->inputs.emplace_back(dequantized_entry(e));
         } else {
-          new_node->inputs.emplace_back(NodeEntry{mirror_node, e.index, e.version});
+          new_node->inputs.emplace_back(NodeEntry{mirror_map.at(e.node.get()), e.index, e.version});
         }
       }
     }
@@ -234,25 +264,14 @@ Graph QuantizeGraph(Graph &&src) {
 
   std::vector<NodeEntry> outputs;
   for (const auto& e : src.outputs) {
-    if (quantized_op_map.count(e.node->op())) {
-      NodePtr mirror_node = mirror_map.at(e.node.get());
-      NodeEntry mirror_entry = NodeEntry{mirror_node, e.index, e.version};
-      size_t num_inputs = e.node->num_inputs();
-      uint32_t min_index = num_inputs + 2 * e.index;
-      uint32_t max_index = num_inputs + 2 * e.index + 1;
-
-      NodePtr dequantize_node = CreateNode("_contrib_dequantize",
-          e.node->attrs.name + "_dequantize");
-      dequantize_node->inputs.emplace_back(mirror_entry);
-      dequantize_node->inputs.emplace_back(NodeEntry{mirror_node, min_index, 0});
-      dequantize_node->inputs.emplace_back(NodeEntry{mirror_node, max_index, 0});
-      dequantize_node->op()->attr_parser(&(dequantize_node->attrs));
-      outputs.emplace_back(NodeEntry{dequantize_node, 0, 0});
+    if (NeedQuantize(e.node, excluded_nodes)) {
+      outputs.emplace_back(dequantized_entry(e));
     } else {
       outputs.emplace_back(NodeEntry{mirror_map.at(e.node.get()), e.index, e.version});
     }
   }
 
+  RemoveRequantizeBeforeDequantize(&outputs);
   if (!offline_params.empty()) outputs =
     OfflineParams(std::move(outputs), std::move(offline_params));
 
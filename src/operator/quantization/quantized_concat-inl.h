@@ -0,0 +1,178 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file quantized_concat-inl.h
+ * \brief implementation of quantized concat operation
+ */
+#ifndef MXNET_OPERATOR_QUANTIZATION_QUANTIZED_CONCAT_INL_H_
+#define MXNET_OPERATOR_QUANTIZATION_QUANTIZED_CONCAT_INL_H_
+
+#include <mxnet/operator_util.h>
+#include <vector>
+#include "../elemwise_op_common.h"
+#include "../mxnet_op.h"
+#include "../nn/concat-inl.h"
+#include "./quantization_utils.h"
+
+namespace mxnet {
+namespace op {
+
+// Widen the output range so that it covers the range of one more input.
+struct quantized_concat_range {
+  MSHADOW_XINLINE static void Map(int i, float *omin_range, float *omax_range,
+                                  const float *imin_range, const float *imax_range,
+                                  const bool first, const bool zero_centered) {
+    if (zero_centered) {
+      const float real_range = first ? MaxAbs(*imin_range, *imax_range) :
+          Max(MaxAbs(*imin_range, *imax_range), *omax_range);
+      *omin_range = -real_range;
+      *omax_range = real_range;
+    } else {
+      *omin_range = first ? *imin_range : Min(*imin_range, *omin_range);
+      *omax_range = first ? *imax_range : Max(*imax_range, *omax_range);
+    }
+  }
+};
+
+// Copy one input into its slice of the output, requantized to the output range.
+struct quantized_concat_copy {
+  template<typename DstDType, typename SrcDType>
+  MSHADOW_XINLINE static void Map(int i, DstDType *out, const SrcDType *in,
+                                  const float *omin_range, const float *omax_range,
+                                  const float *imin_range, const float *imax_range,
+                                  const index_t in_block, const index_t out_block,
+                                  const index_t offset) {
+    float ilevel, izero, olevel, ozero;
+    QuantizedLevelAndZero<SrcDType>(*imin_range, *imax_range, &ilevel, &izero);
+    QuantizedLevelAndZero<DstDType>(*omin_range, *omax_range, &olevel, &ozero);
+    const index_t j = (i / in_block) * out_block + offset + i % in_block;
+    if (ilevel == olevel && izero == ozero) {
+      out[j] = static_cast<DstDType>(in[i]);
+    } else {
+      out[j] = QuantizeWithLevel<DstDType>(
+          static_cast<double>(in[i]) * ilevel + izero, olevel, ozero);
+    }
+  }
+};
+
+/*!
+ * \brief Concatenate quantized arrays that have their own ranges. The output
+ *  covers the union of the input ranges; inputs whose range differs from it
+ *  are requantized while they are copied.
+ */
+template<typename xpu>
+void QuantizedConcatCompute(const nnvm::NodeAttrs& attrs,
+                            const OpContext& ctx,
+                            const std::vector<TBlob>& inputs,
+                            const std::vector<OpReqType>& req,
+                            const std::vector<TBlob>& outputs) {
+  using namespace mshadow;
+  using namespace mxnet_op;
+  const ConcatParam& param = nnvm::get<ConcatParam>(attrs.parsed);
+  const int num_args = param.num_args;
+  CHECK_EQ(inputs.size(), 3U * num_args);
+  CHECK_EQ(outputs.size(), 3U);
+  CHECK_NE(req[0], kAddTo) << "quantized_concat does not support kAddTo";
+  Stream<xpu> *s = ctx.get_stream<xpu>();
+  const TBlob &out = outputs[0];
+  const bool zero_centered = out.type_flag_ == mshadow::kInt8;
+  for (int k = 0; k < num_args; ++k) {
+    Kernel<quantized_concat_range, xpu>::Launch(s, 1,
+      outputs[1].dptr<float>(), outputs[2].dptr<float>(),
+      inputs[num_args + 2 * k].dptr<float>(), inputs[num_args + 2 * k + 1].dptr<float>(),
+      k == 0, zero_centered);
+  }
+  const int axis = CheckAxis(param.dim, out.ndim());
+  const index_t inner = out.shape_.ProdShape(axis + 1, out.ndim());
+  const index_t out_block = out.shape_[axis] * inner;
+  index_t offset = 0;
+  for (int k = 0; k < num_args; ++k) {
+    const TBlob &in = inputs[k];
+    const index_t in_block = in.shape_[axis] * inner;
+    MXNET_QUANTIZED_TYPE_SWITCH(out.type_flag_, DstDType, {
+      MXNET_QUANTIZED_TYPE_SWITCH(in.type_flag_, SrcDType, {
+        Kernel<quantized_concat_copy, xpu>::Launch(s, in.Size(),
+          out.dptr<DstDType>(), in.dptr<SrcDType>(),
+          outputs[1].dptr<float>(), outputs[2].dptr<float>(),
+          inputs[num_args + 2 * k].dptr<float>(), inputs[num_args + 2 * k + 1].dptr<float>(),
+          in_block, out_block, offset);
+      });
+    });
+    offset += in_block;
+  }
+}
+
+inline bool QuantizedConcatShape(const nnvm::NodeAttrs& attrs,
+                                 std::vector<TShape> *in_attrs,
+                                 std::vector<TShape> *out_attrs) {
+  const ConcatParam& param = nnvm::get<ConcatParam>(attrs.parsed);
+  const int num_args = param.num_args;
+  CHECK_EQ(in_attrs->size(), 3U * num_args);
+  CHECK_EQ(out_attrs->size(), 3U);
+  TShape dshape;
+  index_t size = 0;
+  int axis = -1;
+  for (int i = 0; i < num_args; ++i) {
+    TShape tmp = (*in_attrs)[i];
+    if (tmp.ndim() == 0) return false;
+    axis = CheckAxis(param.dim, tmp.ndim());
+    size += tmp[axis];
+    tmp[axis] = 0;
+    CHECK(shape_assign(&dshape, tmp))
+      << "Incompatible input shape: expected " << dshape << ", got " << (*in_attrs)[i];
+  }
+  dshape[axis] = size;
+  for (int i = num_args; i < 3 * num_args; ++i) {
+    SHAPE_ASSIGN_CHECK(*in_attrs, i, TShape{1});
+  }
+  SHAPE_ASSIGN_CHECK(*out_attrs, 0, dshape);
+  SHAPE_ASSIGN_CHECK(*out_attrs, 1, TShape{1});
+  SHAPE_ASSIGN_CHECK(*out_attrs, 2, TShape{1});
+  return true;
+}
+
+inline bool QuantizedConcatType(const nnvm::NodeAttrs& attrs,
+                                std::vector<int> *in_attrs,
+                                std::vector<int> *out_attrs) {
+  const ConcatParam& param = nnvm::get<ConcatParam>(attrs.parsed);
+  const int num_args = param.num_args;
+  CHECK_EQ(in_attrs->size(), 3U * num_args);
+  CHECK_EQ(out_attrs->size(), 3U);
+  // The output is uint8 only if all the inputs are, otherwise it is int8.
+  int out_type = mshadow::kUint8;
+  for (int i = 0; i < num_args; ++i) {
+    const int dtype = (*in_attrs)[i];
+    if (dtype == -1) return false;
+    CHECK(dtype == mshadow::kInt8 || dtype == mshadow::kUint8)
+      << "quantized_concat only supports int8 and uint8 as input type";
+    if (dtype == mshadow::kInt8) out_type = mshadow::kInt8;
+  }
+  for (int i = num_args; i < 3 * num_args; ++i) {
+    TYPE_ASSIGN_CHECK(*in_attrs, i, mshadow::kFloat32);
+  }
+  TYPE_ASSIGN_CHECK(*out_attrs, 0, out_type);
+  TYPE_ASSIGN_CHECK(*out_attrs, 1, mshadow::kFloat32);
+  TYPE_ASSIGN_CHECK(*out_attrs, 2, mshadow::kFloat32);
+  return true;
+}
+
+}  // namespace op
+}  // namespace mxnet
+#endif  // MXNET_OPERATOR_QUANTIZATION_QUANTIZED_CONCAT_INL_H_
@@ -0,0 +1,125 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file quantized_elemwise_add-inl.h
+ * \brief implementation of quantized elementwise addition
+ */
+#ifndef MXNET_OPERATOR_QUANTIZATION_QUANTIZED_ELEMWISE_ADD_INL_H_
+#define MXNET_OPERATOR_QUANTIZATION_QUANTIZED_ELEMWISE_ADD_INL_H_
+
+#include <mxnet/operator_util.h>
+#include <vector>
+#include "../elemwise_op_common.h"
+#include "../mxnet_op.h"
+#include "./quantization_utils.h"
+
+namespace mxnet {
+namespace op {
+
+// The sum of the real values of lhs and rhs, quantized into int32. The output
+// range is the sum of the input ranges, so that the result never saturates.
+struct quantized_elemwise_add {
+  template<typename LType, typename RType>
+  MSHADOW_XINLINE static void Map(int i, int32_t *out, float *omin_range, float *omax_range,
+                                  const LType *lhs, const RType *rhs,
+                                  const float *lmin_range, const float *lmax_range,
+                                  const float *rmin_range, const float *rmax_range) {
+    using mshadow::red::limits::MaxValue;
+    float llevel, lzero, rlevel, rzero;
+    QuantizedLevelAndZero<LType>(*lmin_range, *lmax_range, &llevel, &lzero);
+    QuantizedLevelAndZero<RType>(*rmin_range, *rmax_range, &rlevel, &rzero);
+    const float real_range = MaxAbs(*lmin_range, *lmax_range) + MaxAbs(*rmin_range, *rmax_range);
+    const float olevel = real_range / MaxValue<int32_t>();
+    const double sum = static_cast<double>(lhs[i]) * llevel + lzero +
+                       static_cast<double>(rhs[i]) * rlevel + rzero;
+    out[i] = QuantizeWithLevel<int32_t>(sum, olevel, 0.0f);
+    if (i == 0) {
+      *omin_range = -real_range;
+      *omax_range = real_range;
+    }
+  }
+};
+
+template<typename xpu>
+void QuantizedElemwiseAddCompute(const nnvm::NodeAttrs& attrs,
+                                 const OpContext& ctx,
+                                 const std::vector<TBlob>& inputs,
+                                 const std::vector<OpReqType>& req,
+                                 const std::vector<TBlob>& outputs) {
+  using namespace mshadow;
+  using namespace mxnet_op;
+  CHECK_EQ(inputs.size(), 6U);
+  CHECK_EQ(outputs.size(), 3U);
+  CHECK_NE(req[0], kAddTo) << "quantized_elemwise_add does not support kAddTo";
+  Stream<xpu> *s = ctx.get_stream<xpu>();
+  MXNET_QUANTIZED_TYPE_SWITCH(inputs[0].type_flag_, LType, {
+    MXNET_QUANTIZED_TYPE_SWITCH(inputs[1].type_flag_, RType, {
+      Kernel<quantized_elemwise_add, xpu>::Launch(s, outputs[0].Size(),
+        outputs[0].dptr<int32_t>(), outputs[1].dptr<float>(), outputs[2].dptr<float>(),
+        inputs[0].dptr<LType>(), inputs[1].dptr<RType>(),
+        inputs[2].dptr<float>(), inputs[3].dptr<float>(),
+        inputs[4].dptr<float>(), inputs[5].dptr<float>());
+    });
+  });
+}
+
+inline bool QuantizedElemwiseAddShape(const nnvm::NodeAttrs& attrs,
+                                      std::vector<TShape> *in_attrs,
+                                      std::vector<TShape> *out_attrs) {
+  CHECK_EQ(in_attrs->size(), 6U);
+  CHECK_EQ(out_attrs->size(), 3U);
+  TShape dshape = (*in_attrs)[0];
+  CHECK(shape_assign(&dshape, (*in_attrs)[1]))
+    << "quantized_elemwise_add requires inputs of the same shape, got "
+    << (*in_attrs)[0] << " and " << (*in_attrs)[1];
+  CHECK(shape_assign(&dshape, (*out_attrs)[0]));
+  SHAPE_ASSIGN_CHECK(*in_attrs, 0, dshape);
+  SHAPE_ASSIGN_CHECK(*in_attrs, 1, dshape);
+  for (size_t i = 2; i < 6; ++i) {
+    SHAPE_ASSIGN_CHECK(*in_attrs, i, TShape{1});
+  }
+  SHAPE_ASSIGN_CHECK(*out_attrs, 0, dshape);
+  SHAPE_ASSIGN_CHECK(*out_attrs, 1, TShape{1});
+  SHAPE_ASSIGN_CHECK(*out_attrs, 2, TShape{1});
+  return !shape_is_none(dshape);
+}
+
+inline bool QuantizedElemwiseAddType(const nnvm::NodeAttrs& attrs,
+                                     std::vector<int> *in_attrs,
+                                     std::vector<int> *out_attrs) {
+  CHECK_EQ(in_attrs->size(), 6U);
+  CHECK_EQ(out_attrs->size(), 3U);
+  for (size_t i = 0; i < 2; ++i) {
+    CHECK((*in_attrs)[i] == -1 || (*in_attrs)[i] == mshadow::kInt8 ||
+          (*in_attrs)[i] == mshadow::kUint8)
+      << "quantized_elemwise_add only supports int8 and uint8 as input type";
+  }
+  for (size_t i = 2; i < 6; ++i) {
+    TYPE_ASSIGN_CHECK(*in_attrs, i, mshadow::kFloat32);
+  }
+  TYPE_ASSIGN_CHECK(*out_attrs, 0, mshadow::kInt32);
+  TYPE_ASSIGN_CHECK(*out_attrs, 1, mshadow::kFloat32);
+  TYPE_ASSIGN_CHECK(*out_attrs, 2, mshadow::kFloat32);
+  return (*in_attrs)[0] != -1 && (*in_attrs)[1] != -1;
+}
+
+}  // namespace op
+}  // namespace mxnet
+#endif  // MXNET_OPERATOR_QUANTIZATION_QUANTIZED_ELEMWISE_ADD_INL_H_
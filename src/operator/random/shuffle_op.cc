@@ -36,6 +36,7 @@
   #include <parallel/algorithm>
 #endif
 #include "../elemwise_op_common.h"
+#include "../../common/random_generator.h"
 
 namespace mxnet {
 namespace op {
@@ -98,7 +99,10 @@ void ShuffleForwardCPU(const nnvm::NodeAttrs& attrs,
   MSHADOW_TYPE_SWITCH(inputs[0].type_flag_, DType, {
     Tensor<cpu, 1, DType> in = inputs[0].get_with_shape<cpu, 1, DType>(Shape1(size), s);
     Tensor<cpu, 1, DType> out = outputs[0].get_with_shape<cpu, 1, DType>(Shape1(size), s);
-    auto& prnd = ctx.requested[0].get_random<cpu, index_t>(ctx.get_stream<cpu>())->GetRndEngine();
+    auto& rnd_engine =
+      ctx.requested[0].get_random<cpu, index_t>(ctx.get_stream<cpu>())->GetRndEngine();
+    // a counter-based stream seeded from the resource is cheaper to draw from
+    common::random::Philox4x32 prnd(rnd_engine());
     if (req[0] != kWriteInplace) {
       std::copy(in.dptr_, in.dptr_ + size, out.dptr_);
     }
@@ -101,10 +101,12 @@ inline size_t GetRNNWorkspaceSize(int seq_length,
   switch (mode) {
     case rnn_enum::kLstm:
       size = (seq_length + 1) * batch_size * hidden_size * 4 + batch_size * hidden_size * 2
-             + seq_length * batch_size * hidden_size * direction + hidden_size * seq_length * 8;
+             + seq_length * batch_size * hidden_size * direction + hidden_size * seq_length * 8
+             + hidden_size * hidden_size * 4;
       break;
     case rnn_enum::kGru:
-      size = seq_length * batch_size * hidden_size * direction * 4 + batch_size * hidden_size * 8;
+      size = seq_length * batch_size * hidden_size * direction * 4 + batch_size * hidden_size * 8
+             + hidden_size * hidden_size * 3;
       break;
     case rnn_enum::kRnnRelu:
     case rnn_enum::kRnnTanh:
@@ -27,6 +27,7 @@
 #define MXNET_OPERATOR_RNN_IMPL_H_
 
 #include <dmlc/logging.h>
+#include <dmlc/omp.h>
 #include <dmlc/parameter.h>
 #include <mxnet/operator.h>
 #include <algorithm>
@@ -54,9 +55,93 @@ inline DType relu(DType x) {
   return x > 0.0f ? static_cast<float>(x) : 0.0f;
 }
 
+/*!
+ * \brief gates = h w, computed by the calling thread alone, from inside a parallel region.
+ *  MKL runs sequentially when called from a parallel region. Other BLAS libraries, such as
+ *  a pthreads build of OpenBLAS, would serialize the threads on, or oversubscribe, their own
+ *  thread pool instead, so a plain loop, vectorized over the columns of w, is used for them.
+ * \param h (N, H) hidden state
+ * \param w (H, R) packed hidden weights
+ * \param gates (N, R) result
+ */
+template<typename DType>
+inline void RecurrentStepGemm(const Tensor<cpu, 2, DType> &h,
+                              const Tensor<cpu, 2, DType> &w,
+                              const Tensor<cpu, 2, DType> &gates) {
+#if MSHADOW_USE_MKL == 1
+  linalg_gemm(h, w, gates, DType(1), DType(0), false, false);
+#else
+  const index_t rows = w.size(1);
+  for (index_t j = 0; j < h.size(0); ++j) {
+    const DType* h_j = h[j].dptr_;
+    DType* gates_j = gates[j].dptr_;
+    std::fill(gates_j, gates_j + rows, DType(0));
+    for (index_t c = 0; c < h.size(1); ++c) {
+      const DType h_jc = h_j[c];
+      const DType* w_c = w[c].dptr_;
+      for (index_t r = 0; r < rows; ++r) gates_j[r] += h_jc * w_c[r];
+    }
+  }
+#endif
+}
+
+/*!
+ * \brief Runs the T recurrent steps of a single layer on cpu in one parallel region.
+ *  The hidden units are split in contiguous blocks, one per thread. Each thread first
+ *  packs the rows of wh of its units for all G gates, transposed, in wh_pack, so that
+ *  at every step a single GEMM of the previous hidden state computes the hidden
+ *  projections of all the gates of its units, then applies the cell update to them.
+ *  Threads only synchronize once per step, when the new hidden state is complete.
+ * \param wh hidden weights of shape (G * H, H)
+ * \param wh_pack workspace of G * H * H elements for the packed weights
+ * \param gates_ptr workspace of N * G * H elements for the hidden projections
+ * \param h_prev h_prev(i) is the (N, H) hidden state read at step i
+ * \param cell cell(i, j, k0, k1, gates) updates the units [k0, k1) of sample j at step i,
+ *  gates holding the G x (k1 - k0) hidden projections of these units
+ */
+template<typename DType, typename HPrev, typename Cell>
+void RecurrentStepsCPU(const int T,
+                       const int N,
+                       const int H,
+                       const int G,
+                       const Tensor<cpu, 2, DType> &wh,
+                       DType* wh_pack,
+                       DType* gates_ptr,
+                       const HPrev &h_prev,
+                       const Cell &cell) {
+  const int omp_threads = std::max(1, std::min(H,
+      mxnet::engine::OpenMP::Get()->GetRecommendedOMPThreadCount()));
+  #pragma omp parallel num_threads(omp_threads)
+  {
+    const int nthreads = omp_get_num_threads();
+    const int tid = omp_get_thread_num();
+    const int k0 = static_cast<int>(static_cast<int64_t>(H) * tid / nthreads);
+    const int k1 = static_cast<int>(static_cast<int64_t>(H) * (tid + 1) / nthreads);
+    const int units = k1 - k0;
+    const Tensor<cpu, 2, DType> w(wh_pack + G * k0 * H, Shape2(H, G * units));
+    const Tensor<cpu, 2, DType> gates(gates_ptr + N * G * k0, Shape2(N, G * units));
+    for (int g = 0; g < G; ++g) {
+      for (int k = k0; k < k1; ++k) {
+        const DType* wh_k = wh[g * H + k].dptr_;
+        for (int c = 0; c < H; ++c) w[c][g * units + k - k0] = wh_k[c];
+      }
+    }
+    for (int i = 0; i < T; ++i) {
+      if (units > 0) {
+        RecurrentStepGemm(h_prev(i), w, gates);
+        for (int j = 0; j < N; ++j) {
+          cell(i, j, k0, k1, gates[j].dptr_);
+        }
+      }
+      #pragma omp barrier
+    }
+  }
+}
+
 template<typename DType>
 void LstmForwardTrainingSingleLayer(DType* ws,
                                     DType* rs,
+                                    DType* wh_pack,
                                     bool state_outputs,
                                     bool bid,
                                     const int T,
@@ -77,10 +162,7 @@ void LstmForwardTrainingSingleLayer(DType* ws,
   const Tensor<cpu, 2, DType> bx(b_ptr, Shape2(4, H));
   const Tensor<cpu, 2, DType> bh(b_ptr + H * 4, Shape2(4, H));
   const Tensor<cpu, 2, DType> yx_flat(ws, Shape2(T * N, 4 * H));
-  const Tensor<cpu, 2, DType> yh_flat(ws + T * N * H * 4, Shape2(N, 4 * H));
   const Tensor<cpu, 4, DType> yx(yx_flat.dptr_, Shape4(T, N, 4, H));
-  const Tensor<cpu, 3, DType> yh(yh_flat.dptr_, Shape3(N, 4, H));
-  Tensor<cpu, 2, DType> h(yh_flat.dptr_ + N * H * 4, Shape2(N, H));
   DType *c_ptr = bid ? rs + T * N * H * 7 : rs;
   Tensor<cpu, 3, DType> c(c_ptr, Shape3(T, N, H));
   Tensor<cpu, 4, DType> ifgo(c_ptr + T * N * H, Shape4(T, N, H, 4));
@@ -88,24 +170,25 @@ void LstmForwardTrainingSingleLayer(DType* ws,
   const int offset = bid ? H : 0;
   const DType alpha = 1.0;
   const DType beta = 0.0;
-  const int cell_size = N * H;
   linalg_gemm(x, wx, yx_flat, alpha, beta, false, true);
 
-  const int omp_threads = mxnet::engine::OpenMP::Get()->GetRecommendedOMPThreadCount();
-  for (int i = 0; i < T; ++i) {
-    int t = bid ? T - 1 - i : i;
-    linalg_gemm(i ? h : hx, wh, yh_flat, alpha, beta, false, true);
-    #pragma omp parallel for num_threads(omp_threads)
-    for (int jk = 0; jk < cell_size; ++jk) {
-      int j = jk / H;
-      int k = jk % H;
-      DType it = sigmoid<DType>(yx[t][j][0][k] + yh[j][0][k] + bx[0][k] + bh[0][k]);
-      DType ft = sigmoid<DType>(yx[t][j][1][k] + yh[j][1][k] + bx[1][k] + bh[1][k]);
-      DType gt =           tanh(yx[t][j][2][k] + yh[j][2][k] + bx[2][k] + bh[2][k]);
-      DType ot = sigmoid<DType>(yx[t][j][3][k] + yh[j][3][k] + bx[3][k] + bh[3][k]);
+  // the hidden state of step i - 1 is read back from y
+  auto h_prev = [&](const int i) {
+    const int t = bid ? T - i : i - 1;
+    return i ? Tensor<cpu, 2, DType>(y.dptr_ + t * y.size(1) * y.stride_ + offset,
+                                     Shape2(N, H), y.stride_, nullptr) : hx;
+  };
+  auto cell = [&](const int i, const int j, const int k0, const int k1, const DType* yh) {
+    const int t = bid ? T - 1 - i : i;
+    const int units = k1 - k0;
+    for (int k = k0; k < k1; ++k) {
+      const DType* yh_k = yh + k - k0;
+      DType it = sigmoid<DType>(yx[t][j][0][k] + yh_k[0] + bx[0][k] + bh[0][k]);
+      DType ft = sigmoid<DType>(yx[t][j][1][k] + yh_k[units] + bx[1][k] + bh[1][k]);
+      DType gt =           tanh(yx[t][j][2][k] + yh_k[units * 2] + bx[2][k] + bh[2][k]);
+      DType ot = sigmoid<DType>(yx[t][j][3][k] + yh_k[units * 3] + bx[3][k] + bh[3][k]);
       DType ct = (i ? c[i-1][j][k] : cx[j][k]) * ft + it * gt;
       DType ht = ot * tanh(ct);
-      h[j][k] = ht;
       // reserve
       y[t][j][k + offset] = ht;
       c[i][j][k] = ct;
@@ -114,11 +197,12 @@ void LstmForwardTrainingSingleLayer(DType* ws,
       ifgo[i][j][k][2] = gt;
       ifgo[i][j][k][3] = ot;
       if (i == T - 1 && state_outputs) {
-        hy_ptr[jk] = ht;
-        cy_ptr[jk] = ct;
+        hy_ptr[j * H + k] = ht;
+        cy_ptr[j * H + k] = ct;
       }
     }
-  }
+  };
+  RecurrentStepsCPU<DType>(T, N, H, 4, wh, wh_pack, ws + T * N * H * 4, h_prev, cell);
 }
 
 template <typename DType>
@@ -149,6 +233,7 @@ void LstmForwardTraining(DType* ws,
   const int r_size = D * T * N * H * 6;
   const int y_offset = T * N * H * 5;
   const int cell_size = N * H;
+  DType* wh_pack = ws + (T + 1) * cell_size * 4 + cell_size * 2 + T * cell_size * D + H * T * 8;
   unsigned int seed_ = 17 + rand() % 4096;  // NOLINT(runtime/threadsafe_fn)
   int idx = 0;  // state & cell state's idx;
   const int omp_threads = mxnet::engine::OpenMP::Get()->GetRecommendedOMPThreadCount();
@@ -157,8 +242,9 @@ void LstmForwardTraining(DType* ws,
     const int w_size = (input_size + H) * H * 4;
     Tensor<cpu, 2, DType> x(x_ptr, Shape2(T * N, input_size));
     Tensor<cpu, 3, DType> y(rs2 + y_offset, Shape3(T, N, H * D));
-    LstmForwardTrainingSingleLayer<DType>(ws, rs2, state_outputs, false, T, N, input_size, H, x,
-                                          hx[idx], cx[idx], y, w_ptr, b_ptr, hy_ptr, cy_ptr);
+    LstmForwardTrainingSingleLayer<DType>(ws, rs2, wh_pack, state_outputs, false, T, N,
+                                          input_size, H, x, hx[idx], cx[idx], y, w_ptr, b_ptr,
+                                          hy_ptr, cy_ptr);
     if (D == 2) {
       w_ptr += w_size;
       b_ptr += b_size;
@@ -167,8 +253,9 @@ void LstmForwardTraining(DType* ws,
         hy_ptr += cell_size;
         cy_ptr += cell_size;
       }
-      LstmForwardTrainingSingleLayer<DType>(ws, rs2, state_outputs, true, T, N, input_size, H, x,
-                                            hx[idx], cx[idx], y, w_ptr, b_ptr, hy_ptr, cy_ptr);
+      LstmForwardTrainingSingleLayer<DType>(ws, rs2, wh_pack, state_outputs, true, T, N,
+                                            input_size, H, x, hx[idx], cx[idx], y, w_ptr, b_ptr,
+                                            hy_ptr, cy_ptr);
     }
     if (i != L - 1) {
       w_ptr += w_size;
@@ -203,6 +290,7 @@ void LstmForwardTraining(DType* ws,
 
 template<typename DType>
 void LstmForwardInferenceSingleLayer(DType* ws,
+                                     DType* wh_pack,
                                      bool state_outputs,
                                      bool bid,
                                      const int T,
@@ -223,41 +311,40 @@ void LstmForwardInferenceSingleLayer(DType* ws,
   const Tensor<cpu, 2, DType> bx(b_ptr, Shape2(4, H));
   const Tensor<cpu, 2, DType> bh(b_ptr + H * 4, Shape2(4, H));
   Tensor<cpu, 2, DType> yx_flat(ws, Shape2(T * N, H * 4));
-  Tensor<cpu, 2, DType> yh_flat(ws + T * N * H * 4, Shape2(N, H * 4));
   const Tensor<cpu, 4, DType> yx(yx_flat.dptr_, Shape4(T, N, 4, H));
-  const Tensor<cpu, 3, DType> yh(yh_flat.dptr_, Shape3(N, 4, H));
-  Tensor<cpu, 2, DType> h(yh_flat.dptr_ + N * H * 4, Shape2(N, H));
-  Tensor<cpu, 2, DType> c(h.dptr_ + N * H, Shape2(N, H));
+  Tensor<cpu, 2, DType> c(ws + (T + 1) * N * H * 4 + N * H, Shape2(N, H));
   const int offset = bid ? H : 0;
   const DType alpha = 1.0;
   const DType beta = 0.0;
-  const int cell_size = N * H;
   linalg_gemm(x, wx, yx_flat, alpha, beta, false, true);
 
-  const int omp_threads = mxnet::engine::OpenMP::Get()->GetRecommendedOMPThreadCount();
-  for (int i = 0; i < T; ++i) {
-    int t = bid ? T - 1 - i : i;
-    linalg_gemm(i ? h : hx, wh, yh_flat, alpha, beta, false, true);
-    #pragma omp parallel for num_threads(omp_threads)
-    for (int jk = 0; jk < cell_size; ++jk) {
-      int j = jk / H;
-      int k = jk % H;
-      DType it = sigmoid<DType>(yx[t][j][0][k] + yh[j][0][k] + bx[0][k] + bh[0][k]);
-      DType ft = sigmoid<DType>(yx[t][j][1][k] + yh[j][1][k] + bx[1][k] + bh[1][k]);
-      DType gt =           tanh(yx[t][j][2][k] + yh[j][2][k] + bx[2][k] + bh[2][k]);
-      DType ot = sigmoid<DType>(yx[t][j][3][k] + yh[j][3][k] + bx[3][k] + bh[3][k]);
+  // the hidden state of step i - 1 is read back from y
+  auto h_prev = [&](const int i) {
+    const int t = bid ? T - i : i - 1;
+    return i ? Tensor<cpu, 2, DType>(y.dptr_ + t * y.size(1) * y.stride_ + offset,
+                                     Shape2(N, H), y.stride_, nullptr) : hx;
+  };
+  auto cell = [&](const int i, const int j, const int k0, const int k1, const DType* yh) {
+    const int t = bid ? T - 1 - i : i;
+    const int units = k1 - k0;
+    for (int k = k0; k < k1; ++k) {
+      const DType* yh_k = yh + k - k0;
+      DType it = sigmoid<DType>(yx[t][j][0][k] + yh_k[0] + bx[0][k] + bh[0][k]);
+      DType ft = sigmoid<DType>(yx[t][j][1][k] + yh_k[units] + bx[1][k] + bh[1][k]);
+      DType gt =           tanh(yx[t][j][2][k] + yh_k[units * 2] + bx[2][k] + bh[2][k]);
+      DType ot = sigmoid<DType>(yx[t][j][3][k] + yh_k[units * 3] + bx[3][k] + bh[3][k]);
       DType ct = (i ? c[j][k] : cx[j][k]) * ft + it * gt;
       DType ht = ot * tanh(ct);
       y[t][j][k + offset] = ht;
       if (i == T - 1 && state_outputs) {
-        hy_ptr[jk] = ht;
-        cy_ptr[jk] = ct;
+        hy_ptr[j * H + k] = ht;
+        cy_ptr[j * H + k] = ct;
       } else {
-        h[j][k] = ht;
         c[j][k] = ct;
       }
     }
-  }
+  };
+  RecurrentStepsCPU<DType>(T, N, H, 4, wh, wh_pack, ws + T * N * H * 4, h_prev, cell);
 }
 
 template <typename DType>
@@ -283,6 +370,7 @@ void LstmForwardInference(DType* ws,
   const int b_size = 2 * H * 4;
   const int cell_size = N * H;
   DType* y_tmp_ptr = ws + (T + 1) * cell_size * 4 + cell_size * 2;
+  DType* wh_pack = y_tmp_ptr + T * cell_size * D + H * T * 8;
   DType* y_cur_ptr = y_ptr;
   int idx = 0;  // state & cell state's idx;
   bool flag = L % 2 ? false : true;
@@ -296,8 +384,8 @@ void LstmForwardInference(DType* ws,
     }
     Tensor<cpu, 2, DType> x(x_ptr, Shape2(T * N, input_size));
     Tensor<cpu, 3, DType> y(y_cur_ptr, Shape3(T, N, H * D));
-    LstmForwardInferenceSingleLayer<DType>(ws, state_outputs, false, T, N, input_size, H,
-                                           x, hx[idx], cx[idx], y, w_ptr, b_ptr, hy_ptr, cy_ptr);
+    LstmForwardInferenceSingleLayer<DType>(ws, wh_pack, state_outputs, false, T, N, input_size,
+                                           H, x, hx[idx], cx[idx], y, w_ptr, b_ptr, hy_ptr, cy_ptr);
     // If bidirectional, then calculate the reverse direction's forward result.
     if (D == 2) {
       w_ptr += w_size;
@@ -307,8 +395,9 @@ void LstmForwardInference(DType* ws,
         hy_ptr += cell_size;
         cy_ptr += cell_size;
       }
-      LstmForwardInferenceSingleLayer<DType>(ws, state_outputs, true, T, N, input_size, H,
-                                             x, hx[idx], cx[idx], y, w_ptr, b_ptr, hy_ptr, cy_ptr);
+      LstmForwardInferenceSingleLayer<DType>(ws, wh_pack, state_outputs, true, T, N, input_size,
+                                             H, x, hx[idx], cx[idx], y, w_ptr, b_ptr, hy_ptr,
+                                             cy_ptr);
     }
     // Don't need to move pointer in the last layer.
     if (i != L - 1) {
@@ -586,7 +675,7 @@ void LstmBackward(DType* ws,
 
 template<typename DType>
 void GruForwardInferenceSingleLayer(DType* ws,
-                                    DType* tmp_buf,
+                                    DType* wh_pack,
                                     bool state_outputs,
                                     const int D,
                                     const int T,
@@ -601,136 +690,49 @@ void GruForwardInferenceSingleLayer(DType* ws,
                                     DType* bh_ptr,
                                     DType* y_ptr,
                                     DType* hy_ptr) {
-  DType* ht = y_ptr;
-  DType* ht_1 = y_ptr;
-  DType* back_ht_1 = y_ptr + (T-1) * N * H * D + H;
-  DType* back_ht = back_ht_1;
+  using namespace mshadow;
   DType* gemmC1  = ws;              // [D, T, N, 3 * H]
   DType* gemmC2  = gemmC1 + D * T * N * 3 * H;  // N * 3 * H
-  DType* rt = gemmC2 + N * 3 * H;
-  DType* zt = rt + N * H;
-  DType* nt = zt + N * H;
-  DType* back_wx_ptr = wx_ptr + I * 3 * H + H * 3 * H;
-  DType* back_wh_ptr = wh_ptr + I * 3 * H + H * 3 * H;
-  DType* back_bx_ptr = (bx_ptr != NULL)? bx_ptr + 3 * H * 2 : NULL;
-  DType* back_bh_ptr = (bh_ptr != NULL)? bh_ptr + 3 * H * 2: NULL;
-  DType* back_gemmC1 = gemmC1 + T * N * 3 * H;
-  DType* gemmC1_t = gemmC1;
-
-  const Tensor<cpu, 2, DType> wx(wx_ptr, Shape2(H * 3, I));
-  const Tensor<cpu, 2, DType> wh(wh_ptr, Shape2(H * 3, H));
-  const Tensor<cpu, 2, DType> bx(bx_ptr, Shape2(3, H));
-  const Tensor<cpu, 2, DType> bh(bh_ptr, Shape2(3, H));
-  const Tensor<cpu, 2, DType> back_wx(back_wx_ptr, Shape2(H * 3, I));
-  const Tensor<cpu, 2, DType> back_wh(back_wh_ptr, Shape2(H * 3, H));
-  const Tensor<cpu, 2, DType> back_bx(back_bx_ptr, Shape2(3, H));
-  const Tensor<cpu, 2, DType> back_bh(back_bh_ptr, Shape2(3, H));
-  const int omp_threads = mxnet::engine::OpenMP::Get()->GetRecommendedOMPThreadCount();
-  if (D == 1) {
-    #pragma omp parallel for num_threads(omp_threads)
-    for (int i = 0; i < N; i++)
-      for (int j = 0; j < H; j++) {
-        y_ptr[i * H + j] = hx[i][j];
-      }
-  } else {
-    #pragma omp parallel for num_threads(omp_threads)
-    for (int i = 0; i < N; i++)
-      for (int j = 0; j < H; j++) {
-        y_ptr[i * D * H + j] = hx[i][j];
-        back_ht_1[i * D * H + j] = hx[N + i][j];
-    }
-  }
-  Tensor<cpu, 2, DType> dgemmC1(ws, Shape2(T * N, 3 * H));
-  Tensor<cpu, 2, DType> dgemmC2(gemmC2, Shape2(N, 3 * H));
-  Tensor<cpu, 2, DType> dback_gemmC1(back_gemmC1, Shape2(T * N, 3 * H));
-
-  // x * wx.T : [T * N, I] * [I, 3 * H]
-  DType alpha = 1.0;
-  DType beta = 0.0;
-  linalg_gemm(x, wx, dgemmC1, alpha, beta, false, true);
-  if (D == 2) {
-    linalg_gemm(x, back_wx, dback_gemmC1, alpha, beta, false, true);
-  }
-
-  for (int t = 0; t < T; t++) {
-    //  perform the first direction, X * wx and H * wh for each step
-    //  ht-1 * wh, ht-1:[N, H] wh:[3 * H, H]
-    Tensor<cpu, 2, DType> dht_1(ht_1, Shape2(N, D * H));
-    if (D == 1) {
-      linalg_gemm(dht_1, wh, dgemmC2, alpha, beta, false, true);
-    } else {
-      Tensor<cpu, 3, DType> dht_1_tmp = Tensor<cpu, 3, DType>(reinterpret_cast<DType*>(tmp_buf),
-                                     Shape3(D, H, N));
-      dht_1_tmp = reshape(dht_1.T(), Shape3(D, H, N));
-      linalg_gemm(dht_1_tmp[0], wh, dgemmC2, alpha, beta, true, true);
-    }
-    gemmC1_t = gemmC1 + t * N * 3 * H;
-    #pragma omp parallel for num_threads(omp_threads)
-    for (int i = 0; i < N; ++i) {
-      for (int j = 0; j < H; ++j) {
-        int rtb = i * 3 * H;
-        int ztb = i * 3 * H + H;
-        int ntb = i * 3 * H + 2 * H;
-        rt[i * H + j] = sigmoid(gemmC1_t[rtb + j] + gemmC2[rtb + j]
-            + bx[0][j] + bh[0][j]);
-        zt[i * H + j] = sigmoid(gemmC1_t[ztb + j] + gemmC2[ztb + j]
-            + bx[1][j] + bh[1][j]);
-        nt[i * H + j] = tanh(gemmC1_t[ntb + j] + bx[2][j] +
-            rt[i * H + j] * (gemmC2[ntb + j] + bh[2][j]));
-        ht[i * D * H + j] = (1-zt[i * H + j]) * nt[i * H + j] +
-            zt[i * H + j] * ht_1[i * D * H + j];
-      }
-    }
-    ht_1 = ht;
-    ht = ht + D * H * N;
-    //  perform the second direction
-    if (D == 2) {
-      gemmC1_t = back_gemmC1 + (T - 1 - t) * N * 3 * H;
-      Tensor<cpu, 2, DType> dback_ht_1(back_ht_1 - H, Shape2(N, D * H));
-      Tensor<cpu, 3, DType> dback_ht_1_tmp = Tensor<cpu, 3, DType>
-          (reinterpret_cast<DType*>(tmp_buf), Shape3(D, H, N));
-      dback_ht_1_tmp = reshape(dback_ht_1.T(), Shape3(D, H, N));
-      linalg_gemm(dback_ht_1_tmp[1], back_wh, dgemmC2, alpha, beta, true, true);
-
-      #pragma omp parallel for num_threads(omp_threads)
-      for (int i = 0; i < N; ++i) {
-        for (int j = 0; j < H; ++j) {
-          int rtb = i * 3 * H;
-          int ztb = i * 3 * H + H;
-          int ntb = i * 3 * H + 2 * H;
-          rt[i * H + j] = sigmoid(gemmC1_t[rtb + j] +
-              gemmC2[rtb + j] + back_bx[0][j] + back_bh[0][j]);
-          zt[i * H + j] = sigmoid(gemmC1_t[ztb + j] +
-              gemmC2[ztb + j] + back_bx[1][j]+ back_bh[1][j]);
-          nt[i * H + j] = tanh(gemmC1_t[ntb + j] + back_bx[2][j]
-              + rt[i * H + j] * (gemmC2[ntb + j] + back_bh[2][j]));
-          back_ht[i * D * H + j] = (1 - zt[i * H + j]) * nt[i * H + j]
-              + zt[i * H + j] * back_ht_1[i * D * H + j];
+  const Tensor<cpu, 3, DType> y(y_ptr, Shape3(T, N, D * H));
+  for (int d = 0; d < D; ++d) {
+    // the weights, biases and states of the second direction follow those of the first one
+    const bool bid = d == 1;
+    const int offset = bid ? H : 0;
+    const Tensor<cpu, 2, DType> wx(wx_ptr + d * (I + H) * 3 * H, Shape2(H * 3, I));
+    const Tensor<cpu, 2, DType> wh(wh_ptr + d * (I + H) * 3 * H, Shape2(H * 3, H));
+    const Tensor<cpu, 2, DType> bx(bx_ptr + d * 3 * H * 2, Shape2(3, H));
+    const Tensor<cpu, 2, DType> bh(bh_ptr + d * 3 * H * 2, Shape2(3, H));
+    const Tensor<cpu, 2, DType> hx_d(hx.dptr_ + d * N * H, Shape2(N, H));
+    DType* hy_d = hy_ptr + d * N * H;
+    const Tensor<cpu, 2, DType> yx_flat(gemmC1 + d * T * N * 3 * H, Shape2(T * N, 3 * H));
+    const Tensor<cpu, 4, DType> yx(yx_flat.dptr_, Shape4(T, N, 3, H));
+    // x * wx.T : [T * N, I] * [I, 3 * H]
+    linalg_gemm(x, wx, yx_flat, DType(1), DType(0), false, true);
+
+    // the hidden state of step i - 1 is read back from y
+    auto h_prev = [&](const int i) {
+      const int t = bid ? T - i : i - 1;
+      return i ? Tensor<cpu, 2, DType>(y.dptr_ + t * y.size(1) * y.stride_ + offset,
+                                       Shape2(N, H), y.stride_, nullptr) : hx_d;
+    };
+    // the reset gate only scales the hidden projection of the new gate
+    auto cell = [&](const int i, const int j, const int k0, const int k1, const DType* yh) {
+      const int t = bid ? T - 1 - i : i;
+      const int units = k1 - k0;
+      const DType* ht_1 = i ? y[bid ? t + 1 : t - 1][j].dptr_ + offset : hx_d[j].dptr_;
+      for (int k = k0; k < k1; ++k) {
+        const DType* yh_k = yh + k - k0;
+        DType rt = sigmoid<DType>(yx[t][j][0][k] + yh_k[0] + bx[0][k] + bh[0][k]);
+        DType zt = sigmoid<DType>(yx[t][j][1][k] + yh_k[units] + bx[1][k] + bh[1][k]);
+        DType nt = tanh(yx[t][j][2][k] + bx[2][k] + rt * (yh_k[units * 2] + bh[2][k]));
+        DType ht = (1 - zt) * nt + zt * ht_1[k];
+        y[t][j][k + offset] = ht;
+        if (i == T - 1 && state_outputs) {
+          hy_d[j * H + k] = ht;
         }
       }
-      back_ht_1 = back_ht;
-      back_ht = back_ht - D * H * N;
-    }
-  }
-  //  copy last state to hy, from(N, H * D) to (D, N, H)
-  if (state_outputs) {
-    if (D == 1) {
-      DType* y_start = y_ptr + (T - 1) * N * H;
-      #pragma omp parallel for num_threads(omp_threads)
-      for (int i = 0; i < N; i++)
-        for (int j = 0; j < H; j++) {
-          hy_ptr[i * H + j] = y_start[i * H + j];
-        }
-    } else {
-      DType* y_start = y_ptr + (T - 1) * N * H * D;
-      DType* y_back_start = y_ptr + H;
-      #pragma omp parallel for num_threads(omp_threads)
-      for (int i = 0; i < N; i++)
-        for (int j = 0; j < H; j++) {
-          hy_ptr[i * H + j] = y_start[i * D * H + j];
-          hy_ptr[N * H + i * H + j] = y_back_start[i * D * H + j];
-        }
-    }
+    };
+    RecurrentStepsCPU<DType>(T, N, H, 3, wh, wh_pack, gemmC2, h_prev, cell);
   }
 }
 
@@ -756,8 +758,8 @@ void GruForwardInference(DType* ws,
 
   DType* y_tmp = ws;
   DType* y_l = x_ptr;
-  DType* tmp_buf = y_tmp + D * T * N * H;
   DType* ws2 = y_tmp + D * T * N * H + D * H * N;
+  DType* wh_pack = ws + D * T * N * H * 4 + N * H * 8;
 
   DType* wx_l = wx;
   DType* wh_l = wh;
@@ -773,7 +775,7 @@ void GruForwardInference(DType* ws,
       y_l = y_tmp;
     }
     Tensor<cpu, 2, DType> hx_l = hx[D * l];
-    GruForwardInferenceSingleLayer<DType>(ws2, tmp_buf, state_outputs, D, T, N, I, H,
+    GruForwardInferenceSingleLayer<DType>(ws2, wh_pack, state_outputs, D, T, N, I, H,
                                         x_l, hx_l, wx_l, wh_l, bx_l, bh_l, y_l, hy_l);
     hy_l = hy_l + D * N * H;
     bx_l = bx_l + 3 * H * D * 2;
@@ -789,7 +791,7 @@ void GruForwardInference(DType* ws,
 
 template<typename DType>
 void GruForwardTrainingSingleLayer(DType* ws,
-                                   DType* tmp_buf,
+                                   DType* wh_pack,
                                    bool state_outputs,
                                    const int D,
                                    const int T,
@@ -808,153 +810,56 @@ void GruForwardTrainingSingleLayer(DType* ws,
                                    DType* Mnh,
                                    DType* y_ptr,
                                    DType* hy_ptr) {
-  DType* ht = y_ptr;
-  DType* ht_1 = y_ptr;
-  DType* back_ht_1 = y_ptr + (T - 1)* N * H * D + H;
-  DType* back_ht = back_ht_1;
-
+  using namespace mshadow;
   DType* gemmC1  = ws;              // [D, T, N, 3 * H]
   DType* gemmC2  = gemmC1 + D * T * N * 3 * H;  // N * 3 * H
-  DType* rt = gateR;
-  DType* zt = gateZ;
-  DType* nt = gateN;
-  DType* back_wx_ptr = wx_ptr + I * 3 * H + H * 3 * H;
-  DType* back_wh_ptr = wh_ptr + I * 3 * H + H * 3 * H;
-  DType* back_bx_ptr = (bx_ptr != NULL)? bx_ptr + 3 * H * 2 : NULL;
-  DType* back_bh_ptr = (bh_ptr != NULL)? bh_ptr + 3 * H * 2 : NULL;
-  DType* back_gateR = gateR + T * N * H;
-  DType* back_gateZ = gateZ + T * N * H;
-  DType* back_gateN = gateN + T * N * H;
-  DType* back_Mnh = Mnh + T * N * H;
-  DType* back_gemmC1 = gemmC1 + T * N * 3 * H;
-  DType* gemmC1_t = gemmC1;
-
-  const Tensor<cpu, 2, DType> wx(wx_ptr, Shape2(H * 3, I));
-  const Tensor<cpu, 2, DType> wh(wh_ptr, Shape2(H * 3, H));
-  const Tensor<cpu, 2, DType> bx(bx_ptr, Shape2(3, H));
-  const Tensor<cpu, 2, DType> bh(bh_ptr, Shape2(3, H));
-  const Tensor<cpu, 2, DType> back_wx(back_wx_ptr, Shape2(H * 3, I));
-  const Tensor<cpu, 2, DType> back_wh(back_wh_ptr, Shape2(H * 3, H));
-  const Tensor<cpu, 2, DType> back_bx(back_bx_ptr, Shape2(3, H));
-  const Tensor<cpu, 2, DType> back_bh(back_bh_ptr, Shape2(3, H));
-  const int omp_threads = mxnet::engine::OpenMP::Get()->GetRecommendedOMPThreadCount();
-  if (D == 1) {
-    #pragma omp parallel for num_threads(omp_threads)
-    for (int i = 0; i < N; i++)
-      for (int j = 0; j < H; j++) {
-        y_ptr[i * H + j] = hx[i][j];
-      }
-  } else {
-    #pragma omp parallel for num_threads(omp_threads)
-    for (int i = 0; i < N; i++)
-      for (int j = 0; j < H; j++) {
-        y_ptr[i * D * H + j] = hx[i][j];
-        back_ht_1[i * D * H + j] = hx[N + i][j];
-    }
-  }
-
-  Tensor<cpu, 2, DType> dgemmC1(ws, Shape2(T * N, 3 * H));
-  Tensor<cpu, 2, DType> dgemmC2(gemmC2, Shape2(N, 3 * H));
-  Tensor<cpu, 2, DType> dback_gemmC1(back_gemmC1, Shape2(T * N, 3 * H));
-
-  // x * wx.T : [T * N, I] * [I, 3 * H]
-  DType alpha = 1.0;
-  DType beta = 0.0;
-  linalg_gemm(x, wx, dgemmC1, alpha, beta, false, true);
-  if (D == 2) {
-    linalg_gemm(x, back_wx, dback_gemmC1, alpha, beta, false, true);
-  }
-
-  for (int t = 0; t < T; t++) {
-    //  perform the first direction, X * wx and H * wh for each step
-    //  ht-1 * wh, ht-1:[N, H] wh:[3 * H, H]
-    Tensor<cpu, 2, DType> dht_1(ht_1, Shape2(N, D * H));
-    if (D == 1) {
-      linalg_gemm(dht_1, wh, dgemmC2, alpha, beta, false, true);
-    } else {
-      Tensor<cpu, 3, DType> dht_1_tmp = Tensor<cpu, 3, DType>(reinterpret_cast<DType*>(tmp_buf),
-                                     Shape3(D, H, N));
-      dht_1_tmp = reshape(dht_1.T(), Shape3(D, H, N));
-      linalg_gemm(dht_1_tmp[0], wh, dgemmC2, alpha, beta, true, true);
-    }
-    rt = gateR + t * N * H;
-    zt = gateZ + t * N * H;
-    nt = gateN + t * N * H;
-    gemmC1_t = gemmC1 + t * N * 3 * H;
-    DType* Mnht = Mnh + t * N * H;
-    #pragma omp parallel for num_threads(omp_threads)
-    for (int i = 0; i < N; ++i) {
-      for (int j = 0; j < H; ++j) {
-        int rtb = i * 3 * H;
-        int ztb = i * 3 * H + H;
-        int ntb = i * 3 * H + 2 * H;
-        Mnht[i * H + j] = gemmC2[ntb + j] + bh[2][j];
-        rt[i * H + j] = sigmoid(gemmC1_t[rtb + j] + gemmC2[rtb + j]
-            + bx[0][j] + bh[0][j]);
-        zt[i * H + j] = sigmoid(gemmC1_t[ztb + j] + gemmC2[ztb + j]
-            + bx[1][j] + bh[1][j]);
-        nt[i * H + j] = tanh(gemmC1_t[ntb + j] + bx[2][j] +
-            rt[i * H + j] * (gemmC2[ntb + j] + bh[2][j]));
-        ht[i * D * H + j] = (1-zt[i * H + j]) * nt[i * H + j] +
-            zt[i * H + j] * ht_1[i * D * H + j];
-      }
-    }
-    ht_1 = ht;
-    ht = ht + D * H * N;
-    //  perform the second direction
-    if (D == 2) {
-      rt = back_gateR + (T - 1 - t) * N * H;
-      zt = back_gateZ + (T - 1 - t) * N * H;
-      nt = back_gateN + (T - 1 - t) * N * H;
-      gemmC1_t = back_gemmC1 + (T - 1 - t) * N * 3 * H;
-      Tensor<cpu, 2, DType> dback_ht_1(back_ht_1 - H, Shape2(N, D * H));
-      Tensor<cpu, 3, DType> dback_ht_1_tmp = Tensor<cpu, 3, DType>
-          (reinterpret_cast<DType*>(tmp_buf), Shape3(D, H, N));
-      dback_ht_1_tmp = reshape(dback_ht_1.T(), Shape3(D, H, N));
-      linalg_gemm(dback_ht_1_tmp[1], back_wh, dgemmC2, alpha, beta, true, true);
-
-      DType* back_Mnht = back_Mnh + (T - 1 - t) * N * H;
-      #pragma omp parallel for num_threads(omp_threads)
-      for (int i = 0; i < N; ++i) {
-        for (int j = 0; j < H; ++j) {
-          int rtb = i * 3 * H;
-          int ztb = i * 3 * H + H;
-          int ntb = i * 3 * H + 2 * H;
-          back_Mnht[i * H + j] = gemmC2[ntb + j] + back_bh[2][j];
-          rt[i * H + j] = sigmoid(gemmC1_t[rtb + j] +
-              gemmC2[rtb + j] + back_bx[0][j] + back_bh[0][j]);
-          zt[i * H + j] = sigmoid(gemmC1_t[ztb + j] +
-              gemmC2[ztb + j] + back_bx[1][j] + back_bh[1][j]);
-          nt[i * H + j] = tanh(gemmC1_t[ntb + j] + back_bx[2][j]
-              + rt[i * H + j] * (gemmC2[ntb + j] + back_bh[2][j]));
-          back_ht[i * D * H + j] = (1 - zt[i * H + j]) * nt[i * H + j]
-              + zt[i * H + j] * back_ht_1[i * D * H + j];
+  const Tensor<cpu, 3, DType> y(y_ptr, Shape3(T, N, D * H));
+  for (int d = 0; d < D; ++d) {
+    // the weights, biases, states and gates of the second direction follow those of
+    // the first one
+    const bool bid = d == 1;
+    const int offset = bid ? H : 0;
+    const Tensor<cpu, 2, DType> wx(wx_ptr + d * (I + H) * 3 * H, Shape2(H * 3, I));
+    const Tensor<cpu, 2, DType> wh(wh_ptr + d * (I + H) * 3 * H, Shape2(H * 3, H));
+    const Tensor<cpu, 2, DType> bx(bx_ptr + d * 3 * H * 2, Shape2(3, H));
+    const Tensor<cpu, 2, DType> bh(bh_ptr + d * 3 * H * 2, Shape2(3, H));
+    const Tensor<cpu, 2, DType> hx_d(hx.dptr_ + d * N * H, Shape2(N, H));
+    DType* hy_d = hy_ptr + d * N * H;
+    const Tensor<cpu, 3, DType> rt(gateR + d * T * N * H, Shape3(T, N, H));
+    const Tensor<cpu, 3, DType> zt(gateZ + d * T * N * H, Shape3(T, N, H));
+    const Tensor<cpu, 3, DType> nt(gateN + d * T * N * H, Shape3(T, N, H));
+    const Tensor<cpu, 3, DType> Mnht(Mnh + d * T * N * H, Shape3(T, N, H));
+    const Tensor<cpu, 2, DType> yx_flat(gemmC1 + d * T * N * 3 * H, Shape2(T * N, 3 * H));
+    const Tensor<cpu, 4, DType> yx(yx_flat.dptr_, Shape4(T, N, 3, H));
+    // x * wx.T : [T * N, I] * [I, 3 * H]
+    linalg_gemm(x, wx, yx_flat, DType(1), DType(0), false, true);
+
+    // the hidden state of step i - 1 is read back from y
+    auto h_prev = [&](const int i) {
+      const int t = bid ? T - i : i - 1;
+      return i ? Tensor<cpu, 2, DType>(y.dptr_ + t * y.size(1) * y.stride_ + offset,
+                                       Shape2(N, H), y.stride_, nullptr) : hx_d;
+    };
+    // the reset gate only scales the hidden projection of the new gate
+    auto cell = [&](const int i, const int j, const int k0, const int k1, const DType* yh) {
+      const int t = bid ? T - 1 - i : i;
+      const int units = k1 - k0;
+      const DType* ht_1 = i ? y[bid ? t + 1 : t - 1][j].dptr_ + offset : hx_d[j].dptr_;
+      for (int k = k0; k < k1; ++k) {
+        const DType* yh_k = yh + k - k0;
+        // reserve
+        Mnht[t][j][k] = yh_k[units * 2] + bh[2][k];
+        rt[t][j][k] = sigmoid<DType>(yx[t][j][0][k] + yh_k[0] + bx[0][k] + bh[0][k]);
+        zt[t][j][k] = sigmoid<DType>(yx[t][j][1][k] + yh_k[units] + bx[1][k] + bh[1][k]);
+        nt[t][j][k] = tanh(yx[t][j][2][k] + bx[2][k] + rt[t][j][k] * Mnht[t][j][k]);
+        DType ht = (1 - zt[t][j][k]) * nt[t][j][k] + zt[t][j][k] * ht_1[k];
+        y[t][j][k + offset] = ht;
+        if (i == T - 1 && state_outputs) {
+          hy_d[j * H + k] = ht;
         }
       }
-      back_ht_1 = back_ht;
-      back_ht = back_ht - D * H * N;
-    }
-  }
-
-  //  copy last state to hy, from(N, H * D) to (D, N, H)
-  if (state_outputs) {
-    if (D == 1) {
-      DType* y_start = y_ptr + (T - 1) * N * H;
-      #pragma omp parallel for num_threads(omp_threads)
-      for (int i = 0; i < N; i++)
-        for (int j = 0; j < H; j++) {
-          hy_ptr[i * H + j] = y_start[i * H + j];
-        }
-    } else {
-      DType* y_start = y_ptr + (T - 1) * N * H * D;
-      DType* y_back_start = y_ptr + H;
-      #pragma omp parallel for num_threads(omp_threads)
-      for (int i = 0; i < N; i++)
-        for (int j = 0; j < H; j++) {
-          hy_ptr[i * H + j] = y_start[i * D * H + j];
-          hy_ptr[N * H + i * H + j] = y_back_start[i * D * H + j];
-        }
-    }
+    };
+    RecurrentStepsCPU<DType>(T, N, H, 3, wh, wh_pack, gemmC2, h_prev, cell);
   }
 }
 
@@ -989,6 +894,7 @@ void GruForwardTraining(DType* ws,
   DType* dropout_random = Mnh_l + L * D * T * N * H;
   DType* tmp_buf = dropout_random + (L - 1) * D * T * N * H;
   DType* ws2 = tmp_buf + D * N * H;
+  DType* wh_pack = ws + D * T * N * H * 4 + N * H * 8;
   DType* wx_l = wx;
   DType* wh_l = wh;
   DType* bx_l = bx;
@@ -1016,7 +922,7 @@ void GruForwardTraining(DType* ws,
     }
     Tensor<cpu, 2, DType> x_l(y_tmp, Shape2(T * N, I));
     Tensor<cpu, 2, DType> hx_l = hx[D * l];
-    GruForwardTrainingSingleLayer<DType>(ws2, tmp_buf, state_outputs, D, T, N, I, H,
+    GruForwardTrainingSingleLayer<DType>(ws2, wh_pack, state_outputs, D, T, N, I, H,
                                          x_l, hx_l, wx_l, wh_l, bx_l, bh_l,
                                          gateR_l, gateZ_l, gateN_l, Mnh_l, y_l, hy_l);
     gateR_l = gateR_l + T * D * N * H;
@@ -0,0 +1,195 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file elemwise_fused_op.cc
+ * \brief CPU implementation of _elemwise_fused_op. The arrays are split in
+ *  blocks that fit in the L1 cache; every block is run through all the
+ *  instructions of the fused subgraph before the next one is loaded.
+ */
+#include <algorithm>
+#include "./common.h"
+#include "./elemwise_fused_op.h"
+#include "../mshadow_op.h"
+#include "../mxnet_op.h"
+#include "../../common/utils.h"
+
+namespace mxnet {
+namespace op {
+
+namespace elemwise_fused {
+/*! \brief number of elements of each array processed at a time */
+const int64_t kBlockSize = 512;
+}  // namespace elemwise_fused
+
+template<typename OP, typename DType>
+inline void FusedUnary(DType* out, const DType* in, const int64_t n) {
+  for (int64_t k = 0; k < n; ++k) out[k] = OP::Map(in[k]);
+}
+
+template<typename OP, typename DType>
+inline void FusedBinary(DType* out, const DType* lhs, const DType* rhs, const int64_t n) {
+  for (int64_t k = 0; k < n; ++k) out[k] = OP::Map(lhs[k], rhs[k]);
+}
+
+template<typename OP, typename DType>
+inline void FusedScalar(DType* out, const DType* in, const DType scalar, const int64_t n) {
+  for (int64_t k = 0; k < n; ++k) out[k] = OP::Map(in[k], scalar);
+}
+
+template<typename DType>
+void RunElemwiseFusedBlock(const ElemwiseFusedProgram& prog, DType** regs, const int64_t n) {
+  using namespace elemwise_fused;
+  for (const auto& instr : prog.instrs) {
+    DType* out = regs[instr.out];
+    const DType* lhs = regs[instr.lhs];
+    const DType* rhs = regs[instr.rhs];
+    const DType scalar = static_cast<DType>(instr.scalar);
+    switch (instr.code) {
+      case kCopy: FusedUnary<mshadow_op::identity>(out, lhs, n); break;
+      case kRelu: FusedUnary<mshadow_op::relu>(out, lhs, n); break;
+      case kSigmoid: FusedUnary<mshadow_op::sigmoid>(out, lhs, n); break;
+      case kTanh: FusedUnary<mshadow_op::tanh>(out, lhs, n); break;
+      case kSoftrelu: FusedUnary<mshadow_op::softrelu>(out, lhs, n); break;
+      case kSoftsign: FusedUnary<mshadow_op::softsign>(out, lhs, n); break;
+      case kExp: FusedUnary<mshadow_op::exp>(out, lhs, n); break;
+      case kLog: FusedUnary<mshadow_op::log>(out, lhs, n); break;
+      case kSqrt: FusedUnary<mshadow_op::square_root>(out, lhs, n); break;
+      case kSquare: FusedUnary<mshadow_op::square>(out, lhs, n); break;
+      case kNegative: FusedUnary<mshadow_op::negation>(out, lhs, n); break;
+      case kAbs: FusedUnary<mshadow_op::abs>(out, lhs, n); break;
+      case kAdd: FusedBinary<mshadow_op::plus>(out, lhs, rhs, n); break;
+      case kSub: FusedBinary<mshadow_op::minus>(out, lhs, rhs, n); break;
+      case kMul: FusedBinary<mshadow_op::mul>(out, lhs, rhs, n); break;
+      case kDiv: FusedBinary<mshadow_op::div>(out, lhs, rhs, n); break;
+      case kMaximum: FusedBinary<mshadow_op::maximum>(out, lhs, rhs, n); break;
+      case kMinimum: FusedBinary<mshadow_op::minimum>(out, lhs, rhs, n); break;
+      case kAddScalar: FusedScalar<mshadow_op::plus>(out, lhs, scalar, n); break;
+      case kSubScalar: FusedScalar<mshadow_op::minus>(out, lhs, scalar, n); break;
+      case kRSubScalar: FusedScalar<mshadow_op::rminus>(out, lhs, scalar, n); break;
+      case kMulScalar: FusedScalar<mshadow_op::mul>(out, lhs, scalar, n); break;
+      case kDivScalar: FusedScalar<mshadow_op::div>(out, lhs, scalar, n); break;
+      case kRDivScalar: FusedScalar<mshadow_op::rdiv>(out, lhs, scalar, n); break;
+      case kMaximumScalar: FusedScalar<mshadow_op::maximum>(out, lhs, scalar, n); break;
+      case kMinimumScalar: FusedScalar<mshadow_op::minimum>(out, lhs, scalar, n); break;
+      default: LOG(FATAL) << "Unknown fused op code " << instr.code;
+    }
+  }
+}
+
+void ElemwiseFusedParamParser(nnvm::NodeAttrs* attrs) {
+  if (attrs->subgraphs.size()) attrs->parsed = CompileElemwiseFused(*attrs->subgraphs[0]);
+}
+
+bool ElemwiseFusedType(const nnvm::NodeAttrs& attrs,
+                       std::vector<int> *in_types,
+                       std::vector<int> *out_types) {
+  if (!DefaultSubgraphOpType(attrs, in_types, out_types)) return false;
+  for (const int dtype : *out_types) {
+    CHECK(dtype == mshadow::kFloat32 || dtype == mshadow::kFloat64)
+        << "_elemwise_fused_op only supports float32 and float64, but got "
+        << type_string(dtype);
+  }
+  return true;
+}
+
+bool ElemwiseFusedStorageType(const nnvm::NodeAttrs& attrs,
+                              const int dev_mask,
+                              DispatchMode* dispatch_mode,
+                              std::vector<int>* in_attrs,
+                              std::vector<int>* out_attrs) {
+  bool dispatched = false;
+  if (common::ContainsOnlyStorage(*in_attrs, kDefaultStorage)) {
+    dispatched = storage_type_assign(out_attrs, kDefaultStorage,
+                                     dispatch_mode, DispatchMode::kFCompute);
+  }
+  if (!dispatched) {
+    dispatched = dispatch_fallback(out_attrs, dispatch_mode);
+  }
+  return dispatched;
+}
+
+template<typename DType>
+static void ElemwiseFusedBlocksCPU(const ElemwiseFusedProgram& prog,
+                                   const std::vector<TBlob>& inputs,
+                                   const std::vector<OpReqType>& req,
+                                   const std::vector<TBlob>& outputs) {
+  using namespace elemwise_fused;
+  const int64_t size = outputs[0].Size();
+  const int64_t num_blocks = (size + kBlockSize - 1) / kBlockSize;
+  const int omp_threads = engine::OpenMP::Get()->GetRecommendedOMPThreadCount();
+  #pragma omp parallel num_threads(omp_threads)
+  {
+    std::vector<DType> buffer((prog.num_regs - prog.num_inputs) * kBlockSize);
+    std::vector<DType*> regs(prog.num_regs);
+    for (uint32_t r = prog.num_inputs; r < prog.num_regs; ++r) {
+      regs[r] = buffer.data() + (r - prog.num_inputs) * kBlockSize;
+    }
+    #pragma omp for
+    for (int64_t b = 0; b < num_blocks; ++b) {
+      const int64_t start = b * kBlockSize;
+      const int64_t n = std::min(kBlockSize, size - start);
+      for (uint32_t i = 0; i < prog.num_inputs; ++i) {
+        regs[i] = inputs[i].dptr<DType>() + start;
+      }
+      RunElemwiseFusedBlock(prog, regs.data(), n);
+      // An output written in place over an input only overlaps the block of
+      // that input that has just been consumed.
+      for (size_t i = 0; i < outputs.size(); ++i) {
+        DType* out = outputs[i].dptr<DType>() + start;
+        const DType* res = regs[prog.outputs[i]];
+        if (req[i] == kAddTo) {
+          for (int64_t k = 0; k < n; ++k) out[k] += res[k];
+        } else if (req[i] != kNullOp) {
+          for (int64_t k = 0; k < n; ++k) out[k] = res[k];
+        }
+      }
+    }
+  }
+}
+
+void ElemwiseFusedComputeCPU(const nnvm::NodeAttrs& attrs,
+                             const OpContext& ctx,
+                             const std::vector<TBlob>& inputs,
+                             const std::vector<OpReqType>& req,
+                             const std::vector<TBlob>& outputs) {
+  const ElemwiseFusedProgram& prog = nnvm::get<ElemwiseFusedProgram>(attrs.parsed);
+  CHECK_EQ(inputs.size(), prog.num_inputs);
+  CHECK_EQ(outputs.size(), prog.outputs.size());
+  MSHADOW_REAL_TYPE_SWITCH(outputs[0].type_flag_, DType, {
+    ElemwiseFusedBlocksCPU<DType>(prog, inputs, req, outputs);
+  });
+}
+
+NNVM_REGISTER_OP(_elemwise_fused_op)
+.describe(R"code(Evaluates a subgraph of elementwise operators in a single pass.
+Created by the ELEMWISE subgraph backend.)code" ADD_FILELINE)
+.set_num_inputs(DefaultSubgraphOpNumInputs)
+.set_num_outputs(DefaultSubgraphOpNumOutputs)
+.set_attr_parser(ElemwiseFusedParamParser)
+.set_attr<nnvm::FListInputNames>("FListInputNames", DefaultSubgraphOpListInputs)
+.set_attr<nnvm::FListOutputNames>("FListOutputNames", DefaultSubgraphOpListOutputs)
+.set_attr<nnvm::FInferShape>("FInferShape", DefaultSubgraphOpShape)
+.set_attr<nnvm::FInferType>("FInferType", ElemwiseFusedType)
+.set_attr<FInferStorageType>("FInferStorageType", ElemwiseFusedStorageType)
+.set_attr<FCompute>("FCompute<cpu>", ElemwiseFusedComputeCPU)
+.add_argument("data", "NDArray-or-Symbol[]", "input data list");
+
+}  // namespace op
+}  // namespace mxnet
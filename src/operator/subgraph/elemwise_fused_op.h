@@ -0,0 +1,172 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file elemwise_fused_op.h
+ * \brief Operator that evaluates a subgraph of elementwise operators
+ *  in a single pass over its arrays.
+ */
+#ifndef MXNET_OPERATOR_SUBGRAPH_ELEMWISE_FUSED_OP_H_
+#define MXNET_OPERATOR_SUBGRAPH_ELEMWISE_FUSED_OP_H_
+
+#include <nnvm/graph.h>
+#include <nnvm/symbolic.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../nn/activation-inl.h"
+
+namespace mxnet {
+namespace op {
+
+namespace elemwise_fused {
+enum FusedOpCode {
+  kCopy, kRelu, kSigmoid, kTanh, kSoftrelu, kSoftsign, kExp, kLog, kSqrt, kSquare,
+  kNegative, kAbs,
+  kAdd, kSub, kMul, kDiv, kMaximum, kMinimum,
+  kAddScalar, kSubScalar, kRSubScalar, kMulScalar, kDivScalar, kRDivScalar,
+  kMaximumScalar, kMinimumScalar
+};
+}  // namespace elemwise_fused
+
+/*! \brief one operator of a fused subgraph, applied to a block of elements. */
+struct ElemwiseFusedInstr {
+  int code;
+  uint32_t lhs;
+  uint32_t rhs;
+  double scalar;
+  uint32_t out;
+};
+
+/*!
+ * \brief A fused subgraph compiled to instructions over registers.
+ *  Registers [0, num_inputs) refer to the inputs of the subgraph. The other
+ *  registers hold intermediate blocks and are reused once their value is dead.
+ */
+struct ElemwiseFusedProgram {
+  uint32_t num_inputs = 0;
+  uint32_t num_regs = 0;
+  std::vector<ElemwiseFusedInstr> instrs;
+  /*! \brief register holding each output of the subgraph */
+  std::vector<uint32_t> outputs;
+};
+
+/*!
+ * \brief The fused op code of a node, or -1 if the node can not be fused.
+ *  Broadcast operators are returned as their elementwise counterparts; callers
+ *  must make sure their operands have the same shape.
+ */
+inline int GetElemwiseFusedOpCode(const nnvm::NodeAttrs& attrs) {
+  using namespace elemwise_fused;
+  static const std::unordered_map<std::string, int> codes = {
+    {"_copy", kCopy}, {"relu", kRelu}, {"sigmoid", kSigmoid}, {"tanh", kTanh},
+    {"softsign", kSoftsign}, {"exp", kExp}, {"log", kLog}, {"sqrt", kSqrt},
+    {"square", kSquare}, {"negative", kNegative}, {"abs", kAbs},
+    {"elemwise_add", kAdd}, {"elemwise_sub", kSub}, {"elemwise_mul", kMul},
+    {"elemwise_div", kDiv}, {"_grad_add", kAdd}, {"_maximum", kMaximum},
+    {"_minimum", kMinimum}, {"broadcast_add", kAdd}, {"broadcast_sub", kSub},
+    {"broadcast_mul", kMul}, {"broadcast_div", kDiv},
+    {"broadcast_maximum", kMaximum}, {"broadcast_minimum", kMinimum},
+    {"_plus_scalar", kAddScalar}, {"_minus_scalar", kSubScalar},
+    {"_rminus_scalar", kRSubScalar}, {"_mul_scalar", kMulScalar},
+    {"_div_scalar", kDivScalar}, {"_rdiv_scalar", kRDivScalar},
+    {"_maximum_scalar", kMaximumScalar}, {"_minimum_scalar", kMinimumScalar}
+  };
+  if (attrs.op == nullptr) return -1;
+  if (attrs.op->name == "Activation") {
+    switch (nnvm::get<ActivationParam>(attrs.parsed).act_type) {
+      case activation::kReLU: return kRelu;
+      case activation::kSigmoid: return kSigmoid;
+      case activation::kTanh: return kTanh;
+      case activation::kSoftReLU: return kSoftrelu;
+      case activation::kSoftSign: return kSoftsign;
+      default: return -1;
+    }
+  }
+  auto it = codes.find(attrs.op->name);
+  return it == codes.end() ? -1 : it->second;
+}
+
+/*! \brief whether a fused op code takes a scalar parameter. */
+inline bool IsElemwiseFusedScalarOp(int code) {
+  return code >= elemwise_fused::kAddScalar;
+}
+
+/*! \brief whether a fused op code takes two arrays. */
+inline bool IsElemwiseFusedBinaryOp(int code) {
+  return code >= elemwise_fused::kAdd && code < elemwise_fused::kAddScalar;
+}
+
+/*! \brief compile the subgraph of a fused node into instructions. */
+inline ElemwiseFusedProgram CompileElemwiseFused(const nnvm::Symbol& sym) {
+  nnvm::Graph g;
+  g.outputs = sym.outputs;
+  const auto& idx = g.indexed_graph();
+  ElemwiseFusedProgram prog;
+  prog.num_inputs = idx.input_nodes().size();
+  prog.num_regs = prog.num_inputs;
+
+  std::vector<uint32_t> ref_count(idx.num_node_entries(), 0);
+  for (uint32_t nid = 0; nid < idx.num_nodes(); ++nid) {
+    for (const auto& e : idx[nid].inputs) ++ref_count[idx.entry_id(e)];
+  }
+  for (const auto& e : idx.outputs()) ++ref_count[idx.entry_id(e)];
+
+  std::vector<uint32_t> reg(idx.num_node_entries(), 0);
+  for (uint32_t i = 0; i < prog.num_inputs; ++i) {
+    reg[idx.entry_id(idx.input_nodes()[i], 0)] = i;
+  }
+  std::vector<uint32_t> free_regs;
+  for (uint32_t nid = 0; nid < idx.num_nodes(); ++nid) {
+    const auto& inode = idx[nid];
+    if (inode.source->is_variable()) continue;
+    ElemwiseFusedInstr instr;
+    instr.code = GetElemwiseFusedOpCode(inode.source->attrs);
+    CHECK_GE(instr.code, 0) << "Operator " << inode.source->op()->name
+                            << " can not be fused";
+    instr.scalar = IsElemwiseFusedScalarOp(instr.code) ?
+        std::stod(inode.source->attrs.dict.at("scalar")) : 0;
+    instr.lhs = reg[idx.entry_id(inode.inputs[0])];
+    instr.rhs = IsElemwiseFusedBinaryOp(instr.code) ?
+        reg[idx.entry_id(inode.inputs[1])] : instr.lhs;
+    // Operands that are dead after this instruction free their registers,
+    // so elementwise operators can write their result in place.
+    for (const auto& e : inode.inputs) {
+      uint32_t eid = idx.entry_id(e);
+      if (--ref_count[eid] == 0 && reg[eid] >= prog.num_inputs) {
+        free_regs.push_back(reg[eid]);
+      }
+    }
+    if (free_regs.empty()) {
+      instr.out = prog.num_regs++;
+    } else {
+      instr.out = free_regs.back();
+      free_regs.pop_back();
+    }
+    reg[idx.entry_id(nid, 0)] = instr.out;
+    prog.instrs.push_back(instr);
+  }
+  for (const auto& e : idx.outputs()) prog.outputs.push_back(reg[idx.entry_id(e)]);
+  return prog;
+}
+
+}  // namespace op
+}  // namespace mxnet
+
+#endif  // MXNET_OPERATOR_SUBGRAPH_ELEMWISE_FUSED_OP_H_
@@ -0,0 +1,122 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <vector>
+#include <string>
+#include "./common.h"
+#include "./subgraph_property.h"
+#include "./elemwise_fused_op.h"
+
+namespace mxnet {
+namespace op {
+
+/*
+ * This selects connected elementwise, scalar and activation operators whose
+ * inputs and outputs all have the same shape and floating point type.
+ * Nothing is selected when the graph given to the property carries no
+ * inferred shapes and types, since they can't be checked.
+ */
+class ElemwiseFusionSelector: public SubgraphSelector {
+ public:
+  explicit ElemwiseFusionSelector(const nnvm::Graph* g) : graph_(g) {}
+
+  virtual bool Select(const nnvm::Node &seed_node) {
+    return CanFuse(seed_node);
+  }
+
+  virtual bool SelectInput(const nnvm::Node &cur_node, const nnvm::Node &input_node) {
+    return CanFuse(input_node) && SameOutputAttrs(cur_node, input_node);
+  }
+
+  virtual bool SelectOutput(const nnvm::Node &cur_node, const nnvm::Node &output_node) {
+    return CanFuse(output_node) && SameOutputAttrs(cur_node, output_node);
+  }
+
+  // A single operator gains nothing from fusion.
+  virtual std::vector<nnvm::Node*> Filter(const std::vector<nnvm::Node*>& candidates) {
+    return candidates.size() > 1 ? candidates : std::vector<nnvm::Node*>();
+  }
+
+ private:
+  bool CanFuse(const nnvm::Node &n) const {
+    if (n.is_variable() || GetElemwiseFusedOpCode(n.attrs) < 0) return false;
+    if (graph_ == nullptr) return false;
+    const auto& idx = graph_->indexed_graph();
+    const auto& shapes = graph_->GetAttr<nnvm::ShapeVector>("shape");
+    const auto& dtypes = graph_->GetAttr<nnvm::DTypeVector>("dtype");
+    const uint32_t out_eid = idx.entry_id(idx.node_id(&n), 0);
+    if (shapes[out_eid].ndim() == 0 ||
+        (dtypes[out_eid] != mshadow::kFloat32 && dtypes[out_eid] != mshadow::kFloat64)) {
+      return false;
+    }
+    if (graph_->HasAttr("storage_type") &&
+        graph_->GetAttr<StorageTypeVector>("storage_type")[out_eid] != kDefaultStorage) {
+      return false;
+    }
+    for (const auto& e : n.inputs) {
+      const uint32_t eid = idx.entry_id(e);
+      if (shapes[eid] != shapes[out_eid] || dtypes[eid] != dtypes[out_eid]) return false;
+    }
+    return true;
+  }
+
+  bool SameOutputAttrs(const nnvm::Node &a, const nnvm::Node &b) const {
+    const auto& idx = graph_->indexed_graph();
+    const auto& shapes = graph_->GetAttr<nnvm::ShapeVector>("shape");
+    const auto& dtypes = graph_->GetAttr<nnvm::DTypeVector>("dtype");
+    const uint32_t ea = idx.entry_id(idx.node_id(&a), 0);
+    const uint32_t eb = idx.entry_id(idx.node_id(&b), 0);
+    return shapes[ea] == shapes[eb] && dtypes[ea] == dtypes[eb];
+  }
+
+  const nnvm::Graph* graph_;
+};
+
+/*
+ * This subgraph property replaces each chain of elementwise operators with
+ * an _elemwise_fused_op, which evaluates the whole chain in one pass over
+ * memory instead of one kernel launch per operator.
+ */
+class ElemwiseFusionProperty: public SubgraphProperty {
+ public:
+  static SubgraphPropertyPtr Create() { return std::make_shared<ElemwiseFusionProperty>(); }
+  virtual nnvm::NodePtr CreateSubgraphNode(const nnvm::Symbol &sym,
+                                           const int subgraph_id = 0) const {
+    static const auto fused_op = Op::Get("_elemwise_fused_op");
+    nnvm::NodePtr n = nnvm::Node::Create();
+    n->attrs.op = fused_op;
+    n->attrs.name = "_elemwise_fused_op" + std::to_string(subgraph_id);
+    n->attrs.subgraphs.push_back(std::make_shared<nnvm::Symbol>(sym));
+    fused_op->attr_parser(&(n->attrs));
+    return n;
+  }
+  virtual SubgraphSelectorPtr CreateSubgraphSelector() const {
+    const nnvm::Graph* g = nullptr;
+    if (this->HasAttr("graph")) {
+      g = &this->GetAttr<nnvm::Graph>("graph");
+      if (!g->HasAttr("shape") || !g->HasAttr("dtype")) g = nullptr;
+    }
+    return std::make_shared<ElemwiseFusionSelector>(g);
+  }
+};
+
+MXNET_REGISTER_SUBGRAPH_PROPERTY(ELEMWISE, ElemwiseFusionProperty);
+
+}  // namespace op
+}  // namespace mxnet
@@ -0,0 +1,263 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file mkldnn_conv.cc
+ * \brief _sg_mkldnn_conv runs a convolution together with the batch norm,
+ *  relu and elementwise sum that follow it in a single MKLDNN primitive.
+ *  Batch norm is folded into the weights and the bias, the other operators
+ *  are applied as post-ops.
+ */
+
+#if MXNET_USE_MKLDNN == 1
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../common.h"
+#include "../../nn/batch_norm-inl.h"
+#include "../../nn/mkldnn/mkldnn_base-inl.h"
+#include "../../nn/mkldnn/mkldnn_ops-inl.h"
+#include "../../nn/mkldnn/mkldnn_convolution-inl.h"
+
+namespace mxnet {
+namespace op {
+
+static void SgMKLDNNConvParamParser(nnvm::NodeAttrs *attrs) {
+  MKLDNNConvParam param;
+  param.Init(attrs->dict, dmlc::parameter::kAllowUnknown);
+  attrs->parsed = std::move(param);
+}
+
+class SgMKLDNNConvOperator {
+ public:
+  explicit SgMKLDNNConvOperator(const nnvm::NodeAttrs &attrs);
+
+  void Forward(const OpContext &ctx,
+               const std::vector<NDArray> &inputs,
+               const std::vector<OpReqType> &req,
+               const std::vector<NDArray> &outputs);
+
+ private:
+  /*! \brief compute the weight and the bias with the batch norm folded in */
+  void FoldBatchNorm(const std::vector<NDArray> &inputs);
+
+  MKLDNNConvFullParam full_param_;
+  BatchNormParam bn_param_;
+  // positions of the inputs of the fused operators among the node inputs
+  int idx_data_ = -1;
+  int idx_weight_ = -1;
+  int idx_bias_ = -1;
+  int idx_gamma_ = -1;
+  int idx_beta_ = -1;
+  int idx_mean_ = -1;
+  int idx_var_ = -1;
+  int idx_sum_ = -1;
+  // the weight and the bias used by the primitive
+  NDArray cached_weight_;
+  NDArray cached_bias_;
+  // versions of the inputs that cached_weight_ and cached_bias_ are computed from
+  std::vector<size_t> folded_versions_;
+  std::shared_ptr<MKLDNNConvForward> fwd_;
+  TShape fwd_data_shape_;
+};
+
+SgMKLDNNConvOperator::SgMKLDNNConvOperator(const nnvm::NodeAttrs &attrs) {
+  full_param_.mkldnn_param = nnvm::get<MKLDNNConvParam>(attrs.parsed);
+  const nnvm::Symbol &sym = *attrs.subgraphs[0];
+  nnvm::Graph g;
+  g.outputs = sym.outputs;
+  const auto &idx = g.indexed_graph();
+  auto input_pos = [&idx](const nnvm::NodeEntry &e) -> int {
+    const auto &input_nodes = idx.input_nodes();
+    const uint32_t nid = idx.node_id(e.node.get());
+    auto it = std::find(input_nodes.begin(), input_nodes.end(), nid);
+    return it == input_nodes.end() ? -1 : static_cast<int>(it - input_nodes.begin());
+  };
+  const nnvm::Node *conv = nullptr;
+  for (uint32_t nid = 0; nid < idx.num_nodes(); ++nid) {
+    const nnvm::Node *node = idx[nid].source;
+    if (node->is_variable()) continue;
+    const std::string &name = node->op()->name;
+    if (name == "Convolution") {
+      conv = node;
+      full_param_.conv_param = nnvm::get<ConvolutionParam>(node->attrs.parsed);
+      idx_data_ = input_pos(node->inputs[conv::kData]);
+      idx_weight_ = input_pos(node->inputs[conv::kWeight]);
+      if (!full_param_.conv_param.no_bias) idx_bias_ = input_pos(node->inputs[conv::kBias]);
+    } else if (name == "BatchNorm") {
+      bn_param_ = nnvm::get<BatchNormParam>(node->attrs.parsed);
+      idx_gamma_ = input_pos(node->inputs[batchnorm::kGamma]);
+      idx_beta_ = input_pos(node->inputs[batchnorm::kBeta]);
+      idx_mean_ = input_pos(node->inputs[batchnorm::kInMovingMean]);
+      idx_var_ = input_pos(node->inputs[batchnorm::kInMovingVar]);
+    } else if (name == "elemwise_add") {
+      // The operand of the sum that is not produced by the fused chain.
+      for (const auto &e : node->inputs) {
+        if (e.node->is_variable()) idx_sum_ = input_pos(e);
+      }
+    }
+  }
+  CHECK(conv != nullptr) << "_sg_mkldnn_conv requires a Convolution in its subgraph";
+  CHECK_GE(idx_data_, 0);
+  CHECK_GE(idx_weight_, 0);
+  CHECK(!full_param_.mkldnn_param.with_sum || idx_sum_ >= 0);
+}
+
+void SgMKLDNNConvOperator::FoldBatchNorm(const std::vector<NDArray> &inputs) {
+  const ConvolutionParam &param = full_param_.conv_param;
+  NDArray weight = inputs[idx_weight_];
+  if (weight.IsMKLDNNData()) weight = weight.Reorder2Default();
+  const TShape &wshape = weight.shape();
+  const index_t channels = wshape[0];
+  const index_t channel_size = wshape.Size() / channels;
+  // The previous weight may have been reordered to the layout of the
+  // primitive, so the folded values always go to new arrays.
+  cached_weight_ = NDArray(wshape, Context::CPU(), false, mshadow::kFloat32);
+  cached_bias_ = NDArray(TShape(mshadow::Shape1(channels)), Context::CPU(), false,
+                         mshadow::kFloat32);
+  const float *w = weight.data().dptr<float>();
+  const float *b = param.no_bias ? nullptr : inputs[idx_bias_].data().dptr<float>();
+  const float *gamma = inputs[idx_gamma_].data().dptr<float>();
+  const float *beta = inputs[idx_beta_].data().dptr<float>();
+  const float *mean = inputs[idx_mean_].data().dptr<float>();
+  const float *var = inputs[idx_var_].data().dptr<float>();
+  float *out_w = cached_weight_.data().dptr<float>();
+  float *out_b = cached_bias_.data().dptr<float>();
+  const int omp_threads = engine::OpenMP::Get()->GetRecommendedOMPThreadCount();
+  #pragma omp parallel for num_threads(omp_threads)
+  for (index_t c = 0; c < channels; ++c) {
+    const float scale = (bn_param_.fix_gamma ? 1.0f : gamma[c]) /
+        std::sqrt(var[c] + static_cast<float>(bn_param_.eps));
+    for (index_t k = 0; k < channel_size; ++k) {
+      out_w[c * channel_size + k] = w[c * channel_size + k] * scale;
+    }
+    out_b[c] = ((b ? b[c] : 0.0f) - mean[c]) * scale + beta[c];
+  }
+}
+
+void SgMKLDNNConvOperator::Forward(const OpContext &ctx,
+                                   const std::vector<NDArray> &inputs,
+                                   const std::vector<OpReqType> &req,
+                                   const std::vector<NDArray> &outputs) {
+  CHECK(!ctx.is_train) << "_sg_mkldnn_conv only supports inference";
+  TmpMemMgr::Get()->Init(ctx.requested[0]);
+  const ConvolutionParam &param = full_param_.conv_param;
+  const MKLDNNConvParam &mkldnn_param = full_param_.mkldnn_param;
+  const NDArray &data = inputs[idx_data_];
+  const NDArray &output = outputs[0];
+
+  bool has_bias = !param.no_bias;
+  if (mkldnn_param.with_bn) {
+    // Fold the batch norm again whenever one of its sources has been updated.
+    std::vector<size_t> versions;
+    for (int i : {idx_weight_, idx_bias_, idx_gamma_, idx_beta_, idx_mean_, idx_var_}) {
+      if (i >= 0) versions.push_back(inputs[i].version());
+    }
+    if (versions != folded_versions_) {
+      FoldBatchNorm(inputs);
+      folded_versions_ = versions;
+    }
+    has_bias = true;
+  } else {
+    cached_weight_ = inputs[idx_weight_];
+    if (has_bias) cached_bias_ = inputs[idx_bias_];
+  }
+
+  if (fwd_ == nullptr || fwd_data_shape_ != data.shape()) {
+    fwd_.reset(new MKLDNNConvForward(full_param_, false, data, cached_weight_,
+                                     has_bias ? &cached_bias_ : nullptr, output));
+    fwd_data_shape_ = data.shape();
+  }
+
+  auto data_mem = data.GetMKLDNNDataReorder(fwd_->fwd_pd.src_primitive_desc());
+  const mkldnn::memory *weight_mem = GetInferenceWeights(
+      &cached_weight_, fwd_->fwd_pd.weights_primitive_desc(), param.num_group);
+  const mkldnn::memory *bias_mem = nullptr;
+  if (has_bias) {
+    bias_mem = cached_bias_.GetMKLDNNDataReorder(fwd_->fwd_pd.bias_primitive_desc());
+  }
+
+  const auto &dst_pd = fwd_->fwd_pd.dst_primitive_desc();
+  const mkldnn::memory *sum_mem = nullptr;
+  if (mkldnn_param.with_sum) {
+    // The sum post-op accumulates into the destination, which therefore has
+    // to hold the other operand of the sum before the convolution runs.
+    sum_mem = inputs[idx_sum_].GetMKLDNNDataReorder(dst_pd);
+  }
+  auto out_mem = CreateMKLDNNMem(output, dst_pd, req[0]);
+  if (sum_mem != nullptr && sum_mem->get_data_handle() != out_mem.second->get_data_handle()) {
+    MKLDNNCopy(*sum_mem, out_mem.second);
+  }
+  fwd_->SetNewMem(*data_mem, *weight_mem, bias_mem, *out_mem.second);
+  MKLDNNStream::Get()->RegisterPrim(fwd_->GetFwd());
+  CommitOutput(output, out_mem);
+  MKLDNNStream::Get()->Submit();
+}
+
+static OpStatePtr CreateSgMKLDNNConvState(const nnvm::NodeAttrs &attrs,
+                                          Context ctx,
+                                          const std::vector<TShape> &in_shapes,
+                                          const std::vector<int> &in_types) {
+  return OpStatePtr::Create<SgMKLDNNConvOperator>(attrs);
+}
+
+static void SgMKLDNNConvForward(const OpStatePtr &state_ptr,
+                                const OpContext &ctx,
+                                const std::vector<NDArray> &inputs,
+                                const std::vector<OpReqType> &req,
+                                const std::vector<NDArray> &outputs) {
+  SgMKLDNNConvOperator &op = state_ptr.get_state<SgMKLDNNConvOperator>();
+  op.Forward(ctx, inputs, req, outputs);
+}
+
+static bool SgMKLDNNConvStorageType(const nnvm::NodeAttrs &attrs,
+                                    const int dev_mask,
+                                    DispatchMode *dispatch_mode,
+                                    std::vector<int> *in_stypes,
+                                    std::vector<int> *out_stypes) {
+  return MKLDNNStorageType(attrs, dev_mask, true, dispatch_mode, in_stypes, out_stypes);
+}
+
+NNVM_REGISTER_OP(_sg_mkldnn_conv)
+.describe(R"code(Convolution fused with the batch norm, relu and elementwise sum
+that follow it. Created by the MKLDNN subgraph backend for inference.)code" ADD_FILELINE)
+.set_num_inputs(DefaultSubgraphOpNumInputs)
+.set_num_outputs(1)
+.set_attr_parser(SgMKLDNNConvParamParser)
+.set_attr<nnvm::FListInputNames>("FListInputNames", DefaultSubgraphOpListInputs)
+.set_attr<nnvm::FListOutputNames>("FListOutputNames", DefaultSubgraphOpListOutputs)
+.set_attr<FCreateOpState>("FCreateOpState", CreateSgMKLDNNConvState)
+.set_attr<nnvm::FInferShape>("FInferShape", DefaultSubgraphOpShape)
+.set_attr<nnvm::FInferType>("FInferType", DefaultSubgraphOpType)
+.set_attr<FInferStorageType>("FInferStorageType", SgMKLDNNConvStorageType)
+.set_attr<FStatefulComputeEx>("FStatefulComputeEx<cpu>", SgMKLDNNConvForward)
+.set_attr<nnvm::FMutateInputs>("FMutateInputs", DefaultSubgraphOpMutableInputs)
+.set_attr<FResourceRequest>("FResourceRequest", [](const NodeAttrs& n) {
+  return std::vector<ResourceRequest>{ResourceRequest::kTempSpace};
+})
+.set_attr<std::string>("key_var_num_args", "num_args")
+.add_argument("data", "NDArray-or-Symbol[]", "input data list");
+
+}  // namespace op
+}  // namespace mxnet
+
+#endif  // MXNET_USE_MKLDNN == 1
@@ -0,0 +1,181 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#if MXNET_USE_MKLDNN == 1
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "../common.h"
+#include "../subgraph_property.h"
+#include "../../nn/activation-inl.h"
+#include "../../nn/batch_norm-inl.h"
+#include "../../nn/convolution-inl.h"
+#include "../../nn/mkldnn/mkldnn_convolution-inl.h"
+
+namespace mxnet {
+namespace op {
+
+/*
+ * This selects a 2D convolution followed by, in this order and each of them
+ * optional, a BatchNorm, a relu Activation, an elemwise_add and another relu
+ * Activation. Every operator of the chain except the last one must have the
+ * next operator as its only consumer.
+ */
+class SgMKLDNNConvSelector : public SubgraphSelector {
+ public:
+  enum SelectStatus { kStart, kBN, kRelu, kSum, kSuccess };
+
+  explicit SgMKLDNNConvSelector(const nnvm::Graph *g) : graph_(g) {}
+
+  virtual bool Select(const nnvm::Node &seed_node) {
+    if (graph_ == nullptr || !IsMKLDNNConv(seed_node)) return false;
+    status_ = kStart;
+    last_ = &seed_node;
+    return true;
+  }
+
+  virtual bool SelectInput(const nnvm::Node &cur_node, const nnvm::Node &input_node) {
+    return false;
+  }
+
+  virtual bool SelectOutput(const nnvm::Node &cur_node, const nnvm::Node &output_node) {
+    if (&cur_node != last_ || status_ == kSuccess || output_node.is_variable() ||
+        NumConsumers(cur_node) != 1) {
+      return false;
+    }
+    const std::string &name = output_node.op()->name;
+    SelectStatus next = kSuccess;
+    if (name == "BatchNorm" && status_ == kStart) {
+      const BatchNormParam &param = nnvm::get<BatchNormParam>(output_node.attrs.parsed);
+      if (param.axis != 1 || param.output_mean_var) return false;
+      next = kBN;
+    } else if (IsRelu(output_node) && status_ != kRelu) {
+      next = status_ == kSum ? kSuccess : kRelu;
+    } else if (name == "elemwise_add" && status_ != kSum) {
+      // The other operand of the sum must come from outside of the chain.
+      if (output_node.inputs[0].node.get() == output_node.inputs[1].node.get()) return false;
+      next = kSum;
+    } else {
+      return false;
+    }
+    status_ = next;
+    last_ = &output_node;
+    return true;
+  }
+
+  // A convolution alone is already handled by the MKLDNN Convolution operator.
+  virtual std::vector<nnvm::Node*> Filter(const std::vector<nnvm::Node*>& candidates) {
+    return candidates.size() > 1 ? candidates : std::vector<nnvm::Node*>();
+  }
+
+ private:
+  static bool IsRelu(const nnvm::Node &n) {
+    return n.op()->name == "Activation" &&
+        nnvm::get<ActivationParam>(n.attrs.parsed).act_type == activation::kReLU;
+  }
+
+  bool IsMKLDNNConv(const nnvm::Node &n) const {
+    if (n.is_variable() || n.op()->name != "Convolution") return false;
+    const ConvolutionParam &param = nnvm::get<ConvolutionParam>(n.attrs.parsed);
+    if (param.kernel.ndim() != 2) return false;
+    const auto &idx = graph_->indexed_graph();
+    const uint32_t nid = idx.node_id(&n);
+    const auto &dev_masks = graph_->GetAttr<exec::DevMaskVector>("dev_mask");
+    if (dev_masks[nid] != Context::kCPU) return false;
+    const auto &shapes = graph_->GetAttr<nnvm::ShapeVector>("shape");
+    const auto &dtypes = graph_->GetAttr<nnvm::DTypeVector>("dtype");
+    const auto &stypes = graph_->GetAttr<StorageTypeVector>("storage_type");
+    const uint32_t data_eid = idx.entry_id(n.inputs[conv::kData]);
+    return shapes[data_eid].ndim() == 4 && dtypes[data_eid] == mshadow::kFloat32 &&
+        stypes[data_eid] == kDefaultStorage;
+  }
+
+  /*! \brief number of references to the outputs of a node, graph outputs included */
+  size_t NumConsumers(const nnvm::Node &n) {
+    if (num_consumers_.empty()) {
+      const auto &idx = graph_->indexed_graph();
+      num_consumers_.resize(idx.num_nodes(), 0);
+      for (uint32_t nid = 0; nid < idx.num_nodes(); ++nid) {
+        for (const auto &e : idx[nid].inputs) ++num_consumers_[e.node_id];
+      }
+      for (const auto &e : idx.outputs()) ++num_consumers_[e.node_id];
+    }
+    return num_consumers_[graph_->indexed_graph().node_id(&n)];
+  }
+
+  const nnvm::Graph *graph_;
+  SelectStatus status_ = kStart;
+  const nnvm::Node *last_ = nullptr;
+  std::vector<size_t> num_consumers_;
+};
+
+/*
+ * This subgraph property replaces the chains found by SgMKLDNNConvSelector
+ * with _sg_mkldnn_conv, which folds the batch norm into the convolution and
+ * runs the relu and the sum as post-ops of the same MKLDNN primitive. The
+ * fused operator only supports inference.
+ */
+class SgMKLDNNConvProperty : public SubgraphProperty {
+ public:
+  static SubgraphPropertyPtr Create() { return std::make_shared<SgMKLDNNConvProperty>(); }
+
+  virtual nnvm::NodePtr CreateSubgraphNode(const nnvm::Symbol &sym,
+                                           const int subgraph_id = 0) const {
+    static const auto fused_op = Op::Get("_sg_mkldnn_conv");
+    nnvm::NodePtr n = nnvm::Node::Create();
+    n->attrs.op = fused_op;
+    n->attrs.name = "sg_mkldnn_conv_" + std::to_string(subgraph_id);
+    bool seen_sum = false;
+    nnvm::DFSVisit(sym.outputs, [&](const nnvm::NodePtr &node) {
+      if (node->is_variable()) return;
+      const std::string &name = node->op()->name;
+      if (name == "BatchNorm") {
+        n->attrs.dict["with_bn"] = "true";
+      } else if (name == "Activation") {
+        n->attrs.dict[seen_sum ? "with_postsum_relu" : "with_relu"] = "true";
+      } else if (name == "elemwise_add") {
+        n->attrs.dict["with_sum"] = "true";
+        seen_sum = true;
+      }
+    });
+    n->attrs.subgraphs.push_back(std::make_shared<nnvm::Symbol>(sym));
+    fused_op->attr_parser(&(n->attrs));
+    return n;
+  }
+
+  virtual SubgraphSelectorPtr CreateSubgraphSelector() const {
+    const nnvm::Graph *g = nullptr;
+    if (this->HasAttr("graph")) {
+      g = &this->GetAttr<nnvm::Graph>("graph");
+      if (!g->HasAttr("shape") || !g->HasAttr("dtype") ||
+          !g->HasAttr("storage_type") || !g->HasAttr("dev_mask")) {
+        g = nullptr;
+      }
+    }
+    return std::make_shared<SgMKLDNNConvSelector>(g);
+  }
+};
+
+MXNET_REGISTER_SUBGRAPH_PROPERTY(MKLDNN, SgMKLDNNConvProperty);
+
+}  // namespace op
+}  // namespace mxnet
+
+#endif  // MXNET_USE_MKLDNN == 1
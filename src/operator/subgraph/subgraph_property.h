@@ -98,6 +98,10 @@ class SubgraphProperty {
     attrs_[name] = std::make_shared<dmlc::any>(value);
     return *this;
   }
+  // whether the attr with the name has been set
+  bool HasAttr(const std::string& name) const {
+    return attrs_.count(name) > 0;
+  }
   // get the attr with the name
   template<typename T>
   const T& GetAttr(const std::string& name) const {
@@ -189,12 +189,232 @@ bool is_type_udf(const int &x) {
   return x == -1;
 }
 
-LoopState::LoopState(const Symbol &g) {
+std::shared_ptr<LoopBodyExec> LoopBodyExec::Create(const nnvm::Symbol &sym,
+                                                   const Context &ctx,
+                                                   const std::vector<TShape> &in_shapes,
+                                                   const std::vector<int> &in_dtypes) {
+  using namespace nnvm;
+  using namespace imperative;
+  static const auto _copy = Op::Get("_copy");
+  static auto& fcompute_cpu = Op::GetAttr<FCompute>("FCompute<cpu>");
+  static auto& fcompute_gpu = Op::GetAttr<FCompute>("FCompute<gpu>");
+  static auto& fexec_type = Op::GetAttr<FExecType>("FExecType");
+  static auto& fmutate = Op::GetAttr<FMutateInputs>("FMutateInputs");
+  static auto& ftmp_resource = Op::GetAttr<FResourceRequest>("FResourceRequest");
+  static auto& ftmp_resource_ex = Op::GetAttr<FResourceRequestEx>("FResourceRequestEx");
+
+  std::shared_ptr<LoopBodyExec> body(new LoopBodyExec());
+  body->ctx = ctx;
+  body->in_shapes = in_shapes;
+  body->in_dtypes = in_dtypes;
+  // Every output has to be computed into its own array, so an output that is
+  // an input of the body or that appears more than once is copied.
+  nnvm::Graph& g = body->graph;
+  NodeEntryMap<int> dedup_out;
+  for (const auto& i : sym.outputs) {
+    if (i.node->is_variable() || dedup_out.count(i)) {
+      NodePtr copy_node = Node::Create();
+      copy_node->attrs.op = _copy;
+      copy_node->attrs.name =
+          i.node->attrs.name + "_copy" + std::to_string(dedup_out[i]++);
+      copy_node->inputs.emplace_back(i);
+      if (_copy->attr_parser != nullptr) {
+        _copy->attr_parser(&(copy_node->attrs));
+      }
+      g.outputs.push_back(NodeEntry{copy_node, 0, 0});
+    } else {
+      dedup_out.insert({i, 0});
+      g.outputs.push_back(i);
+    }
+  }
+  CHECK_EQ(g.indexed_graph().input_nodes().size(), in_shapes.size());
+
+  CheckAndInferShape(&g, ShapeVector(in_shapes), true);
+  CheckAndInferType(&g, DTypeVector(in_dtypes), true);
+  exec::DevMaskVector dev_mask(g.indexed_graph().num_nodes(), ctx.dev_mask());
+  CheckAndInferStorageType(&g, std::move(dev_mask),
+                           StorageTypeVector(in_shapes.size(), kDefaultStorage), true);
+
+  const auto& idx = g.indexed_graph();
+  const auto& shapes = g.GetAttr<ShapeVector>("shape");
+  const auto& dtypes = g.GetAttr<DTypeVector>("dtype");
+  const auto& stypes = g.GetAttr<StorageTypeVector>("storage_type");
+  const auto& dispatch_modes = g.GetAttr<DispatchModeVector>("dispatch_mode");
+  const auto& fcompute = ctx.dev_mask() == gpu::kDevMask ? fcompute_gpu : fcompute_cpu;
+  for (const auto stype : stypes) {
+    if (stype != kDefaultStorage) return nullptr;
+  }
+
+  for (size_t nid = 0; nid < idx.num_nodes(); ++nid) {
+    const auto& inode = idx[nid];
+    if (inode.source->is_variable()) continue;
+    const Op *op = inode.source->op();
+    const NodeAttrs& attrs = inode.source->attrs;
+    // All the arrays are dense, so FComputeEx operators can run their FCompute.
+    const bool dense_dispatch = dispatch_modes[nid] == DispatchMode::kFCompute ||
+        dispatch_modes[nid] == DispatchMode::kFComputeEx;
+    if (!dense_dispatch || !fcompute.count(op) || fmutate.count(op) ||
+        (fexec_type.count(op) && fexec_type[op](attrs) != ExecType::kSync)) {
+      return nullptr;
+    }
+    OpNode node;
+    node.attrs = &attrs;
+    node.fn = fcompute[op];
+    for (const auto& e : inode.inputs) node.in_eids.push_back(idx.entry_id(e));
+    for (uint32_t i = 0; i < inode.source->num_outputs(); ++i)
+      node.out_eids.push_back(idx.entry_id(nid, i));
+    if (ftmp_resource_ex.count(op) || ftmp_resource.count(op)) {
+      auto resource_reqs = ftmp_resource_ex.count(op) ?
+          ftmp_resource_ex[op](attrs, ctx.dev_mask(), DispatchMode::kFCompute) :
+          ftmp_resource[op](attrs);
+      for (const auto& req : resource_reqs) {
+        node.requested.push_back(ResourceManager::Get()->Request(ctx, req));
+        body->vars.push_back(node.requested.back().var);
+      }
+    }
+    body->nodes.push_back(std::move(node));
+  }
+
+  // Plan the memory of the intermediate results. The inputs and outputs are
+  // given in every iteration.
+  std::vector<uint32_t> ref_count(idx.num_node_entries(), 0);
+  StorageVector storage(idx.num_node_entries(), exec::kBadStorageID);
+  for (const auto i : idx.input_nodes()) {
+    body->in_eids.push_back(idx.entry_id(i, 0));
+    storage[body->in_eids.back()] = exec::kExternalStorageID;
+    ++ref_count[body->in_eids.back()];
+  }
+  for (const auto& i : idx.outputs()) {
+    body->out_eids.push_back(idx.entry_id(i));
+    body->out_shapes.push_back(shapes[body->out_eids.back()]);
+    body->out_dtypes.push_back(dtypes[body->out_eids.back()]);
+    storage[body->out_eids.back()] = exec::kExternalStorageID;
+    ++ref_count[body->out_eids.back()];
+  }
+  for (size_t i = 0; i < idx.num_nodes(); ++i) {
+    for (const auto& j : idx[i].inputs) ++ref_count[idx.entry_id(j)];
+  }
+  auto mem_plan = PlanMemory(&g, std::move(storage), ref_count);
+
+  std::vector<OpReqType> reqs(idx.num_node_entries(), kWriteTo);
+  std::vector<void*> dptrs(idx.num_node_entries(), nullptr);
+  body->blobs.resize(idx.num_node_entries());
+  for (uint32_t i = 0; i < idx.num_node_entries(); ++i) {
+    if (mem_plan[i].storage_id == exec::kExternalStorageID) continue;
+    if (mem_plan[i].storage_id < 0) return nullptr;
+    const uint32_t root = mem_plan[i].root;
+    if (root == i && mem_plan[i].size > 0) {
+      NDArray buff(TShape({static_cast<nnvm::dim_t>(mem_plan[i].size)}),
+                   ctx, false, mshadow::kUint8);
+      dptrs[i] = buff.data().dptr_;
+      body->buffers.push_back(buff);
+      body->vars.push_back(buff.var());
+    }
+    body->blobs[i] = TBlob(dptrs[root], shapes[i], ctx.dev_mask(), dtypes[i], ctx.dev_id);
+    if (mem_plan[i].inplace) reqs[i] = kWriteInplace;
+  }
+  for (auto& node : body->nodes) {
+    for (const auto eid : node.out_eids) node.req.push_back(reqs[eid]);
+  }
+  return body;
+}
+
+void LoopBodyExec::Run(const RunContext &rctx, bool is_train,
+                       const std::vector<TBlob> &inputs,
+                       const std::vector<TBlob> &outputs,
+                       Workspace *ws) const {
+  CHECK_EQ(inputs.size(), in_eids.size());
+  CHECK_EQ(outputs.size(), out_eids.size());
+  CHECK_EQ(ws->blobs.size(), blobs.size());
+  for (size_t i = 0; i < inputs.size(); ++i) ws->blobs[in_eids[i]] = inputs[i];
+  for (size_t i = 0; i < outputs.size(); ++i) ws->blobs[out_eids[i]] = outputs[i];
+  for (const auto& node : nodes) {
+    ws->in_blobs.clear();
+    ws->out_blobs.clear();
+    for (const auto eid : node.in_eids) ws->in_blobs.push_back(ws->blobs[eid]);
+    for (const auto eid : node.out_eids) ws->out_blobs.push_back(ws->blobs[eid]);
+    OpContext opctx{false, is_train, rctx, engine::CallbackOnComplete(), node.requested};
+    node.fn(*node.attrs, opctx, ws->in_blobs, node.req, ws->out_blobs);
+  }
+}
+
+LoopState::LoopState(const Symbol &g)
+    : checkpoint_steps(std::max(dmlc::GetEnv("MXNET_LOOP_CHECKPOINT_STEPS", 1), 1)),
+      num_reserved(0), next_pool(0) {
   this->subgraph_sym = g;
   this->subgraph.outputs = g.outputs;
   this->iter_op = LoopState::MakeSharedOp(g);
 }
 
+// Alignment of the iteration buffers in an arena.
+static const size_t kLoopArenaAlign = 64;
+
+std::multimap<size_t, NDArray> LoopState::NextIterPool(const Context &ctx) {
+  // The buffer sizes are known after the first recorded iteration.
+  if (iter_buffer_sizes.empty()) return std::multimap<size_t, NDArray>();
+  if (next_pool == iter_pools.size()) {
+    // Allocate all the remaining recorded iterations at once if the number of
+    // iterations is known, otherwise double the number of slots.
+    size_t num_slots = std::max<size_t>(iter_pools.size(), 1);
+    if (num_reserved > 0) {
+      size_t expected = (num_reserved + checkpoint_steps - 1) / checkpoint_steps;
+      // One more slot for recomputing the iterations which are not recorded.
+      if (checkpoint_steps > 1) ++expected;
+      if (expected > next_pool) num_slots = expected - next_pool;
+    }
+    size_t slot_size = 0;
+    for (size_t s : iter_buffer_sizes) {
+      slot_size += (s + kLoopArenaAlign - 1) / kLoopArenaAlign * kLoopArenaAlign;
+    }
+    NDArray arena(TShape({static_cast<nnvm::dim_t>(slot_size * num_slots)}),
+                  ctx, false, mshadow::kUint8);
+    uint8_t *base = arena.data().dptr<uint8_t>();
+    for (size_t i = 0; i < num_slots; ++i) {
+      std::multimap<size_t, NDArray> pool;
+      size_t offset = i * slot_size;
+      for (size_t s : iter_buffer_sizes) {
+        TBlob blob(base + offset, TShape({static_cast<nnvm::dim_t>(s)}),
+                   ctx.dev_mask(), mshadow::kUint8, ctx.dev_id);
+        NDArray buff(blob, ctx.dev_id);
+        pool.insert({s, buff});
+        arena_slices.push_back(buff);
+        offset += (s + kLoopArenaAlign - 1) / kLoopArenaAlign * kLoopArenaAlign;
+      }
+      iter_pools.push_back(std::move(pool));
+    }
+    arenas.push_back(arena);
+  }
+  return iter_pools[next_pool++];
+}
+
+OpStatePtr LoopState::NewIterState(const Context &ctx) {
+  return iter_op->CreateStaticState(ctx, plan_state, NextIterPool(ctx));
+}
+
+void LoopState::RetireArenas() {
+  retired_arenas.insert(retired_arenas.end(), arenas.begin(), arenas.end());
+  retired_slices.insert(retired_slices.end(), arena_slices.begin(), arena_slices.end());
+  arenas.clear();
+  arena_slices.clear();
+  iter_pools.clear();
+  next_pool = 0;
+}
+
+void LoopState::ReleaseRetiredArenas() {
+  if (retired_arenas.empty()) return;
+  std::vector<Engine::VarHandle> vars;
+  vars.reserve(retired_slices.size());
+  for (const auto &buff : retired_slices) vars.push_back(buff.var());
+  std::vector<NDArray> memory;
+  memory.swap(retired_arenas);
+  const Context ctx = memory[0].ctx();
+  // The buffers don't own their memory, so the arenas are only freed after
+  // all the pending operations on the buffers finish.
+  Engine::Get()->PushSync([memory](RunContext rctx) {}, ctx, {}, vars,
+                          FnProperty::kNormal, 0, "LoopArenaRelease");
+  retired_slices.clear();
+}
+
 void LoopState::Forward(int iter_no,
                         const std::vector<NDArray> &cinputs,
                         const std::vector<OpReqType>& req,
@@ -203,9 +423,14 @@ void LoopState::Forward(int iter_no,
   using namespace nnvm;
   using namespace imperative;
 
+  // A new forward pass drops the computation recorded by the previous one.
+  if (is_recording && iter_no == 0) Cleanup();
+  // In training, only every checkpoint_steps-th iteration keeps its buffers
+  // for backward. The others run like inference and are recomputed in backward.
+  const bool record_iter = is_recording && iter_no % checkpoint_steps == 0;
   bool orig_is_record;
   if (is_recording)
-    orig_is_record = Imperative::Get()->set_is_recording(true);
+    orig_is_record = Imperative::Get()->set_is_recording(record_iter);
   else
     orig_is_record = Imperative::Get()->is_recording();
 
@@ -218,7 +443,21 @@ void LoopState::Forward(int iter_no,
   for (size_t i = 0; i < outputs.size(); i++)
     outputs[i] = &out_bufs[i];
 
-  OpStatePtr state = iter_op->Forward(nullptr, inputs, outputs);
+  OpStatePtr state;
+  if (record_iter) {
+    state = NewIterState(in_bufs[0].ctx());
+    iter_op->Forward(nullptr, inputs, outputs, state);
+    std::vector<size_t> sizes = iter_op->StaticForwardBufferSizes(state);
+    if (sizes != iter_buffer_sizes) {
+      // The memory plan changed, e.g. the input shapes are different,
+      // so new arenas are laid out for the new buffer sizes.
+      RetireArenas();
+      iter_buffer_sizes = sizes;
+    }
+    plan_state = state;
+  } else {
+    iter_op->Forward(nullptr, inputs, outputs);
+  }
   // If an input and an output share the array, the output array will be changed
   // by CachedOp. We need to copy data to the real output.
   for (size_t i = 0; i < out_bufs.size(); i++)
@@ -233,6 +472,27 @@ void LoopState::Forward(int iter_no,
   Imperative::Get()->set_is_recording(orig_is_record);
 }
 
+OpStatePtr LoopState::Recompute(int iter_no) {
+  using namespace imperative;
+  if (!recompute_state) {
+    recompute_state = NewIterState(all_inputs[iter_no][0].ctx());
+  }
+  std::vector<NDArray> in_bufs = all_inputs[iter_no];
+  // The outputs recorded in forward already hold the results,
+  // so the recomputed outputs are written to scratch arrays.
+  std::vector<NDArray> out_bufs(all_outputs[iter_no].size());
+  std::vector<NDArray *> inputs(in_bufs.size());
+  std::vector<NDArray *> outputs(out_bufs.size());
+  for (size_t i = 0; i < inputs.size(); i++)
+    inputs[i] = &in_bufs[i];
+  for (size_t i = 0; i < outputs.size(); i++)
+    outputs[i] = &out_bufs[i];
+  bool orig_is_record = Imperative::Get()->set_is_recording(true);
+  iter_op->Forward(nullptr, inputs, outputs, recompute_state);
+  Imperative::Get()->set_is_recording(orig_is_record);
+  return recompute_state;
+}
+
 void LoopState::Backward(int iter_no,
                          const std::vector<NDArray> &ograds,
                          const std::vector<OpReqType> &req,
@@ -240,9 +500,11 @@ void LoopState::Backward(int iter_no,
   using namespace nnvm;
   using namespace imperative;
 
-  CHECK_GT(all_states.size(), iter_no)
+  CHECK_GT(all_inputs.size(), iter_no)
       << "We didn't record the computation for iteration " << iter_no;
   auto op = iter_op;
+  OpStatePtr state = all_states[iter_no];
+  if (!state) state = Recompute(iter_no);
   std::vector<NDArray *> inputs;
   std::vector<NDArray *> outputs;
   inputs.reserve(op->num_backward_inputs());
@@ -268,8 +530,11 @@ void LoopState::Backward(int iter_no,
   for (size_t i = 0; i < igrads.size(); i++)
     outputs.push_back(&igrad_bufs[i]);
   CHECK_EQ(outputs.size(), op->num_inputs());
-  auto state = all_states[iter_no];
+  // The backward buffers of the previous iteration are reused.
+  if (last_bwd_state) op->TransferStaticBackward(last_bwd_state, state);
   op->Backward(false, state, inputs, req, outputs);
+  last_bwd_state = state;
+  all_states[iter_no] = OpStatePtr();
   // If an input and an output share the array, the output array will be changed
   // by CachedOp. We need to copy data to the real output.
   for (size_t i = 0; i < igrads.size(); i++)
@@ -24,6 +24,8 @@
 #include <mxnet/base.h>
 #include <mxnet/op_attr_types.h>
 #include <vector>
+#include <map>
+#include <memory>
 #include <utility>
 #include <string>
 #include "../imperative/cached_op.h"
@@ -119,6 +121,89 @@ bool sync_out_out(std::vector<T> *out_1,
   return true;
 }
 
+/*
+ * This runs the subgraph of a loop body by calling the FCompute functions of
+ * its operators directly on static buffers. The body is compiled once for the
+ * shapes of an iteration, so that all iterations of a loop can run inside a
+ * single engine operation. It only works for inference, and every operator in
+ * the body has to be a stateless FCompute operator on the default storage.
+ * Operators dispatched to FComputeEx, e.g. by MKLDNN, run their FCompute
+ * function instead, since all the arrays are dense. A body with an operator
+ * that only has an FComputeEx function can't run this way.
+ */
+class LoopBodyExec {
+  struct OpNode {
+    const nnvm::NodeAttrs *attrs;
+    FCompute fn;
+    std::vector<uint32_t> in_eids;
+    std::vector<uint32_t> out_eids;
+    std::vector<OpReqType> req;
+    std::vector<Resource> requested;
+  };
+  nnvm::Graph graph;
+  Context ctx;
+  std::vector<TShape> in_shapes;
+  std::vector<int> in_dtypes;
+  std::vector<TShape> out_shapes;
+  std::vector<int> out_dtypes;
+  std::vector<uint32_t> in_eids;
+  std::vector<uint32_t> out_eids;
+  // The memory of the intermediate results in the body.
+  std::vector<NDArray> buffers;
+  // The data of all entries in the graph. The blobs of the intermediate
+  // results are fixed, the others are set in every iteration.
+  std::vector<TBlob> blobs;
+  std::vector<OpNode> nodes;
+  // The vars that an engine operation running the body has to mutate.
+  std::vector<engine::VarHandle> vars;
+
+  LoopBodyExec() {}
+
+ public:
+  /*
+   * Compile the body for the given input shapes and types.
+   * It returns nullptr if the body can't run this way.
+   */
+  static std::shared_ptr<LoopBodyExec> Create(const nnvm::Symbol &sym,
+                                              const Context &ctx,
+                                              const std::vector<TShape> &in_shapes,
+                                              const std::vector<int> &in_dtypes);
+  bool Match(const Context &ctx, const std::vector<TShape> &in_shapes,
+             const std::vector<int> &in_dtypes) const {
+    return this->ctx == ctx && this->in_shapes == in_shapes &&
+        this->in_dtypes == in_dtypes;
+  }
+  const std::vector<TShape> &output_shapes() const {
+    return out_shapes;
+  }
+  const std::vector<int> &output_dtypes() const {
+    return out_dtypes;
+  }
+  const std::vector<engine::VarHandle> &mutable_vars() const {
+    return vars;
+  }
+  /*
+   * The blobs of the graph entries used by Run. Every engine operation running
+   * the body has its own, so that operations of the same body never share them.
+   */
+  struct Workspace {
+    std::vector<TBlob> blobs;
+    std::vector<TBlob> in_blobs;
+    std::vector<TBlob> out_blobs;
+  };
+  void InitWorkspace(Workspace *ws) const {
+    ws->blobs = blobs;
+  }
+  /*
+   * Run an iteration. It can only be called inside an engine operation that
+   * depends on the vars of the inputs and outputs, and mutates mutable_vars().
+   */
+  void Run(const RunContext &rctx, bool is_train,
+           const std::vector<TBlob> &inputs,
+           const std::vector<TBlob> &outputs,
+           Workspace *ws) const;
+};
+
 /*
  * This contains the states for running a loop and provides methods
  * of running the subgraph computation for an iteration.
@@ -130,17 +215,59 @@ class LoopState {
   std::vector<std::vector<NDArray> > all_inputs;
   // For inference, there should be only one cached op because we
   // want to share the memory in iterations.
-  // For training, each iteration has a cached op because each iteration
-  // needs to maintain a set of memory buffers for all computation states,
-  // which will be used in the backward.
+  // For training, each recorded iteration has its own cached op state because
+  // it needs to maintain a set of memory buffers for all computation states,
+  // which will be used in the backward. The states of the iterations which
+  // are not checkpointed are empty and recomputed in the backward.
   std::vector<OpStatePtr> all_states;
   CachedOpPtr iter_op;
   Symbol subgraph_sym;
   nnvm::Graph subgraph;
+  // Only every checkpoint_steps-th iteration is recorded in training.
+  int checkpoint_steps;
+  // The number of iterations expected in the current forward, 0 if unknown.
+  size_t num_reserved;
+  // A recorded state whose graph plans are reused by new iteration states.
+  OpStatePtr plan_state;
+  // The state used to recompute the iterations that are not recorded.
+  OpStatePtr recompute_state;
+  // The state which ran backward last, its backward buffers are reused.
+  OpStatePtr last_bwd_state;
+  // The forward buffer sizes of an iteration, which the arenas are laid out for.
+  std::vector<size_t> iter_buffer_sizes;
+  // Contiguous memory holding the forward buffers of many iterations.
+  std::vector<NDArray> arenas;
+  // The buffers carved from the arenas.
+  std::vector<NDArray> arena_slices;
+  // The buffers of each iteration slot in the arenas. They are kept across
+  // forward passes so that the engine orders the reuse of the memory.
+  std::vector<std::multimap<size_t, NDArray> > iter_pools;
+  // The next unused slot in iter_pools.
+  size_t next_pool;
+  // Arenas laid out for an old plan, freed once no state uses them.
+  std::vector<NDArray> retired_arenas;
+  std::vector<NDArray> retired_slices;
+
+  std::multimap<size_t, NDArray> NextIterPool(const Context &ctx);
+  OpStatePtr NewIterState(const Context &ctx);
+  OpStatePtr Recompute(int iter_no);
+  void RetireArenas();
+  void ReleaseRetiredArenas();
 
  public:
   explicit LoopState(const Symbol &g);
+  ~LoopState() {
+    RetireArenas();
+    ReleaseRetiredArenas();
+  }
 
+  /*
+   * Give a hint of the number of iterations of the next forward in training,
+   * so that the memory of all the iterations is allocated at once.
+   */
+  void Reserve(size_t num_iterations) {
+    num_reserved = num_iterations;
+  }
   void Forward(int iter_no,
                const std::vector<NDArray> &inputs,
                const std::vector<OpReqType>& req,
@@ -154,6 +281,14 @@ class LoopState {
     all_outputs.clear();
     all_inputs.clear();
     all_states.clear();
+    last_bwd_state = OpStatePtr();
+    recompute_state = OpStatePtr();
+    next_pool = 0;
+    if (!retired_arenas.empty()) {
+      // plan_state may hold buffers of the retired arenas.
+      plan_state = OpStatePtr();
+      ReleaseRetiredArenas();
+    }
   }
   static CachedOpPtr MakeSharedOp(const Symbol &sym) {
     // We turn on static_alloc for two reasons.
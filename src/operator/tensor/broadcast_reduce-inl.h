@@ -184,11 +184,82 @@ void binary_broadcast_compute(const int N, const bool addto, const DType *lhs,
   }
 }
 
+/*! \brief smallest innermost axis for which the output is computed row by row */
+const int kBroadcastMinRowSize = 8;
+/*! \brief smallest output for which broadcast kernels are run in parallel */
+const int kBroadcastMinParallelSize = 1 << 14;
+
+/*!
+ * \brief Compute one row of the output. A null stride means that the operand
+ *  is broadcast along the row. The loops are kept free of index arithmetic
+ *  so that the compiler can vectorize them.
+ */
+template<typename DType, typename OP>
+MSHADOW_XINLINE void binary_broadcast_row(const int W, const bool addto,
+                                          const DType *lhs, const int lstride,
+                                          const DType *rhs, const int rstride,
+                                          DType *out) {
+  if (lstride && rstride) {
+    if (addto) {
+      for (int k = 0; k < W; ++k) out[k] += OP::Map(lhs[k], rhs[k]);
+    } else {
+      for (int k = 0; k < W; ++k) out[k] = OP::Map(lhs[k], rhs[k]);
+    }
+  } else if (rstride) {
+    const DType l = lhs[0];
+    if (addto) {
+      for (int k = 0; k < W; ++k) out[k] += OP::Map(l, rhs[k]);
+    } else {
+      for (int k = 0; k < W; ++k) out[k] = OP::Map(l, rhs[k]);
+    }
+  } else {
+    const DType r = rhs[0];
+    if (addto) {
+      for (int k = 0; k < W; ++k) out[k] += OP::Map(lhs[k], r);
+    } else {
+      for (int k = 0; k < W; ++k) out[k] = OP::Map(lhs[k], r);
+    }
+  }
+}
+
+/*!
+ * \brief Broadcast computed one innermost row of the output at a time: the
+ *  offsets of the operands are computed once per row instead of once per
+ *  element. This covers both the row broadcast (e.g. adding a bias of shape
+ *  (1, C) to (N, C)) and the column broadcast (e.g. (N, C) with (N, 1)).
+ */
+template<int ndim, typename DType, typename OP>
+void binary_broadcast_compute_rows(const int N, const bool addto, const DType *lhs,
+                                   const DType *rhs, DType *out, const Shape<ndim> lshape,
+                                   const Shape<ndim> rshape, const Shape<ndim> oshape) {
+  const int W = oshape[ndim - 1];
+  const int lstride = lshape[ndim - 1] == W ? 1 : 0;
+  const int rstride = rshape[ndim - 1] == W ? 1 : 0;
+  const int rows = N / W;
+  const int omp_threads = N >= kBroadcastMinParallelSize ?
+                          engine::OpenMP::Get()->GetRecommendedOMPThreadCount() : 1;
+  #pragma omp parallel for num_threads(omp_threads)
+  for (int r = 0; r < rows; ++r) {
+    const Shape<ndim> coord = unravel(r * W, oshape);
+    binary_broadcast_row<DType, OP>(W, addto, lhs + ravel(coord, lshape), lstride,
+                                    rhs + ravel(coord, rshape), rstride,
+                                    out + static_cast<index_t>(r) * W);
+  }
+}
+
 template<int ndim, typename DType, typename OP>
 void BinaryBroadcastComputeImpl(Stream<cpu> *s, const OpReqType req,
                                 const TBlob& lhs, const TBlob& rhs, const TBlob& out) {
   if (req == kNullOp) return;
   int N = out.shape_.Size();
+  if (N == 0) return;
+  if (out.shape_[ndim - 1] >= kBroadcastMinRowSize) {
+    binary_broadcast_compute_rows<ndim, DType, OP>(N, req == kAddTo, lhs.dptr<DType>(),
+                                                   rhs.dptr<DType>(), out.dptr<DType>(),
+                                                   lhs.shape_.get<ndim>(), rhs.shape_.get<ndim>(),
+                                                   out.shape_.get<ndim>());
+    return;
+  }
   binary_broadcast_compute<ndim, DType, OP>(N, req == kAddTo, lhs.dptr<DType>(), rhs.dptr<DType>(),
                            out.dptr<DType>(), lhs.shape_.get<ndim>(), rhs.shape_.get<ndim>(),
                            out.shape_.get<ndim>());
@@ -227,10 +298,188 @@ void seq_reduce_compute_extra_mem(const int N, const int M, const bool addto,
   }
 }
 
+/*!
+ * \brief Whether only the innermost axes of big are reduced, in which case
+ *  every element of small is the reduction of a contiguous segment of big.
+ * \param M the length of the segments
+ */
+template<int ndim>
+inline bool IsInnerReduce(const Shape<ndim>& small, const Shape<ndim>& big, int *M) {
+  int i = ndim - 1;
+  *M = 1;
+  for (; i >= 0 && small[i] == 1; --i) *M *= big[i];
+  for (; i >= 0; --i) {
+    if (small[i] != big[i]) return false;
+  }
+  return true;
+}
+
+/*!
+ * \brief Whether only the outermost axes of big are reduced, in which case big
+ *  is a (M, N) matrix reduced into its N columns.
+ * \param M the number of rows of big
+ */
+template<int ndim>
+inline bool IsOuterReduce(const Shape<ndim>& small, const Shape<ndim>& big, int *M) {
+  int i = 0;
+  *M = 1;
+  for (; i < ndim && small[i] == 1; ++i) *M *= big[i];
+  for (; i < ndim; ++i) {
+    if (small[i] != big[i]) return false;
+  }
+  return true;
+}
+
+/*! \brief number of columns whose accumulators are updated together by the outer reduction */
+const int kReduceBlockSize = 256;
+/*! \brief smallest number of elements reduced by one task when a reduction is split */
+const int kReduceMinSplitSize = 1 << 14;
+
+/*!
+ * \brief Number of parts a reduction of M elements into each of N outputs is
+ *  split into, so that all threads are busy even when N is small.
+ */
+inline int ReduceSplitCount(const int N, const int64_t M, const int nthreads) {
+  if (N >= nthreads) return 1;
+  const int64_t nsplit = (nthreads + N - 1) / N;
+  return static_cast<int>(std::max<int64_t>(1, std::min(nsplit, M / kReduceMinSplitSize)));
+}
+
+/*!
+ * \brief Reduce a contiguous segment into val and residual, without
+ *  finalizing the result. Independent accumulators break the dependency
+ *  between consecutive elements so the reduction is not latency bound.
+ */
+template<typename Reducer, typename DType, typename OP>
+MSHADOW_XINLINE void seq_reduce_segment(const DType* __restrict big, const int M,
+                                        DType *val, DType *residual) {
+  const int kLanes = 8;
+  DType lval[kLanes], lres[kLanes];
+  for (int l = 0; l < kLanes; ++l) Reducer::SetInitValue(lval[l], lres[l]);
+  int k = 0;
+  for (; k + kLanes <= M; k += kLanes) {
+    for (int l = 0; l < kLanes; ++l) {
+      Reducer::Reduce(lval[l], OP::Map(big[k + l]), lres[l]);
+    }
+  }
+  for (; k < M; ++k) Reducer::Reduce(lval[0], OP::Map(big[k]), lres[0]);
+  for (int l = 1; l < kLanes; ++l) Reducer::Merge(lval[0], lres[0], lval[l], lres[l]);
+  *val = lval[0];
+  *residual = lres[0];
+}
+
+/*!
+ * \brief Reduction of the innermost axes: small[i] is the reduction of the
+ *  segment big[i * M, (i + 1) * M). When there are fewer outputs than threads,
+ *  the segments are split and the partial results merged.
+ */
+template<typename Reducer, typename DType, typename OP>
+void seq_reduce_compute_inner(const int N, const int M, const bool addto,
+                              const DType *big, DType *small) {
+  const int omp_threads = engine::OpenMP::Get()->GetRecommendedOMPThreadCount();
+  const int nsplit = ReduceSplitCount(N, M, omp_threads);
+  if (nsplit == 1) {
+    #pragma omp parallel for num_threads(omp_threads)
+    for (int idx = 0; idx < N; ++idx) {
+      DType val, residual;
+      seq_reduce_segment<Reducer, DType, OP>(big + static_cast<index_t>(idx) * M, M,
+                                             &val, &residual);
+      Reducer::Finalize(val, residual);
+      assign(&small[idx], addto, val);
+    }
+    return;
+  }
+  const int chunk = (M + nsplit - 1) / nsplit;
+  std::vector<DType> val(N * nsplit), residual(N * nsplit);
+  #pragma omp parallel for num_threads(omp_threads)
+  for (int t = 0; t < N * nsplit; ++t) {
+    const int begin = std::min(M, t % nsplit * chunk);
+    const int end = std::min(M, begin + chunk);
+    seq_reduce_segment<Reducer, DType, OP>(big + static_cast<index_t>(t / nsplit) * M + begin,
+                                           end - begin, &val[t], &residual[t]);
+  }
+  for (int idx = 0; idx < N; ++idx) {
+    const int t = idx * nsplit;
+    for (int i = 1; i < nsplit; ++i) {
+      Reducer::Merge(val[t], residual[t], val[t + i], residual[t + i]);
+    }
+    Reducer::Finalize(val[t], residual[t]);
+    assign(&small[idx], addto, val[t]);
+  }
+}
+
+/*!
+ * \brief Reduction of the outermost axes: small[j] is the reduction of the
+ *  column j of big viewed as a (M, N) matrix. The columns are processed in
+ *  blocks of kReduceBlockSize, so that their accumulators stay in cache while
+ *  the rows are streamed, and the inner loop runs over contiguous memory.
+ *  When there are fewer blocks than threads, the rows are split as well.
+ */
+template<typename Reducer, typename DType, typename OP>
+void seq_reduce_compute_outer(const int N, const int M, const bool addto,
+                              const DType *big, DType *small) {
+  const int omp_threads = engine::OpenMP::Get()->GetRecommendedOMPThreadCount();
+  const int nblocks = (N + kReduceBlockSize - 1) / kReduceBlockSize;
+  const int64_t block_size = static_cast<int64_t>(M) * std::min(N, kReduceBlockSize);
+  const int nsplit = ReduceSplitCount(nblocks, block_size, omp_threads);
+  const int chunk = (M + nsplit - 1) / nsplit;
+  std::vector<DType> val(static_cast<size_t>(N) * nsplit), residual(val.size());
+  #pragma omp parallel for num_threads(omp_threads)
+  for (int t = 0; t < nblocks * nsplit; ++t) {
+    const int begin = t / nsplit * kReduceBlockSize;
+    const int width = std::min(N - begin, kReduceBlockSize);
+    const int row_begin = std::min(M, t % nsplit * chunk);
+    const int row_end = std::min(M, row_begin + chunk);
+    DType* bval = &val[static_cast<size_t>(t % nsplit) * N + begin];
+    DType* bres = &residual[static_cast<size_t>(t % nsplit) * N + begin];
+    for (int j = 0; j < width; ++j) Reducer::SetInitValue(bval[j], bres[j]);
+    for (int k = row_begin; k < row_end; ++k) {
+      const DType* __restrict row = big + static_cast<index_t>(k) * N + begin;
+      for (int j = 0; j < width; ++j) Reducer::Reduce(bval[j], OP::Map(row[j]), bres[j]);
+    }
+  }
+  #pragma omp parallel for num_threads(omp_threads)
+  for (int j = 0; j < N; ++j) {
+    for (int i = 1; i < nsplit; ++i) {
+      Reducer::Merge(val[j], residual[j], val[static_cast<size_t>(i) * N + j],
+                     residual[static_cast<size_t>(i) * N + j]);
+    }
+    Reducer::Finalize(val[j], residual[j]);
+    assign(&small[j], addto, val[j]);
+  }
+}
+
+/*!
+ * \brief Run the reduction with the kernel specialized for its shapes, if
+ *  there is one.
+ * \return false if the generic kernel has to be used
+ */
+template<typename Reducer, int ndim, typename DType, typename OP>
+bool seq_reduce_compute_special(const bool addto, const DType *big, DType *small,
+                                const Shape<ndim>& bshape, const Shape<ndim>& sshape) {
+  const int N = sshape.Size();
+  int M;
+  if (N == 0) return true;
+  if (IsInnerReduce(sshape, bshape, &M)) {
+    seq_reduce_compute_inner<Reducer, DType, OP>(N, M, addto, big, small);
+    return true;
+  }
+  if (IsOuterReduce(sshape, bshape, &M)) {
+    seq_reduce_compute_outer<Reducer, DType, OP>(N, M, addto, big, small);
+    return true;
+  }
+  return false;
+}
+
 template <typename Reducer, int ndim, typename DType, typename OP>
 void Reduce(Stream<cpu>* s, const TBlob& small, const OpReqType req,
             const Tensor<cpu, 1, char>& workspace, const TBlob& big) {
   if (req == kNullOp) return;
+  if (seq_reduce_compute_special<Reducer, ndim, DType, OP>(
+        req == kAddTo, big.dptr<DType>(), small.dptr<DType>(),
+        big.shape_.get<ndim>(), small.shape_.get<ndim>())) {
+    return;
+  }
   Shape<ndim> rshape, rstride;
   diff(small.shape_.get<ndim>(), big.shape_.get<ndim>(), &rshape, &rstride);
   int N = small.shape_.Size(), M = rshape.Size();
@@ -244,6 +493,11 @@ void ReduceWithExtraMem(Stream<cpu>* s, const TBlob& small, const OpReqType req,
                         const Tensor<cpu, 1, char>& workspace, const TBlob& big) {
   using namespace mxnet_op;
   if (req == kNullOp) return;
+  if (seq_reduce_compute_special<Reducer, ndim, DType, OP>(
+        req == kAddTo, big.dptr<DType>(), small.dptr<DType>(),
+        big.shape_.get<ndim>(), small.shape_.get<ndim>())) {
+    return;
+  }
   Shape<ndim> rshape, rstride;
   diff(small.shape_.get<ndim>(), big.shape_.get<ndim>(), &rshape, &rstride);
   index_t* ws_dptr = reinterpret_cast<index_t*>(workspace.dptr_);
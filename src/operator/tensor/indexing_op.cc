@@ -88,6 +88,69 @@ void SparseEmbeddingOpForwardRspImpl<cpu>(const OpContext& ctx,
 }
 
 
+/*!
+ * \brief Row sparse gradient of SparseEmbedding on cpu: the (row, position) pairs
+ *  of the data are sorted so that each non-zero row of the gradient is summed by
+ *  a single thread.
+ */
+template<typename IType, typename DType, typename RType>
+static void SparseEmbeddingBackwardRowsCPU(mshadow::Stream<cpu> *s,
+                                           const TBlob& ograd,
+                                           const TBlob& data,
+                                           const NDArray& output) {
+  using namespace mshadow;
+  using namespace rowsparse;
+  using nnvm::dim_t;
+  const dim_t row_length = output.shape()[1];
+  const dim_t data_size = static_cast<dim_t>(data.shape_.Size());
+  const int omp_threads = engine::OpenMP::Get()->GetRecommendedOMPThreadCount();
+  // check out of bound indices
+  const IType* data_ptr = data.dptr<IType>();
+  {
+    IType min = 0;
+    IType max = static_cast<IType>(output.shape()[0] - 1);
+    // check with single thread is faster since data is small
+    bool is_valid = CheckIndexOutOfBound(data_ptr, data.shape_.Size(), min, max);
+    CHECK(is_valid) << "Embedding input contains data out of bound";
+  }
+  // sort the (row, position) pairs of the data, so that the positions of each
+  // non-zero row of the gradient are contiguous and in ascending order
+  std::vector<std::pair<dim_t, dim_t>> sorted(data_size);
+  #pragma omp parallel for num_threads(omp_threads)
+  for (dim_t i = 0; i < data_size; ++i) {
+    sorted[i] = std::make_pair(static_cast<dim_t>(data_ptr[i]), i);
+  }
+  common::ParallelSort(sorted.begin(), sorted.end(), omp_threads);
+  // the first pair of each non-zero row
+  std::vector<dim_t> row_start;
+  for (dim_t i = 0; i < data_size; ++i) {
+    if (i == 0 || sorted[i].first != sorted[i - 1].first) row_start.push_back(i);
+  }
+  // total number of non-zero rows
+  dim_t nnr = row_start.size();
+  if (nnr == 0) {
+    FillZerosRspImpl(s, output);
+    return;
+  }
+  row_start.push_back(data_size);
+  output.CheckAndAlloc({Shape1(nnr)});
+  RType* grad_row_idx = output.aux_data(kIdx).dptr<RType>();
+  DType* grad_data = output.data().dptr<DType>();
+  const DType* ograd_data = ograd.dptr<DType>();
+  // each non-zero row is computed by a single thread, without prefilling it with zeros
+  const int num_threads = nnr * row_length < kTakeGradMinParallelSize ? 1 : omp_threads;
+  #pragma omp parallel for num_threads(num_threads) schedule(dynamic, 64)
+  for (dim_t r = 0; r < nnr; ++r) {
+    grad_row_idx[r] = static_cast<RType>(sorted[row_start[r]].first);
+    DType* grad_row = grad_data + r * row_length;
+    const DType* first = ograd_data + sorted[row_start[r]].second * row_length;
+    std::copy(first, first + row_length, grad_row);
+    for (dim_t i = row_start[r] + 1; i < row_start[r + 1]; ++i) {
+      AddTakeGradRow(grad_row, ograd_data + sorted[i].second * row_length, row_length);
+    }
+  }
+}
+
 template<>
 inline void SparseEmbeddingOpBackwardRspImpl<cpu>(const bool deterministic,
                                                   const OpContext& ctx,
@@ -95,71 +158,16 @@ inline void SparseEmbeddingOpBackwardRspImpl<cpu>(const bool deterministic,
                                                   const TBlob& data,
                                                   const OpReqType req,
                                                   const NDArray& output) {
-  using namespace mshadow;
-  using namespace mxnet_op;
-  using namespace mshadow::expr;
   using namespace rowsparse;
-  using nnvm::dim_t;
   if (req == kNullOp) return;
   CHECK_EQ(req, kWriteTo) << "SparseEmbedding layer doesn't support "
                           << "weight gradient calculation with req != write";
 
-  // Request temporary storage for marking non-zero rows and prefix sum
-  Stream<cpu> *s = ctx.get_stream<cpu>();
-  dim_t num_rows = output.shape()[0];
-  dim_t row_length = output.shape()[1];
-  size_t workspace_size = num_rows * sizeof(dim_t);
-  Tensor<cpu, 1, char> workspace =
-    ctx.requested[embedding::kTempSpace].get_space_typed<cpu, 1, char>(
-      Shape1(workspace_size), s);
-  dim_t* row_flg = reinterpret_cast<dim_t*>(workspace.dptr_);
-  // prefix sum array re-uses the row_flg array temp space
-  dim_t* prefix_sum = row_flg;
-  dim_t data_size = static_cast<dim_t>(data.shape_.Size());
-
+  mshadow::Stream<cpu> *s = ctx.get_stream<cpu>();
   MSHADOW_TYPE_SWITCH(data.type_flag_, IType, {
     MSHADOW_SGL_DBL_TYPE_SWITCH(ograd.type_flag_, DType, {
       MSHADOW_IDX_TYPE_SWITCH(output.aux_type(kIdx), RType, {
-        // check out of bound indices
-        {
-          IType min = 0;
-          IType max = static_cast<IType>(output.shape()[0] - 1);
-          // check with single thread is faster since data is small
-          IType* data_ptr = data.dptr<IType>();
-          bool is_valid = CheckIndexOutOfBound(data_ptr, data.shape_.Size(), min, max);
-          CHECK(is_valid) << "Embedding input contains data out of bound";
-        }
-        // mark row flags
-        Fill<false>(s, TBlob(row_flg, Shape1(num_rows), cpu::kDevMask), kWriteTo, 0);
-        Kernel<MarkRowFlgKernel, cpu>::Launch(s, data_size, row_flg, data.dptr<IType>());
-        // calculate inclusive prefix sum
-        // TODO(haibin) ideally this is should be done in parallel
-        prefix_sum[0] = row_flg[0];
-        for (dim_t i = 1; i < num_rows; i++) {
-          prefix_sum[i] = prefix_sum[i - 1] + row_flg[i];
-        }
-        // total number of non-zero rows
-        dim_t nnr = prefix_sum[num_rows - 1];
-        if (nnr == 0) {
-          FillZerosRspImpl(s, output);
-          return;
-        }
-        output.CheckAndAlloc({Shape1(nnr)});
-        RType* grad_row_idx = output.aux_data(kIdx).dptr<RType>();
-        // fill row_idx array of output matrix, using the row_flg values
-        Kernel<FillRspRowIdxKernel, cpu>::Launch(s, num_rows,
-            grad_row_idx, prefix_sum, num_rows);
-        // prefill with zeros
-        DType* grad_data = output.data().dptr<DType>();
-        Fill<false>(s, TBlob(grad_data, Shape1(nnr * row_length),
-            cpu::kDevMask), kWriteTo, 0);
-        // add the final gradients
-        const int num_threads = engine::OpenMP::Get()->GetRecommendedOMPThreadCount();
-        dim_t segment_len = (nnr + num_threads - 1) / num_threads;
-        Kernel<AddTakeGradRspKernel, cpu>::Launch(s, num_threads, grad_data, prefix_sum,
-                                                  ograd.dptr<DType>(), row_length,
-                                                  data.dptr<IType>(), data_size, segment_len,
-                                                  num_rows);
+        SparseEmbeddingBackwardRowsCPU<IType, DType, RType>(s, ograd, data, output);
       });
     });
   });
@@ -119,6 +119,39 @@ AddTakeGradLargeBatchWorkspaceSize(size_t num_keys) {
 template <typename IndexType, typename xpu>
 inline typename std::enable_if<std::is_same<xpu, gpu>::value, size_t>::type
 AddTakeGradLargeBatchWorkspaceSize(size_t num_keys);
+/*! \brief smallest gradient update for which the cpu takes gradients are parallel */
+const nnvm::dim_t kTakeGradMinParallelSize = 1 << 15;
+
+/*!
+ * \brief CPU: Split n keys sorted in ascending order into contiguous segments
+ *        to be processed by different threads, such that equal keys are in the
+ *        same segment. No row is then updated by more than one thread.
+ * \param n number of keys
+ * \param row_length the length of the rows updated for each key
+ * \param key the key at a position
+ * \return the bounds of the segments
+ */
+template<typename FKey>
+inline std::vector<nnvm::dim_t> SplitSortedKeys(nnvm::dim_t n, nnvm::dim_t row_length,
+                                                 const FKey& key) {
+  const int num_segments = n * row_length < kTakeGradMinParallelSize ? 1 :
+    engine::OpenMP::Get()->GetRecommendedOMPThreadCount();
+  std::vector<nnvm::dim_t> bounds(1, 0);
+  for (int t = 1; t < num_segments; ++t) {
+    nnvm::dim_t b = std::max(bounds.back(), n * t / num_segments);
+    while (b > 0 && b < n && key(b) == key(b - 1)) ++b;
+    if (b > bounds.back() && b < n) bounds.push_back(b);
+  }
+  bounds.push_back(n);
+  return bounds;
+}
+
+/*! \brief CPU: dst[i] += src[i] for the len elements of a row */
+template<typename DType>
+MSHADOW_XINLINE void AddTakeGradRow(DType* dst, const DType* src, index_t len) {
+  for (index_t i = 0; i < len; ++i) dst[i] += src[i];
+}
+
 /*!
  * \brief CPU/GPU: Gradient accumulate of embedding matrix.
                    dst[sorted[i]] += src[index[i]]
@@ -135,10 +168,66 @@ inline void AddTakeGradLargeBatch(mshadow::Tensor<cpu, 2, DType> dst,
                                   const mshadow::Tensor<cpu, 1, IndexType>& index,
                                   const mshadow::Tensor<cpu, 2, DType> &src,
                                   mshadow::Tensor<cpu, 1, char>* workspace = NULL) {
-  for (index_t y = 0; y < sorted.size(0); ++y) {
-    dst[sorted[y]] += src[index[y]];
+  const nnvm::dim_t num_keys = sorted.size(0);
+  const std::vector<nnvm::dim_t> bounds = SplitSortedKeys(num_keys, dst.size(1),
+    [&sorted](nnvm::dim_t i) { return static_cast<index_t>(sorted[i]); });
+  const int num_segments = bounds.size() - 1;
+  #pragma omp parallel for num_threads(num_segments)
+  for (int t = 0; t < num_segments; ++t) {
+    for (nnvm::dim_t y = bounds[t]; y < bounds[t + 1]; ++y) {
+      AddTakeGradRow(dst[static_cast<index_t>(sorted[y])].dptr_,
+                     src[static_cast<index_t>(index[y])].dptr_, dst.size(1));
+    }
+  }
+}
+
+/*!
+ * \brief CPU/GPU: Gradient accumulate of embedding matrix.
+                   dst[index[i]] += src[i], with the indices clipped to the rows of dst
+ *        On CPU, the indices are sorted so that each row of dst is accumulated by a
+ *        single thread, in the order of the indices.
+ * \param dst destination
+ * \param index the indices
+ * \param src source output
+ */
+template<typename IndexType, typename DType>
+inline void AddTakeGradGrouped(mshadow::Tensor<cpu, 2, DType> dst,
+                               const mshadow::Tensor<cpu, 1, IndexType>& index,
+                               const mshadow::Tensor<cpu, 2, DType> &src) {
+  using nnvm::dim_t;
+  const dim_t num_keys = index.size(0);
+  const dim_t num_rows = dst.size(0);
+  const int omp_threads = engine::OpenMP::Get()->GetRecommendedOMPThreadCount();
+  if (omp_threads == 1 || num_keys * dst.size(1) < kTakeGradMinParallelSize) {
+    AddTakeGrad(dst, index, src);
+    return;
+  }
+  std::vector<std::pair<dim_t, dim_t>> sorted(num_keys);
+  #pragma omp parallel for num_threads(omp_threads)
+  for (dim_t i = 0; i < num_keys; ++i) {
+    dim_t j = static_cast<dim_t>(index[i]);
+    if (j <= 0) j = 0;
+    else if (j >= num_rows) j = num_rows - 1;
+    sorted[i] = std::make_pair(j, i);
+  }
+  common::ParallelSort(sorted.begin(), sorted.end(), omp_threads);
+  const std::vector<dim_t> bounds = SplitSortedKeys(num_keys, dst.size(1),
+    [&sorted](dim_t i) { return sorted[i].first; });
+  const int num_segments = bounds.size() - 1;
+  #pragma omp parallel for num_threads(num_segments)
+  for (int t = 0; t < num_segments; ++t) {
+    for (dim_t y = bounds[t]; y < bounds[t + 1]; ++y) {
+      AddTakeGradRow(dst[sorted[y].first].dptr_, src[sorted[y].second].dptr_, dst.size(1));
+    }
   }
 }
+
+template<typename IndexType, typename DType>
+inline void AddTakeGradGrouped(mshadow::Tensor<gpu, 2, DType> dst,
+                               const mshadow::Tensor<gpu, 1, IndexType>& index,
+                               const mshadow::Tensor<gpu, 2, DType> &src) {
+  AddTakeGrad(dst, index, src);
+}
 template<typename ParamType>
 inline bool EmbeddingOpShape(const nnvm::NodeAttrs& attrs,
                              std::vector<TShape> *in_attrs,
@@ -573,7 +662,7 @@ void EmbeddingOpBackward(const nnvm::NodeAttrs& attrs,
         if (req[embedding::kWeight] == kWriteTo) {
           grad_in = scalar<DType>(0.0f);
         }
-        AddTakeGrad(grad_in, data, grad_out);
+        AddTakeGradGrouped(grad_in, data, grad_out);
       } else {
         LOG(FATAL) << "wrong req";
       }
@@ -581,48 +670,6 @@ void EmbeddingOpBackward(const nnvm::NodeAttrs& attrs,
   });
 }
 
-struct AddTakeGradRspKernel {
-  /*!
-   * \brief Each thread i is responsible for row slices in [segment_start, segment_end)
-            of the result gradient
-   * \param tid             global thread id
-   * \param grad            the gradient to calculate
-   * \param prefix_sum      the inclusive prefix sum of row ids of the gradient
-   * \param ograd           output gradient
-   * \param row_length      the length of the row slices of the gradient
-   * \param data_val        the values of input data
-   * \param data_size       number of values of input data
-   * \param segment_length  the length of row segment to process for each thread
-   * \param nnr             total number of non-zero rows of result gradient
-   */
-  template<typename DType, typename IType>
-  MSHADOW_CINLINE static void Map(int tid,
-                                  DType* grad,
-                                  const nnvm::dim_t* prefix_sum,
-                                  const DType* ograd,
-                                  const nnvm::dim_t row_length,
-                                  const IType* data_val,
-                                  const nnvm::dim_t data_size,
-                                  const nnvm::dim_t segment_length,
-                                  const nnvm::dim_t nnr) {
-    using nnvm::dim_t;
-    dim_t segment_start = tid * segment_length;
-    dim_t segment_end = std::min(nnr, segment_start + segment_length);
-    // scan all data
-    for (dim_t data_i = 0; data_i < data_size; data_i++) {
-      dim_t data = static_cast<dim_t>(data_val[data_i]);
-      dim_t grad_row_id = prefix_sum[data] - 1;
-      if (grad_row_id < segment_start || grad_row_id >= segment_end) continue;
-      // no projection is performed
-      dim_t ograd_i = data_i * row_length;
-      dim_t grad_i = grad_row_id * row_length;
-      for (dim_t offset = 0; offset < row_length; offset++) {
-        grad[grad_i + offset] += ograd[ograd_i + offset];
-      }
-    }
-  }
-};
-
 template<typename xpu>
 inline void SparseEmbeddingOpBackwardRspImpl(const bool deterministic,
                                              const OpContext& ctx,
@@ -1073,7 +1120,7 @@ void TakeOpBackward(const nnvm::NodeAttrs& attrs,
           if (req[take_::kArr] == kWriteTo) {
             grad_in = scalar<DType>(0.0f);
           }
-          AddTakeGrad(grad_in, idx, grad_out);
+          AddTakeGradGrouped(grad_in, idx, grad_out);
         } else {
           LOG(FATAL) << "wrong req";
         }
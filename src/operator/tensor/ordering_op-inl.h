@@ -29,6 +29,7 @@
 #include <dmlc/optional.h>
 #include <mshadow/tensor.h>
 #include <algorithm>
+#include <utility>
 #include <vector>
 #include <type_traits>
 #include "../mshadow_op.h"
@@ -176,43 +177,161 @@ inline void ParseTopKParam(const TShape& src_shape, const TopKParam& param, TSha
 
 using namespace mshadow;
 
+/*! \brief largest K for which the top-K of a row are selected with a heap */
+const int kTopKHeapMaxK = 256;
+/*! \brief number of elements compared to the heap threshold at once */
+const int kTopKFilterBlock = 64;
+/*! \brief smallest row for which the heap selection of a single row is split among threads */
+const int kTopKMinSplitRow = 1 << 16;
+/*! \brief smallest input for which the rows are processed in parallel */
+const int kTopKMinParallelSize = 1 << 14;
+
+/*!
+ * \brief Order of the top-K elements: by value, and by index for equal
+ *  values, so that the result does not depend on the selection algorithm.
+ */
+template<typename DType, bool is_ascend>
+struct TopKBetter {
+  MSHADOW_XINLINE static bool Value(const DType& a, const DType& b) {
+    return is_ascend ? a < b : a > b;
+  }
+  bool operator()(const std::pair<DType, int>& a, const std::pair<DType, int>& b) const {
+    return Value(a.first, b.first) || (a.first == b.first && a.second < b.second);
+  }
+};
+
+/*!
+ * \brief Select the K best elements of vals[begin, end) into heap, a heap whose
+ *  front is the worst of them. Elements are first compared in blocks to the
+ *  worst selected value, which most of them do not beat once the heap is full.
+ */
+template<typename DType, bool is_ascend>
+void TopKHeapSelect(const DType *vals, int begin, int end, int K,
+                    std::vector<std::pair<DType, int>> *heap) {
+  typedef TopKBetter<DType, is_ascend> Better;
+  heap->clear();
+  const int first_end = std::min(end, begin + K);
+  for (int j = begin; j < first_end; ++j) heap->emplace_back(vals[j], j);
+  std::make_heap(heap->begin(), heap->end(), Better());
+  if (first_end == end) return;
+  DType threshold = heap->front().first;
+  for (int j = first_end; j < end; j += kTopKFilterBlock) {
+    const int block_end = std::min(end, j + kTopKFilterBlock);
+    bool any = false;
+    for (int l = j; l < block_end; ++l) any |= Better::Value(vals[l], threshold);
+    if (!any) continue;
+    for (int l = j; l < block_end; ++l) {
+      // Later elements equal to the threshold lose against it, as their index is larger.
+      if (Better::Value(vals[l], threshold)) {
+        std::pop_heap(heap->begin(), heap->end(), Better());
+        heap->back() = std::make_pair(vals[l], l);
+        std::push_heap(heap->begin(), heap->end(), Better());
+        threshold = heap->front().first;
+      }
+    }
+  }
+}
+
+/*!
+ * \brief Sort the top-K elements of a row of N values into sorted_vals and
+ *  indices, which receive the index of the elements in the batch.
+ *  Depending on K, this uses a heap, a selection followed by the sort of the
+ *  K selected elements, or a full sort. buf is a scratch buffer.
+ */
+template<typename DType, bool is_ascend>
+void TopKSortRow(const DType *vals, int row, int K, int N, DType *sorted_vals, int *indices,
+                 std::vector<std::pair<DType, int>> *buf) {
+  typedef TopKBetter<DType, is_ascend> Better;
+  const DType *row_vals = vals + static_cast<index_t>(row) * N;
+  if (K <= kTopKHeapMaxK && K * 8 <= N) {
+    TopKHeapSelect<DType, is_ascend>(row_vals, 0, N, K, buf);
+    std::sort_heap(buf->begin(), buf->end(), Better());
+  } else {
+    buf->resize(N);
+    for (int j = 0; j < N; ++j) (*buf)[j] = std::make_pair(row_vals[j], j);
+    if (K * 8 > N) {
+      std::sort(buf->begin(), buf->end(), Better());
+    } else {
+      std::nth_element(buf->begin(), buf->begin() + K - 1, buf->end(), Better());
+      std::sort(buf->begin(), buf->begin() + K, Better());
+    }
+  }
+  for (int j = 0; j < K; ++j) {
+    sorted_vals[j] = (*buf)[j].first;
+    indices[j] = row * N + (*buf)[j].second;
+  }
+}
+
+/*!
+ * \brief Heap selection of the top-K elements of a single row, split among
+ *  threads: every thread selects the top-K of a chunk of the row, then the
+ *  candidates are merged.
+ */
+template<typename DType, bool is_ascend>
+void TopKSortSplitRow(const DType *vals, int row, int K, int N, DType *sorted_vals,
+                      int *indices, int nthreads) {
+  typedef TopKBetter<DType, is_ascend> Better;
+  const DType *row_vals = vals + static_cast<index_t>(row) * N;
+  const int chunk = (N + nthreads - 1) / nthreads;
+  std::vector<std::vector<std::pair<DType, int>>> heaps(nthreads);
+  #pragma omp parallel for num_threads(nthreads)
+  for (int t = 0; t < nthreads; ++t) {
+    const int begin = std::min(N, t * chunk);
+    TopKHeapSelect<DType, is_ascend>(row_vals, begin, std::min(N, begin + chunk), K, &heaps[t]);
+  }
+  std::vector<std::pair<DType, int>> candidates;
+  for (const auto& heap : heaps) candidates.insert(candidates.end(), heap.begin(), heap.end());
+  std::partial_sort(candidates.begin(), candidates.begin() + K, candidates.end(), Better());
+  for (int j = 0; j < K; ++j) {
+    sorted_vals[j] = candidates[j].first;
+    indices[j] = row * N + candidates[j].second;
+  }
+}
+
+template<typename DType, bool is_ascend>
+void TopKSortRows(const DType *vals, int M, int K, int N, DType *sorted_vals, int *indices) {
+  const int omp_threads(engine::OpenMP::Get()->GetRecommendedOMPThreadCount());
+  const bool heap_select = K <= kTopKHeapMaxK && K * 8 <= N;
+  if (heap_select && M < omp_threads && N >= kTopKMinSplitRow && N / omp_threads >= K * 8) {
+    // Too few rows to keep the threads busy: split the rows instead.
+    for (int i = 0; i < M; ++i) {
+      const index_t offset = static_cast<index_t>(i) * N;
+      TopKSortSplitRow<DType, is_ascend>(vals, i, K, N, sorted_vals + offset, indices + offset,
+                                         omp_threads);
+    }
+    return;
+  }
+  const int nthreads = M > 1 && static_cast<int64_t>(M) * N >= kTopKMinParallelSize ?
+                       std::min(M, omp_threads) : 1;
+  #pragma omp parallel num_threads(nthreads)
+  {
+    std::vector<std::pair<DType, int>> buf;
+    #pragma omp for
+    for (int i = 0; i < M; ++i) {
+      const index_t offset = static_cast<index_t>(i) * N;
+      TopKSortRow<DType, is_ascend>(vals, i, K, N, sorted_vals + offset, indices + offset, &buf);
+    }
+  }
+}
+
+/*!
+ * \brief Sort the top-K elements of every row of N values of work, the
+ *  flattened source data, into the first K elements of the rows of dat and
+ *  ind. The indices do not need to be initialized.
+ */
 template<typename DType>
 MSHADOW_FORCE_INLINE void TopKSort(const Tensor<cpu, 1, DType>& dat,
                                    const Tensor<cpu, 1, int>& ind,
                                    const Tensor<cpu, 1, char>& work,
                                    int K, int N, bool is_ascend,
                                    Stream<cpu> *s) {
-  // Use full sort when K is relatively large.
-  const bool full_sort(K*8 > N);
   // Batch size.
   const int M(work.size(0)/(sizeof(DType)*N));
-  const int omp_threads(engine::OpenMP::Get()->GetRecommendedOMPThreadCount());
-  #pragma omp parallel for num_threads(omp_threads)
-  for (int i = 0; i < M; ++i) {
-    // Tensor `work` stores the flattened source data, while `dat` stores the sorted result.
-    DType *vals = reinterpret_cast<DType*>(work.dptr_);
-    DType *sorted_vals = dat.dptr_+i*N;
-    int *indices = ind.dptr_+i*N;
-    if (is_ascend) {
-      if (full_sort) {
-        std::sort(indices, indices+N,
-                  [&](const int& i1, const int& i2){ return vals[i1] < vals[i2]; });
-      } else {
-        std::partial_sort(indices, indices+K, indices+N,
-                          [&](const int& i1, const int& i2){ return vals[i1] < vals[i2]; });
-      }
-    } else {
-      if (full_sort) {
-        std::sort(indices, indices+N,
-                  [&](const int& i1, const int& i2){ return vals[i1] > vals[i2]; });
-      } else {
-        std::partial_sort(indices, indices+K, indices+N,
-                          [&](const int& i1, const int& i2){ return vals[i1] > vals[i2]; });
-      }
-    }
-    for (int j = 0; j < K; ++j) {
-      sorted_vals[j] = vals[indices[j]];
-    }
+  const DType *vals = reinterpret_cast<DType*>(work.dptr_);
+  if (is_ascend) {
+    TopKSortRows<DType, true>(vals, M, K, N, dat.dptr_, ind.dptr_);
+  } else {
+    TopKSortRows<DType, false>(vals, M, K, N, dat.dptr_, ind.dptr_);
   }
 }
 
@@ -438,8 +557,11 @@ void TopKImpl(const RunContext &ctx,
     workspace_curr_ptr += temp_size;
   }
 
-  mxnet_op::Kernel<range_fwd, xpu>::Launch(s, batch_size * element_num, 1, 0, 1,
-    kWriteTo, indices.dptr_);
+  // The cpu sort computes the indices of the elements it selects.
+  if (!std::is_same<xpu, cpu>::value) {
+    mxnet_op::Kernel<range_fwd, xpu>::Launch(s, batch_size * element_num, 1, 0, 1,
+      kWriteTo, indices.dptr_);
+  }
   CHECK_EQ(indices.CheckContiguous(), true);
 
   // 2. Perform inplace batch sort.
@@ -0,0 +1,135 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ *  \file random_generator.cc
+ *  \brief Tests and throughput run of the cpu counter-based random generator
+ */
+
+#include <gtest/gtest.h>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "../include/test_perf.h"
+#include "../include/test_util.h"
+#include "../../src/common/random_generator.h"
+
+using namespace mxnet;
+using mxnet::common::random::Philox4x32;
+using mxnet::common::random::RandGenerator;
+
+/*!
+ * \brief Known answers of Philox4x32-10 from the Random123 distribution
+ */
+TEST(RandomGenerator, PhiloxKnownAnswers) {
+  const uint32_t keys[3][2] = {
+    {0, 0}, {0xffffffff, 0xffffffff}, {0xa4093822, 0x299f31d0}
+  };
+  const uint32_t counters[3][4] = {
+    {0, 0, 0, 0},
+    {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+    {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}
+  };
+  const uint32_t expected[3][4] = {
+    {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8},
+    {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd},
+    {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}
+  };
+  for (int i = 0; i < 3; ++i) {
+    uint32_t out[4];
+    Philox4x32::Block(keys[i], counters[i], out);
+    for (int j = 0; j < 4; ++j) EXPECT_EQ(expected[i][j], out[j]);
+  }
+}
+
+/*!
+ * \brief The batched generation and the sequential draws of a stream match the
+ *  block of each counter
+ */
+TEST(RandomGenerator, PhiloxStream) {
+  const uint32_t key[2] = {42, 7};
+  const int num_blocks = 3 * Philox4x32::kLanes + 5;
+  std::vector<uint32_t> batch(4 * num_blocks);
+  Philox4x32::Generate(key, 0, num_blocks, batch.data());
+  Philox4x32 engine(42, 7);
+  for (int n = 0; n < num_blocks; ++n) {
+    const uint32_t counter[4] = {static_cast<uint32_t>(n), 0, 0, 0};
+    uint32_t block[4];
+    Philox4x32::Block(key, counter, block);
+    for (int j = 0; j < 4; ++j) {
+      EXPECT_EQ(block[j], batch[4 * n + j]);
+      EXPECT_EQ(block[j], engine());
+    }
+  }
+}
+
+/*!
+ * \brief The states of RandGenerator<cpu> are distinct streams, reproducible from the seed
+ *  whatever the order in which they are drawn from
+ */
+TEST(RandomGenerator, CPUStatesReproducible) {
+  const int num_states = RandGenerator<cpu, float>::kNumRandomStates;
+  const int draws = 16;
+  RandGenerator<cpu, float> gen1, gen2;
+  RandGenerator<cpu, float>::AllocState(&gen1);
+  RandGenerator<cpu, float>::AllocState(&gen2);
+  gen1.Seed(nullptr, 1234);
+  gen2.Seed(nullptr, 1234);
+  std::vector<float> forward(num_states * draws), backward(num_states * draws);
+  for (int i = 0; i < num_states; ++i) {
+    RandGenerator<cpu, float>::Impl impl(&gen1, i);
+    for (int j = 0; j < draws; ++j) forward[i * draws + j] = impl.uniform();
+  }
+  for (int i = num_states - 1; i >= 0; --i) {
+    RandGenerator<cpu, float>::Impl impl(&gen2, i);
+    for (int j = 0; j < draws; ++j) backward[i * draws + j] = impl.uniform();
+  }
+  double sum = 0;
+  for (size_t i = 0; i < forward.size(); ++i) {
+    EXPECT_EQ(forward[i], backward[i]);
+    EXPECT_GE(forward[i], 0.0f);
+    EXPECT_LT(forward[i], 1.0f);
+    sum += forward[i];
+  }
+  EXPECT_NEAR(sum / forward.size(), 0.5, 0.01);
+  EXPECT_NE(forward[0], forward[draws]);
+  RandGenerator<cpu, float>::FreeState(&gen1);
+  RandGenerator<cpu, float>::FreeState(&gen2);
+}
+
+/*!
+ * \brief Throughput of uniform float sampling, Philox against the Mersenne Twister
+ */
+TEST(RandomGenerator, TimingCPU) {
+  const size_t count = test::performance_run ? (1 << 26) : (1 << 20);
+  std::uniform_real_distribution<float> dist;
+  float sum = 0;
+  std::mt19937 mt(17);
+  uint64_t start = test::perf::getMicroTickCount();
+  for (size_t i = 0; i < count; ++i) sum += dist(mt);
+  const uint64_t mt_us = test::perf::getMicroTickCount() - start;
+  Philox4x32 philox(17);
+  start = test::perf::getMicroTickCount();
+  for (size_t i = 0; i < count; ++i) {
+    sum += mxnet::common::random::UniformFromBits(&philox, 0.0f);
+  }
+  const uint64_t philox_us = test::perf::getMicroTickCount() - start;
+  std::cout << count << " uniform floats: mt19937 " << mt_us << " us, philox4x32 "
+            << philox_us << " us (" << sum << ")" << std::endl;
+}
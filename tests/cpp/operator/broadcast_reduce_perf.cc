@@ -0,0 +1,201 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ *  \file broadcast_reduce_perf.cc
+ *  \brief Perf/profile run of the CPU broadcast and reduce kernels, comparing
+ *   the kernels specialized for inner/outer reductions and row broadcasts
+ *   with the generic ones.
+ */
+
+#include <gtest/gtest.h>
+#include <mxnet/tensor_blob.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../include/test_perf.h"
+#include "../include/test_util.h"
+#include "../../src/operator/tensor/broadcast_reduce-inl.h"
+
+using namespace mxnet;
+using namespace mxnet::op;
+
+namespace {
+
+/*! \brief a float array and its blob */
+struct TestArray {
+  explicit TestArray(const TShape &shape) : data(shape.Size()),
+    blob(data.data(), shape, cpu::kDevMask) {
+    for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<float>(i % 97) / 97 - 0.5f;
+  }
+  std::vector<float> data;
+  TBlob blob;
+};
+
+template<typename Reducer>
+void ReduceGeneric(const TBlob &small, const TBlob &big) {
+  Shape<2> rshape, rstride;
+  broadcast::diff(small.shape_.get<2>(), big.shape_.get<2>(), &rshape, &rstride);
+  broadcast::seq_reduce_compute<Reducer, 2, float, mshadow_op::identity>(
+    small.Size(), rshape.Size(), false, big.dptr<float>(), small.dptr<float>(),
+    big.shape_.get<2>(), small.shape_.get<2>(), rshape, rstride);
+}
+
+template<typename Reducer>
+void ReduceSpecial(const TBlob &small, const TBlob &big) {
+  mshadow::Tensor<cpu, 1, char> workspace;
+  broadcast::Reduce<Reducer, 2, float, mshadow_op::identity>(
+    nullptr, small, kWriteTo, workspace, big);
+}
+
+void BroadcastGeneric(const TBlob &lhs, const TBlob &rhs, const TBlob &out) {
+  broadcast::binary_broadcast_compute<2, float, mshadow_op::plus>(
+    out.Size(), false, lhs.dptr<float>(), rhs.dptr<float>(), out.dptr<float>(),
+    lhs.shape_.get<2>(), rhs.shape_.get<2>(), out.shape_.get<2>());
+}
+
+void BroadcastSpecial(const TBlob &lhs, const TBlob &rhs, const TBlob &out) {
+  broadcast::BinaryBroadcastComputeImpl<2, float, mshadow_op::plus>(
+    nullptr, kWriteTo, lhs, rhs, out);
+}
+
+void ExpectNear(const std::vector<float> &expected, const std::vector<float> &actual) {
+  ASSERT_EQ(expected.size(), actual.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_NEAR(expected[i], actual[i], 1e-3f * (1 + std::fabs(expected[i]))) << "at " << i;
+  }
+}
+
+template<typename Reducer>
+void CheckReduce(const TShape &big_shape, const TShape &small_shape) {
+  TestArray big(big_shape), expected(small_shape), actual(small_shape);
+  ReduceGeneric<Reducer>(expected.blob, big.blob);
+  ReduceSpecial<Reducer>(actual.blob, big.blob);
+  ExpectNear(expected.data, actual.data);
+}
+
+void CheckBroadcast(const TShape &lhs_shape, const TShape &rhs_shape) {
+  TShape out_shape(2);
+  for (int i = 0; i < 2; ++i) out_shape[i] = std::max(lhs_shape[i], rhs_shape[i]);
+  TestArray lhs(lhs_shape), rhs(rhs_shape), expected(out_shape), actual(out_shape);
+  BroadcastGeneric(lhs.blob, rhs.blob, expected.blob);
+  BroadcastSpecial(lhs.blob, rhs.blob, actual.blob);
+  ExpectNear(expected.data, actual.data);
+}
+
+/*! \brief average time in microseconds of a run of f */
+template<typename F>
+uint64_t Time(F f, const size_t count) {
+  f();  // prime code and cache
+  const uint64_t start = test::perf::getMicroTickCount();
+  for (size_t i = 0; i < count; ++i) f();
+  return (test::perf::getMicroTickCount() - start) / count;
+}
+
+void PrintTiming(const std::string &label, const TShape &big_shape, const TShape &small_shape,
+                 uint64_t generic_us, uint64_t special_us) {
+  std::cout << label << " " << big_shape << " -> " << small_shape
+            << ": generic " << generic_us << " us, specialized " << special_us << " us"
+            << std::endl;
+}
+
+}  // namespace
+
+TEST(BROADCAST_REDUCE_PERF, InnerReduce) {
+  CheckReduce<mshadow::red::sum>(TShape({37, 1000}), TShape({37, 1}));
+  CheckReduce<mshadow::red::maximum>(TShape({37, 1000}), TShape({37, 1}));
+  // Fewer outputs than threads: the segments are split.
+  CheckReduce<mshadow::red::sum>(TShape({1, 100000}), TShape({1, 1}));
+  CheckReduce<mshadow_op::nrm2>(TShape({2, 100000}), TShape({2, 1}));
+  CheckReduce<mshadow::red::sum>(TShape({5, 3}), TShape({5, 1}));
+}
+
+TEST(BROADCAST_REDUCE_PERF, OuterReduce) {
+  CheckReduce<mshadow::red::sum>(TShape({1000, 37}), TShape({1, 37}));
+  CheckReduce<mshadow::red::minimum>(TShape({1000, 600}), TShape({1, 600}));
+  // Fewer column blocks than threads: the rows are split.
+  CheckReduce<mshadow::red::sum>(TShape({100000, 3}), TShape({1, 3}));
+  CheckReduce<mshadow_op::nrm2>(TShape({100000, 3}), TShape({1, 3}));
+}
+
+TEST(BROADCAST_REDUCE_PERF, RowBroadcast) {
+  CheckBroadcast(TShape({300, 64}), TShape({1, 64}));
+  CheckBroadcast(TShape({300, 64}), TShape({300, 1}));
+  CheckBroadcast(TShape({1, 64}), TShape({300, 64}));
+  CheckBroadcast(TShape({300, 1}), TShape({1, 64}));
+  CheckBroadcast(TShape({300, 4}), TShape({1, 4}));
+}
+
+TEST(BROADCAST_REDUCE_PERF, TimingCPU) {
+  std::vector<std::pair<TShape, TShape>> reductions;
+  size_t count;
+  if (test::performance_run) {
+    reductions = {
+      {{1024, 1024}, {1024, 1}},
+      {{64, 65536}, {64, 1}},
+      {{1, 4194304}, {1, 1}},
+      {{1024, 1024}, {1, 1024}},
+      {{65536, 64}, {1, 64}},
+      {{4194304, 1}, {1, 1}}
+    };
+    count = 50;
+  } else {
+    reductions = {
+      {{128, 128}, {128, 1}},
+      {{128, 128}, {1, 128}}
+    };
+    count = 2;
+  }
+  for (const auto &shapes : reductions) {
+    TestArray big(shapes.first), small(shapes.second);
+    const uint64_t generic_us = Time([&]() {
+      ReduceGeneric<mshadow::red::sum>(small.blob, big.blob);
+    }, count);
+    const uint64_t special_us = Time([&]() {
+      ReduceSpecial<mshadow::red::sum>(small.blob, big.blob);
+    }, count);
+    PrintTiming("sum", shapes.first, shapes.second, generic_us, special_us);
+  }
+  std::vector<std::pair<TShape, TShape>> broadcasts;
+  if (test::performance_run) {
+    broadcasts = {
+      {{1024, 1024}, {1, 1024}},
+      {{1024, 1024}, {1024, 1}},
+      {{65536, 64}, {1, 64}},
+      {{64, 65536}, {64, 1}}
+    };
+  } else {
+    broadcasts = {
+      {{128, 128}, {1, 128}},
+      {{128, 128}, {128, 1}}
+    };
+  }
+  for (const auto &shapes : broadcasts) {
+    TestArray lhs(shapes.first), rhs(shapes.second), out(shapes.first);
+    const uint64_t generic_us = Time([&]() {
+      BroadcastGeneric(lhs.blob, rhs.blob, out.blob);
+    }, count);
+    const uint64_t special_us = Time([&]() {
+      BroadcastSpecial(lhs.blob, rhs.blob, out.blob);
+    }, count);
+    PrintTiming("plus", shapes.first, shapes.second, generic_us, special_us);
+  }
+}
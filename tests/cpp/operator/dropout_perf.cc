@@ -82,6 +82,37 @@ TEST(DROPOUT_PERF, TimingCPU) {
   }
 }
 
+/*!
+ * \brief DropoutOp timing test for CPU with a bit-packed mask
+ */
+TEST(DROPOUT_PERF, TimingPackedMaskCPU) {
+  kwargs_t kwargs = basic_dropout_args;
+  kwargs.push_back({"mode", "always"});
+  kwargs.push_back({"packed_mask", "true"});
+  kwargs = test::op::CoreOpExecutor<float>::ArgsWithOpName(kwargs, "Dropout",
+                                                           "_backward_Dropout");
+  test::op::CoreOperatorRunner<float> runner;
+  runner.RunBidirectional(false, { TShape({10, 10, 10, 10}) }, kwargs, 1);
+  std::vector <TShape> shapes;
+  if (test::performance_run) {
+    shapes = {
+      {1,  1, 28,  28},
+      {50, 3, 18,  32},
+      {20, 3, 128, 128},
+      {32, 128, 1024}
+    };
+  } else {
+    shapes = {
+      {1,  1, 28,  28},
+      {50, 3, 18,  32},
+    };
+  }
+  for (const TShape &shape : shapes) {
+    runner.TimingTest("Dropout Operator CPU, packed mask", false, false, kwargs, 2, 10,
+                      { shape }, false);
+  }
+}
+
 #if MXNET_USE_CUDA == 1
 /*!
  * \brief DropoutOp timing test for GPU
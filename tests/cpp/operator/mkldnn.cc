@@ -88,6 +88,23 @@ TEST(MKLDNN_UTIL_FUNC, AlignMem) {
 #endif
 }
 
+TEST(MKLDNN_UTIL_FUNC, PrimitiveCache) {
+  MKLDNNPrimitiveCache<int, int, std::hash<int>> cache("PrimitiveCacheTest", 2);
+  int num_created = 0;
+  auto create = [&num_created]() { return ++num_created; };
+  EXPECT_EQ(cache.GetOrCreate(1, create), 1);
+  EXPECT_EQ(cache.GetOrCreate(2, create), 2);
+  // A hit makes 1 the most recently used entry.
+  EXPECT_EQ(cache.GetOrCreate(1, create), 1);
+  EXPECT_EQ(num_created, 2);
+  // 2 is evicted to make room for 3.
+  EXPECT_EQ(cache.GetOrCreate(3, create), 3);
+  EXPECT_EQ(cache.size(), 2U);
+  EXPECT_EQ(cache.GetOrCreate(1, create), 1);
+  EXPECT_EQ(cache.GetOrCreate(2, create), 4);
+  EXPECT_EQ(num_created, 4);
+}
+
 TEST(MKLDNN_UTIL_FUNC, MemFormat) {
   // Check whether the number of format is correct.
   CHECK_EQ(mkldnn_format_last, 67);
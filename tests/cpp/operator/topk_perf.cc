@@ -0,0 +1,82 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ *  \file topk_perf.cc
+ *  \brief Perf/profile run of the topk operator across batch sizes, row
+ *   lengths and K
+ */
+
+#include <gtest/gtest.h>
+#include <mxnet/tensor_blob.h>
+#include <string>
+#include <vector>
+#include "../include/test_op_runner.h"
+#include "../include/test_core_op.h"
+
+using namespace mxnet;
+
+using kwargs_t = test::op::kwargs_t;
+
+static kwargs_t TopKArgs(const int k) {
+  const kwargs_t args = { {"k", std::to_string(k)}, {"axis", "-1"}, {"ret_typ", "both"} };
+  return test::op::CoreOpExecutor<float>::ArgsWithOpName(args, "topk",
+                                                          COREOP_BWD_OP_NAME_VALUE_NONE);
+}
+
+/*!
+ * \brief Generic forward sanity test
+ */
+TEST(TOPK_PERF, ExecuteForward) {
+  test::op::CoreOperatorRunner<float> runner;
+  runner.RunBidirectional(false, { TShape({4, 1000}) }, TopKArgs(5), 1);
+}
+
+/*!
+ * \brief topk timing test for CPU: small K is selected with a heap, larger K
+ *  with a partial selection and K close to the row length with a full sort
+ */
+TEST(TOPK_PERF, TimingCPU) {
+  test::op::CoreOperatorRunner<float> runner;
+  runner.RunBidirectional(false, { TShape({4, 1000}) }, TopKArgs(5), 1);  // prime code and cache
+  std::vector<TShape> shapes;
+  std::vector<int> ks;
+  if (test::performance_run) {
+    shapes = {
+      {1, 200000},
+      {10, 200000},
+      {64, 50000},
+      {256, 1000}
+    };
+    ks = {1, 5, 50, 1000, 10000};
+  } else {
+    shapes = {
+      {1, 20000},
+      {10, 2000}
+    };
+    ks = {5, 1000};
+  }
+  for (const TShape &shape : shapes) {
+    for (const int k : ks) {
+      if (k > static_cast<int>(shape[1])) continue;
+      runner.TimingTest("topk k=" + std::to_string(k) + " Operator CPU", false, false,
+                        TopKArgs(k), 2, 10, { shape }, false);
+    }
+  }
+}
@@ -426,5 +426,82 @@ def test_non_mkldnn_fcomputeex():
     exec1.forward()[0].wait_to_read()
 
 
+@with_seed()
+def test_subgraph_conv_fusion():
+    def get_executor(sym, shapes, backend=None):
+        if backend is not None:
+            os.environ['MXNET_SUBGRAPH_BACKEND'] = backend
+        exe = sym.simple_bind(ctx=mx.cpu(), grad_req='null', **shapes)
+        if backend is not None:
+            del os.environ['MXNET_SUBGRAPH_BACKEND']
+        return exe
+
+    def check_fusion(sym, shapes, num_fused):
+        exe = get_executor(sym, shapes)
+        fused_exe = get_executor(sym, shapes, 'MKLDNN')
+        assert fused_exe.debug_str().count('Op:_sg_mkldnn_conv') == num_fused
+        for name, arr in list(exe.arg_dict.items()) + list(exe.aux_dict.items()):
+            arr[:] = mx.nd.random.uniform(0.1, 1, shape=arr.shape)
+        for name, arr in exe.arg_dict.items():
+            fused_exe.arg_dict[name][:] = arr
+        for name, arr in exe.aux_dict.items():
+            fused_exe.aux_dict[name][:] = arr
+        exe.forward(is_train=False)
+        fused_exe.forward(is_train=False)
+        assert_almost_equal(exe.outputs[0].asnumpy(), fused_exe.outputs[0].asnumpy(),
+                            rtol=1e-4, atol=1e-4)
+
+    data = mx.sym.var('data')
+    shapes = {'data': (2, 4, 10, 10)}
+    conv = mx.sym.Convolution(data, kernel=(3, 3), pad=(1, 1), num_filter=4, name='conv')
+    bn = mx.sym.BatchNorm(conv, fix_gamma=False, name='bn')
+    # conv + bn + relu
+    check_fusion(mx.sym.Activation(bn, act_type='relu'), shapes, 1)
+    # conv + bn + sum + relu, with a residual connection
+    check_fusion(mx.sym.Activation(bn + data, act_type='relu'), shapes, 1)
+    # conv + relu + sum
+    check_fusion(mx.sym.Activation(conv, act_type='relu') + data, shapes, 1)
+    # the convolution output is also used elsewhere, so nothing is fused
+    check_fusion(mx.sym.Group([conv, mx.sym.Activation(conv, act_type='relu')]), shapes, 0)
+
+
+@with_seed()
+def test_inference_weights_shared_by_executors():
+    data = mx.sym.var('data')
+    conv = mx.sym.Convolution(data, kernel=(3, 3), pad=(1, 1), num_filter=32, name='conv')
+    sym = mx.sym.FullyConnected(conv, num_hidden=16, name='fc')
+    weights = {'conv_weight': mx.nd.random.uniform(-1, 1, shape=(32, 16, 3, 3)),
+               'conv_bias': mx.nd.random.uniform(-1, 1, shape=(32,)),
+               'fc_weight': mx.nd.random.uniform(-1, 1, shape=(16, 32 * 8 * 8)),
+               'fc_bias': mx.nd.random.uniform(-1, 1, shape=(16,))}
+    expected_weights = {name: arr.asnumpy() for name, arr in weights.items()}
+    data1 = mx.nd.random.uniform(shape=(1, 16, 8, 8))
+    data8 = mx.nd.concat(*([data1] * 8), dim=0)
+    # Both executors use the same weight arrays, with primitives of different batch sizes.
+    args1 = dict(weights, data=data1)
+    args8 = dict(weights, data=data8)
+    exe1 = sym.bind(mx.cpu(), args=args1, grad_req='null')
+    exe8 = sym.bind(mx.cpu(), args=args8, grad_req='null')
+    for _ in range(2):
+        out1 = exe1.forward(is_train=False)[0].asnumpy()
+        out8 = exe8.forward(is_train=False)[0].asnumpy()
+        for i in range(8):
+            assert_almost_equal(out8[i], out1[0], rtol=1e-4, atol=1e-4)
+    # The weights are reordered in copies, the arrays keep their content and layout.
+    for name, arr in weights.items():
+        assert_almost_equal(arr.asnumpy(), expected_weights[name])
+    # New values of the weights are picked up by the next forward of both executors.
+    weights['conv_weight'][:] = weights['conv_weight'] * 2
+    weights['conv_bias'][:] = weights['conv_bias'] * 2
+    weights['fc_weight'][:] = weights['fc_weight'] * 3
+    weights['fc_bias'][:] = 0
+    expected = (out1 - expected_weights['fc_bias']) * 6
+    new_out1 = exe1.forward(is_train=False)[0].asnumpy()
+    new_out8 = exe8.forward(is_train=False)[0].asnumpy()
+    assert_almost_equal(new_out1, expected, rtol=1e-4, atol=1e-3)
+    for i in range(8):
+        assert_almost_equal(new_out8[i], expected[0], rtol=1e-4, atol=1e-3)
+
+
 if __name__ == '__main__':
     install.test_mkldnn_install()
@@ -269,8 +269,11 @@ def test_quantized_pooling():
 @with_seed()
 def test_quantized_fc():
     def check_quantized_fc(data_shape, num_hidden, no_bias, qdtype, flatten=True):
-        if mx.current_context().device_type != 'gpu':
-            print('skipped testing quantized_fc on cpu since it is not supported yet')
+        if is_test_for_native_cpu():
+            print('skipped testing quantized_fc for native cpu since it is not supported yet')
+            return
+        elif qdtype == 'int8' and is_test_for_mkldnn():
+            print('skipped testing quantized_fc for mkldnn cpu int8 since it is not supported yet')
             return
         elif qdtype == 'uint8' and is_test_for_gpu():
             print('skipped testing quantized_fc for gpu uint8 since it is not supported yet')
@@ -296,7 +299,7 @@ def test_quantized_fc():
                                                                          shape=arg_shapes[2]).astype('int32')
         output = fc_fp32_exe.forward()[0]
 
-        qdata = mx.sym.Variable(name='qdata', shape=data_shape, dtype='int8')
+        qdata = mx.sym.Variable(name='qdata', shape=data_shape, dtype=qdtype)
         fc_int8 = mx.sym.contrib.quantized_fully_connected(data=qdata, num_hidden=num_hidden,
                                                            no_bias=no_bias, flatten=flatten)
         qarg_names = fc_int8.list_arguments()
@@ -363,6 +366,69 @@ def test_quantized_flatten():
         check_quantized_flatten((3, 4, 23, 23), qdtype)
 
 
+@with_seed()
+def test_quantized_concat():
+    def check_quantized_concat(shapes, dim, qdtypes):
+        qargs, ranges, dequantized = [], [], []
+        for k, (shape, qdtype) in enumerate(zip(shapes, qdtypes)):
+            low = -1.0 if qdtype == 'int8' else 0.0
+            data = mx.nd.random.uniform(low=low, high=1.0, shape=shape) * (k + 1)
+            qdata, min_data, max_data = mx.nd.contrib.quantize(data, mx.nd.min(data), mx.nd.max(data),
+                                                               out_type=qdtype)
+            qargs.append(qdata)
+            ranges += [min_data, max_data]
+            dequantized.append(mx.nd.contrib.dequantize(qdata, min_data, max_data))
+        qoutput, min_output, max_output = mx.nd.contrib.quantized_concat(*(qargs + ranges),
+                                                                         num_args=len(shapes), dim=dim)
+        expected_type = np.uint8 if all(t == 'uint8' for t in qdtypes) else np.int8
+        assert qoutput.dtype == expected_type
+        output = mx.nd.contrib.dequantize(qoutput, min_output, max_output)
+        expected = mx.nd.concat(*dequantized, dim=dim)
+        # inputs with a smaller range lose up to one level of the output range
+        real_range = max(np.abs(min_output.asscalar()), np.abs(max_output.asscalar()))
+        assert_almost_equal(output.asnumpy(), expected.asnumpy(), rtol=0, atol=real_range / 100)
+
+    check_quantized_concat([(2, 3, 4), (2, 5, 4)], 1, ['int8', 'int8'])
+    check_quantized_concat([(3, 4), (3, 4), (3, 2)], 1, ['uint8', 'uint8', 'uint8'])
+    check_quantized_concat([(2, 3, 4), (1, 3, 4)], 0, ['uint8', 'int8'])
+
+
+@with_seed()
+def test_quantized_elemwise_add():
+    def check_quantized_elemwise_add(shape, ltype, rtype):
+        lhs = mx.nd.random.uniform(low=-1.0 if ltype == 'int8' else 0.0, high=1.0, shape=shape)
+        rhs = mx.nd.random.uniform(low=-3.0 if rtype == 'int8' else 0.0, high=3.0, shape=shape)
+        qlhs, min_lhs, max_lhs = mx.nd.contrib.quantize(lhs, mx.nd.min(lhs), mx.nd.max(lhs), out_type=ltype)
+        qrhs, min_rhs, max_rhs = mx.nd.contrib.quantize(rhs, mx.nd.min(rhs), mx.nd.max(rhs), out_type=rtype)
+        qoutput, min_output, max_output = mx.nd.contrib.quantized_elemwise_add(
+            qlhs, qrhs, min_lhs, max_lhs, min_rhs, max_rhs)
+        assert qoutput.dtype == np.int32
+        output = mx.nd.contrib.dequantize(qoutput, min_output, max_output)
+        expected = (mx.nd.contrib.dequantize(qlhs, min_lhs, max_lhs) +
+                    mx.nd.contrib.dequantize(qrhs, min_rhs, max_rhs))
+        assert_almost_equal(output.asnumpy(), expected.asnumpy(), rtol=1e-4, atol=1e-4)
+
+    for ltype in ['int8', 'uint8']:
+        for rtype in ['int8', 'uint8']:
+            check_quantized_elemwise_add((4, 5, 6), ltype, rtype)
+
+
+@with_seed()
+def test_quantize_graph_shared_quantized_output():
+    # conv is consumed by both a quantized and a non-quantized operator
+    data = mx.sym.Variable('data')
+    conv = mx.sym.Convolution(data, kernel=(1, 1), num_filter=16, name='conv')
+    pool = mx.sym.Pooling(conv, kernel=(2, 2), pool_type='max', name='pool')
+    act = mx.sym.Activation(conv, act_type='relu', name='relu')
+    sym = mx.sym.Group([pool, act])
+    qsym = mx.contrib.quant._quantize_symbol(sym, offline_params=[])
+    internals = qsym.get_internals().list_outputs()
+    assert 'quantized_pool_output' in internals
+    assert sum(1 for name in internals if name == 'conv_dequantize_output') == 1
+    # pool reads the requantized conv directly instead of a quantize node
+    assert not any(name.startswith('conv_quantize') for name in internals)
+
+
 @with_seed()
 def test_quantize_params():
     data = mx.sym.Variable('data')
@@ -572,14 +638,20 @@ def test_quantize_residual_unit():
 
 @with_seed()
 def test_quantize_sym_with_calib():
-    sym = get_fp32_sym()
+    data = mx.sym.Variable('data')
+    conv = mx.sym.Convolution(data, kernel=(1, 1), num_filter=16, name='conv')
+    pool = mx.sym.Pooling(conv, kernel=(4, 4), pool_type='avg', name='pool')
+    fc = mx.sym.FullyConnected(pool, num_hidden=10, flatten=True, name='fc')
+    sym = mx.sym.SoftmaxOutput(fc, name='softmax')
     offline_params = [name for name in sym.list_arguments()
                       if not name.startswith('data') and not name.endswith('label')]
     qsym = mx.contrib.quant._quantize_symbol(sym, offline_params=offline_params)
-    requantize_op_names = ['requantize_conv', 'requantize_fc']
+    # the output of fc is only dequantized, so it is not requantized first
+    assert 'requantize_fc' not in qsym.attr_dict()
+    requantize_op_names = ['requantize_conv']
     th_dict = {'conv_output': (np.random.uniform(low=100.0, high=200.0), np.random.uniform(low=100.0, high=200.0)),
                'fc_output': (np.random.uniform(low=100.0, high=200.0), np.random.uniform(low=100.0, high=200.0))}
-    op_name_to_th_name = {'requantize_conv': 'conv_output', 'requantize_fc': 'fc_output'}
+    op_name_to_th_name = {'requantize_conv': 'conv_output'}
     cqsym = mx.contrib.quant._calibrate_quantized_sym(qsym, th_dict)
     attr_dict = cqsym.attr_dict()
     for name in requantize_op_names:
@@ -630,6 +702,36 @@ def test_get_optimal_thresholds():
     assert_almost_equal(np.array([th_dict['layer1'][1]]), expected_threshold, rtol=1e-2, atol=1e-4)
 
 
+@with_seed()
+def test_native_calib_collector():
+    batches = [mx.nd.random.normal(scale=1.0, shape=(8, 16, 12, 12)),
+               mx.nd.random.normal(scale=1.0, shape=(8, 16, 12, 12)) * 1.5]
+    concat = np.concatenate([nd.asnumpy().ravel() for nd in batches])
+
+    naive = mx.contrib.quant._LayerOutputNativeCollector('naive', layer_names=['conv_output'])
+    for nd in batches:
+        naive.collect('conv_output', nd)
+        naive.collect('pool_output', nd)
+    th_dict = naive.get_calib_table()
+    assert list(th_dict.keys()) == ['conv_output']
+    assert_almost_equal(np.array(th_dict['conv_output']), np.array([concat.min(), concat.max()]))
+
+    # a single batch gives the same histogram as the python implementation
+    entropy = mx.contrib.quant._LayerOutputNativeCollector('entropy')
+    entropy.collect('conv_output', batches[0])
+    th_dict = entropy.get_calib_table()
+    _, _, _, expected_th = mx.contrib.quant._get_optimal_threshold(batches[0])
+    assert_almost_equal(np.array(th_dict['conv_output']), np.array([-expected_th, expected_th]),
+                        rtol=1e-2, atol=1e-3)
+
+    # the histogram grows with the range of the batches
+    entropy.collect('conv_output', batches[1])
+    th_dict = entropy.get_calib_table()
+    _, _, _, expected_th = mx.contrib.quant._get_optimal_threshold(concat)
+    assert_almost_equal(np.array([th_dict['conv_output'][1]]), np.array([expected_th]),
+                        rtol=5e-2, atol=1e-3)
+
+
 if __name__ == "__main__":
     import nose
     nose.runmodule()
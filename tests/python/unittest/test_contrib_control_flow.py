@@ -16,6 +16,7 @@
 # under the License.
 
 import copy
+import os
 import numpy as np
 import mxnet as mx
 from mxnet import gluon
@@ -1672,6 +1673,53 @@ def test_foreach_rnn():
         check_foreach_rnn(cell_type, num_states)
 
 
+@with_seed()
+def test_foreach_rnn_checkpoint():
+    # Only every 3rd iteration is recorded, the others are recomputed in backward.
+    os.environ["MXNET_LOOP_CHECKPOINT_STEPS"] = "3"
+    try:
+        cell_types = [(mx.rnn.LSTMCell, 2), (mx.rnn.GRUCell, 1)]
+        for cell_type, num_states in cell_types:
+            check_foreach_rnn(cell_type, num_states)
+    finally:
+        del os.environ["MXNET_LOOP_CHECKPOINT_STEPS"]
+
+
+@with_seed()
+def test_foreach_fused_inference():
+    def step(data, states):
+        h = mx.sym.FullyConnected(data, num_hidden=4, name='i2h') + \
+            mx.sym.FullyConnected(states[0], num_hidden=4, name='h2h')
+        h = mx.sym.tanh(h)
+        # The output and the new state are the same array.
+        return h, [h]
+
+    data = mx.sym.var("data")
+    init_h = mx.sym.var("h")
+    out, states = mx.sym.contrib.foreach(step, data, [init_h])
+    out = mx.sym.Group([out, states[0]])
+    for seq_len in [1, 4, 5]:
+        shapes = {'data': (seq_len, 2, 3), 'h': (2, 4)}
+        arg_shapes, _, _ = out.infer_shape(**shapes)
+        args = {name: mx.nd.random.uniform(shape=shape)
+                for name, shape in zip(out.list_arguments(), arg_shapes)}
+        results = []
+        for fuse in ["0", "1"]:
+            os.environ["MXNET_FOREACH_FUSE_INFERENCE"] = fuse
+            try:
+                e = out.bind(ctx=default_context(), args=args)
+                e.forward(is_train=False)
+                results.append([o.asnumpy() for o in e.outputs])
+                # Run again to reuse the compiled body.
+                e.forward(is_train=False)
+                for o, r in zip(e.outputs, results[-1]):
+                    assert_almost_equal(o.asnumpy(), r)
+            finally:
+                del os.environ["MXNET_FOREACH_FUSE_INFERENCE"]
+        for unfused, fused in zip(results[0], results[1]):
+            assert_almost_equal(unfused, fused, rtol=1e-5, atol=1e-5)
+
+
 @with_seed()
 def test_cut_subgraph_foreach():
     class TestLayer(gluon.HybridBlock):
@@ -176,6 +176,60 @@ def test_box_nms_op():
     test_box_nms_forward(np.array(boxes8), np.array(expected8), force=force, thresh=thresh, valid=valid, topk=topk)
     test_box_nms_backward(np.array(boxes8), grad8, expected_in_grad8, force=force, thresh=thresh, valid=valid, topk=topk)
 
+def test_box_nms_random():
+    def numpy_box_nms(data, thresh, valid, topk, force):
+        out = np.full(data.shape, -1.0)
+        record = np.full(data.shape[:-1], -1.0)
+        for b in range(data.shape[0]):
+            boxes = data[b]
+            # stable sort keeps ties in input order, like the operator
+            order = np.argsort(-boxes[:, 1], kind='mergesort')
+            order = [i for i in order if boxes[i, 1] > valid][:topk]
+            keep = []
+            for i in order:
+                suppressed = False
+                for j in keep:
+                    if not force and boxes[i, 0] != boxes[j, 0]:
+                        continue
+                    w = max(0, min(boxes[i, 4], boxes[j, 4]) - max(boxes[i, 2], boxes[j, 2]))
+                    h = max(0, min(boxes[i, 5], boxes[j, 5]) - max(boxes[i, 3], boxes[j, 3]))
+                    inter = w * h
+                    area_i = (boxes[i, 4] - boxes[i, 2]) * (boxes[i, 5] - boxes[i, 3])
+                    area_j = (boxes[j, 4] - boxes[j, 2]) * (boxes[j, 5] - boxes[j, 3])
+                    if inter / (area_i + area_j - inter) > thresh:
+                        suppressed = True
+                        break
+                if not suppressed:
+                    keep.append(i)
+            out[b, :len(keep)] = boxes[keep]
+            record[b, :len(keep)] = np.array(keep) + b * data.shape[1]
+        return out, record
+
+    num_batch, num_box = 3, 300
+    xy = np.random.uniform(0, 1, size=(num_batch, num_box, 2))
+    wh = np.random.uniform(0.05, 0.3, size=(num_batch, num_box, 2))
+    data = np.concatenate([np.random.randint(0, 4, size=(num_batch, num_box, 1)),
+                           np.random.uniform(size=(num_batch, num_box, 1)),
+                           xy, xy + wh], axis=-1)
+    for force, topk in itertools.product([False, True], [-1, 50]):
+        expected, expected_record = numpy_box_nms(data, 0.3, 0.2, num_box if topk < 0 else topk,
+                                                  force)
+        out = mx.nd.contrib.box_nms(mx.nd.array(data, dtype='float64'), overlap_thresh=0.3,
+                                    valid_thresh=0.2, topk=topk, id_index=0, force_suppress=force)
+        assert_almost_equal(out.asnumpy(), expected)
+        # the gradient flows back to the kept boxes only
+        in_var = mx.sym.Variable('data')
+        op = mx.contrib.sym.box_nms(in_var, overlap_thresh=0.3, valid_thresh=0.2, topk=topk,
+                                    id_index=0, force_suppress=force)
+        arr_grad = mx.nd.zeros(data.shape, dtype='float64')
+        exe = op.bind(ctx=default_context(), args=[mx.nd.array(data, dtype='float64')],
+                      args_grad=[arr_grad])
+        exe.forward(is_train=True)
+        exe.backward(mx.nd.ones(data.shape, dtype='float64'))
+        kept = np.zeros(data.shape[:-1])
+        kept.reshape(-1)[expected_record[expected_record >= 0].astype('int64')] = 1
+        assert_almost_equal(arr_grad.asnumpy(), np.repeat(kept[:, :, np.newaxis], 6, axis=-1))
+
 def test_box_iou_op():
     def numpy_box_iou(a, b, fmt='corner'):
         def area(left, top, right, bottom):
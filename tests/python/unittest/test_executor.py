@@ -15,6 +15,8 @@
 # specific language governing permissions and limitations
 # under the License.
 
+import os
+import re
 import numpy as np
 import mxnet as mx
 from common import setup_module, with_seed, teardown
@@ -165,6 +167,41 @@ def test_reshape():
     assert np.all(new_exe.arg_arrays[1].asnumpy() == 1)
 
 
+@with_seed()
+def test_memory_budget():
+    net = mx.sym.Variable('data')
+    for i in range(16):
+        net = mx.sym.FullyConnected(net, num_hidden=256, name='fc%d' % i)
+        net = mx.sym.Activation(net, act_type='tanh', name='tanh%d' % i)
+    net = mx.sym.sum(net)
+    shapes = {'data': (1024, 256)}
+    arg_shapes, _, _ = net.infer_shape(**shapes)
+    args = [mx.nd.random.uniform(-0.1, 0.1, shape=s) for s in arg_shapes]
+
+    def run(budget_mb):
+        os.environ['MXNET_BACKWARD_MEMORY_BUDGET_MB'] = str(budget_mb)
+        try:
+            exe = net.simple_bind(mx.cpu(), **shapes)
+        finally:
+            del os.environ['MXNET_BACKWARD_MEMORY_BUDGET_MB']
+        for dst, src in zip(exe.arg_arrays, args):
+            src.copyto(dst)
+        exe.forward(is_train=True)
+        exe.backward()
+        predicted = int(re.search(r'Predicted peak (\d+) MB', exe.debug_str()).group(1))
+        actual = int(re.search(r'Actual peak (\d+) MB', exe.debug_str()).group(1))
+        return [g.asnumpy() for g in exe.grad_arrays], predicted, actual
+
+    # A large budget recomputes nothing.
+    grads, predicted, actual = run(1 << 20)
+    budget = predicted * 2 // 3
+    budget_grads, budget_predicted, budget_actual = run(budget)
+    assert budget_predicted <= budget
+    assert budget_actual < actual
+    for g, budget_g in zip(grads, budget_grads):
+        assert_almost_equal(g, budget_g)
+
+
 if __name__ == "__main__":
     import nose
     nose.runmodule()
@@ -45,6 +45,48 @@ def test_normalize():
     assert_almost_equal(data_expected, out_nd.asnumpy())
 
 
+@with_seed()
+def test_to_tensor_normalize():
+    def bilinear_index(size, src_size):
+        f = (np.arange(size) + 0.5) * src_size / size - 0.5
+        f = np.clip(f, 0, src_size - 1)
+        lo = np.floor(f).astype(np.int64)
+        return lo, np.minimum(lo + 1, src_size - 1), f - lo
+
+    def resize(img, width, height):
+        y0, y1, wy = bilinear_index(height, img.shape[-3])
+        x0, x1, wx = bilinear_index(width, img.shape[-2])
+        wx = wx[:, None]
+        top = img[..., y0, :, :][..., x0, :] * (1 - wx) + img[..., y0, :, :][..., x1, :] * wx
+        bottom = img[..., y1, :, :][..., x0, :] * (1 - wx) + img[..., y1, :, :][..., x1, :] * wx
+        wy = wy[:, None, None]
+        return top * (1 - wy) + bottom * wy
+
+    mean, std = (0.485, 0.456, 0.406), (0.229, 0.224, 0.225)
+    for shape in [(37, 45, 3), (4, 37, 45, 3)]:
+        for dtype in ['uint8', 'float32']:
+            data_in = np.random.uniform(0, 255, shape).astype(dtype=np.uint8)
+            data_nd = nd.array(data_in, dtype=dtype)
+            # same as to_tensor followed by normalize
+            out_nd = nd.image.to_tensor_normalize(data_nd, mean=mean, std=std)
+            images = [data_nd[i] for i in range(shape[0])] if len(shape) == 4 else [data_nd]
+            expected = [nd.image.normalize(nd.image.to_tensor(img), mean=mean, std=std)
+                        for img in images]
+            expected = nd.stack(*expected) if len(shape) == 4 else expected[0]
+            assert_almost_equal(out_nd.asnumpy(), expected.asnumpy(), rtol=1e-5, atol=1e-5)
+            # crop only
+            out_nd = nd.image.to_tensor_normalize(data_nd, mean=mean, std=std, crop=(5, 3, 30, 20))
+            assert_almost_equal(out_nd.asnumpy(), expected.asnumpy()[..., 3:23, 5:35],
+                                rtol=1e-5, atol=1e-5)
+            # resize, then crop
+            out_nd = nd.image.to_tensor_normalize(data_nd, mean=mean, std=std,
+                                                  size=(60, 25), crop=(4, 2, 50, 20))
+            resized = resize(data_in.astype(np.float64) / 255.0, 60, 25)[..., 2:22, 4:54, :]
+            expected = (resized - np.array(mean)) / np.array(std)
+            expected = np.moveaxis(expected, -1, -3)
+            assert_almost_equal(out_nd.asnumpy(), expected, rtol=1e-4, atol=1e-4)
+
+
 @with_seed()
 def test_flip_left_right():
     data_in = np.random.uniform(0, 255, (300, 300, 3)).astype(dtype=np.uint8)
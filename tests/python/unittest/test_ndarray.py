@@ -861,6 +861,21 @@ def test_order():
                      k=dat_size*dat_size*dat_size*dat_size, is_ascend=False)
         assert_almost_equal(nd_ret_sort, gt)
 
+@with_seed()
+def test_topk_large_vocab():
+    # Small k selects with a heap, larger k with a partial selection, and a single
+    # long row is split among threads. Equal values are ordered by their index.
+    for batch_size, vocab_size in [(1, 200000), (16, 50000)]:
+        data = np.random.randint(0, 1000, size=(batch_size, vocab_size)).astype(np.float32)
+        data_nd = mx.nd.array(data, ctx=mx.cpu())
+        for k in [1, 5, 200, 3000]:
+            for is_ascend in [False, True]:
+                order = np.argsort(data if is_ascend else -data, axis=1, kind='mergesort')[:, :k]
+                values, indices = mx.nd.topk(data_nd, axis=1, k=k, ret_typ="both",
+                                             is_ascend=is_ascend, dtype=np.int32)
+                assert_almost_equal(indices.asnumpy(), order)
+                assert_almost_equal(values.asnumpy(), data[np.arange(batch_size)[:, None], order])
+
 @with_seed()
 def test_ndarray_equal():
     x = mx.nd.zeros((2, 3))
@@ -1440,6 +1455,59 @@ def test_ndarray_cpu_shared_ctx():
     assert(res.context == ctx)
 
 
+@with_seed()
+def test_ndarray_repeated_invoke():
+    # Repeated calls reuse the inferred attributes of the calls with the same
+    # operator, attributes and array signatures, and only those.
+    for _ in range(3):
+        for shape in [(2, 3), (4, 5)]:
+            for dtype in ['float32', 'float16']:
+                x = mx.nd.array(np.random.uniform(size=shape), dtype=dtype)
+                for axis in [0, 1]:
+                    y = mx.nd.sum(x, axis=axis)
+                    assert y.shape == (shape[1 - axis],)
+                    assert y.dtype == np.dtype(dtype)
+                    assert_almost_equal(y.asnumpy(), x.asnumpy().sum(axis=axis),
+                                        rtol=1e-2, atol=1e-2)
+                out = mx.nd.empty(shape, dtype=dtype)
+                mx.nd.relu(x, out=out)
+                assert_almost_equal(out.asnumpy(), np.maximum(x.asnumpy(), 0))
+                if dtype == 'float32':
+                    csr = x.tostype('csr')
+                    assert csr.stype == 'csr'
+                    assert_almost_equal(csr.asnumpy(), x.asnumpy())
+
+
+@with_seed()
+def test_ndarray_lazy():
+    def chain(x, w):
+        y = x
+        for _ in range(5):
+            y = mx.nd.relu(y * w + 1) - 0.5
+        tmp = mx.nd.exp(y)  # never read
+        return y, mx.nd.sum(y, axis=1)
+
+    x = mx.nd.array(np.random.uniform(-1, 1, size=(4, 8)))
+    w = mx.nd.array(np.random.uniform(-1, 1, size=(4, 8)))
+    ref_y, ref_s = chain(x, w)
+    for _ in range(3):
+        with mx.engine.lazy():
+            y, s = chain(x, w)
+            assert y.shape == (4, 8) and s.shape == (4,)
+            # reading a slice, writing in place and mixing in eager calls
+            # run the pending operators first
+            assert_almost_equal(y[1].asnumpy(), ref_y[1].asnumpy())
+            z = y + 1
+            z += 1
+            out = mx.nd.empty((4, 8))
+            mx.nd.relu(z, out=out)
+            assert_almost_equal(out.asnumpy(), np.maximum(ref_y.asnumpy() + 2, 0))
+            v = s * 2
+        assert_almost_equal(s.asnumpy(), ref_s.asnumpy())
+        assert_almost_equal(v.asnumpy(), ref_s.asnumpy() * 2)
+        assert_almost_equal(y.asnumpy(), ref_y.asnumpy())
+
+
 if __name__ == '__main__':
     import nose
     nose.runmodule()
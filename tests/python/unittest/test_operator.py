@@ -106,6 +106,22 @@ def test_lstm_bidirectional():
     check_rnn_consistency(fused, stack, T, N, I, H, 'add')
     check_rnn_consistency(fused, stack, T, N, I, H, 'null')
 
+@with_seed()
+@assert_raises_cudnn_disabled()
+def test_lstm_uneven_hidden_blocks():
+    # hidden sizes that do not split evenly over the threads, or are smaller than their count
+    for H in [1, 3, 37]:
+        T, N, I = 7, 5, 11
+        fused = mx.rnn.FusedRNNCell(H, num_layers=2, mode='lstm',
+                                    bidirectional=True, get_next_state=True, prefix='')
+        stack = mx.rnn.SequentialRNNCell()
+        for i in range(2):
+            stack.add(mx.rnn.BidirectionalCell(
+                        mx.rnn.LSTMCell(H, prefix='l%d_' % i),
+                        mx.rnn.LSTMCell(H, prefix='r%d_' % i),
+                        output_prefix='bi_lstm_%d_' % i))
+        check_rnn_consistency(fused, stack, T, N, I, H, 'write')
+
 @with_seed()
 @assert_raises_cudnn_disabled()
 def test_gru_sym():
@@ -120,6 +136,15 @@ def test_gru_sym():
     check_rnn_consistency(fused, stack, T, N, I, H, 'add')
     check_rnn_consistency(fused, stack, T, N, I, H, 'null')
 
+    # hidden sizes that do not split evenly over the threads, or are smaller than their count
+    for H in [1, 3, 37]:
+        T, N, I = 7, 5, 11
+        fused = mx.rnn.FusedRNNCell(H, num_layers=2, mode='gru', get_next_state=True, prefix='')
+        stack = mx.rnn.SequentialRNNCell()
+        stack.add(mx.rnn.GRUCell(H, prefix='l0_'))
+        stack.add(mx.rnn.GRUCell(H, prefix='l1_'))
+        check_rnn_consistency(fused, stack, T, N, I, H, 'write')
+
 @with_seed()
 @assert_raises_cudnn_disabled()
 def test_gru_bidirectional():
@@ -143,6 +168,19 @@ def test_gru_bidirectional():
     check_rnn_consistency(fused, stack, T, N, I, H, 'add')
     check_rnn_consistency(fused, stack, T, N, I, H, 'null')
 
+    # hidden sizes that do not split evenly over the threads, or are smaller than their count
+    for H in [1, 3, 37]:
+        T, N, I = 7, 5, 11
+        fused = mx.rnn.FusedRNNCell(H, num_layers=2, mode='gru',
+                                    bidirectional=True, get_next_state=True, prefix='')
+        stack = mx.rnn.SequentialRNNCell()
+        for i in range(2):
+            stack.add(mx.rnn.BidirectionalCell(
+                        mx.rnn.GRUCell(H, prefix='l%d_' % i),
+                        mx.rnn.GRUCell(H, prefix='r%d_' % i),
+                        output_prefix='bi_gru_%d_' % i))
+        check_rnn_consistency(fused, stack, T, N, I, H, 'write')
+
 @with_seed()
 @assert_raises_cudnn_disabled()
 def test_rnntanh_sym():
@@ -3232,6 +3270,39 @@ def test_layer_norm():
                                               forward_check_eps=forward_check_eps)
 
 
+@with_seed()
+def test_layer_norm_contiguous_channels():
+    # Rows longer than the vectorized lanes and a tail, and trailing unit axes
+    for in_shape, axis in [((64, 771), -1), ((4, 16, 1024), 2), ((6, 37, 1), 1)]:
+        data = np.random.normal(3, 2, in_shape).astype(np.float32)
+        gamma = np.random.normal(0, 1, (in_shape[axis],)).astype(np.float32)
+        beta = np.random.normal(0, 1, (in_shape[axis],)).astype(np.float32)
+        ograd = np.random.normal(0, 1, in_shape).astype(np.float32)
+        eps = 1E-5
+        bshape = [1] * len(in_shape)
+        bshape[axis] = in_shape[axis]
+        red_axes = tuple(i for i in range(len(in_shape)) if i != axis % len(in_shape))
+        mean = data.mean(axis=axis, keepdims=True)
+        std = np.sqrt(data.var(axis=axis, keepdims=True) + eps)
+        xhat = (data - mean) / std
+        out = xhat * gamma.reshape(bshape) + beta.reshape(bshape)
+        w = ograd * gamma.reshape(bshape) / std
+        data_grad = w - w.mean(axis=axis, keepdims=True) - \
+            xhat * (w * xhat).mean(axis=axis, keepdims=True)
+        gamma_grad = (ograd * xhat).sum(axis=red_axes)
+        beta_grad = ograd.sum(axis=red_axes)
+        sym = mx.sym.LayerNorm(data=mx.sym.Variable('data'), gamma=mx.sym.Variable('gamma'),
+                               beta=mx.sym.Variable('beta'), axis=axis, eps=eps,
+                               output_mean_var=True)
+        location = [data, gamma, beta]
+        check_symbolic_forward(sym, location, [out, mean, std], rtol=1e-4, atol=1e-4)
+        out_grads = [ograd, np.zeros(mean.shape), np.zeros(std.shape)]
+        expected = [data_grad, gamma_grad, beta_grad]
+        for req in ['write', 'add']:
+            check_symbolic_backward(sym, location, out_grads, expected, grad_req=req,
+                                    rtol=1e-3, atol=1e-3)
+
+
 # Numpy Implementation of Sequence Ops
 def sequence_last_numpy(array, lengths, axis):
     # create new array of dims [batch, seqlen, ...]
@@ -4787,6 +4858,126 @@ def test_div_sqrt_dim():
     check_symbolic_forward(test, [data_tmp], [data_tmp / np.sqrt(data_tmp.shape[-1])])
 
 
+def _attention_reference(queries, keys, values, heads, mask=None):
+    # queries, keys and values of shape (length, batch, heads * head_dim)
+    def split_heads(x):
+        x = mx.nd.reshape(x, shape=(0, 0, heads, -1))
+        x = mx.nd.transpose(x, axes=(1, 2, 0, 3))
+        return mx.nd.reshape(x, shape=(-1, 0, 0), reverse=True)
+    q, k, v = split_heads(queries), split_heads(keys), split_heads(values)
+    att = mx.nd.batch_dot(mx.nd.contrib.div_sqrt_dim(q), k, transpose_b=True)
+    if mask is not None:
+        att = mx.nd.where(mask, att, mx.nd.ones_like(att) * -1e18)
+    att = mx.nd.softmax(att, axis=-1)
+    if mask is not None:
+        att = att * mask
+    out = mx.nd.batch_dot(att, v)
+    out = mx.nd.reshape(out, shape=(-1, heads, 0, 0), reverse=True)
+    out = mx.nd.transpose(out, axes=(2, 0, 1, 3))
+    return mx.nd.reshape(out, shape=(0, 0, -1)), att
+
+
+def _attention_mask(batch, heads, qlen, klen, valid_length, causal):
+    mask = np.ones((batch, heads, qlen, klen))
+    if valid_length is not None:
+        for b, length in enumerate(valid_length):
+            mask[b, :, :, int(length):] = 0
+    if causal:
+        mask *= np.tril(np.ones((qlen, klen)))
+    return mx.nd.array(mask.reshape((batch * heads, qlen, klen)))
+
+
+def _check_attention(attention, reference, inputs):
+    outs, grads = [], []
+    for f in (attention, reference):
+        for x in inputs:
+            x.attach_grad()
+        with mx.autograd.record():
+            out = f(*inputs)
+        out.backward(mx.nd.array(np.arange(out.size).reshape(out.shape) % 7 - 3))
+        outs.append(out.asnumpy())
+        grads.append([x.grad.asnumpy() for x in inputs])
+    assert_almost_equal(outs[0], outs[1], rtol=1e-4, atol=1e-4)
+    for grad, reference_grad in zip(*grads):
+        assert_almost_equal(grad, reference_grad, rtol=1e-4, atol=1e-4)
+
+
+@with_seed()
+def test_interleaved_matmul():
+    batch, heads, head_dim, qlen, klen = 3, 4, 8, 7, 5
+    embed = heads * head_dim
+    with mx.Context(mx.cpu()):
+        qkv = mx.nd.random.normal(shape=(qlen, batch, 3 * embed))
+        q = mx.nd.random.normal(shape=(qlen, batch, embed))
+        kv = mx.nd.random.normal(shape=(klen, batch, 2 * embed))
+
+        def selfatt(qkv):
+            tmp = mx.nd.reshape(qkv, shape=(0, 0, heads, 3, -1))
+            q, k, v = [mx.nd.reshape(tmp[:, :, :, i, :], shape=(0, 0, -1)) for i in range(3)]
+            return _attention_reference(q, k, v, heads)
+
+        def selfatt_interleaved(qkv):
+            att = mx.nd.contrib.interleaved_matmul_selfatt_qk(qkv, heads=heads)
+            att = mx.nd.softmax(att, axis=-1)
+            return mx.nd.contrib.interleaved_matmul_selfatt_valatt(qkv, att, heads=heads)
+
+        def encdec(q, kv):
+            tmp = mx.nd.reshape(kv, shape=(0, 0, heads, 2, -1))
+            k, v = [mx.nd.reshape(tmp[:, :, :, i, :], shape=(0, 0, -1)) for i in range(2)]
+            return _attention_reference(q, k, v, heads)
+
+        def encdec_interleaved(q, kv):
+            att = mx.nd.contrib.interleaved_matmul_encdec_qk(q, kv, heads=heads)
+            att = mx.nd.softmax(att, axis=-1)
+            return mx.nd.contrib.interleaved_matmul_encdec_valatt(kv, att, heads=heads)
+
+        _check_attention(selfatt_interleaved, lambda x: selfatt(x)[0], [qkv])
+        _check_attention(encdec_interleaved, lambda x, y: encdec(x, y)[0], [q, kv])
+
+
+@with_seed()
+def test_interleaved_attention():
+    batch, heads, head_dim = 3, 2, 8
+    embed = heads * head_dim
+    with mx.Context(mx.cpu()):
+        # The longer sequences are processed in several blocks of queries. The
+        # reference self attention of 2000 keys is too large, 300 keys already
+        # take three blocks of queries.
+        for qlen, klen in [(6, 5), (300, 300), (40, 2000)]:
+            valid_length = mx.nd.array(np.random.randint(0, klen + 1, size=(batch,)))
+            for causal, use_valid_length in itertools.product([False, True], [False, True]):
+                qkv = mx.nd.random.normal(shape=(klen, batch, 3 * embed))
+                q = mx.nd.random.normal(shape=(qlen, batch, embed))
+                kv = mx.nd.random.normal(shape=(klen, batch, 2 * embed))
+                lengths = valid_length.asnumpy() if use_valid_length else None
+                kwargs = {'heads': heads, 'causal': causal, 'use_valid_length': use_valid_length}
+                extra = [valid_length] if use_valid_length else []
+
+                def selfatt(qkv):
+                    tmp = mx.nd.reshape(qkv, shape=(0, 0, heads, 3, -1))
+                    q, k, v = [mx.nd.reshape(tmp[:, :, :, i, :], shape=(0, 0, -1))
+                               for i in range(3)]
+                    mask = _attention_mask(batch, heads, klen, klen, lengths, causal)
+                    return _attention_reference(q, k, v, heads, mask)[0]
+
+                def selfatt_fused(qkv):
+                    return mx.nd.contrib.interleaved_selfatt(qkv, *extra, **kwargs)
+
+                def encdec(q, kv):
+                    tmp = mx.nd.reshape(kv, shape=(0, 0, heads, 2, -1))
+                    k, v = [mx.nd.reshape(tmp[:, :, :, i, :], shape=(0, 0, -1))
+                            for i in range(2)]
+                    mask = _attention_mask(batch, heads, qlen, klen, lengths, causal)
+                    return _attention_reference(q, k, v, heads, mask)[0]
+
+                def encdec_fused(q, kv):
+                    return mx.nd.contrib.interleaved_encdec_att(q, kv, *extra, **kwargs)
+
+                if klen <= 300:
+                    _check_attention(selfatt_fused, selfatt, [qkv])
+                _check_attention(encdec_fused, encdec, [q, kv])
+
+
 @with_seed()
 def test_reciprocal_op():
     eps = 2**(-11)
@@ -5896,6 +6087,35 @@ def test_dropout():
         check_dropout_axes(0.25, nshape, axes = (1, 2, 3))
 
 
+@with_seed()
+def test_dropout_packed_mask():
+    for dtype in ['float16', 'float32', 'float64']:
+        for shape in [(3, 5), (4, 3, 17), (1000,)]:
+            size = int(np.prod(shape))
+            data = mx.sym.var('data')
+            sym = mx.sym.Dropout(data, p=0.3, packed_mask=True)
+            _, out_shapes, _ = sym.get_internals().infer_shape(data=shape)
+            _, out_types, _ = sym.get_internals().infer_type(data=dtype)
+            assert out_shapes[-1] == ((size + 7) // 8,)
+            assert out_types[-1] == np.uint8
+
+            x = mx.nd.random.uniform(1, 2, shape=shape, dtype=dtype)
+            x.attach_grad()
+            with mx.autograd.record():
+                y = mx.nd.Dropout(x, p=0.3, packed_mask=True)
+            dy = mx.nd.random.uniform(shape=shape, dtype=dtype)
+            y.backward(dy)
+            keep = y.asnumpy() != 0
+            scale = np.array(1.0 / 0.7, dtype=np.float32).astype(dtype)
+            assert_almost_equal(y.asnumpy(), x.asnumpy() * keep * scale)
+            assert_almost_equal(x.grad.asnumpy(), dy.asnumpy() * keep * scale)
+            if size >= 1000:
+                assert abs(1 - keep.mean() - 0.3) < 0.1
+
+            # inference leaves the input unchanged
+            assert_almost_equal(mx.nd.Dropout(x, p=0.3, packed_mask=True).asnumpy(), x.asnumpy())
+
+
 @unittest.skip("test fails intermittently. temporarily disabled till it gets fixed. tracked at https://github.com/apache/incubator-mxnet/issues/11290")
 @with_seed()
 def test_scatter_gather_nd():
@@ -22,6 +22,7 @@ from mxnet import gluon
 import unittest
 from nose.tools import raises
 import math
+import itertools
 from mxnet.test_utils import *
 from common import setup_module, with_seed, teardown
 
@@ -650,6 +651,41 @@ def test_adam():
                                           dtype, w_stype='default', g_stype='row_sparse',
                                           rtol=1e-4, atol=2e-5)
 
+@with_seed()
+def test_multi_tensor_update():
+    # several small weights and one split into several chunks, of two dtypes or float16
+    shapes = [(3, 4), (7,), (1, 1, 5), (200, 300), (9, 2)]
+    configs = [('sgd', {'momentum': 0.0}), ('sgd', {'momentum': 0.9}), ('adam', {}),
+               ('sgd', {'momentum': 0.9, 'multi_precision': True}),
+               ('adam', {'multi_precision': True})]
+    for (name, opt_kwargs), clip_gradient in itertools.product(configs, [None, 0.1]):
+        kwargs = dict(opt_kwargs, learning_rate=0.1, wd=0.03, rescale_grad=0.5,
+                      clip_gradient=clip_gradient)
+        if opt_kwargs.get('multi_precision'):
+            # float16 weights are updated through their float32 master copies
+            dtypes = [np.float16] * len(shapes)
+        else:
+            dtypes = [np.float32, np.float32, np.float64, np.float32, np.float64]
+        opt_aggregated = mx.optimizer.create(name, **kwargs)
+        opt_aggregated.aggregate_num = 3
+        opt_single = mx.optimizer.create(name, **kwargs)
+        opt_single.aggregate_num = 0
+        opt_aggregated.set_lr_mult({1: 0.5})
+        opt_single.set_lr_mult({1: 0.5})
+        updater_aggregated = mx.optimizer.get_updater(opt_aggregated)
+        updater_single = mx.optimizer.get_updater(opt_single)
+        weights = [mx.nd.random.normal(shape=s, dtype=t) for s, t in zip(shapes, dtypes)]
+        weights_single = [w.copy() for w in weights]
+        indices = list(range(len(shapes)))
+        for _ in range(3):
+            grads = [mx.nd.random.normal(shape=s, dtype=t) for s, t in zip(shapes, dtypes)]
+            updater_aggregated(indices, grads, weights)
+            for i, g, w in zip(indices, grads, weights_single):
+                updater_single(i, g, w)
+            for w, w_single in zip(weights, weights_single):
+                assert_almost_equal(w.asnumpy(), w_single.asnumpy(), rtol=1e-5, atol=1e-6)
+
+
 # Signum
 class PySignum(mx.optimizer.Optimizer):
     """The python reference of Signum optimizer.
@@ -869,7 +905,7 @@ def test_rms():
                                     continue
                                 compare_optimizer(opt1(**kwarg), opt2(**kwarg), shape, dtype, rtol=rtol, atol=atol)
                                 if (default_context() == mx.cpu()):
-                                    compare_optimizer(opt1(**kwarg), opt2(**kwarg), shape, dtype, g_stype='row_sparse', rtol=rtol, atol=atol)
+                                    compare_optimizer(opt1(**kwarg), opt2(lazy_update=False, **kwarg), shape, dtype, g_stype='row_sparse', rtol=rtol, atol=atol)
 
 class PyFtrl(mx.optimizer.Optimizer):
     """The Ftrl optimizer.
@@ -1039,6 +1075,50 @@ def test_adagrad():
                             compare_optimizer(opt1(**kwarg), opt2(**kwarg), shape, dtype,
                                               g_stype='row_sparse')
 
+@with_seed()
+def test_lazy_update_dense_equivalence():
+    # the lazy update of the rows present in a row_sparse gradient must be bit-identical
+    # to the dense update of these rows, and must leave the other rows untouched
+    if default_context() != mx.cpu():
+        return
+    shape = (20, 7)
+    # update op, ranges of the initial states, arguments
+    updates = [
+        (mx.nd.rmsprop_update, [(0, 1)],
+         {'lr': 0.1, 'wd': 0.05, 'rescale_grad': 0.8, 'clip_gradient': 0.5}),
+        (mx.nd.rmsprop_update, [(0, 1)], {'lr': 0.1, 'clip_weights': 0.6}),
+        (mx.nd.rmspropalex_update, [(1, 2), (0, 0.5), (-1, 1)],
+         {'lr': 0.1, 'wd': 0.05, 'clip_gradient': 0.5}),
+        (mx.nd.ftml_update, [(0, 1), (0, 1), (-1, 1)],
+         {'lr': 0.1, 't': 3, 'wd': 0.05, 'rescale_grad': 0.8}),
+        (mx.nd.signum_update, [(-1, 1)],
+         {'lr': 0.1, 'momentum': 0.9, 'wd': 0.05, 'wd_lh': 0.01}),
+        (mx.nd.signsgd_update, [], {'lr': 0.1, 'wd': 0.05}),
+        (mx.nd.nag_mom_update, [(-1, 1)],
+         {'lr': 0.1, 'momentum': 0.9, 'wd': 0.05, 'clip_gradient': 0.5}),
+    ]
+    for update, state_ranges, kwargs in updates:
+        for stype in ['default', 'row_sparse']:
+            weight = mx.nd.random.uniform(-1, 1, shape=shape)
+            states = [mx.nd.random.uniform(low, high, shape=shape) for low, high in state_ranges]
+            grad = rand_ndarray(shape, 'row_sparse', density=0.5)
+            rows = grad.indices.asnumpy()
+            untouched = np.setdiff1d(np.arange(shape[0]), rows)
+
+            lazy_weight = weight.tostype(stype)
+            lazy_states = [state.tostype(stype) for state in states]
+            update(lazy_weight, grad, *lazy_states, out=lazy_weight, **kwargs)
+
+            dense_weight = mx.nd.array(weight.asnumpy()[rows])
+            dense_states = [mx.nd.array(state.asnumpy()[rows]) for state in states]
+            update(dense_weight, grad.data, *dense_states, out=dense_weight, **kwargs)
+
+            for before, lazy, dense in zip([weight] + states, [lazy_weight] + lazy_states,
+                                           [dense_weight] + dense_states):
+                assert lazy.stype == stype
+                assert np.array_equal(lazy.asnumpy()[rows], dense.asnumpy())
+                assert np.array_equal(lazy.asnumpy()[untouched], before.asnumpy()[untouched])
+
 
 def test_factor_scheduler():
     base_lr = 1
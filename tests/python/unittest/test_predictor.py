@@ -17,9 +17,10 @@
 
 from __future__ import print_function
 import sys, os
+import threading
 curr_path = os.path.dirname(os.path.abspath(os.path.expanduser(__file__)))
 sys.path.append(os.path.join(curr_path, "../../../amalgamation/python/"))
-from mxnet_predict import Predictor, load_ndarray_file
+from mxnet_predict import Predictor, Batcher, create_predictors, load_ndarray_file
 
 import numpy as np
 import mxnet as mx
@@ -67,6 +68,91 @@ def test_predictor():
     # destroy the predictor
     del predictor
 
+@with_seed()
+def test_multi_instance_predictor():
+    prefix = 'test_predictor_multi_instance'
+    symbol_file = "%s-symbol.json" % prefix
+    param_file = "%s-0000.params" % prefix
+
+    input1 = np.random.uniform(size=(1,3))
+    input2 = np.random.uniform(size=(3,3))
+
+    block = gluon.nn.HybridSequential()
+    block.add(gluon.nn.Dense(7))
+    block.add(gluon.nn.Dense(3))
+    block.hybridize()
+    block.initialize()
+    out1 = block.forward(nd.array(input1))
+    out2 = block.forward(nd.array(input2))
+    block.export(prefix)
+
+    predictors = create_predictors(open(symbol_file, "r").read(),
+                                   open(param_file, "rb").read(),
+                                   {'data':input1.shape}, 3)
+    assert len(predictors) == 3
+    for predictor in predictors:
+        predictor.forward(data=input1)
+        assert_almost_equal(out1.asnumpy(), predictor.get_output(0), rtol=1e-5, atol=1e-6)
+
+    # switch between cached shapes
+    predictor = predictors[0]
+    for data, out in [(input2, out2), (input1, out1), (input2, out2)]:
+        predictor.reshape({'data':data.shape})
+        predictor.forward(data=data)
+        assert_almost_equal(out.asnumpy(), predictor.get_output(0), rtol=1e-5, atol=1e-6)
+
+    # other instances are not affected by the reshape
+    predictors[1].forward(data=input1)
+    assert_almost_equal(out1.asnumpy(), predictors[1].get_output(0), rtol=1e-5, atol=1e-6)
+    del predictors
+
+@with_seed()
+def test_batcher():
+    prefix = 'test_predictor_batcher'
+    symbol_file = "%s-symbol.json" % prefix
+    param_file = "%s-0000.params" % prefix
+
+    num_requests = 64
+    inputs = np.random.uniform(size=(num_requests, 3))
+
+    block = gluon.nn.HybridSequential()
+    block.add(gluon.nn.Dense(7))
+    block.add(gluon.nn.Dense(3))
+    block.hybridize()
+    block.initialize()
+    expected = block.forward(nd.array(inputs)).asnumpy()
+    block.export(prefix)
+
+    max_batch_size = 8
+    batcher = Batcher(open(symbol_file, "r").read(),
+                      open(param_file, "rb").read(),
+                      {'data':(3,)}, max_batch_size,
+                      max_wait_us=2000, num_workers=2)
+
+    # local load generator: several client threads submitting single requests
+    outputs = [None] * num_requests
+    def client(begin, step):
+        for i in range(begin, num_requests, step):
+            req = batcher.submit(data=inputs[i])
+            outputs[i] = req.get_output(0)
+    num_clients = 8
+    clients = [threading.Thread(target=client, args=(i, num_clients))
+               for i in range(num_clients)]
+    for t in clients:
+        t.start()
+    for t in clients:
+        t.join()
+
+    for i in range(num_requests):
+        assert outputs[i].shape == (1, 3)
+        assert_almost_equal(expected[i:i+1], outputs[i], rtol=1e-5, atol=1e-6)
+
+    batch_hist = batcher.batch_size_histogram()
+    assert len(batch_hist) == max_batch_size
+    assert sum((i + 1) * c for i, c in enumerate(batch_hist)) == num_requests
+    assert sum(c for _, c in batcher.latency_histogram()) == num_requests
+    del batcher
+
 @with_seed()
 def test_load_ndarray():
     nd_file = 'test_predictor_load_ndarray.params'
@@ -1907,6 +1907,32 @@ def test_sparse_embedding():
             check_sparse_embedding(in_dim, out_dim, batch, densities, sparse_grad, weight_stype)
             check_sparse_embedding(in_dim, out_dim, batch, densities, sparse_grad, weight_stype)
 
+@with_seed()
+def test_embedding_backward_large_batch():
+    ''' test the embedding gradient of batches large enough to be accumulated in parallel '''
+    in_dim = 1000
+    out_dim = 16
+    batch = 20000
+    # a skewed distribution, so that some rows are referenced many times
+    np_data = np.minimum(np.random.zipf(1.5, size=batch) - 1, in_dim - 1)
+    np_grad = np.random.uniform(-1, 1, (batch, out_dim))
+    expected = np.zeros((in_dim, out_dim))
+    np.add.at(expected, np_data, np_grad)
+    for sparse_grad in [True, False]:
+        data = mx.sym.Variable("data")
+        embed = mx.sym.Embedding(data=data, input_dim=in_dim, output_dim=out_dim,
+                                 sparse_grad=sparse_grad, name='embed')
+        exe = embed.simple_bind(default_context(), grad_req={'data': 'null', 'embed_weight': 'write'},
+                                data=(batch,))
+        exe.arg_dict["data"][:] = np_data
+        exe.forward(is_train=True)
+        exe.backward([mx.nd.array(np_grad)])
+        weight_grad = exe.grad_dict["embed_weight"]
+        assert weight_grad.stype == ('row_sparse' if sparse_grad else 'default')
+        assert_almost_equal(weight_grad.asnumpy(), expected, atol=1e-4)
+        if sparse_grad:
+            assert_almost_equal(weight_grad.indices.asnumpy(), np.unique(np_data))
+
 @with_seed()
 def test_sparse_broadcast_add_sub():
     def check_broadcast_add(mx_lhs, mx_rhs, np_lhs, np_rhs, dtype):
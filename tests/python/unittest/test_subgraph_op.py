@@ -233,6 +233,46 @@ def test_subgraph_exe():
     test_network_structure_7()
 
 
+def test_elemwise_fusion_subgraph():
+    def get_executor(sym, shapes, backend=None):
+        if backend is not None:
+            os.environ['MXNET_SUBGRAPH_BACKEND'] = backend
+        exe = sym.simple_bind(ctx=mx.cpu(), grad_req='null', **shapes)
+        if backend is not None:
+            del os.environ['MXNET_SUBGRAPH_BACKEND']
+        return exe
+
+    def check_fusion(sym, shapes, num_fused):
+        exe = get_executor(sym, shapes)
+        fused_exe = get_executor(sym, shapes, 'ELEMWISE')
+        assert fused_exe.debug_str().count('Op:_elemwise_fused_op') == num_fused
+        for name, arr in exe.arg_dict.items():
+            arr[:] = mx.nd.random.uniform(0.1, 1, shape=arr.shape)
+            fused_exe.arg_dict[name][:] = arr
+        exe.forward()
+        fused_exe.forward()
+        assert len(exe.outputs) == len(fused_exe.outputs)
+        for out, fused_out in zip(exe.outputs, fused_exe.outputs):
+            assert_almost_equal(out.asnumpy(), fused_out.asnumpy(), rtol=1e-5, atol=1e-6)
+
+    a = mx.sym.var('a')
+    b = mx.sym.var('b')
+    c = mx.sym.var('c')
+    # a chain with scalar, binary and activation operators
+    ret = mx.sym.Activation(mx.sym.sqrt(a * 2 + b) - 1 / b, act_type='tanh')
+    check_fusion(ret, {'a': (4, 1000), 'b': (4, 1000)}, 1)
+    # an intermediate result that is also an output
+    mid = mx.sym.exp(-a) + b
+    check_fusion(mx.sym.Group([mid, mx.sym.relu(mid * mid)]), {'a': (3, 7), 'b': (3, 7)}, 1)
+    # operators that are not elementwise split the chains
+    ret = mx.sym.sum(mx.sym.sigmoid(a + b), axis=1, keepdims=True)
+    ret = mx.sym.broadcast_mul(ret * 3 + 1, c)
+    check_fusion(ret, {'a': (5, 6), 'b': (5, 6), 'c': (5, 6)}, 2)
+    # broadcast operators whose operands differ in shape are not fused
+    ret = mx.sym.broadcast_add(mx.sym.exp(a), mx.sym.square(c))
+    check_fusion(ret, {'a': (5, 6), 'c': (1, 6)}, 0)
+
+
 if __name__ == '__main__':
     import nose
     nose.runmodule()